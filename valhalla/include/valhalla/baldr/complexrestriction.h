@@ -80,6 +80,14 @@ class ComplexRestriction {
    */
   const std::vector<GraphId> GetVias() const;
 
+  /**
+   * Get the vias in place, without copying them.
+   * @return  Returns the via edge ids.
+   */
+  midgard::iterable_t<const GraphId> vias() const {
+    return midgard::iterable_t<const GraphId>(via_list_, via_count());
+  }
+
   /**
    * Get the size of this complex restriction (without padding).
    * @return  Returns the size in bytes of this object.
@@ -6,22 +6,67 @@
 #include <valhalla/baldr/graphtilestorage.h>
 
 #include <vector>
+#include <map>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <cstdint>
 
 namespace valhalla {
   namespace baldr {
-    //TODO: maintain consistent coloring of regions despite the connectivity changing
+    /**
+     * Colors of the tiles of each hierarchy level, any 2 tiles with a connected
+     * path between them have the same color. The colors are kept as a compact
+     * blob, per level an array of (tile id, color) sorted by tile id, that is
+     * also the layout of the sidecar file so a saved map is memory mapped at
+     * startup rather than recomputed. The levels are colored in parallel.
+     */
     class connectivity_map_t {
      public:
       /**
-       * Constructs the connectivity map
+       * Constructs the connectivity map. If mjolnir.connectivity_map names a
+       * sidecar file it is mapped when it exists, otherwise the map is computed
+       * from the tile set and saved to it. A sidecar saved for another tile
+       * set is updated to the current one and saved again.
        * @param storage the graph storage handler
        * @param pt   the ptree sub child labeled mjolnir in the valhalla json config
        */
       connectivity_map_t(const std::shared_ptr<GraphTileStorage>& storage, const boost::property_tree::ptree& pt);
 
+      /**
+       * Constructs the connectivity map from a sidecar file written by save,
+       * memory mapping it. Throws if the file can not be read.
+       * @param storage the graph storage handler, for the tile hierarchy
+       * @param file    the sidecar file
+       */
+      connectivity_map_t(const std::shared_ptr<GraphTileStorage>& storage, const std::string& file);
+
+      /**
+       * Writes the connectivity map to a sidecar file. Throws if the file can
+       * not be written.
+       * @param file  the sidecar file
+       */
+      void save(const std::string& file) const;
+
+      /**
+       * Updates the colors after tiles were added or removed, for example when
+       * a tile package is added or removed. Only the regions touching changed
+       * tiles are recolored, the other regions keep their colors.
+       *
+       * @param added    tiles added to the tile set
+       * @param removed  tiles removed from the tile set
+       */
+      void update(const std::unordered_set<GraphId>& added, const std::unordered_set<GraphId>& removed);
+
+      /**
+       * Updates the colors to match a tile set, see update above.
+       *
+       * @param tiles  the tiles now in the tile set
+       * @return       the number of tiles added and removed
+       */
+      size_t update(const std::unordered_set<GraphId>& tiles);
+
       /**
        * Returns the color for the given graphid
        *
@@ -57,9 +102,33 @@ namespace valhalla {
       std::vector<size_t> to_image(const uint32_t hierarchy_level) const;
 
      private:
+      struct tile_color_t {
+        uint32_t tileid;
+        uint32_t color;
+      };
+
+      //the colors of a level, sorted by tile id
+      struct level_colors_t {
+        const tile_color_t* begin;
+        const tile_color_t* end;
+      };
+
+      //points the levels at the colors in a blob
+      void index(const std::shared_ptr<const char>& blob, size_t size);
+
+      //colors the levels that changed and rebuilds the blob
+      void recolor(std::map<uint32_t, std::unordered_map<uint32_t, size_t> >& levels,
+                   const std::unordered_set<uint32_t>& changed);
+
+      //the tiling used by a level, transit uses the local level tiles
+      const midgard::Tiles<midgard::PointLL>& tiles(uint32_t level) const;
+
       uint32_t transit_level;
-      //this is a map(tile_level, map(tile_id, tile_color))
-      std::unordered_map<uint32_t, std::unordered_map<uint32_t, size_t> > colors;
+      //this is a map(tile_level, colors sorted by tile id)
+      std::map<uint32_t, level_colors_t> colors;
+      //the blob the colors point into, owned memory or a mapped sidecar
+      std::shared_ptr<const char> blob;
+      size_t blob_size;
       TileHierarchy tile_hierarchy;
     };
   }
@@ -1,8 +1,10 @@
 #ifndef VALHALLA_BALDR_DATETIME_H_
 #define VALHALLA_BALDR_DATETIME_H_
 
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/local_time/tz_database.hpp>
@@ -14,12 +16,73 @@ namespace valhalla {
 namespace baldr {
 namespace DateTime {
 
+  // Years the precompiled time zone offsets cover
+  constexpr int kFirstOffsetYear = 1970;
+  constexpr int kLastOffsetYear = 2100;
+
   struct tz_db_t : public boost::local_time::tz_database {
     tz_db_t();
     size_t to_index(const std::string& region) const;
     boost::shared_ptr<time_zone_base_type> from_index(size_t index) const;
+
+    /**
+     * Get the offset from UTC in effect in a time zone at an instant. The
+     * offset is looked up in the precompiled transitions of the zone, it
+     * does not allocate within the years the transitions cover.
+     * @param  index        Time zone index.
+     * @param  utc_seconds  Seconds since epoch.
+     * @return Returns the offset in seconds, 0 for an invalid index.
+     */
+    int32_t utc_offset(size_t index, int64_t utc_seconds) const;
+
+    /**
+     * Is daylight saving time in effect in a time zone at an instant?
+     * Looked up like utc_offset.
+     * @param  index        Time zone index.
+     * @param  utc_seconds  Seconds since epoch.
+     * @return Returns true if daylight saving time is in effect.
+     */
+    bool is_dst(size_t index, int64_t utc_seconds) const;
+
+    /**
+     * Get the posix string of a time zone, computed once per zone.
+     * @param  index  Time zone index.
+     * @return Returns the posix string, empty for an invalid index.
+     */
+    const std::string& posix_string(size_t index) const;
+
+    /**
+     * Get the abbreviation of a time zone.
+     * @param  index  Time zone index.
+     * @param  dst    True for the daylight saving time abbreviation.
+     * @return Returns the abbreviation, empty for an invalid index.
+     */
+    const std::string& abbrev(size_t index, bool dst) const;
+
    protected:
+    // UTC offsets of a time zone and the instants they change at, from
+    // kFirstOffsetYear through kLastOffsetYear
+    struct zone_offsets_t {
+      // Seconds since epoch the offset changes at, sorted
+      std::vector<int64_t> transitions;
+      // offsets[0] is in effect before the first transition and
+      // offsets[i + 1] from transitions[i] on, same for dst
+      std::vector<int32_t> offsets;
+      std::vector<bool> dst;
+      std::string posix;
+      std::string std_abbrev;
+      std::string dst_abbrev;
+    };
+
+    // Get the position in the offsets of a zone in effect at an instant
+    size_t offset_position(const zone_offsets_t& zone, int64_t utc_seconds) const;
+
     std::vector<std::string> regions;
+    std::unordered_map<std::string, size_t> region_indexes;
+    std::vector<boost::shared_ptr<time_zone_base_type> > zones;
+    std::vector<zone_offsets_t> zone_offsets;
+    int64_t first_offset_seconds;
+    int64_t last_offset_seconds;
   };
 
   /**
@@ -184,6 +247,19 @@ namespace DateTime {
   std::string get_duration(const std::string& date_time, const uint32_t seconds,
                            const boost::local_time::time_zone_ptr& tz);
 
+  /**
+   * Add x seconds to a date_time and return a ISO date_time string. Same as
+   * above but the time zone is given by index and its offsets are taken
+   * from the precompiled tables, so date_times in the format of
+   * 2015-05-06T08:00 are handled without going through boost::local_time.
+   * @param   date_time   in the format of 01:34:15 or 2015-05-06T08:00
+   * @param   seconds     seconds to add to the date.
+   * @param   tz_index    timezone index
+   * @return  Returns ISO formatted string
+   */
+  std::string get_duration(const std::string& date_time, const uint32_t seconds,
+                           const size_t tz_index);
+
   /**
    * checks if string is in the format of %Y-%m-%dT%H:%M
    * @param   date_time should be in the format of 2015-05-06T08:00
@@ -2,7 +2,7 @@
 #define VALHALLA_BALDR_DOUBLE_BUCKET_QUEUE_H_
 
 #include <vector>
-#include <deque>
+#include <limits>
 #include <valhalla/midgard/util.h>
 
 namespace valhalla {
@@ -10,17 +10,18 @@ namespace baldr {
 
 constexpr uint32_t kInvalidLabel = std::numeric_limits<uint32_t>::max();
 
-/**
- * A callable element which returns the cost for a label.
- */
-using LabelCost = std::function<float (const uint32_t label)>;
-
 /**
  * Double Bucket Queue. Contains a bucket sort implementation for performance.
  * An "overflow" bucket is maintained to allow reduced memory use. Costs
  * outside the current bucket "range" get placed into the overflow bucket and
  * are moved into the low-level buckets as needed. Each bucket stores label
  * indexes into external data.
+ *
+ * Buckets are contiguous arrays. The position of every label is recorded so
+ * a label whose cost decreases is removed from its old bucket in constant
+ * time (its slot is marked invalid and skipped when popping). Clearing the
+ * queue keeps all bucket memory so the queue can be reused across requests
+ * without reallocating.
  */
 class DoubleBucketQueue {
  public:
@@ -33,10 +34,9 @@ class DoubleBucketQueue {
    * @param range      Cost range for low-level buckets.
    * @param bucketsize Bucket size (range of costs within same bucket).
    *                   Must be an integer value.
-   * @param labelcost  Functor to get a cost given a label index.
    */
   DoubleBucketQueue(const float mincost, const float range,
-                    const uint32_t bucketsize, const LabelCost& labelcost);
+                    const uint32_t bucketsize);
 
   /**
    * Destructor.
@@ -45,9 +45,20 @@ class DoubleBucketQueue {
 
   /**
    * Clear all labels from the low-level buckets and the overflow buckets.
+   * Memory held by the buckets is kept for reuse.
    */
   void clear();
 
+  /**
+   * Clears the queue and sets up a new cost range, reusing the memory of the
+   * buckets. Same parameters as the constructor.
+   * @param mincost    Minimum cost.
+   * @param range      Cost range for low-level buckets.
+   * @param bucketsize Bucket size (range of costs within same bucket).
+   */
+  void reuse(const float mincost, const float range,
+             const uint32_t bucketsize);
+
   /**
    * Adds a label index to the bucketed sort. Adds it to the appropriate bucket
    * given the cost. If the cost is greater than maxcost_ the label
@@ -57,7 +68,7 @@ class DoubleBucketQueue {
    * @param   cost   Cost for this label.
    */
   void add(const uint32_t label, const float cost) {
-    get_bucket(cost).push_back(label);
+    push(label, cost, get_bucket(cost));
   }
 
   /**
@@ -65,10 +76,8 @@ class DoubleBucketQueue {
    * sorted bucket list.
    * @param  label        Label index to reorder.
    * @param  newcost      New sort cost.
-   * @param  previouscost Previous cost.
    */
-  void decrease(const uint32_t label, const float newcost,
-                const float previouscost);
+  void decrease(const uint32_t label, const float newcost);
 
   /**
    * Removes the lowest cost label index from the sorted buckets.
@@ -79,7 +88,7 @@ class DoubleBucketQueue {
 
  private:
   float bucketrange_;  // Total range of costs in lower level buckets
-  float bucketcount_;  // Number of buckets
+  uint32_t bucketcount_;  // Number of buckets
   float bucketsize_;   // Bucket size (range of costs in same bucket)
   float inv_;          // 1/bucketsize (so we can avoid division)
   float mincost_;      // Minimum cost within the low level buckets
@@ -87,27 +96,53 @@ class DoubleBucketQueue {
   float currentcost_;  // Current cost
 
   // Low level buckets
-  std::vector<std::deque<uint32_t>> buckets_;
+  std::vector<std::vector<uint32_t>> buckets_;
 
-  // Current bucket
-  std::vector<std::deque<uint32_t>>::iterator currentbucket_;
+  // Current bucket and the position of the next label to pop within it
+  uint32_t currentbucket_;
+  uint32_t currentpos_;
 
-  // Overflow bucket
-  std::deque<uint32_t> overflowbucket_;
+  // Overflow bucket. Costs are kept so labels can be sorted into the low
+  // level buckets without asking for their cost.
+  std::vector<std::pair<uint32_t, float>> overflowbucket_;
 
-  // Cost function to get cost given the label index.
-  LabelCost labelcost_;
+  // Bucket and position within the bucket of each label
+  struct position_t {
+    uint32_t bucket;
+    uint32_t pos;
+  };
+  std::vector<position_t> positions_;
 
   /**
-   * Returns the bucket given the cost.
+   * Returns the bucket index given the cost. The overflow bucket has index
+   * bucketcount_.
    * @param  cost  Cost.
    * @return Returns the bucket that the cost lies within.
    */
-  std::deque<uint32_t>& get_bucket(const float cost) {
-    return (cost < currentcost_) ? *currentbucket_ :
+  uint32_t get_bucket(const float cost) const {
+    return (cost < currentcost_) ? currentbucket_ :
              (cost < maxcost_) ?
-               buckets_[static_cast<uint32_t>((cost - mincost_) * inv_)] :
-               overflowbucket_;
+               static_cast<uint32_t>((cost - mincost_) * inv_) :
+               bucketcount_;
+  }
+
+  /**
+   * Appends a label to a bucket and records its position.
+   * @param  label   Label index.
+   * @param  cost    Cost of the label.
+   * @param  bucket  Bucket index.
+   */
+  void push(const uint32_t label, const float cost, const uint32_t bucket) {
+    if (label >= positions_.size()) {
+      positions_.resize(std::max<size_t>(label + 1, positions_.size() * 2));
+    }
+    if (bucket == bucketcount_) {
+      positions_[label] = { bucket, static_cast<uint32_t>(overflowbucket_.size()) };
+      overflowbucket_.emplace_back(label, cost);
+    } else {
+      positions_[label] = { bucket, static_cast<uint32_t>(buckets_[bucket].size()) };
+      buckets_[bucket].push_back(label);
+    }
   }
 
   /**
@@ -121,4 +156,3 @@ class DoubleBucketQueue {
 }
 
 #endif  // VALHALLA_BALDR_DOUBLE_BUCKET_QUEUE_H_
-
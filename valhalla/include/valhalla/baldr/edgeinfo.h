@@ -104,6 +104,14 @@ class EdgeInfo {
    */
   std::vector<std::string> GetNames() const;
 
+  /**
+   * Get a name of the edge in place, pointing into the text list rather
+   * than copying it.
+   * @param  index  Index into the name list.
+   * @return  Returns the null terminated name.
+   */
+  const char* name(uint8_t index) const;
+
   /**
    * Get the shape of the edge.
    * @return  Returns the the list of lat,lng points describing the
@@ -111,6 +119,12 @@ class EdgeInfo {
    */
   const std::vector<PointLL>& shape() const;
 
+  /**
+   * Decode the shape of the edge into a vector, reusing its memory.
+   * @param  shape  Vector to decode the lat,lng points into.
+   */
+  void DecodeShape(std::vector<PointLL>& shape) const;
+
   midgard::Shape7Decoder<PointLL> lazy_shape() const {
     return midgard::Shape7Decoder<PointLL>(encoded_shape_, item_->encoded_shape_size);
   }
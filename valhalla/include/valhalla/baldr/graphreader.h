@@ -1,6 +1,9 @@
 #ifndef VALHALLA_BALDR_GRAPHREADER_H_
 #define VALHALLA_BALDR_GRAPHREADER_H_
 
+#include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include <valhalla/baldr/graphid.h>
@@ -12,9 +15,174 @@
 namespace valhalla {
 namespace baldr {
 
+/**
+ * Interface for a memory cache of graph tiles, keyed by the tile base id.
+ * Implementations account for the size of the cached tiles and are
+ * responsible for keeping that size within the configured limit.
+ */
+class TileCache {
+ public:
+  /**
+   * Destructor
+   */
+  virtual ~TileCache() = default;
+
+  /**
+   * Reserves enough cache to hold (max_cache_size / tile_size) tiles.
+   * @param tile_size  the average size of a tile in bytes
+   */
+  virtual void Reserve(size_t tile_size) = 0;
+
+  /**
+   * Checks if tile exists in the cache.
+   * @param graphid  the graphid of the tile
+   * @return true if tile exists in the cache
+   */
+  virtual bool Contains(const GraphId& graphid) const = 0;
+
+  /**
+   * Puts a copy of a tile into the cache.
+   * @param graphid  the graphid of the tile
+   * @param tile     the graph tile
+   * @param size     size of the tile in memory
+   * @return a pointer to the cached tile
+   */
+  virtual const GraphTile* Put(const GraphId& graphid, const GraphTile& tile, size_t size) = 0;
+
+  /**
+   * Get a pointer to a graph tile object given a GraphId.
+   * @param graphid  the graphid of the tile
+   * @return GraphTile* a pointer to the graph tile or nullptr if not cached
+   */
+  virtual const GraphTile* Get(const GraphId& graphid) = 0;
+
+  /**
+   * Lets you know if the cache is too large
+   * @return true if the cache is over committed with respect to the limit
+   */
+  virtual bool OverCommitted() const = 0;
+
+  /**
+   * Clears the cache
+   */
+  virtual void Clear() = 0;
+
+  /**
+   * Evicts tiles until the cache is back within its limit
+   */
+  virtual void Trim() = 0;
+};
+
+/**
+ * Tile cache with least recently used eviction. Trim() evicts the least
+ * recently used tiles until the cache fits within its limit again, so the
+ * cache never has to be flushed as a whole.
+ *
+ * Put() never evicts. Pointers handed out by Get/Put stay valid until the
+ * next Trim() or Clear(), so algorithms can hold on to any number of tiles
+ * while walking the graph. The flip side is that the cache grows past its
+ * limit without bound until Trim() is called: call it between requests, or
+ * whenever OverCommitted() when walking the whole graph at once.
+ * It is NOT thread-safe!
+ */
+class TileCacheLRU : public TileCache {
+ public:
+  /**
+   * Constructor
+   * @param max_size  the max cache size in bytes
+   */
+  TileCacheLRU(size_t max_size);
+
+  void Reserve(size_t tile_size) override;
+  bool Contains(const GraphId& graphid) const override;
+  const GraphTile* Put(const GraphId& graphid, const GraphTile& tile, size_t size) override;
+  const GraphTile* Get(const GraphId& graphid) override;
+  bool OverCommitted() const override;
+  void Clear() override;
+  void Trim() override;
+
+ protected:
+
+  // Evict least recently used tiles until the cache (plus the requested
+  // number of bytes) fits within the limit
+  void MakeRoom(size_t size);
+
+  struct entry_t {
+    GraphId id;
+    GraphTile tile;
+    size_t size;
+  };
+
+  // Cached tiles, most recently used at the front
+  std::list<entry_t> lru_;
+
+  // Index into the lru list by tile id
+  std::unordered_map<GraphId, std::list<entry_t>::iterator> cache_;
+
+  // The current cache size in bytes
+  size_t cache_size_;
+
+  // The max cache size in bytes
+  size_t max_cache_size_;
+};
+
+/**
+ * Thread-safe tile cache meant to be shared by the GraphReaders of several
+ * worker threads. Tiles are handed out by copy (which shares the underlying
+ * tile memory) so a tile evicted here stays alive for as long as any reader
+ * still holds it in its own local cache.
+ */
+class SynchronizedTileCache {
+ public:
+  /**
+   * Constructor
+   * @param max_size  the max cache size in bytes
+   */
+  SynchronizedTileCache(size_t max_size);
+
+  /**
+   * Checks if tile exists in the cache.
+   * @param graphid  the graphid of the tile
+   * @return true if tile exists in the cache
+   */
+  bool Contains(const GraphId& graphid) const;
+
+  /**
+   * Copies a tile out of the cache.
+   * @param graphid  the graphid of the tile
+   * @param tile     (OUT) the graph tile, untouched if not cached
+   * @return true if the tile was found
+   */
+  bool Get(const GraphId& graphid, GraphTile& tile);
+
+  /**
+   * Puts a copy of a tile into the cache. May evict other tiles to make room.
+   * @param graphid  the graphid of the tile
+   * @param tile     the graph tile
+   * @param size     size of the tile in memory
+   */
+  void Put(const GraphId& graphid, const GraphTile& tile, size_t size);
+
+  /**
+   * Clears the cache
+   */
+  void Clear();
+
+  /**
+   * Evicts the least recently used tiles until the cache is within its limit
+   */
+  void Trim();
+
+ protected:
+  mutable std::mutex mutex_;
+  TileCacheLRU cache_;
+};
+
 /**
  * Class that manages access to GraphTiles. Reads new tiles where necessary
- * and manages a memory cache of active tiles. It is NOT thread-safe!
+ * and manages a size bounded memory cache of active tiles. A GraphReader
+ * itself is NOT thread-safe, each thread needs its own. Readers on different
+ * threads can share tiles through a SynchronizedTileCache though.
  */
 class GraphReader {
  public:
@@ -25,6 +193,16 @@ class GraphReader {
    */
   GraphReader(const std::shared_ptr<GraphTileStorage>& tile_storage, const boost::property_tree::ptree& pt);
 
+  /**
+   * Constructor
+   * @param tile_storage the tile storage to use
+   * @param pt the configuration for the tilehierarchy
+   * @param shared_cache cache shared with readers on other threads, tiles are
+   *                     looked up there before going to the tile storage
+   */
+  GraphReader(const std::shared_ptr<GraphTileStorage>& tile_storage, const boost::property_tree::ptree& pt,
+              const std::shared_ptr<SynchronizedTileCache>& shared_cache);
+
   /**
    * Test if tile exists
    * @param  graphid  GraphId of the tile to test (tile id and level).
@@ -65,6 +243,13 @@ class GraphReader {
    */
   void Clear();
 
+  /**
+   * Evicts the least recently used tiles until the cache is within its limit.
+   * Tiles are only ever evicted here (or by Clear), the cache grows past its
+   * limit until then. Pointers to evicted tiles are no longer valid.
+   */
+  void Trim();
+
   /**
    * Lets you know if the cache is too large
    * @return true if the cache is over committed with respect to the limit
@@ -130,13 +315,10 @@ class GraphReader {
   const TileHierarchy tile_hierarchy_;
 
   // The actual cached GraphTile objects
-  std::unordered_map<GraphId, GraphTile> cache_;
-
-  // The current cache size in bytes
-  size_t cache_size_;
+  std::unique_ptr<TileCache> cache_;
 
-  // The max cache size in bytes
-  size_t max_cache_size_;
+  // Optional cache shared with readers on other threads
+  std::shared_ptr<SynchronizedTileCache> shared_cache_;
 };
 
 }
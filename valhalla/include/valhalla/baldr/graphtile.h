@@ -21,6 +21,7 @@
 #include <valhalla/midgard/util.h>
 
 #include <boost/shared_array.hpp>
+#include <cstdint>
 #include <memory>
 #include "signinfo.h"
 
@@ -146,6 +147,34 @@ class GraphTile {
                                                   const GraphId id,
                                                   const uint64_t modes) const;
 
+  /**
+   * Visit the complex restrictions in the forward or reverse order in place,
+   * without copying them out of the tile.
+   * @param   forward - do we want the restrictions in reverse order?
+   * @param   id - edge id
+   * @param   modes - access modes
+   * @param   visit - called with each restriction matching the id and modes,
+   *                  returns false to stop visiting.
+   * @return  Returns false if the visitor stopped early.
+   */
+  template <class visitor_t>
+  bool VisitRestrictions(const bool forward, const GraphId id,
+                         const uint64_t modes, visitor_t visit) const {
+    char* restrictions = forward ? complex_restriction_forward_ :
+                                   complex_restriction_reverse_;
+    const size_t size = forward ? complex_restriction_forward_size_ :
+                                  complex_restriction_reverse_size_;
+    for (size_t offset = 0; offset < size; ) {
+      ComplexRestriction cr(restrictions + offset);
+      offset += cr.SizeOf();
+      if ((forward ? cr.to_id() : cr.from_id()) == id && (cr.modes() & modes) &&
+          !visit(cr)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /**
    * Convenience method to get the directed edges originating at a node.
    * @param  node_index  Node Id within this tile.
@@ -164,6 +193,16 @@ class GraphTile {
    */
   std::vector<std::string> GetNames(const uint32_t edgeinfo_offset) const;
 
+  /**
+   * Get the shape of an edge given the offset to the edge information. The
+   * shapes looked up last are kept decoded in a small cache shared by all the
+   * copies of the tile, so the edges looked at over and over, for example by
+   * map matching, are not decoded each time. Thread-safe.
+   * @param  edgeinfo_offset  Offset to the edge info.
+   * @return  Returns the lat,lng points describing the shape of the edge.
+   */
+  std::shared_ptr<const std::vector<PointLL>> GetShape(const uint32_t edgeinfo_offset) const;
+
   /**
    * Get the admininfo at the specified index. Populates the state name and
    * country name from the text/name list.
@@ -186,6 +225,14 @@ class GraphTile {
    */
   std::string GetName(const uint32_t textlist_offset) const;
 
+  /**
+   * Get the text at an offset in the text list, pointing into the tile
+   * rather than copying it.
+   * @param   textlist_offset  offset into the text list.
+   * @return  Returns the null terminated text.
+   */
+  const char* text(const uint32_t textlist_offset) const;
+
   /**
    * Convenience method to get the signs for an edge given the directed
    * edge index.
@@ -194,6 +241,14 @@ class GraphTile {
    */
   std::vector<SignInfo> GetSigns(const uint32_t idx) const;
 
+  /**
+   * Get the signs of an edge in place. Use text() to get the text of a sign
+   * without copying it.
+   * @param  idx  Directed edge index.
+   * @return  Returns the signs of the edge, empty if it has none.
+   */
+  midgard::iterable_t<const Sign> signs(const uint32_t idx) const;
+
   /**
    * Get the next departure given the directed edge Id and the current
    * time (seconds from midnight). TODO - what if crosses midnight?
@@ -234,6 +289,13 @@ class GraphTile {
    */
   std::unordered_map<uint32_t,TransitDeparture*> GetTransitDepartures() const;
 
+  /**
+   * Get the departures of a line in place, sorted by departure time.
+   * @param   lineid  Transit Line Id
+   * @return  Returns the departures of the line, empty if it has none.
+   */
+  midgard::iterable_t<const TransitDeparture> departures(const uint32_t lineid) const;
+
   /**
    * Get the stop onestops in this tile
    * @return  Returns a map of onestops
@@ -289,6 +351,14 @@ class GraphTile {
   std::vector<AccessRestriction> GetAccessRestrictions(const uint32_t edgeid,
                                                        const uint32_t access) const;
 
+  /**
+   * Get the access restrictions of an edge in place, for all the access
+   * modes. Check modes() for the ones of interest.
+   * @param   edgeid  Directed edge index.
+   * @return  Returns the restrictions of the edge, empty if it has none.
+   */
+  midgard::iterable_t<const AccessRestriction> access_restrictions(const uint32_t edgeid) const;
+
   /**
    * Get an iteratable list of GraphIds given a bin in the tile
    * @param  column the bin's column
@@ -312,12 +382,39 @@ class GraphTile {
    */
   std::vector<TrafficSegment> GetTrafficSegments(const size_t idx) const;
 
+  /**
+   * Get data derived from this tile that was attached to it, for example
+   * precomputed edge costs. Attachments are shared by all the copies of the
+   * tile, so they are released when the last cached copy is evicted.
+   * @param  key  Key the data was attached with.
+   * @return Returns the data or nullptr if nothing is attached with the key.
+   */
+  std::shared_ptr<const void> GetAttachment(const uint64_t key) const;
+
+  /**
+   * Attach data derived from this tile. Thread-safe, if data was attached
+   * with the same key in the meantime that data is kept. Only a few keys
+   * are kept per tile, attaching a new one drops the least recently used.
+   * @param  key   Key to attach the data with.
+   * @param  data  Data to attach.
+   * @return Returns the data attached with the key.
+   */
+  std::shared_ptr<const void> Attach(const uint64_t key,
+                                     const std::shared_ptr<const void>& data) const;
 
  protected:
 
-  // Graph tile memory, this must be shared so that we can put it into cache
-  // Apparently you can std::move a non-copyable
-  boost::shared_ptr<std::vector<char>> graphtile_;
+  // Graph tile memory, this must be shared so that we can put it into cache.
+  // Owned by whatever the tile storage handed over (a buffer, a mapping...)
+  std::shared_ptr<const char> graphtile_;
+
+  // Data attached to the tile, shared by all copies of the tile
+  struct attachments_t;
+  std::shared_ptr<attachments_t> attachments_;
+
+  // Recently decoded edge shapes, shared by all copies of the tile
+  struct shape_cache_t;
+  std::shared_ptr<shape_cache_t> shape_cache_;
 
   // Header information for the tile
   GraphTileHeader* header_;
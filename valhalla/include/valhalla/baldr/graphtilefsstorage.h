@@ -49,6 +49,17 @@ class GraphTileFsStorage : public GraphTileStorage {
    */
   bool ReadTile(const GraphId& tileid, const TileHierarchy& tile_hierarchy, std::vector<char>& tile_data) const override;
 
+  /**
+   * Reads the specified tile without copying it. Tiles in the extract are
+   * referenced in place and uncompressed tile files are memory mapped.
+   * @param  graphid        The tile id to read.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @param  tile_memory    (OUT) The tile data. Keeps the memory alive while referenced.
+   * @param  tile_size      (OUT) The size of the tile data in bytes.
+   * @return Returns true if the tile exists and was successfully read and false otherwise.
+   */
+  bool ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::shared_ptr<const char>& tile_memory, size_t& tile_size) const override;
+
   /**
    * Reads the optional Real-Time-Speeds associated with the tile.
    * @param  graphid        The tile id to read.
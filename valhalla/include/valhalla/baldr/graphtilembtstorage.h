@@ -4,28 +4,50 @@
 #include <tuple>
 #include <memory>
 #include <vector>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 #include <valhalla/baldr/graphtilestorage.h>
 
 namespace sqlite3pp {
   class database;
+  class query;
 }
 
 namespace valhalla {
 namespace baldr {
 
+/**
+ * Tile storage reading tiles from MBTiles (sqlite) routing packages.
+ * Statements are prepared once per connection and reused. Existence
+ * checks are answered from an in-memory index of the available tiles,
+ * built on first use. The class is thread-safe: each database has a pool
+ * of connections and concurrent readers only wait for one another when
+ * all connections to a database are busy.
+ */
 class GraphTileMBTStorage : public GraphTileStorage {
  public:
 
   /**
    * Constructor
-   * @param dbs The routing databases.
+   * @param dbs The routing databases. Each database is used as a single
+   *            connection, so reads from the same database are serialized.
    */
   GraphTileMBTStorage(const std::vector<std::shared_ptr<sqlite3pp::database>>& dbs);
 
+  /**
+   * Constructor
+   * @param db_files       The routing database files.
+   * @param pool_size      Number of read-only connections to open per database,
+   *                       usually the number of threads reading tiles.
+   */
+  GraphTileMBTStorage(const std::vector<std::string>& db_files, size_t pool_size);
+
   /**
    * Destructor
    */
-  ~GraphTileMBTStorage() = default;
+  ~GraphTileMBTStorage();
 
   /**
    * Gets the list of all tile ids available given tile hierarchy.
@@ -50,6 +72,7 @@ class GraphTileMBTStorage : public GraphTileStorage {
    * @return Returns true if the tile exists and false otherwise.
    */
   bool ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<char>& tile_data) const override;
+  using GraphTileStorage::ReadTile;
 
   /**
    * Reads the optional Real-Time-Speeds associated with the tile.
@@ -66,7 +89,32 @@ class GraphTileMBTStorage : public GraphTileStorage {
 
   static GraphId ToGraphId(const std::tuple<int, int, int>& tile_coords, const TileHierarchy& tile_hierarchy);
 
-  std::vector<std::shared_ptr<sqlite3pp::database>> mbt_dbs_;
+  // A connection to a routing database and its prepared tile query
+  struct Connection {
+    std::shared_ptr<sqlite3pp::database> db;
+    std::unique_ptr<sqlite3pp::query> tile_query;
+  };
+
+  // The connections to one routing database. Connections are taken
+  // out of the idle list while in use.
+  struct ConnectionPool {
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<Connection*> idle;
+    std::mutex mutex;
+    std::condition_variable available;
+
+    Connection* Acquire();
+    void Release(Connection* connection);
+  };
+
+  // Builds the tile index if it has not been built yet
+  void BuildTileIndex(const TileHierarchy& tile_hierarchy) const;
+
+  std::vector<std::unique_ptr<ConnectionPool>> pools_;
+
+  // Index of the database holding each tile
+  mutable std::unordered_map<GraphId, size_t> tile_index_;
+  mutable std::once_flag tile_index_flag_;
 
 };
 
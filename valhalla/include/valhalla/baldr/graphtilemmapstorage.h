@@ -0,0 +1,118 @@
+#ifndef VALHALLA_BALDR_GRAPHTILEMMAPSTORAGE_H_
+#define VALHALLA_BALDR_GRAPHTILEMMAPSTORAGE_H_
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <valhalla/baldr/graphtilestorage.h>
+
+namespace valhalla {
+namespace baldr {
+
+/**
+ * A graph tile storage serving tiles from a single memory mapped extract
+ * file. Tiles are stored uncompressed so GraphTiles point straight into the
+ * mapping, nothing is read or decompressed and the OS page cache is shared
+ * by all processes using the same extract.
+ *
+ * File layout (little endian):
+ *   header  - magic, version, tile count
+ *   index   - tile count entries of {graphid, offset, size} sorted by graphid
+ *   tiles   - the raw tiles, each starting at an 8 byte aligned offset
+ */
+class GraphTileMMapStorage : public GraphTileStorage {
+ public:
+
+  /**
+   * Constructor
+   * @param extract_file The extract file to map.
+   */
+  GraphTileMMapStorage(const std::string& extract_file);
+
+  /**
+   * Destructor
+   */
+  ~GraphTileMMapStorage() = default;
+
+  /**
+   * Gets the list of all tile ids available given tile hierarchy.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @return Returns the list of all available tile ids.
+   */
+  std::unordered_set<GraphId> FindTiles(const TileHierarchy& tile_hierarchy) const override;
+
+  /**
+   * Checks if the specified tile exists.
+   * @param  graphid        The tile id to check.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @return Returns true if the tile exists and false otherwise.
+   */
+  bool DoesTileExist(const GraphId& graphid, const TileHierarchy& tile_hierarchy) const override;
+
+  /**
+   * Reads the specified tile. Copies the tile out of the mapping.
+   * @param graphid        The tile id to read.
+   * @param tile_hierarchy The tile hierachy to use.
+   * @param tile_data      The buffer to use for storing the raw tile data.
+   * @return Returns true if the tile exists and false otherwise.
+   */
+  bool ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<char>& tile_data) const override;
+
+  /**
+   * Reads the specified tile by referencing it inside the mapping.
+   * @param  graphid        The tile id to read.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @param  tile_memory    (OUT) The tile data. Keeps the mapping alive while referenced.
+   * @param  tile_size      (OUT) The size of the tile data in bytes.
+   * @return Returns true if the tile exists and false otherwise.
+   */
+  bool ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::shared_ptr<const char>& tile_memory, size_t& tile_size) const override;
+
+  /**
+   * Reads the optional Real-Time-Speeds associated with the tile.
+   * Not supported by extracts.
+   * @param  graphid        The tile id to read.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @param  rts_data       The buffer to use for storing real-time-speed data.
+   * @return Returns false.
+   */
+  bool ReadTileRealTimeSpeeds(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<uint8_t>& rts_data) const override;
+
+  /**
+   * Writes all tiles of a storage (e.g. an MBTiles graph package) into an
+   * extract file that can be used with this storage.
+   * @param  storage        The storage to convert.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @param  extract_file   The extract file to write.
+   * @return Returns true if the extract was written successfully.
+   */
+  static bool Create(const GraphTileStorage& storage, const TileHierarchy& tile_hierarchy, const std::string& extract_file);
+
+ private:
+
+  struct header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t tile_count;
+  };
+
+  struct index_entry_t {
+    uint64_t graphid;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  // Finds the index entry of a tile, nullptr if the tile is not in the extract
+  const index_entry_t* Find(const GraphId& graphid) const;
+
+  struct mapping_t;
+  std::shared_ptr<const mapping_t> mapping_;
+
+  const index_entry_t* index_begin_;
+  const index_entry_t* index_end_;
+};
+
+}
+}
+
+#endif  // VALHALLA_BALDR_GRAPHTILEMMAPSTORAGE_H_
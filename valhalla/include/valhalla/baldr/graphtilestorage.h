@@ -5,6 +5,7 @@
 #include <valhalla/baldr/tilehierarchy.h>
 
 #include <vector>
+#include <memory>
 #include <unordered_set>
 #include <cstdint>
 
@@ -48,6 +49,27 @@ class GraphTileStorage {
    */
   virtual bool ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<char>& tile_data) const = 0;
 
+  /**
+   * Reads the specified tile, handing over ownership of the tile memory.
+   * The default implementation moves the buffer filled by the method above,
+   * storages able to serve tiles without a copy (e.g. from a memory mapping)
+   * override this.
+   * @param  graphid        The tile id to read.
+   * @param  tile_hierarchy The tile hierachy to use.
+   * @param  tile_memory    (OUT) The tile data. Keeps the memory alive while referenced.
+   * @param  tile_size      (OUT) The size of the tile data in bytes.
+   * @return Returns true if the tile exists and was successfully read and false otherwise.
+   */
+  virtual bool ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::shared_ptr<const char>& tile_memory, size_t& tile_size) const {
+    std::shared_ptr<std::vector<char>> tile_data = std::make_shared<std::vector<char>>();
+    if (!ReadTile(graphid, tile_hierarchy, *tile_data)) {
+      return false;
+    }
+    tile_size = tile_data->size();
+    tile_memory = std::shared_ptr<const char>(tile_data, tile_data->data());
+    return true;
+  }
+
   /**
    * Reads the optional Real-Time-Speeds associated with the tile.
    * @param  graphid        The tile id to read.
@@ -5,10 +5,13 @@
 #include <valhalla/baldr/pathlocation.h>
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/directededge.h>
+#include <valhalla/midgard/worker_pool.h>
 #include <valhalla/sif/dynamiccost.h>
 
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace valhalla{
 namespace loki{
@@ -43,6 +46,43 @@ std::unordered_map<baldr::Location, baldr::PathLocation>
 Search(const std::vector<baldr::Location>& locations, baldr::GraphReader& reader,
   const sif::EdgeFilter& edge_filter = PassThroughEdgeFilter, const sif::NodeFilter& node_filter = PassThroughNodeFilter);
 
+/**
+ * Find locations within the route network for a batch of input locations.
+ * Meant for bulk snapping of many locations at once. Locations in the same
+ * bin are tested together against the bin's edges, every edge shape is
+ * decoded only once per thread, and the bins are spread over the calling
+ * thread and one additional thread per worker reader.
+ *
+ * @param locations       the positions which need to be correlated to the route network
+ * @param reader          and object used to access tiled route data
+ * @param worker_readers  readers for the worker threads. They must not be used by anything
+ *                        else during the search and should share a SynchronizedTileCache with reader
+ * @param edge_filter     a function/functor to be used in the rejection of edges. defaults to a pass through filter
+ * @param node_filter     a function/functor to be used in the rejection of nodes used in graph traversal. defaults to a pass through filter
+ * @return pathLocations  the correlated data with in the tile that matches the inputs. If a projection is not found, it will not have any entry in the returned value.
+ */
+std::unordered_map<baldr::Location, baldr::PathLocation>
+Search(const std::vector<baldr::Location>& locations, baldr::GraphReader& reader,
+  const std::vector<std::shared_ptr<baldr::GraphReader> >& worker_readers,
+  const sif::EdgeFilter& edge_filter = PassThroughEdgeFilter, const sif::NodeFilter& node_filter = PassThroughNodeFilter);
+
+/**
+ * Same as above but running on the threads of a pool kept by the caller, so
+ * no threads are started per call.
+ *
+ * @param locations       the positions which need to be correlated to the route network
+ * @param reader          and object used to access tiled route data
+ * @param worker_readers  readers for the worker threads, as above
+ * @param pool            pool with one worker per worker reader besides the calling thread
+ * @param edge_filter     a function/functor to be used in the rejection of edges. defaults to a pass through filter
+ * @param node_filter     a function/functor to be used in the rejection of nodes used in graph traversal. defaults to a pass through filter
+ * @return pathLocations  the correlated data with in the tile that matches the inputs. If a projection is not found, it will not have any entry in the returned value.
+ */
+std::unordered_map<baldr::Location, baldr::PathLocation>
+Search(const std::vector<baldr::Location>& locations, baldr::GraphReader& reader,
+  const std::vector<std::shared_ptr<baldr::GraphReader> >& worker_readers, midgard::WorkerPool& pool,
+  const sif::EdgeFilter& edge_filter = PassThroughEdgeFilter, const sif::NodeFilter& node_filter = PassThroughNodeFilter);
+
 }
 }
 
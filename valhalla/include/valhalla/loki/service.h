@@ -1,6 +1,7 @@
 #ifndef __VALHALLA_LOKI_SERVICE_H__
 #define __VALHALLA_LOKI_SERVICE_H__
 
+#include <memory>
 #include <vector>
 
 #include <boost/property_tree/ptree.hpp>
@@ -9,6 +10,7 @@
 #include <prime_server/http_protocol.hpp>
 
 #include <valhalla/midgard/pointll.h>
+#include <valhalla/midgard/worker_pool.h>
 #include <valhalla/baldr/location.h>
 #include <valhalla/baldr/graphfsreader.h>
 #include <valhalla/baldr/connectivity_map.h>
@@ -59,6 +61,10 @@ namespace valhalla {
       sif::EdgeFilter edge_filter;
       sif::NodeFilter node_filter;
       valhalla::baldr::GraphFsReader reader;
+      // Graph readers and threads correlating the locations of matrix and
+      // optimized route requests besides this one
+      std::vector<std::shared_ptr<baldr::GraphReader>> worker_readers;
+      std::unique_ptr<midgard::WorkerPool> search_workers;
       valhalla::baldr::connectivity_map_t connectivity_map;
       std::unordered_set<std::string> actions;
       std::string action_str;
@@ -134,13 +134,24 @@ class BucketQueue
   size_type size() const
   { return costmap_.size(); }
 
+  // Empty the queue, keeping the buckets' memory for reuse
   void clear()
   {
-    buckets_.clear();
+    for (auto& bucket : buckets_) {
+      bucket.clear();
+    }
     costmap_.clear();
     top_ = 0;
   }
 
+  // Empty the queue and set the number of buckets, costs beyond them are
+  // rejected
+  void reset(size_type count)
+  {
+    clear();
+    bucket_count_ = count;
+  }
+
  private:
 
   size_type bucket_count_;
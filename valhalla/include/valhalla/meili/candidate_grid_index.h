@@ -0,0 +1,175 @@
+// -*- mode: c++ -*-
+#ifndef MMP_CANDIDATE_GRID_INDEX_H_
+#define MMP_CANDIDATE_GRID_INDEX_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <valhalla/midgard/aabb2.h>
+#include <valhalla/midgard/pointll.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/baldr/graphtile.h>
+
+#include <valhalla/meili/grid_traversal.h>
+
+namespace valhalla {
+namespace meili {
+
+// Default memory budget of a grid cache in bytes
+constexpr size_t kDefaultMaxGridCacheSize = 256 * 1024 * 1024;
+
+/**
+ * Immutable spatial index of the edges in one bin of a graph tile. The
+ * grid spans the whole tile, but only the cells that the bin's edges pass
+ * through are stored: a sorted array of cell ids with, per cell, a range
+ * into one flat array of edge ids (compressed sparse rows). Once built it
+ * is never modified, so any number of threads can query it at once.
+ */
+class CandidateGridIndex
+{
+ public:
+  /**
+   * Constructor
+   * @param bbox         Bounding box the grid is laid over.
+   * @param cell_width   Width of a grid cell in degrees.
+   * @param cell_height  Height of a grid cell in degrees.
+   * @param items        (cell id, edge id) pairs to index. Order does not
+   *                     matter and duplicates are removed. The vector is
+   *                     consumed.
+   */
+  CandidateGridIndex(const midgard::AABB2<midgard::PointLL>& bbox,
+                     float cell_width, float cell_height,
+                     std::vector<std::pair<uint32_t, baldr::GraphId>>& items);
+
+  /**
+   * Index the edges of one bin of a graph tile. Only one side of each
+   * directed edge is in a bin, transition and transit connection edges are
+   * skipped.
+   * @param tile         Tile owning the bin.
+   * @param bin_index    Index of the bin within the tile.
+   * @param reader       Graph reader to fetch edges living in other tiles.
+   * @param cell_width   Width of a grid cell in degrees.
+   * @param cell_height  Height of a grid cell in degrees.
+   * @return Returns the index of the bin.
+   */
+  static std::shared_ptr<const CandidateGridIndex>
+  Build(const baldr::GraphTile& tile, const int32_t bin_index,
+        baldr::GraphReader& reader, float cell_width, float cell_height);
+
+  /**
+   * Appends the edges in all cells intersecting the range to a buffer.
+   * Edges spanning several cells are appended once per cell, callers that
+   * need unique edges have to remove the duplicates.
+   * @param range  Range to query.
+   * @param edges  (OUT) Buffer the edge ids are appended to.
+   */
+  void Query(const midgard::AABB2<midgard::PointLL>& range,
+             std::vector<baldr::GraphId>& edges) const;
+
+  /**
+   * Get the approximate memory used by the index.
+   * @return Returns the size in bytes.
+   */
+  size_t MemoryUse() const;
+
+ private:
+  GridTraversal<midgard::PointLL> grid_;
+  int ncols_, nrows_;
+
+  // Non empty cells (col + row * ncols), sorted
+  std::vector<uint32_t> cells_;
+
+  // Edges of cells_[i] are edges_[offsets_[i]] to edges_[offsets_[i + 1]]
+  std::vector<uint32_t> offsets_;
+  std::vector<baldr::GraphId> edges_;
+};
+
+/**
+ * Thread-safe cache of bin indexes meant to be shared by all the candidate
+ * queries (and so all the map matching sessions) using the same graph.
+ * Indexes are handed out as shared pointers, so evicting one never pulls it
+ * from under a query still using it. When the cache grows beyond its
+ * budget the least recently used indexes are evicted.
+ */
+class CandidateGridCache
+{
+ public:
+  /**
+   * Constructor
+   * @param cell_width   Width of a grid cell in degrees.
+   * @param cell_height  Height of a grid cell in degrees.
+   * @param max_size     The max cache size in bytes.
+   */
+  CandidateGridCache(float cell_width, float cell_height,
+                     size_t max_size = kDefaultMaxGridCacheSize);
+
+  float cell_width() const
+  { return cell_width_; }
+
+  float cell_height() const
+  { return cell_height_; }
+
+  /**
+   * Gets the index of a bin and marks it as the most recently used one.
+   * @param bin_id  Id of the bin across the whole tile level.
+   * @return Returns the index or nullptr if it is not cached.
+   */
+  std::shared_ptr<const CandidateGridIndex> Get(const int32_t bin_id);
+
+  /**
+   * Puts the index of a bin into the cache, evicting the least recently
+   * used ones if needed. If another thread cached the bin in the meantime
+   * the index already cached is kept.
+   * @param bin_id  Id of the bin across the whole tile level.
+   * @param index   The index of the bin.
+   * @return Returns the index cached for the bin.
+   */
+  std::shared_ptr<const CandidateGridIndex>
+  Put(const int32_t bin_id, const std::shared_ptr<const CandidateGridIndex>& index);
+
+  /**
+   * Get the number of cached bins.
+   * @return Returns the number of cached bins.
+   */
+  size_t size() const;
+
+  /**
+   * Clears the cache
+   */
+  void Clear();
+
+ private:
+  struct entry_t {
+    int32_t bin_id;
+    std::shared_ptr<const CandidateGridIndex> index;
+    size_t size;
+  };
+
+  float cell_width_;
+  float cell_height_;
+
+  mutable std::mutex mutex_;
+
+  // Cached bins, most recently used at the front
+  std::list<entry_t> lru_;
+
+  // Index into the lru list by bin id
+  std::unordered_map<int32_t, std::list<entry_t>::iterator> cache_;
+
+  // The current cache size in bytes
+  size_t cache_size_;
+
+  // The max cache size in bytes
+  size_t max_cache_size_;
+};
+
+}
+}
+
+#endif // MMP_CANDIDATE_GRID_INDEX_H_
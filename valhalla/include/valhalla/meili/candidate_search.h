@@ -19,7 +19,7 @@
 #include <valhalla/baldr/edgeinfo.h>
 #include <valhalla/sif/dynamiccost.h>
 
-#include <valhalla/meili/grid_range_query.h>
+#include <valhalla/meili/candidate_grid_index.h>
 
 namespace valhalla{
 
@@ -54,41 +54,52 @@ class CandidateQuery
 class CandidateGridQuery final: public CandidateQuery
 {
  public:
-  using grid_t = GridRangeQuery<baldr::GraphId, midgard::PointLL>;
-
+  /**
+   * Constructor using a grid cache of its own.
+   * @param reader       Graph reader.
+   * @param cell_width   Width of a grid cell in degrees.
+   * @param cell_height  Height of a grid cell in degrees.
+   */
   CandidateGridQuery(baldr::GraphReader& reader, float cell_width, float cell_height);
 
+  /**
+   * Constructor sharing the bin indexes with other queries, e.g. the ones
+   * of concurrent map matching sessions.
+   * @param reader      Graph reader. Not shared, one per thread.
+   * @param grid_cache  Grid cache shared between queries.
+   */
+  CandidateGridQuery(baldr::GraphReader& reader,
+                     const std::shared_ptr<CandidateGridCache>& grid_cache);
+
   ~CandidateGridQuery();
 
   std::vector<baldr::PathLocation>
   Query(const midgard::PointLL& location, float sq_search_radius, sif::EdgeFilter filter) const override;
 
-  std::unordered_map<baldr::GraphId, grid_t>::size_type
-  size() const
-  { return grid_cache_.size(); }
+  size_t size() const
+  { return grid_cache_->size(); }
 
   void Clear()
-  { grid_cache_.clear(); }
+  { grid_cache_->Clear(); }
 
  private:
 
-  // Get a grid for a specified bin within a tile. Tile support for
+  // Get the index of a specified bin within a tile. Tile support for
   // graph tiles and bins is provided to go between bin Ids and tile Ids.
-  const grid_t* GetGrid(const int32_t bin_id,
-                        const midgard::Tiles<midgard::PointLL>& tiles,
-                        const midgard::Tiles<midgard::PointLL>& bins) const;
+  std::shared_ptr<const CandidateGridIndex>
+  GetGrid(const int32_t bin_id,
+          const midgard::Tiles<midgard::PointLL>& tiles,
+          const midgard::Tiles<midgard::PointLL>& bins) const;
 
-  std::unordered_set<baldr::GraphId>
-  RangeQuery(const midgard::AABB2<midgard::PointLL>& range) const;
+  // Get the unique edges within the range
+  void RangeQuery(const midgard::AABB2<midgard::PointLL>& range,
+                  std::vector<baldr::GraphId>& edgeids) const;
 
   uint32_t bin_level_;
   const baldr::TileHierarchy& hierarchy_;
 
-  float cell_width_;
-  float cell_height_;
-
-  // Grid cache - cached per "bin" within a graph tile
-  mutable std::unordered_map<int32_t, grid_t> grid_cache_;
+  // Bin indexes, possibly shared with other queries
+  std::shared_ptr<CandidateGridCache> grid_cache_;
 };
 
 }
@@ -38,6 +38,9 @@ public:
   sif::TravelMode travelmode() const
   { return travelmode_; }
 
+  const sif::cost_ptr_t* mode_costing() const
+  { return mode_costing_; }
+
   const boost::property_tree::ptree& config() const
   { return config_; }
 
@@ -47,6 +50,26 @@ public:
   std::vector<MatchResult>
   OfflineMatch(const std::vector<Measurement>& measurements);
 
+  /**
+   * Match a trace online, one measurement at a time. Results are returned
+   * once the best paths of all candidates agree on them, or once they are
+   * more than online_max_lag match measurements behind, in which case the
+   * current best path is committed to. Everything behind the returned
+   * results is forgotten, so memory stays bounded however long the trace.
+   * The state ids of the results are valid until the next call.
+   * @param measurement  The next measurement of the trace.
+   * @return Returns the results that became final, in trace order.
+   */
+  std::vector<MatchResult>
+  OnlineMatch(const Measurement& measurement);
+
+  /**
+   * Finish the trace matched online.
+   * @return Returns the results of all measurements not returned yet.
+   */
+  std::vector<MatchResult>
+  FinishOnlineMatch();
+
   /**
    * Set a callback that will throw when the map-matching should be aborted
    * @param interrupt_callback  the function to periodically call to see if we should abort
@@ -58,6 +81,12 @@ public:
 private:
   Time AppendMeasurement(const Measurement& measurement);
 
+  // Results from online_time_ up to the time of state_rbegin, whose next
+  // state is state_after
+  std::vector<MatchResult>
+  OnlineResults(const MapMatching::state_iterator& state_rbegin,
+                const MapMatching::state_iterator& state_after);
+
   boost::property_tree::ptree config_;
 
   baldr::GraphReader& graphreader_;
@@ -72,6 +101,13 @@ private:
 
   // Interrupt callback. Can be set to interrupt if connection is closed.
   const std::function<void ()>* interrupt_;
+
+  // First match time of the online trace whose results were not returned
+  // yet, kInvalidTime if no trace is being matched online
+  Time online_time_;
+
+  // Measurements to interpolate by the time of the previous match
+  std::unordered_map<Time, std::vector<Measurement>> online_interpolated_;
 };
 
 }
@@ -30,6 +30,10 @@ public:
   CandidateQuery& candidatequery()
   { return candidatequery_; }
 
+  // Grid cache to share with candidate queries on other threads
+  const std::shared_ptr<CandidateGridCache>& grid_cache() const
+  { return grid_cache_; }
+
   MapMatcher* Create(const std::string& name)
   { return Create(name, boost::property_tree::ptree()); }
 
@@ -61,9 +65,9 @@ private:
 
   sif::CostFactory<sif::DynamicCost> cost_factory_;
 
-  CandidateGridQuery candidatequery_;
+  std::shared_ptr<CandidateGridCache> grid_cache_;
 
-  float max_grid_cache_size_;
+  CandidateGridQuery candidatequery_;
 
   sif::cost_ptr_t get_costing(const boost::property_tree::ptree& request,
                                           const std::string& costing);
@@ -29,16 +29,22 @@ class State
   { return candidate_; }
 
   bool routed() const
-  { return labelset_ != nullptr; }
+  { return routed_; }
 
+  // Route to the states in a single search run on the label set, keeping
+  // the labels of the routes
   void route(const std::vector<const State*>& states,
              baldr::GraphReader& graphreader,
              float max_route_distance,
              const midgard::DistanceApproximator& approximator,
              float search_radius,
              sif::cost_ptr_t costing,
-             std::shared_ptr<const sif::EdgeLabel> edgelabel,
-             const float turn_cost_table[181]) const;
+             const sif::EdgeLabel* edgelabel,
+             const float turn_cost_table[181],
+             LabelSet& labelset) const;
+
+  // Take the labels of the routes out of the state, it is no longer routed
+  std::vector<Label> release_labels() const;
 
   const Label* last_label(const State& state) const;
 
@@ -46,13 +52,13 @@ class State
   {
     const auto it = label_idx_.find(state.id());
     if (it != label_idx_.end()) {
-      return RoutePathIterator(labelset_.get(), it->second);
+      return RoutePathIterator(&labels_, it->second);
     }
-    return RoutePathIterator(labelset_.get());
+    return RoutePathIterator(&labels_);
   }
 
   RoutePathIterator RouteEnd() const
-  { return RoutePathIterator(labelset_.get()); }
+  { return RoutePathIterator(&labels_); }
 
  private:
   const StateId id_;
@@ -61,7 +67,9 @@ class State
 
   const baldr::PathLocation candidate_;
 
-  mutable std::shared_ptr<LabelSet> labelset_;
+  mutable bool routed_;
+
+  mutable std::vector<Label> labels_;
 
   mutable std::unordered_map<StateId, uint32_t> label_idx_;
 };
@@ -88,6 +96,9 @@ class MapMatching: public ViterbiSearch<State>
 
   void Clear();
 
+  // Forget the states and measurements before the time
+  void Prune(Time time);
+
   baldr::GraphReader& graphreader() const
   { return graphreader_; }
 
@@ -96,28 +107,29 @@ class MapMatching: public ViterbiSearch<State>
 
   const std::vector<const State*>&
   states(Time time) const
-  { return states_[time]; }
+  { return states_[time - time_base_]; }
 
   const Measurement& measurement(Time time) const
-  { return measurements_[time]; }
+  { return measurements_[time - time_base_]; }
 
   const Measurement& measurement(const State& state) const
-  { return measurements_[state.time()]; }
+  { return measurements_[state.time() - time_base_]; }
 
-  std::vector<Measurement>::size_type size() const
-  { return measurements_.size(); }
+  // Number of measurements including the pruned ones
+  std::deque<Measurement>::size_type size() const
+  { return time_base_ + measurements_.size(); }
 
   template <typename candidate_iterator_t>
   Time AppendState(const Measurement& measurement,
                    candidate_iterator_t begin,
                    candidate_iterator_t end)
   {
-    Time time = states_.size();
+    Time time = time_base_ + states_.size();
 
     // Append to base class
     std::vector<const State*> column;
     for (auto it = begin; it != end; it++) {
-      StateId id = state_.size();
+      StateId id = state_base_ + state_.size();
       state_.push_back(new State(id, time, *it));
       column.push_back(state_.back());
     }
@@ -156,9 +168,10 @@ class MapMatching: public ViterbiSearch<State>
 
   const sif::TravelMode mode_;
 
-  std::vector<Measurement> measurements_;
+  // Measurements and columns from time_base_ on
+  std::deque<Measurement> measurements_;
 
-  std::vector<std::vector<const State*>> states_;
+  std::deque<std::vector<const State*>> states_;
 
   float sigma_z_;
   double inv_double_sq_sigma_z_;  // equals to 1.f / (sigma_z_ * sigma_z_ * 2.f)
@@ -174,6 +187,12 @@ class MapMatching: public ViterbiSearch<State>
 
   // Cost for each degree in [0, 180]
   float turn_cost_table_[181];
+
+  // Search state and label storage shared by the routes of all states
+  mutable LabelSet labelset_;
+
+  // Give the labels of the states back to the label set
+  void RecycleLabels(const std::vector<const State*>& column);
 };
 
 }
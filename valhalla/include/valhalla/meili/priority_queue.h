@@ -52,6 +52,27 @@ class SPQueue
   typename Heap::size_type size() const
   { return heap_.size(); }
 
+  // Iterate the labels in no particular order
+  typename Heap::const_iterator begin() const
+  { return heap_.begin(); }
+
+  typename Heap::const_iterator end() const
+  { return heap_.end(); }
+
+  // Remove all labels the predicate holds for
+  template <typename predicate_t>
+  void remove_if(predicate_t predicate)
+  {
+    for (auto it = handlers_.begin(); it != handlers_.end(); ) {
+      if (predicate(*(it->second))) {
+        heap_.erase(it->second);
+        it = handlers_.erase(it);
+      } else {
+        it++;
+      }
+    }
+  }
+
  protected:
   Heap heap_;
 
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <algorithm>
+#include <limits>
 
 #include <valhalla/midgard/distanceapproximator.h>
 #include <valhalla/baldr/graphid.h>
@@ -37,7 +38,7 @@ struct Label
         uint32_t the_predecessor,
         const baldr::DirectedEdge* the_edge,
         sif::TravelMode the_travelmode,
-        std::shared_ptr<const sif::EdgeLabel> the_edgelabel)
+        const sif::EdgeLabel* the_edgelabel)
       : Label(the_nodeid, kInvalidDestination, the_edgeid,
               the_source, the_target,
               the_cost, the_turn_cost, the_sortcost,
@@ -51,7 +52,7 @@ struct Label
         uint32_t the_predecessor,
         const baldr::DirectedEdge* the_edge,
         sif::TravelMode the_travelmode,
-        std::shared_ptr<const sif::EdgeLabel> the_edgelabel)
+        const sif::EdgeLabel* the_edgelabel)
       : Label({}, the_dest, the_edgeid,
               the_source, the_target,
               the_cost, the_turn_cost, the_sortcost,
@@ -66,12 +67,13 @@ struct Label
         uint32_t the_predecessor,
         const baldr::DirectedEdge* the_edge,
         sif::TravelMode the_travelmode,
-        std::shared_ptr<const sif::EdgeLabel> the_edgelabel)
+        const sif::EdgeLabel* the_edgelabel)
       : nodeid(the_nodeid), dest(the_dest), edgeid(the_edgeid),
         source(the_source), target(the_target),
         cost(the_cost), turn_cost(the_turn_cost), sortcost(the_sortcost),
         predecessor(the_predecessor),
-        edgelabel(the_edgelabel)
+        edgelabel(),
+        has_edgelabel(the_edgelabel != nullptr || the_edge != nullptr)
   {
     if (!((nodeid.Is_Valid() && dest == kInvalidDestination) || (!nodeid.Is_Valid() && dest != kInvalidDestination))) {
       throw std::invalid_argument("nodeid and dest must be mutually exclusive, i.e. either nodeid is valid or dest is valid");
@@ -92,18 +94,24 @@ struct Label
       throw std::invalid_argument("invalid turn_cost = " + std::to_string(turn_cost));
     }
 
-    if (!edgelabel && the_edge) {
-      edgelabel = std::make_shared<const sif::EdgeLabel>(the_predecessor,
-                                                         the_edgeid,
-                                                         the_edge,
-                                                         sif::Cost(the_cost, the_cost), // Cost
-                                                         sortcost, // Sortcost
-                                                         the_cost, // Distance
-                                                         the_travelmode,
-                                                         0);
+    if (the_edgelabel) {
+      edgelabel = *the_edgelabel;
+    } else if (the_edge) {
+      edgelabel = sif::EdgeLabel(the_predecessor,
+                                 the_edgeid,
+                                 the_edge,
+                                 sif::Cost(the_cost, the_cost), // Cost
+                                 sortcost, // Sortcost
+                                 the_cost, // Distance
+                                 the_travelmode,
+                                 0);
     }
   }
 
+  // The EdgeLabel if there is one, nullptr otherwise
+  const sif::EdgeLabel* edgelabel_ptr() const
+  { return has_edgelabel? &edgelabel : nullptr; }
+
   // Must be mutually exclusive, i.e. nodeid.Is_Valid() XOR dest != kInvalidDestination
   baldr::GraphId nodeid;
   uint16_t dest;
@@ -128,8 +136,11 @@ struct Label
   // kInvalidLabelIndex if dummy
   uint32_t predecessor;
 
-  // An EdgeLabel is needed here for passing to sif's filters later
-  std::shared_ptr<const sif::EdgeLabel> edgelabel;
+  // An EdgeLabel is needed here for passing to sif's filters later,
+  // kept by value so labels need no allocation of their own. Only
+  // valid if has_edgelabel
+  sif::EdgeLabel edgelabel;
+  bool has_edgelabel;
 };
 
 
@@ -146,13 +157,86 @@ struct Status{
 };
 
 
+// Status of the nodes or destinations reached by a search, keyed by
+// GraphId value or destination index. An open addressing hash table
+// which only resets the slots a search used, so it is reused from search
+// to search without freeing or rehashing.
+class StatusMap
+{
+ public:
+  StatusMap();
+
+  Status* find(uint64_t key)
+  {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+    for (auto i = slot_idx(key); ; i = (i + 1) & mask_) {
+      if (slots_[i].key == key) {
+        return &slots_[i].status;
+      }
+      if (slots_[i].key == kEmptyKey) {
+        return nullptr;
+      }
+    }
+  }
+
+  // The key must not be in the map
+  void emplace(uint64_t key, uint32_t label_idx);
+
+  void clear();
+
+  bool empty() const
+  { return used_.empty(); }
+
+ private:
+  static constexpr uint64_t kEmptyKey = std::numeric_limits<uint64_t>::max();
+
+  struct Slot {
+    uint64_t key;
+    Status status;
+  };
+
+  std::vector<Slot> slots_;
+
+  // Indexes of the slots in use
+  std::vector<uint32_t> used_;
+
+  uint32_t mask_;
+
+  uint32_t slot_idx(uint64_t key) const
+  { return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_; }
+
+  void grow();
+};
+
+
+// Max number of label lists the label set keeps for reuse
+constexpr size_t kMaxPooledLabelLists = 256;
+
+
+// Labels, queue and status of a search. One label set is meant to be
+// reused by all the searches of a matcher: the labels of each search are
+// taken out with release_labels and their storage is given back with
+// recycle once they are no longer needed, so the next searches fill
+// existing storage instead of allocating.
 class LabelSet
 {
  public:
   LabelSet(typename BucketQueue<uint32_t, kInvalidLabelIndex>::size_type count, float size = 1.f);
 
+  // Get ready for a new search with the given number of buckets, labels
+  // costing more are rejected
+  void reuse(typename BucketQueue<uint32_t, kInvalidLabelIndex>::size_type count);
+
+  // Take the labels of the last search out of the set
+  std::vector<Label> release_labels();
+
+  // Give label storage back for reuse
+  void recycle(std::vector<Label>&& labels);
+
   bool put(const baldr::GraphId& nodeid, sif::TravelMode travelmode,
-           std::shared_ptr<const sif::EdgeLabel> edgelabel);
+           const sif::EdgeLabel* edgelabel);
 
   bool put(const baldr::GraphId& nodeid,
            const baldr::GraphId& edgeid,
@@ -161,10 +245,10 @@ class LabelSet
            uint32_t predecessor,
            const baldr::DirectedEdge* edge,
            sif::TravelMode travelmode,
-           std::shared_ptr<const sif::EdgeLabel> edgelabel);
+           const sif::EdgeLabel* edgelabel);
 
   bool put(uint16_t dest, sif::TravelMode travelmode,
-           std::shared_ptr<const sif::EdgeLabel> edgelabel);
+           const sif::EdgeLabel* edgelabel);
 
   bool put(uint16_t dest,
            const baldr::GraphId& edgeid,
@@ -173,7 +257,7 @@ class LabelSet
            uint32_t predecessor,
            const baldr::DirectedEdge* edge,
            sif::TravelMode travelmode,
-           std::shared_ptr<const sif::EdgeLabel> edgelabel);
+           const sif::EdgeLabel* edgelabel);
 
   uint32_t pop();
 
@@ -194,9 +278,10 @@ class LabelSet
 
  private:
   BucketQueue<uint32_t, kInvalidLabelIndex> queue_;
-  std::unordered_map<baldr::GraphId, Status> node_status_;
-  std::unordered_map<uint16_t, Status> dest_status_;
+  StatusMap node_status_;
+  StatusMap dest_status_;
   std::vector<Label> labels_;
+  std::vector<std::vector<Label>> pool_;
 };
 
 
@@ -208,7 +293,7 @@ find_shortest_path(baldr::GraphReader& reader,
                    const midgard::DistanceApproximator& approximator,
                    float search_radius,
                    sif::cost_ptr_t costing = nullptr,
-                   std::shared_ptr<const sif::EdgeLabel> edgelabel = nullptr,
+                   const sif::EdgeLabel* edgelabel = nullptr,
                    const float turn_cost_table[181] = nullptr);
 
 
@@ -216,19 +301,19 @@ class RoutePathIterator:
       public std::iterator<std::forward_iterator_tag, const Label>
 {
  public:
-  RoutePathIterator(const LabelSet* labelset,
+  RoutePathIterator(const std::vector<Label>* labels,
                     uint32_t label_idx)
-      : labelset_(labelset),
+      : labels_(labels),
         label_idx_(label_idx) {}
 
   // Construct a tail iterator
-  RoutePathIterator(const LabelSet* labelset)
-      : labelset_(labelset),
+  RoutePathIterator(const std::vector<Label>* labels)
+      : labels_(labels),
         label_idx_(kInvalidLabelIndex) {}
 
   // Construct an invalid iterator
   RoutePathIterator()
-      : labelset_(nullptr),
+      : labels_(nullptr),
         label_idx_(kInvalidLabelIndex) {}
 
   // Postfix increment
@@ -236,7 +321,7 @@ class RoutePathIterator:
   {
     if (label_idx_ != kInvalidLabelIndex) {
       auto clone = *this;
-      label_idx_ = labelset_->label(label_idx_).predecessor;
+      label_idx_ = (*labels_)[label_idx_].predecessor;
       return clone;
     }
     return *this;
@@ -246,7 +331,7 @@ class RoutePathIterator:
   RoutePathIterator& operator++()
   {
     if (label_idx_ != kInvalidLabelIndex) {
-      label_idx_ = labelset_->label(label_idx_).predecessor;
+      label_idx_ = (*labels_)[label_idx_].predecessor;
     }
     return *this;
   }
@@ -254,7 +339,7 @@ class RoutePathIterator:
   bool operator==(const RoutePathIterator& other) const
   {
     return label_idx_ == other.label_idx_
-        && labelset_ == other.labelset_;
+        && labels_ == other.labels_;
   }
 
   bool operator!=(const RoutePathIterator& other) const
@@ -262,17 +347,17 @@ class RoutePathIterator:
 
   // Derefrencnce
   reference operator*() const
-  { return labelset_->label(label_idx_); }
+  { return (*labels_)[label_idx_]; }
 
   // Pointer dereference
   pointer operator->() const
-  { return &(labelset_->label(label_idx_)); }
+  { return &(*labels_)[label_idx_]; }
 
   bool is_valid() const
-  { return labelset_ != nullptr; }
+  { return labels_ != nullptr; }
 
  private:
-  const LabelSet* labelset_;
+  const std::vector<Label>* labels_;
   uint32_t label_idx_;
 };
 
@@ -1,13 +1,21 @@
 #ifndef MMP_TRAFFIC_SEGMENT_MATCHER_H_
 #define MMP_TRAFFIC_SEGMENT_MATCHER_H_
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <boost/property_tree/ptree.hpp>
 
 #include "baldr/graphfsreader.h"
 #include "baldr/graphid.h"
 #include "baldr/json.h"
+#include "midgard/pointll.h"
+#include "midgard/worker_pool.h"
+#include "meili/candidate_search.h"
 #include "meili/map_matcher.h"
 #include "meili/map_matcher_factory.h"
 #include "meili/match_route.h"
@@ -47,6 +55,37 @@ struct MatchedTrafficSegment {
   long int end_shape_index;
 };
 
+// GPS trace to match in a batch
+struct TrafficTrace {
+  uint64_t id;                                // Caller's id of the trace
+  std::vector<valhalla::midgard::PointLL> shape;
+  std::vector<uint32_t> times;                // Time of each point (seconds)
+};
+
+// Gets the traffic segments matched to a trace of a batch
+using traffic_segment_callback_t = std::function<void (const TrafficTrace&,
+    const std::vector<MatchedTrafficSegment>&)>;
+
+/**
+ * Writes matched traffic segments to a stream as compact binary records,
+ * to be used as the callback of a batch. Each trace gives one record:
+ *   uint64 trace id, uint32 segment count, then per segment
+ *   uint64 segment id, float start time, float end time, uint32 length,
+ *   uint32 begin shape index, uint32 end shape index and uint8 flags
+ *   (1 = partial start, 2 = partial end).
+ * All values are in host byte order and without padding.
+ */
+class TrafficSegmentWriter {
+ public:
+  TrafficSegmentWriter(std::ostream& out) : out_(&out) { }
+
+  void operator()(const TrafficTrace& trace,
+                  const std::vector<MatchedTrafficSegment>& segments);
+
+ protected:
+  std::ostream* out_;
+};
+
 /**
  * Traffic segment matcher. Allows matching GPS traces to Valhalla edges and
  * then forms the traffic segments associated to those edges.
@@ -56,9 +95,12 @@ class TrafficSegmentMatcher {
 
   /**
    * Constructor.
-   * @param  config  Boost property tree - config information.
+   * @param  config        Boost property tree - config information.
+   * @param  thread_count  Number of threads matching the traces of a batch,
+   *                       including the calling thread.
    */
-  TrafficSegmentMatcher(const boost::property_tree::ptree& config);
+  TrafficSegmentMatcher(const boost::property_tree::ptree& config,
+                        const uint32_t thread_count = 1);
 
   /**
    * Matches the GPS trace to Valhalla edges and then associates those
@@ -69,9 +111,45 @@ class TrafficSegmentMatcher {
    */
   std::string match(const std::string& json);
 
+  /**
+   * Matches a batch of GPS traces to traffic segments. The traces are
+   * spread over the threads, the matchers and candidate caches are kept
+   * from one trace and batch to the next. The segments of each trace are
+   * handed to the callback as soon as the trace is matched, so not in the
+   * order of the traces. Calls to the callback never overlap.
+   * @param  traces    GPS traces to match.
+   * @param  callback  Gets the traffic segments of each trace.
+   */
+  void match(const std::vector<TrafficTrace>& traces,
+             const traffic_segment_callback_t& callback);
+
+  /**
+   * Matches a GPS trace and forms the traffic segments it traverses.
+   * @param  matcher   Map matcher to use.
+   * @param  trace     GPS trace.
+   * @param  segments  (OUT) Traffic segments the trace is matched to.
+   * @return Returns false if the trace could not be matched.
+   */
+  static bool match_segments(MapMatcher& matcher, const TrafficTrace& trace,
+                             std::vector<MatchedTrafficSegment>& segments);
+
  protected:
   valhalla::baldr::GraphFsReader reader;
   valhalla::meili::MapMatcherFactory matcher_factory;
+
+  // Threads matching the traces of a batch
+  valhalla::midgard::WorkerPool workers;
+
+  // Graph readers and candidate queries of the threads other than the
+  // calling one, which uses the ones of the matcher factory
+  std::vector<std::unique_ptr<valhalla::baldr::GraphReader>> worker_readers;
+  std::vector<std::unique_ptr<CandidateGridQuery>> worker_queries;
+
+  // Map matcher of each thread
+  std::vector<std::unique_ptr<MapMatcher>> matchers;
+
+  // Serializes the callbacks of a batch
+  std::mutex callback_mutex;
 };
 
 }
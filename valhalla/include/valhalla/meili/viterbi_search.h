@@ -3,7 +3,9 @@
 #define MMP_VITERBI_SEARCH_H_
 
 #include <vector>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 #include <valhalla/meili/priority_queue.h>
@@ -133,6 +135,10 @@ class StateIterator: public std::iterator<std::forward_iterator_tag, T>
   bool IsValid() const
   { return id_ != kInvalidStateId; }
 
+  // The time the iterator is at, kInvalidTime at the path end
+  Time time() const
+  { return time_; }
+
  private:
   IViterbiSearch<T>* vs_;
 
@@ -460,7 +466,9 @@ template <typename T>
 class ViterbiSearch: public IViterbiSearch<T>
 {
  public:
-  ViterbiSearch(): earliest_time_(0) {}
+  using typename IViterbiSearch<T>::state_iterator;
+
+  ViterbiSearch(): earliest_time_(0), time_base_(0), state_base_(0) {}
 
   ~ViterbiSearch();
 
@@ -468,6 +476,21 @@ class ViterbiSearch: public IViterbiSearch<T>
 
   StateId SearchWinner(Time time) override;
 
+  // Find the latest searched time at which all the paths still alive in
+  // the search pass through the same state. The path up to that time is
+  // final no matter which states are added later. If it is more than
+  // max_lag behind the latest searched time, the search commits to the
+  // current best path at max_lag behind and drops the paths disagreeing
+  // with it. Returns an iterator at the state (invalid if the path has no
+  // state there), or the path end if nothing converged
+  state_iterator Converge(Time max_lag = kInvalidTime);
+
+  // Forget all states before the time, which must have been searched. The
+  // path before it can't be iterated any more. Meant for times the path
+  // has converged at, paths still reaching back before it are dropped.
+  // State ids must increase with time
+  void Prune(Time time);
+
   const T& state(StateId id) const override;
 
   StateId predecessor(StateId id) const override;
@@ -479,11 +502,13 @@ class ViterbiSearch: public IViterbiSearch<T>
   virtual double AccumulatedCost(StateId id) const override;
 
  protected:
-  std::vector<const T*> state_;
+  // States from state_base_ on, indexed by id - state_base_
+  std::deque<const T*> state_;
 
-  std::vector<const T*> winner_;
+  // Winners and columns from time_base_ on, indexed by time - time_base_
+  std::deque<const T*> winner_;
 
-  std::vector<std::vector<const T*>> unreached_states_;
+  std::deque<std::vector<const T*>> unreached_states_;
 
   virtual float TransitionCost(const T& left, const T& right) const override = 0;
 
@@ -503,7 +528,20 @@ class ViterbiSearch: public IViterbiSearch<T>
 
   Time IterativeSearch(Time target, bool request_new_start);
 
+  // The state before the given one on the path through it at the time,
+  // the winner before if the path starts over there
+  const T* PreviousState(const T* state, Time time) const;
+
+  // Same for a path ending with a label that has not been scanned yet
+  const T* PreviousState(const StateLabel<T>& label) const;
+
   Time earliest_time_;
+
+ protected:
+  // The earliest time and state id not pruned
+  Time time_base_;
+
+  StateId state_base_;
 };
 
 
@@ -515,16 +553,21 @@ inline ViterbiSearch<T>::~ViterbiSearch()
 template <typename T>
 StateId ViterbiSearch<T>::SearchWinner(Time time)
 {
+  // Pruned already
+  if (time < time_base_) {
+    return kInvalidStateId;
+  }
+
   // Use the cache
-  if (time < winner_.size()) {
-    return winner_[time]? winner_[time]->id() : kInvalidStateId;
+  if (time < time_base_ + winner_.size()) {
+    return winner_[time - time_base_]? winner_[time - time_base_]->id() : kInvalidStateId;
   }
 
   if (unreached_states_.empty()) {
     return kInvalidStateId;
   }
 
-  const Time max_allowed_time = unreached_states_.size() - 1;
+  const Time max_allowed_time = time_base_ + unreached_states_.size() - 1;
   const auto target = std::min(time, max_allowed_time);
 
   // Continue last search if possible
@@ -537,8 +580,8 @@ StateId ViterbiSearch<T>::SearchWinner(Time time)
     // Guarantee that that winner_.size() is increasing and searched_time == winner_.size() - 1
   }
 
-  if (time < winner_.size() && winner_[time]) {
-    return winner_[time]->id();
+  if (time < time_base_ + winner_.size() && winner_[time - time_base_]) {
+    return winner_[time - time_base_]->id();
   }
   return kInvalidStateId;
 }
@@ -548,11 +591,8 @@ template <typename T>
 inline StateId
 ViterbiSearch<T>::predecessor(StateId id) const
 {
-  // Let it throw out-of-bound here. This is by design to be
-  // consistent with NaiveViterbiSearch::predecessor
-  const auto& state = state_[id];
-
-  const auto it = scanned_labels_.find(state->id());
+  // Pruned and unscanned states have no labels
+  const auto it = scanned_labels_.find(id);
   if (it != scanned_labels_.end()) {
     return (it->second).predecessor? (it->second).predecessor->id() : kInvalidStateId;
   } else {
@@ -570,11 +610,8 @@ ViterbiSearch<T>::IsInvalidCost(double cost) const
 template <typename T>
 double ViterbiSearch<T>::AccumulatedCost(StateId id) const
 {
-  // Let it throw out-of-bound here. This is by design to be
-  // consistent with NaiveViterbiSearch::AccumulatedCost
-  const auto& state = state_[id];
-
-  const auto it = scanned_labels_.find(state->id());
+  // Pruned and unscanned states have no labels
+  const auto it = scanned_labels_.find(id);
   if (it == scanned_labels_.end()) {
     return -1.f;
   } else {
@@ -585,13 +622,15 @@ double ViterbiSearch<T>::AccumulatedCost(StateId id) const
 
 template <typename T>
 inline const T& ViterbiSearch<T>::state(StateId id) const
-{ return *state_[id]; }
+{ return *state_[id - state_base_]; }
 
 
 template <typename T>
 void ViterbiSearch<T>::Clear()
 {
   earliest_time_ = 0;
+  time_base_ = 0;
+  state_base_ = 0;
   queue_.clear();
   scanned_labels_.clear();
   unreached_states_.clear();
@@ -620,7 +659,7 @@ void ViterbiSearch<T>::InitQueue(const std::vector<const T*>& column)
 template <typename T>
 void ViterbiSearch<T>::AddSuccessorsToQueue(const T* state)
 {
-  if (!(state->time() + 1 < unreached_states_.size())) {
+  if (!(state->time() + 1 < time_base_ + unreached_states_.size())) {
     throw std::logic_error("the state at time " + std::to_string(state->time()) + " is impossible to have successors");
   }
 
@@ -637,7 +676,7 @@ void ViterbiSearch<T>::AddSuccessorsToQueue(const T* state)
 
   // Optimal states have been removed from unreached_states_ so no
   // worry about optimality
-  for (const auto& next_state : unreached_states_[state->time() + 1]) {
+  for (const auto& next_state : unreached_states_[state->time() + 1 - time_base_]) {
     const auto emission_cost = EmissionCost(*next_state);
     if (IsInvalidCost(emission_cost)) {
       continue;
@@ -661,31 +700,32 @@ void ViterbiSearch<T>::AddSuccessorsToQueue(const T* state)
 template <typename T>
 Time ViterbiSearch<T>::IterativeSearch(Time target, bool request_new_start)
 {
-  if (unreached_states_.size() <= target) {
+  if (time_base_ + unreached_states_.size() <= target) {
     if (unreached_states_.empty()) {
       throw std::runtime_error("empty states: add some states at least before searching");
     } else {
       throw std::runtime_error("the target time is beyond the maximum allowed time "
-                               + std::to_string(unreached_states_.size()-1));
+                               + std::to_string(time_base_ + unreached_states_.size() - 1));
     }
   }
 
   // Do nothing since the winner at the target time is already known
-  if (target < winner_.size()) {
+  if (target < time_base_ + winner_.size()) {
     return target;
   }
 
   // Clearly here we have precondition: winner_.size() <= target < unreached_states_.size()
+  // (all relative to time_base_)
 
   Time source;
 
   // Either continue last search, or start a new search
   if (!request_new_start && !winner_.empty() && winner_.back()) {
-    source = winner_.size() - 1;
-    AddSuccessorsToQueue(winner_[source]);
+    source = time_base_ + winner_.size() - 1;
+    AddSuccessorsToQueue(winner_.back());
   } else {
-    source = winner_.size();
-    InitQueue(unreached_states_[source]);
+    source = time_base_ + winner_.size();
+    InitQueue(unreached_states_[source - time_base_]);
   }
 
   // Start with the source time, which will be searched anyhow
@@ -715,7 +755,7 @@ Time ViterbiSearch<T>::IterativeSearch(Time target, bool request_new_start)
     }
 
     // Remove it from its column
-    auto& column = unreached_states_[time];
+    auto& column = unreached_states_[time - time_base_];
     const auto it = std::find_if(column.begin(), column.end(),
                                  [id] (const T* state) {
                                    return id == state->id();
@@ -734,8 +774,8 @@ Time ViterbiSearch<T>::IterativeSearch(Time target, bool request_new_start)
 
     // If it's the first state that arrives at this column, mark it as
     // the winner at this time
-    if (winner_.size() <= time) {
-      if (!(time == winner_.size())) {
+    if (time_base_ + winner_.size() <= time) {
+      if (!(time == time_base_ + winner_.size())) {
         // Should check if states at unreached_states_[time] are all
         // at the same TIME
         throw std::logic_error("found a state from the future time " + std::to_string(time));
@@ -757,7 +797,7 @@ Time ViterbiSearch<T>::IterativeSearch(Time target, bool request_new_start)
 
   // Guarantee that either winner (if found) or nullptr (not found) is
   // saved at searched_time
-  while (winner_.size() <= searched_time) {
+  while (time_base_ + winner_.size() <= searched_time) {
     winner_.push_back(nullptr);
   }
 
@@ -770,6 +810,160 @@ Time ViterbiSearch<T>::IterativeSearch(Time target, bool request_new_start)
   return searched_time;
 }
 
+
+template <typename T>
+const T* ViterbiSearch<T>::PreviousState(const T* state, Time time) const
+{
+  if (state) {
+    const auto it = scanned_labels_.find(state->id());
+    if (it != scanned_labels_.end() && it->second.predecessor) {
+      return it->second.predecessor;
+    }
+  }
+  return time_base_ < time? winner_[time - 1 - time_base_] : nullptr;
+}
+
+
+template <typename T>
+const T* ViterbiSearch<T>::PreviousState(const StateLabel<T>& label) const
+{
+  if (label.predecessor) {
+    return label.predecessor;
+  }
+  const auto time = label.state->time();
+  return time_base_ < time? winner_[time - 1 - time_base_] : nullptr;
+}
+
+
+template <typename T>
+typename ViterbiSearch<T>::state_iterator
+ViterbiSearch<T>::Converge(Time max_lag)
+{
+  if (winner_.empty()) {
+    return this->PathEnd();
+  }
+  const Time latest = time_base_ + winner_.size() - 1;
+
+  // Nothing reached the latest time, so the next search starts over and
+  // the whole path is final
+  if (!winner_.back()) {
+    return state_iterator(this, kInvalidStateId, latest);
+  }
+
+  // Every path found from now on extends the latest winner or a label in
+  // the queue, i.e. the state the label was reached from. Labels with
+  // neither a predecessor nor a winner before reach back beyond the
+  // search, and so do labels at the earliest time not pruned
+  std::vector<std::pair<Time, const T*>> heads;
+  heads.emplace_back(latest, winner_.back());
+  bool diverged = false;
+  for (const auto& label : queue_) {
+    const auto time = label.state->time();
+    if (time < earliest_time_) {
+      continue;
+    }
+    if (time <= time_base_) {
+      diverged = true;
+      break;
+    }
+    heads.emplace_back(time - 1, PreviousState(label));
+  }
+  std::sort(heads.begin(), heads.end(),
+            [](const std::pair<Time, const T*>& left, const std::pair<Time, const T*>& right) {
+              return left.first > right.first;
+            });
+
+  // Walk all the paths back in lockstep until they meet
+  Time converged = kInvalidTime;
+  const T* converged_state = nullptr;
+  if (!diverged) {
+    std::unordered_set<const T*> states, previous_states;
+    auto head = heads.cbegin();
+    for (Time time = latest; ; time--) {
+      for (; head != heads.cend() && head->first == time; head++) {
+        states.insert(head->second);
+      }
+      if (head == heads.cend() && states.size() == 1) {
+        converged = time;
+        converged_state = *states.begin();
+        break;
+      }
+      if (time == time_base_) {
+        break;
+      }
+      previous_states.clear();
+      for (const auto state : states) {
+        previous_states.insert(PreviousState(state, time));
+      }
+      std::swap(states, previous_states);
+    }
+  }
+
+  // Converged recently enough or no lag limit
+  if (max_lag == kInvalidTime || latest < time_base_ + max_lag ||
+      (converged != kInvalidTime && latest - max_lag <= converged)) {
+    return converged != kInvalidTime?
+        state_iterator(this, converged_state? converged_state->id() : kInvalidStateId, converged)
+        : this->PathEnd();
+  }
+
+  // Commit to the current best path at the lag time
+  const Time committed = latest - max_lag;
+  const auto ancestor = [this, committed](const T* state, Time time) {
+    for (; committed < time; time--) {
+      state = PreviousState(state, time);
+    }
+    return state;
+  };
+  const auto committed_state = ancestor(winner_.back(), latest);
+  queue_.remove_if([this, committed, committed_state, &ancestor](const StateLabel<T>& label) {
+    const auto time = label.state->time();
+    return time <= committed || ancestor(PreviousState(label), time - 1) != committed_state;
+  });
+  return state_iterator(this, committed_state? committed_state->id() : kInvalidStateId, committed);
+}
+
+
+template <typename T>
+void ViterbiSearch<T>::Prune(Time time)
+{
+  if (time <= time_base_) {
+    return;
+  }
+  if (time_base_ + winner_.size() < time) {
+    throw std::logic_error("can't prune states that have not been searched yet");
+  }
+
+  // Labels before the time can't be part of the path to future winners,
+  // and neither can the labels reached from before it
+  earliest_time_ = std::max(earliest_time_, time);
+  queue_.remove_if([time](const StateLabel<T>& label) {
+    return label.state->time() < time || (label.predecessor && label.predecessor->time() < time);
+  });
+
+  // Forget the labels of the pruned states and cut the links to them
+  for (auto it = scanned_labels_.begin(); it != scanned_labels_.end(); ) {
+    if (it->second.state->time() < time) {
+      it = scanned_labels_.erase(it);
+    } else {
+      if (it->second.predecessor && it->second.predecessor->time() < time) {
+        it->second.predecessor = nullptr;
+      }
+      it++;
+    }
+  }
+
+  while (!state_.empty() && state_.front()->time() < time) {
+    delete state_.front();
+    state_.pop_front();
+    state_base_++;
+  }
+  for (; time_base_ < time; time_base_++) {
+    winner_.pop_front();
+    unreached_states_.pop_front();
+  }
+}
+
 }
 }
 #endif // MMP_VITERBI_SEARCH_H_
@@ -55,8 +55,51 @@ container_t decode(const std::string& encoded) {
   return decode<container_t, ShapeDecoder>(encoded.c_str(), encoded.length());
 }
 
+/**
+ * Varint decode into a vector of points, reusing its memory. The shape is
+ * decoded in bulk rather than a point at a time.
+ *
+ * @param encoded   the encoded points
+ * @param length    the length of the encoded points in bytes
+ * @param output    the vector of points to fill, it is cleared first
+ */
+template<class container_t>
+void decode7(const char* encoded, size_t length, container_t& output) {
+  //the coordinates are decoded into a scratch buffer kept by each thread
+  static thread_local std::vector<int32_t> values;
+  if (values.size() < length) {
+    values.resize(length);
+  }
+  const size_t count = decode7_fixed_point(encoded, length, values.data());
+
+  //lat comes first in the encoding
+  output.clear();
+  output.reserve(count / 2);
+  for (size_t i = 0; i < count; i += 2) {
+    output.emplace_back(typename container_t::value_type::first_type(double(values[i + 1]) * 1e-6),
+                        typename container_t::value_type::second_type(double(values[i]) * 1e-6));
+  }
+}
+
+// specialized implemetation for std::vector using the bulk decoder
+template<class container_t>
+typename
+std::enable_if<std::is_same<std::vector<typename container_t::value_type>,
+                            container_t>::value,
+               container_t>::type
+decode7(const char* encoded, size_t length) {
+  container_t c;
+  decode7(encoded, length, c);
+  return c;
+}
+
+// implementation for non std::vector
 template<class container_t>
-container_t decode7(const char* encoded, size_t length) {
+typename
+std::enable_if<! std::is_same<std::vector<typename container_t::value_type>,
+                              container_t>::value,
+               container_t>::type
+decode7(const char* encoded, size_t length) {
   return decode<container_t, Shape7Decoder<typename container_t::value_type>>(encoded, length);
 }
 
@@ -53,6 +53,28 @@ class GriddedData : public Tiles<coord_t> {
    */
   bool SetIfLessThan(const coord_t& pt, const float value);
 
+  /**
+   * Set the values of the cells crossed by the segments of a polyline if
+   * less than the current values. The first segment is assigned value and
+   * each following segment delta more than the one before. Segments are
+   * treated as straight lines in the grid so they should be short compared
+   * to the cell size. Marks the whole polyline in one pass without the
+   * temporary containers of Intersect.
+   * @param  polyline  Polyline to mark.
+   * @param  value     Value of the first segment.
+   * @param  delta     Value increment from one segment to the next.
+   */
+  void SetIfLessThan(const std::vector<coord_t>& polyline, float value,
+                     const float delta);
+
+  /**
+   * Set each cell to the corresponding value if it is less than the current
+   * value. Used to merge data that was gridded separately over the same
+   * tiles.
+   * @param  values  Values to merge, one per cell.
+   */
+  void SetIfLessThan(const std::vector<float>& values);
+
   /**
    * Get the array of data.
    * @return  Returns the data associated with the tiles.
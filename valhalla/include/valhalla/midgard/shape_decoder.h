@@ -1,6 +1,8 @@
 #ifndef VALHALLA_MIDGARD_SHAPE_DECODER_H_
 #define VALHALLA_MIDGARD_SHAPE_DECODER_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 
 namespace valhalla {
@@ -81,6 +83,22 @@ class Shape5Decoder {
   }
 };
 
+/**
+ * Bulk varint decode a shape into fixed point coordinates (1e-6 degrees)
+ * in the encoded order: lat, lon, lat, lon... The whole shape is decoded at
+ * once, finding the ends of the varints a vector of bytes at a time where
+ * the cpu has SSSE3 (checked at run time on x86), so it is much faster than
+ * popping the points off a Shape7Decoder one by one. The results are exactly
+ * the same.
+ *
+ * @param encoded   the encoded points
+ * @param length    the length of the encoded points in bytes
+ * @param values    where to write the coordinates, room for length values
+ * @return          the number of values written, twice the number of points
+ */
+size_t decode7_fixed_point(const char* encoded, const size_t length,
+                           int32_t* values) noexcept(false);
+
 }
 }
 
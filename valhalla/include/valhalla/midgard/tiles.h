@@ -239,9 +239,10 @@ class Tiles {
   std::vector<int32_t> TileList(const AABB2<coord_t>& boundingbox) const;
 
   /**
-   * Color a "connectivity map" starting with a sparse map of uncolored tiles.
-   * Any 2 tiles that have a connected path between them will have the same
-   * value in the connectivity map.
+   * Color a "connectivity map" starting with a sparse map of uncolored (0)
+   * tiles. Any 2 tiles that have a connected path between them will have the
+   * same value in the connectivity map. Tiles already colored keep their
+   * color, new colors start after the largest one in the map.
    * @param  tilemap  map of tileid to color value
    * @return
    */
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <memory>
 #include <limits>
+#include <functional>
 
 #include <valhalla/midgard/pointll.h>
 
@@ -194,6 +195,20 @@ T clamp(T value, T lower, T upper) {
 template<class container_t>
 container_t resample_spherical_polyline(const container_t& polyline, double resolution, bool preserve = false);
 
+/**
+ * Rasterize a line between two floating point pixel coordinates. This is
+ * modified to include all pixels that are intersected by the line, at each
+ * step it moves in x or y based on which pixel midpoint forms the smaller
+ * triangle with the line.
+ * @param x0         x of the start of the line
+ * @param y0         y of the start of the line
+ * @param x1         x of the end of the line
+ * @param y1         y of the end of the line
+ * @param set_pixel  called for each pixel, returns true if the pixel is outside
+ *                   the valid drawing region, leaving it stops the rasterization
+ */
+void bresenham_line(float x0, float y0, float x1, float y1, const std::function<bool (int32_t, int32_t)>& set_pixel);
+
 /**
  * A class to wrap a primitive array in something iterable which is useful for loops mostly
  * Basically if you dont have a vector or list, this makes your array a bit more usable in
@@ -0,0 +1,75 @@
+#ifndef VALHALLA_MIDGARD_WORKER_POOL_H_
+#define VALHALLA_MIDGARD_WORKER_POOL_H_
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+
+namespace valhalla {
+namespace midgard {
+
+/**
+ * A fixed set of threads that run the same job in lock step. Run() hands
+ * the job to every worker, the calling thread being worker 0, and returns
+ * once all of them finished it. This suits algorithms that alternate
+ * between parallel phases and a bit of serial bookkeeping, the threads
+ * stay alive between phases so a phase can be very short.
+ */
+class WorkerPool {
+ public:
+  /**
+   * Constructor
+   * @param worker_count  Total number of workers including the calling
+   *                      thread. 0 or 1 means everything runs on the
+   *                      calling thread.
+   */
+  WorkerPool(const uint32_t worker_count);
+
+  /**
+   * Destructor. Stops and joins the threads.
+   */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * Get the number of workers including the calling thread.
+   * @return  Returns the number of workers.
+   */
+  uint32_t size() const {
+    return threads_.size() + 1;
+  }
+
+  /**
+   * Run a job on all workers and wait for them to finish. The job is
+   * called with the index of the worker running it. If any of the workers
+   * throws, the first exception is rethrown here after all workers are
+   * done.
+   * @param  job  Job to run.
+   */
+  void Run(const std::function<void(const uint32_t)>& job);
+
+ private:
+  // Thread loop of the worker with the given index
+  void Work(const uint32_t worker);
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(const uint32_t)>* job_;
+  uint64_t generation_;
+  uint32_t running_;
+  bool stop_;
+  std::exception_ptr error_;
+};
+
+}
+}
+
+#endif  // VALHALLA_MIDGARD_WORKER_POOL_H_
@@ -1,6 +1,8 @@
 #ifndef VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 #define VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 
+#include <cstdint>
+#include <initializer_list>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -148,8 +150,74 @@ constexpr auto kTransitStopCountLabelTag = "<TRANSIT_STOP_COUNT_LABEL>";
 namespace valhalla {
 namespace odin {
 
+/**
+ * The value of a phrase tag, used when rendering a phrase template.
+ */
+struct PhraseTagValue {
+  const char* tag;
+  const std::string& value;
+};
+
+/**
+ * A phrase split into literal text and tags when the dictionary is loaded.
+ * Rendering an instruction is then a single pass over the tokens instead of
+ * searching the whole phrase for each tag and rebuilding it per replacement.
+ */
+class PhraseTemplate {
+ public:
+  /**
+   * Constructor of an undefined template.
+   */
+  PhraseTemplate();
+
+  /**
+   * Constructor
+   * @param  phrase  Phrase with <TAG> placeholders.
+   */
+  explicit PhraseTemplate(const std::string& phrase);
+
+  /**
+   * Appends the phrase to the output with its tags replaced by the given
+   * values. Tags without a value are copied as they are.
+   * @param  output  String to append the rendered phrase to.
+   * @param  values  Tag values.
+   */
+  void Render(std::string& output,
+              std::initializer_list<PhraseTagValue> values) const;
+
+  /**
+   * Was the template built from a phrase?
+   * @return Returns true if the template has a phrase.
+   */
+  bool defined() const {
+    return defined_;
+  }
+
+ private:
+  struct token_t {
+    uint32_t offset;
+    uint32_t length;
+    bool tag;
+  };
+
+  std::string text_;
+  std::vector<token_t> tokens_;
+  bool defined_;
+};
+
 struct PhraseSet {
   std::unordered_map<std::string, std::string> phrases;
+
+  // Phrases parsed into templates, indexed by phrase id
+  std::vector<PhraseTemplate> phrase_templates;
+
+  /**
+   * Get the template of a phrase.
+   * @param  phrase_id  Phrase id.
+   * @return Returns the template of the phrase.
+   * @throws std::out_of_range if the phrase does not exist.
+   */
+  const PhraseTemplate& phrase(const uint32_t phrase_id) const;
 };
 
 struct StartSubset : PhraseSet {
@@ -39,6 +39,16 @@ class NarrativeBuilder {
   void Build(const DirectionsOptions& directions_options,
              const EnhancedTripPath* etp, std::list<Maneuver>& maneuvers);
 
+  /**
+   * Sets whether Build forms the verbal instructions. Clients that only
+   * show the text instructions can turn them off, as most of the phrases
+   * formed per maneuver are verbal. Verbal instructions are formed by
+   * default.
+   *
+   * @param  verbal_enabled  True to form the verbal instructions.
+   */
+  void set_verbal_enabled(const bool verbal_enabled);
+
  protected:
 
   /////////////////////////////////////////////////////////////////////////////
@@ -552,6 +562,7 @@ class NarrativeBuilder {
   const EnhancedTripPath* trip_path_;
   const NarrativeDictionary& dictionary_;
   bool articulated_preposition_enabled_;
+  bool verbal_enabled_;
 
 };
 
@@ -9,6 +9,251 @@
 namespace valhalla {
 namespace sif {
 
+/**
+ * Derived class providing dynamic edge costing for "direct" auto routes. This
+ * is a route that is generally shortest time but uses route hierarchies that
+ * can result in slightly longer routes that avoid shortcuts on residential
+ * roads.
+ */
+class AutoCost : public DynamicCost {
+ public:
+  /**
+   * Construct auto costing. Pass in configuration using property tree.
+   * @param  config  Property tree with configuration/options.
+   */
+  AutoCost(const boost::property_tree::ptree& config);
+
+  virtual ~AutoCost();
+
+  /**
+   * Does the costing method allow multiple passes (with relaxed hierarchy
+   * limits).
+   * @return  Returns true if the costing model allows multiple passes.
+   */
+  virtual bool AllowMultiPass() const;
+
+  /**
+   * Disables entrance into destination only areas. This should only be used
+   * for bidirectional path algorithms (and generally only for driving),
+   * otherwise a destination only penalty should be used.
+   */
+  virtual void DisableDestinationOnly();
+
+  /**
+   * Get the access mode used by this costing method.
+   * @return  Returns access mode.
+   */
+  uint32_t access_mode() const;
+
+  /**
+   * Checks if access is allowed for the provided directed edge.
+   * This is generally based on mode of travel and the access modes
+   * allowed on the edge. However, it can be extended to exclude access
+   * based on other parameters.
+   * @param  edge     Pointer to a directed edge.
+   * @param  pred     Predecessor edge information.
+   * @param  tile     current tile
+   * @param  edgeid   edgeid that we care about
+   * @return  Returns true if access is allowed, false if not.
+   */
+  virtual bool Allowed(const baldr::DirectedEdge* edge,
+                       const EdgeLabel& pred,
+                       const baldr::GraphTile*& tile,
+                       const baldr::GraphId& edgeid) const;
+
+  /**
+   * Checks if access is allowed for an edge on the reverse path
+   * (from destination towards origin). Both opposing edges are
+   * provided.
+   * @param  edge           Pointer to a directed edge.
+   * @param  pred           Predecessor edge information.
+   * @param  opp_edge       Pointer to the opposing directed edge.
+   * @param  tile           Tile for the opposing edge (for looking
+   *                        up restrictions).
+   * @param  opp_edgeid     Opposing edge Id
+   * @return  Returns true if access is allowed, false if not.
+   */
+  virtual bool AllowedReverse(const baldr::DirectedEdge* edge,
+                 const EdgeLabel& pred,
+                 const baldr::DirectedEdge* opp_edge,
+                 const baldr::GraphTile*& tile,
+                 const baldr::GraphId& opp_edgeid) const;
+
+  /**
+   * Checks if access is allowed for the provided node. Node access can
+   * be restricted if bollards or gates are present.
+   * @param  edge  Pointer to node information.
+   * @return  Returns true if access is allowed, false if not.
+   */
+  virtual bool Allowed(const baldr::NodeInfo* node) const;
+
+  /**
+   * Get the cost to traverse the specified directed edge. Cost includes
+   * the time (seconds) to traverse the edge.
+   * @param   edge  Pointer to a directed edge.
+   * @return  Returns the cost and time (seconds)
+   */
+  virtual Cost EdgeCost(const baldr::DirectedEdge* edge) const;
+
+  /**
+   * Returns the cost to make the transition from the predecessor edge.
+   * Defaults to 0. Costing models that wish to include edge transition
+   * costs (i.e., intersection/turn costs) must override this method.
+   * @param  edge  Directed edge (the to edge)
+   * @param  node  Node (intersection) where transition occurs.
+   * @param  pred  Predecessor edge information.
+   * @return  Returns the cost and time (seconds)
+   */
+  virtual Cost TransitionCost(const baldr::DirectedEdge* edge,
+                              const baldr::NodeInfo* node,
+                              const EdgeLabel& pred) const;
+
+  /**
+   * Returns the cost to make the transition from the predecessor edge
+   * when using a reverse search (from destination towards the origin).
+   * @param  idx   Directed edge local index
+   * @param  node  Node (intersection) where transition occurs.
+   * @param  pred  the opposing current edge in the reverse tree.
+   * @param  edge  the opposing predecessor in the reverse tree
+   * @return  Returns the cost and time (seconds)
+   */
+  virtual Cost TransitionCostReverse(
+      const uint32_t idx, const baldr::NodeInfo* node,
+      const baldr::DirectedEdge* pred,
+      const baldr::DirectedEdge* edge) const;
+
+  /**
+   * Get the cost factor for A* heuristics. This factor is multiplied
+   * with the distance to the destination to produce an estimate of the
+   * minimum cost to the destination. The A* heuristic must underestimate the
+   * cost to the destination. So a time based estimate based on speed should
+   * assume the maximum speed is used to the destination such that the time
+   * estimate is less than the least possible time along roads.
+   */
+  virtual float AStarCostFactor() const;
+
+  /**
+   * Get the current travel type.
+   * @return  Returns the current travel type.
+   */
+  virtual uint8_t travel_type() const;
+
+  /**
+   * Returns a function/functor to be used in location searching which will
+   * exclude and allow ranking results from the search by looking at each
+   * edges attribution and suitability for use as a location by the travel
+   * mode used by the costing method. Function/functor is also used to filter
+   * edges not usable / inaccessible by automobile.
+   */
+  virtual const EdgeFilter GetEdgeFilter() const {
+    // Throw back a lambda that checks the access for this type of costing
+    return [](const baldr::DirectedEdge* edge) {
+      if (edge->trans_up() || edge->trans_down() || edge->is_shortcut() ||
+         !(edge->forwardaccess() & baldr::kAutoAccess))
+        return 0.0f;
+      else {
+        // TODO - use classification/use to alter the factor
+        return 1.0f;
+      }
+    };
+  }
+
+  /**
+   * Returns a function/functor to be used in location searching which will
+   * exclude results from the search by looking at each node's attribution
+   * @return Function/functor to be used in filtering out nodes
+   */
+  virtual const NodeFilter GetNodeFilter() const {
+    //throw back a lambda that checks the access for this type of costing
+    return [](const baldr::NodeInfo* node){
+      return !(node->access() & baldr::kAutoAccess);
+    };
+  }
+
+ protected:
+  VehicleType type_;                // Vehicle type: car (default), motorcycle, etc
+  float speedfactor_[256];
+  float density_factor_[16];        // Density factor
+  float maneuver_penalty_;          // Penalty (seconds) when inconsistent names
+  float destination_only_penalty_;  // Penalty (seconds) using a driveway or parking aisle
+  float gate_cost_;                 // Cost (seconds) to go through gate
+  float gate_penalty_;              // Penalty (seconds) to go through gate
+  float tollbooth_cost_;            // Cost (seconds) to go through toll booth
+  float tollbooth_penalty_;         // Penalty (seconds) to go through a toll booth
+  float ferry_cost_;                // Cost (seconds) to enter a ferry
+  float ferry_penalty_;             // Penalty (seconds) to enter a ferry
+  float ferry_weight_;              // Weighting to apply to ferry edges
+  float alley_penalty_;             // Penalty (seconds) to use a alley
+  float country_crossing_cost_;     // Cost (seconds) to go through toll booth
+  float country_crossing_penalty_;  // Penalty (seconds) to go across a country border
+
+  // Density factor used in edge transition costing
+  std::vector<float> trans_density_factor_;
+};
+
+// Get the access mode used by this costing method.
+inline uint32_t AutoCost::access_mode() const {
+  return baldr::kAutoAccess;
+}
+
+// Check if access is allowed on the specified edge.
+inline bool AutoCost::Allowed(const baldr::DirectedEdge* edge,
+                              const EdgeLabel& pred,
+                              const baldr::GraphTile*& tile,
+                              const baldr::GraphId& edgeid) const {
+  // TODO - obtain and check the access restrictions.
+
+  // Check access, U-turn, and simple turn restriction.
+  // Allow U-turns at dead-end nodes in case the origin is inside
+  // a not thru region and a heading selected an edge entering the
+  // region.
+  if (!(edge->forwardaccess() & baldr::kAutoAccess) ||
+      (!pred.deadend() && pred.opp_local_idx() == edge->localedgeidx()) ||
+      (pred.restrictions() & (1 << edge->localedgeidx())) ||
+       edge->surface() == baldr::Surface::kImpassable ||
+       IsUserAvoidEdge(edgeid) ||
+      (disable_destination_only_ && !pred.destonly() && edge->destonly())) {
+    return false;
+  }
+  return true;
+}
+
+// Checks if access is allowed for an edge on the reverse path (from
+// destination towards origin). Both opposing edges are provided.
+inline bool AutoCost::AllowedReverse(const baldr::DirectedEdge* edge,
+                      const EdgeLabel& pred,
+                      const baldr::DirectedEdge* opp_edge,
+                      const baldr::GraphTile*& tile,
+                      const baldr::GraphId& opp_edgeid) const {
+  // TODO - obtain and check the access restrictions.
+
+  // Check access, U-turn, and simple turn restriction.
+  // Allow U-turns at dead-end nodes.
+  if (!(opp_edge->forwardaccess() & baldr::kAutoAccess) ||
+       (!pred.deadend() && pred.opp_local_idx() == edge->localedgeidx()) ||
+       (opp_edge->restrictions() & (1 << pred.opp_local_idx())) ||
+        opp_edge->surface() == baldr::Surface::kImpassable ||
+        IsUserAvoidEdge(opp_edgeid) ||
+       (disable_destination_only_ && !pred.destonly() && opp_edge->destonly())) {
+    return false;
+  }
+  return true;
+}
+
+// Check if access is allowed at the specified node.
+inline bool AutoCost::Allowed(const baldr::NodeInfo* node) const  {
+  return (node->access() & baldr::kAutoAccess);
+}
+
+// Get the cost to traverse the edge in seconds
+inline Cost AutoCost::EdgeCost(const baldr::DirectedEdge* edge) const {
+  float factor = (edge->use() == baldr::Use::kFerry) ?
+        ferry_weight_ : density_factor_[edge->density()];
+
+  float sec = (edge->length() * speedfactor_[edge->speed()]);
+  return Cost(sec * factor, sec);
+}
+
 /**
  * Create an auto route cost method. This is generally shortest time but uses
  * hierarchies and can avoid "shortcuts" through residential areas.
@@ -6,6 +6,253 @@
 namespace valhalla {
 namespace sif {
 
+/**
+ * Derived class providing dynamic edge costing for bicycle routes.
+ */
+class BicycleCost : public DynamicCost {
+ public:
+  /**
+   * Constructor. Configuration / options for bicycle costing are provided
+   * via a property tree.
+   * @param  config  Property tree with configuration/options.
+   */
+  BicycleCost(const boost::property_tree::ptree& config);
+
+  virtual ~BicycleCost();
+
+  /**
+   * Get the access mode used by this costing method.
+   * @return  Returns access mode.
+   */
+  uint32_t access_mode() const;
+
+  /**
+   * Checks if access is allowed for the provided directed edge.
+   * This is generally based on mode of travel and the access modes
+   * allowed on the edge. However, it can be extended to exclude access
+   * based on other parameters.
+   * @param  edge     Pointer to a directed edge.
+   * @param  pred     Predecessor edge information.
+   * @param  tile     current tile
+   * @param  edgeid   edgeid that we care about
+   * @return  Returns true if access is allowed, false if not.
+   */
+  virtual bool Allowed(const baldr::DirectedEdge* edge,
+                       const EdgeLabel& pred,
+                       const baldr::GraphTile*& tile,
+                       const baldr::GraphId& edgeid) const;
+
+  /**
+   * Checks if access is allowed for an edge on the reverse path
+   * (from destination towards origin). Both opposing edges are
+   * provided.
+   * @param  edge           Pointer to a directed edge.
+   * @param  pred           Predecessor edge information.
+   * @param  opp_edge       Pointer to the opposing directed edge.
+   * @param  tile           Tile for the opposing edge (for looking
+   *                        up restrictions).
+   * @param  opp_edgeid     Opposing edge Id
+   * @return  Returns true if access is allowed, false if not.
+   */
+  virtual bool AllowedReverse(const baldr::DirectedEdge* edge,
+                 const EdgeLabel& pred,
+                 const baldr::DirectedEdge* opp_edge,
+                 const baldr::GraphTile*& tile,
+                 const baldr::GraphId& opp_edgeid) const;
+
+  /**
+   * Checks if access is allowed for the provided node. Node access can
+   * be restricted if bollards or gates are present. (TODO - others?)
+   * @param  edge  Pointer to node information.
+   * @return  Returns true if access is allowed, false if not.
+   */
+  virtual bool Allowed(const baldr::NodeInfo* node) const;
+
+  /**
+   * Get the cost to traverse the specified directed edge. Cost includes
+   * the time (seconds) to traverse the edge.
+   * @param   edge  Pointer to a directed edge.
+   * @return  Returns the cost and time (seconds)
+   */
+  virtual Cost EdgeCost(const baldr::DirectedEdge* edge) const;
+
+  /**
+   * Returns the cost to make the transition from the predecessor edge.
+   * Defaults to 0. Costing models that wish to include edge transition
+   * costs (i.e., intersection/turn costs) must override this method.
+   * @param  edge  Directed edge (the to edge)
+   * @param  node  Node (intersection) where transition occurs.
+   * @param  pred  Predecessor edge information.
+   * @return  Returns the cost and time (seconds)
+   */
+  virtual Cost TransitionCost(const baldr::DirectedEdge* edge,
+                              const baldr::NodeInfo* node,
+                              const EdgeLabel& pred) const;
+
+  /**
+   * Returns the cost to make the transition from the predecessor edge
+   * when using a reverse search (from destination towards the origin).
+   * @param  idx   Directed edge local index
+   * @param  node  Node (intersection) where transition occurs.
+   * @param  pred  the opposing current edge in the reverse tree.
+   * @param  edge  the opposing predecessor in the reverse tree
+   * @return  Returns the cost and time (seconds)
+   */
+  virtual Cost TransitionCostReverse(const uint32_t idx,
+                                     const baldr::NodeInfo* node,
+                                     const baldr::DirectedEdge* pred,
+                                     const baldr::DirectedEdge* edge) const;
+
+  /**
+   * Get the cost factor for A* heuristics. This factor is multiplied
+   * with the distance to the destination to produce an estimate of the
+   * minimum cost to the destination. The A* heuristic must underestimate the
+   * cost to the destination. So a time based estimate based on speed should
+   * assume the maximum speed is used to the destination such that the time
+   * estimate is less than the least possible time along roads.
+   */
+  virtual float AStarCostFactor() const;
+
+  /**
+   * Get the current travel type.
+   * @return  Returns the current travel type.
+   */
+  virtual uint8_t travel_type() const;
+
+ protected:
+
+  float speedfactor_[100];          // Cost factors based on speed in kph
+  float density_factor_[16];        // Density factor
+  float maneuver_penalty_;          // Penalty (seconds) when inconsistent names
+  float driveway_penalty_;          // Penalty (seconds) using a driveway
+  float gate_cost_;                 // Cost (seconds) to go through gate
+  float gate_penalty_;              // Penalty (seconds) to go through gate
+  float alley_penalty_;             // Penalty (seconds) to use a alley
+  float ferry_cost_;                // Cost (seconds) to exit a ferry
+  float ferry_penalty_;             // Penalty (seconds) to enter a ferry
+  float ferry_weight_;              // Weighting to apply to ferry edges
+  float country_crossing_cost_;     // Cost (seconds) to go through toll booth
+  float country_crossing_penalty_;  // Penalty (seconds) to go across a country border
+
+  // Density factor used in edge transition costing
+  std::vector<float> trans_density_factor_;
+
+  // Average speed (kph) on smooth, flat roads.
+  float speed_;
+
+  // Bicycle type
+  BicycleType type_;
+
+  // Minimal surface type usable by the bicycle type
+  baldr::Surface minimal_allowed_surface_;
+
+  // Surface speed factors (based on road surface type).
+  const float* surface_speed_factor_;
+
+  // Speed penalty factor. Penalties apply above a threshold
+  // (based on the use_roads factor)
+  float speedpenalty_[100];
+  uint32_t speed_penalty_threshold_;
+
+  // A measure of willingness to ride with traffic. Ranges from 0-1 with
+  // 0 being not willing at all and 1 being totally comfortable. This factor
+  // determines how much cycle lanes and paths are preferred over roads (if
+  // at all). When useroads factor is low there is more penalty to higher
+  // class and higher speed roads.
+  // Experienced road riders and messengers may use a value = 1 while
+  // beginners may use a value of 0.1 to stay away from roads unless
+  // absolutely necessary.
+  float useroads_;
+  float road_factor_;
+
+  // Elevation/grade penalty (weighting applied based on the edge's weighted
+  // grade (relative value from 0-15)
+  float grade_penalty[16];
+
+ public:
+
+  /**
+   * Returns a function/functor to be used in location searching which will
+   * exclude and allow ranking results from the search by looking at each
+   * edges attribution and suitability for use as a location by the travel
+   * mode used by the costing method. Function/functor is also used to filter
+   * edges not usable / inaccessible by bicycle.
+   */
+  virtual const EdgeFilter GetEdgeFilter() const;
+
+  /**
+   * Returns a function/functor to be used in location searching which will
+   * exclude results from the search by looking at each node's attribution
+   * @return Function to be used in filtering out nodes
+   */
+  virtual const NodeFilter GetNodeFilter() const {
+    //throw back a lambda that checks the access for this type of costing
+    return [](const baldr::NodeInfo* node) {
+      return !(node->access() & baldr::kBicycleAccess);
+    };
+  }
+};
+
+// Get the access mode used by this costing method.
+inline uint32_t BicycleCost::access_mode() const {
+  return baldr::kBicycleAccess;
+}
+
+// Check if access is allowed on the specified edge.
+inline bool BicycleCost::Allowed(const baldr::DirectedEdge* edge,
+                                 const EdgeLabel& pred,
+                                 const baldr::GraphTile*& tile,
+                                 const baldr::GraphId& edgeid) const {
+  // TODO - obtain and check the access restrictions.
+
+  // Check bicycle access and turn restrictions. Bicycles should obey
+  // vehicular turn restrictions. Allow Uturns at dead ends only.
+  // Skip impassable edges and shortcut edges.
+  if (!(edge->forwardaccess() & baldr::kBicycleAccess) || edge->is_shortcut() ||
+      (!pred.deadend() && pred.opp_local_idx() == edge->localedgeidx()) ||
+      (pred.restrictions() & (1 << edge->localedgeidx())) ||
+      IsUserAvoidEdge(edgeid)) {
+    return false;
+  }
+
+  // Disallow transit connections
+  // (except when set for multi-modal routes (FUTURE)
+  if (edge->use() == baldr::Use::kTransitConnection /* && !allow_transit_connections_*/) {
+    return false;
+  }
+
+  // Prohibit certain roads based on surface type and bicycle type
+  return edge->surface() <= minimal_allowed_surface_;
+}
+
+// Checks if access is allowed for an edge on the reverse path (from
+// destination towards origin). Both opposing edges are provided.
+inline bool BicycleCost::AllowedReverse(const baldr::DirectedEdge* edge,
+                      const EdgeLabel& pred,
+                      const baldr::DirectedEdge* opp_edge,
+                      const baldr::GraphTile*& tile,
+                      const baldr::GraphId& opp_edgeid) const {
+  // TODO - obtain and check the access restrictions.
+
+  // Check access, U-turn (allow at dead-ends), and simple turn restriction.
+  // Do not allow transit connection edges.
+  if (!(opp_edge->forwardaccess() & baldr::kBicycleAccess) ||
+        opp_edge->is_shortcut() || opp_edge->use() == baldr::Use::kTransitConnection ||
+       (!pred.deadend() && pred.opp_local_idx() == edge->localedgeidx()) ||
+       (opp_edge->restrictions() & (1 << pred.opp_local_idx())) ||
+       IsUserAvoidEdge(opp_edgeid)) {
+    return false;
+  }
+
+  // Prohibit certain roads based on surface type and bicycle type
+  return opp_edge->surface() <= minimal_allowed_surface_;
+}
+
+// Check if access is allowed at the specified node.
+inline bool BicycleCost::Allowed(const baldr::NodeInfo* node) const {
+  return (node->access() & baldr::kBicycleAccess);
+}
+
 /**
  * Create a bicyclecost
  * @param  config  Property tree with configuration / options.
@@ -0,0 +1,235 @@
+#ifndef VALHALLA_SIF_DIRECTCOST_H_
+#define VALHALLA_SIF_DIRECTCOST_H_
+
+#include <cstdint>
+#include <typeinfo>
+#include <vector>
+
+#include <valhalla/baldr/directededge.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphtile.h>
+#include <valhalla/baldr/nodeinfo.h>
+#include <valhalla/sif/dynamiccost.h>
+#include <valhalla/sif/edgelabel.h>
+#include <valhalla/sif/edgecostcache.h>
+#include <valhalla/sif/autocost.h>
+#include <valhalla/sif/bicyclecost.h>
+#include <valhalla/sif/pedestriancost.h>
+#include <valhalla/sif/truckcost.h>
+
+namespace valhalla {
+namespace sif {
+
+/**
+ * Costing types the path algorithms are instantiated on. Anything else,
+ * including classes derived from these (auto shorter, bus, hov), runs
+ * through the virtual DynamicCost interface.
+ */
+enum class DirectCostType : uint8_t {
+  kDynamic = 0,
+  kAuto = 1,
+  kBicycle = 2,
+  kPedestrian = 3,
+  kTruck = 4
+};
+
+/**
+ * Get the concrete costing type a path algorithm can be instantiated on.
+ * This is an exact type match, done once per request.
+ * @param  costing  Costing method.
+ * @return Returns the costing type or kDynamic if it is none of them.
+ */
+inline DirectCostType GetDirectCostType(const DynamicCost& costing) {
+  const std::type_info& type = typeid(costing);
+  if (type == typeid(AutoCost)) {
+    return DirectCostType::kAuto;
+  } else if (type == typeid(BicycleCost)) {
+    return DirectCostType::kBicycle;
+  } else if (type == typeid(PedestrianCost)) {
+    return DirectCostType::kPedestrian;
+  } else if (type == typeid(TruckCost)) {
+    return DirectCostType::kTruck;
+  }
+  return DirectCostType::kDynamic;
+}
+
+/**
+ * Costing calls made on the hot path of the graph expansion, bound to a
+ * concrete costing type. The calls are qualified so they are not virtual
+ * and the compiler can inline them into the expansion loop. It must only
+ * be constructed on a costing whose exact type is costing_t (see
+ * GetDirectCostType), calling an override of a derived class would be
+ * skipped otherwise. Given an edge cost cache, edge costs are read from
+ * the precomputed per tile tables where possible.
+ */
+template <class costing_t>
+class DirectCost {
+ public:
+  /**
+   * Constructor
+   * @param  costing  Costing method, its exact type must be costing_t.
+   * @param  cache    Optional edge cost cache, reset for this costing.
+   */
+  explicit DirectCost(const DynamicCost& costing,
+                      EdgeCostCache* cache = nullptr)
+      : costing_(static_cast<const costing_t&>(costing)),
+        cache_(cache) {
+    if (cache_ != nullptr) {
+      cache_->Reset(costing);
+    }
+  }
+
+  const costing_t& costing() const {
+    return costing_;
+  }
+
+  bool Allowed(const baldr::NodeInfo* node) const {
+    return costing_.costing_t::Allowed(node);
+  }
+
+  bool Allowed(const baldr::DirectedEdge* edge, const EdgeLabel& pred,
+               const baldr::GraphTile*& tile,
+               const baldr::GraphId& edgeid) const {
+    return costing_.costing_t::Allowed(edge, pred, tile, edgeid);
+  }
+
+  bool AllowedReverse(const baldr::DirectedEdge* edge, const EdgeLabel& pred,
+                      const baldr::DirectedEdge* opp_edge,
+                      const baldr::GraphTile*& tile,
+                      const baldr::GraphId& opp_edgeid) const {
+    return costing_.costing_t::AllowedReverse(edge, pred, opp_edge, tile,
+                                              opp_edgeid);
+  }
+
+  Cost EdgeCost(const baldr::DirectedEdge* edge) const {
+    return costing_.costing_t::EdgeCost(edge);
+  }
+
+  // Edge cost read from the cache when there is one, edges the costing
+  // has no access to are not cached.
+  Cost EdgeCost(const baldr::DirectedEdge* edge,
+                const baldr::GraphTile* tile) const {
+    if (cache_ != nullptr) {
+      const TileEdgeCosts* costs = cache_->Get(tile);
+      const uint32_t idx = edge - tile->directededge(0);
+      if (costs->flags(idx) & TileEdgeCosts::kCostCached) {
+        return costs->cost(idx);
+      }
+    }
+    return EdgeCost(edge);
+  }
+
+  Cost TransitionCost(const baldr::DirectedEdge* edge,
+                      const baldr::NodeInfo* node,
+                      const EdgeLabel& pred) const {
+    return costing_.costing_t::TransitionCost(edge, node, pred);
+  }
+
+  Cost TransitionCostReverse(const uint32_t idx, const baldr::NodeInfo* node,
+                             const baldr::DirectedEdge* opp_edge,
+                             const baldr::DirectedEdge* opp_pred_edge) const {
+    return costing_.costing_t::TransitionCostReverse(idx, node, opp_edge,
+                                                     opp_pred_edge);
+  }
+
+  // Almost no edge carries a complex restriction, so check the flag inline
+  // and only look the restrictions up when it is set.
+  bool Restricted(const baldr::DirectedEdge* edge, const EdgeLabel& pred,
+                  const EdgeLabelStore& edgelabels,
+                  const baldr::GraphTile*& tile,
+                  const baldr::GraphId& edgeid, const bool forward) const {
+    uint32_t restriction = forward ? edge->end_restriction() :
+                                     edge->start_restriction();
+    return (restriction & costing_.costing_t::access_mode()) &&
+           costing_.costing_t::Restricted(edge, pred, edgelabels, tile,
+                                          edgeid, forward);
+  }
+
+ private:
+  const costing_t& costing_;
+  EdgeCostCache* cache_;
+};
+
+/**
+ * Costing calls for any other costing method, made through the virtual
+ * DynamicCost interface.
+ */
+template <>
+class DirectCost<DynamicCost> {
+ public:
+  explicit DirectCost(const DynamicCost& costing,
+                      EdgeCostCache* cache = nullptr)
+      : costing_(costing),
+        cache_(cache) {
+    if (cache_ != nullptr) {
+      cache_->Reset(costing);
+    }
+  }
+
+  const DynamicCost& costing() const {
+    return costing_;
+  }
+
+  bool Allowed(const baldr::NodeInfo* node) const {
+    return costing_.Allowed(node);
+  }
+
+  bool Allowed(const baldr::DirectedEdge* edge, const EdgeLabel& pred,
+               const baldr::GraphTile*& tile,
+               const baldr::GraphId& edgeid) const {
+    return costing_.Allowed(edge, pred, tile, edgeid);
+  }
+
+  bool AllowedReverse(const baldr::DirectedEdge* edge, const EdgeLabel& pred,
+                      const baldr::DirectedEdge* opp_edge,
+                      const baldr::GraphTile*& tile,
+                      const baldr::GraphId& opp_edgeid) const {
+    return costing_.AllowedReverse(edge, pred, opp_edge, tile, opp_edgeid);
+  }
+
+  Cost EdgeCost(const baldr::DirectedEdge* edge) const {
+    return costing_.EdgeCost(edge);
+  }
+
+  // Edge cost read from the cache when there is one, edges the costing
+  // has no access to are not cached.
+  Cost EdgeCost(const baldr::DirectedEdge* edge,
+                const baldr::GraphTile* tile) const {
+    if (cache_ != nullptr) {
+      const TileEdgeCosts* costs = cache_->Get(tile);
+      const uint32_t idx = edge - tile->directededge(0);
+      if (costs->flags(idx) & TileEdgeCosts::kCostCached) {
+        return costs->cost(idx);
+      }
+    }
+    return EdgeCost(edge);
+  }
+
+  Cost TransitionCost(const baldr::DirectedEdge* edge,
+                      const baldr::NodeInfo* node,
+                      const EdgeLabel& pred) const {
+    return costing_.TransitionCost(edge, node, pred);
+  }
+
+  Cost TransitionCostReverse(const uint32_t idx, const baldr::NodeInfo* node,
+                             const baldr::DirectedEdge* opp_edge,
+                             const baldr::DirectedEdge* opp_pred_edge) const {
+    return costing_.TransitionCostReverse(idx, node, opp_edge, opp_pred_edge);
+  }
+
+  bool Restricted(const baldr::DirectedEdge* edge, const EdgeLabel& pred,
+                  const EdgeLabelStore& edgelabels,
+                  const baldr::GraphTile*& tile,
+                  const baldr::GraphId& edgeid, const bool forward) const {
+    return costing_.Restricted(edge, pred, edgelabels, tile, edgeid, forward);
+  }
+
+ private:
+  const DynamicCost& costing_;
+  EdgeCostCache* cache_;
+};
+
+}
+}
+
+#endif  // VALHALLA_SIF_DIRECTCOST_H_
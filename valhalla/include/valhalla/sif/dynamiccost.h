@@ -12,6 +12,7 @@
 
 #include <valhalla/sif/hierarchylimits.h>
 #include <valhalla/sif/edgelabel.h>
+#include <valhalla/sif/edgelabelstore.h>
 #include <valhalla/sif/costconstants.h>
 
 namespace valhalla {
@@ -205,7 +206,7 @@ class DynamicCost {
    */
   virtual bool Restricted(const baldr::DirectedEdge* edge,
                           const EdgeLabel& pred,
-                          const std::vector<EdgeLabel>& edgelabels,
+                          const EdgeLabelStore& edgelabels,
                           const baldr::GraphTile*& tile,
                           const baldr::GraphId& edgeid,
                           const bool forward) const;
@@ -353,6 +354,16 @@ class DynamicCost {
             user_avoid_edges_.find(edgeid) != user_avoid_edges_.end());
   }
 
+  /**
+   * Get a hash of the options this costing was created with, leaving out
+   * the ones that do not change edge costs (avoid edges). Two costings of
+   * the same type with the same hash compute the same edge costs.
+   * @return Returns the hash of the costing options.
+   */
+  uint64_t options_hash() const {
+    return options_hash_;
+  }
+
  protected:
   // Flag indicating whether transit connections are allowed.
   bool allow_transit_connections_;
@@ -368,6 +379,9 @@ class DynamicCost {
 
   // User specified edges to avoid
   std::unordered_set<baldr::GraphId> user_avoid_edges_;
+
+  // Hash of the costing options
+  uint64_t options_hash_;
 };
 
 typedef std::shared_ptr<DynamicCost> cost_ptr_t;
@@ -0,0 +1,120 @@
+#ifndef VALHALLA_SIF_EDGECOSTCACHE_H_
+#define VALHALLA_SIF_EDGECOSTCACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <valhalla/baldr/directededge.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphtile.h>
+#include <valhalla/sif/costconstants.h>
+#include <valhalla/sif/dynamiccost.h>
+
+namespace valhalla {
+namespace sif {
+
+/**
+ * Edge costs and access of all the directed edges of one tile for one
+ * costing profile, 9 bytes per edge. Only edges the costing has access to
+ * in at least one direction get a cost, the others fall back to the
+ * costing. Once built it is never modified, so any number of threads can
+ * read it at once.
+ */
+class TileEdgeCosts {
+ public:
+  // Per edge flags
+  static constexpr uint8_t kForwardAccess = 1;
+  static constexpr uint8_t kReverseAccess = 2;
+  static constexpr uint8_t kCostCached = 4;
+
+  /**
+   * Constructor. Computes the costs of the edges of the tile.
+   * @param  costing  Costing method.
+   * @param  tile     Tile to compute the edge costs of.
+   */
+  TileEdgeCosts(const DynamicCost& costing, const baldr::GraphTile& tile);
+
+  /**
+   * Get the flags of an edge.
+   * @param  idx  Index of the directed edge within the tile.
+   * @return Returns the flags of the edge.
+   */
+  uint8_t flags(const uint32_t idx) const {
+    return flags_[idx];
+  }
+
+  /**
+   * Get the cost of an edge, only valid if kCostCached is set.
+   * @param  idx  Index of the directed edge within the tile.
+   * @return Returns the cost of the edge.
+   */
+  const Cost& cost(const uint32_t idx) const {
+    return costs_[idx];
+  }
+
+ private:
+  std::vector<Cost> costs_;
+  std::vector<uint8_t> flags_;
+};
+
+/**
+ * Looks up the precomputed edge costs of the tiles a search expands. The
+ * costs are attached to the tiles, keyed by the costing type and options,
+ * so every request using the same costing profile shares them and they
+ * are released along with the tile when it leaves the tile cache. The
+ * first search touching a tile pays for computing the costs of all of its
+ * edges, so this only pays off for profiles that are used over and over.
+ * Not thread-safe, each thread of a search needs its own.
+ */
+class EdgeCostCache {
+ public:
+  /**
+   * Constructor
+   */
+  EdgeCostCache();
+
+  /**
+   * Sets up the cache for a new search. Forgets the tiles looked up so far,
+   * it must be called before each search.
+   * @param  costing  Costing method of the search.
+   */
+  void Reset(const DynamicCost& costing);
+
+  /**
+   * Get the edge costs of a tile, computing them if no search did so far.
+   * @param  tile  Tile, it must not be null.
+   * @return Returns the edge costs of the tile.
+   */
+  const TileEdgeCosts* Get(const baldr::GraphTile* tile) {
+    // Most lookups are for the tile the expansion is in. Tiles are not
+    // evicted during a search so the pointer identifies the tile.
+    if (tile == last_tile_) {
+      return last_costs_;
+    }
+    return Load(tile);
+  }
+
+ private:
+  // Find or compute the edge costs of a tile that was not the last one
+  const TileEdgeCosts* Load(const baldr::GraphTile* tile);
+
+  const DynamicCost* costing_;
+
+  // Key the costs are attached to tiles with
+  uint64_t key_;
+
+  // Edge costs of the tiles looked up by this search, by tile id, so the
+  // attachments of a tile are only locked once per search
+  std::unordered_map<baldr::GraphId, std::shared_ptr<const TileEdgeCosts>> tiles_;
+
+  // Tile looked up last
+  const baldr::GraphTile* last_tile_;
+  const TileEdgeCosts* last_costs_;
+};
+
+}
+}
+
+#endif  // VALHALLA_SIF_EDGECOSTCACHE_H_
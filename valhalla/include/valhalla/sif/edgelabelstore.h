@@ -0,0 +1,148 @@
+#ifndef VALHALLA_SIF_EDGELABELSTORE_H_
+#define VALHALLA_SIF_EDGELABELSTORE_H_
+
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <valhalla/sif/edgelabel.h>
+
+namespace valhalla {
+namespace sif {
+
+// Edge labels are stored in blocks of 2^kEdgeLabelBlockBits labels
+constexpr uint32_t kEdgeLabelBlockBits = 14;
+constexpr uint32_t kEdgeLabelBlockSize = 1 << kEdgeLabelBlockBits;
+constexpr uint32_t kEdgeLabelBlockMask = kEdgeLabelBlockSize - 1;
+
+// Max number of free blocks each thread keeps for reuse (about 75 MB)
+constexpr uint32_t kMaxPooledEdgeLabelBlocks = 64;
+
+/**
+ * Edge labels of a path search, indexed like a vector. Labels live in fixed
+ * size blocks so growing never copies the labels already stored and never
+ * needs twice the memory, which matters for long routes with millions of
+ * labels. References to labels stay valid until the store is cleared.
+ * Cleared blocks go to a pool of the calling thread and are handed to the
+ * next store that grows on that thread, so label memory is reused from
+ * request to request and shared by all path algorithms of a thread.
+ */
+class EdgeLabelStore {
+ public:
+  /**
+   * Constructor
+   */
+  EdgeLabelStore() : size_(0) {
+  }
+
+  /**
+   * Destructor. Returns the blocks to the pool.
+   */
+  ~EdgeLabelStore() {
+    clear();
+  }
+
+  EdgeLabelStore(const EdgeLabelStore&) = delete;
+  EdgeLabelStore& operator=(const EdgeLabelStore&) = delete;
+
+  EdgeLabelStore(EdgeLabelStore&& other) noexcept
+      : blocks_(std::move(other.blocks_)),
+        size_(other.size_) {
+    other.blocks_.clear();
+    other.size_ = 0;
+  }
+
+  EdgeLabelStore& operator=(EdgeLabelStore&& other) noexcept {
+    if (this != &other) {
+      clear();
+      blocks_.swap(other.blocks_);
+      size_ = other.size_;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * Get the number of labels.
+   * @return Returns the number of labels.
+   */
+  uint32_t size() const {
+    return size_;
+  }
+
+  /**
+   * Is the store empty?
+   * @return Returns true if there are no labels.
+   */
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  EdgeLabel& operator[](const uint32_t idx) {
+    return blocks_[idx >> kEdgeLabelBlockBits][idx & kEdgeLabelBlockMask];
+  }
+
+  const EdgeLabel& operator[](const uint32_t idx) const {
+    return blocks_[idx >> kEdgeLabelBlockBits][idx & kEdgeLabelBlockMask];
+  }
+
+  EdgeLabel& back() {
+    return (*this)[size_ - 1];
+  }
+
+  const EdgeLabel& back() const {
+    return (*this)[size_ - 1];
+  }
+
+  /**
+   * Construct a label at the end of the store.
+   * @param  args  Arguments of an EdgeLabel constructor.
+   */
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    if ((size_ & kEdgeLabelBlockMask) == 0 &&
+        (size_ >> kEdgeLabelBlockBits) == blocks_.size()) {
+      blocks_.push_back(AcquireBlock());
+    }
+    new (&(*this)[size_]) EdgeLabel(std::forward<Args>(args)...);
+    size_++;
+  }
+
+  /**
+   * Add a label at the end of the store.
+   * @param  label  Label to add.
+   */
+  void push_back(const EdgeLabel& label) {
+    emplace_back(label);
+  }
+
+  /**
+   * Remove all labels. The blocks go back to the pool of the calling thread,
+   * stores filled on a worker thread should be cleared on that worker.
+   */
+  void clear();
+
+  /**
+   * Get the memory used by the labels.
+   * @return Returns the size in bytes.
+   */
+  size_t MemoryUse() const {
+    return blocks_.size() * kEdgeLabelBlockSize * sizeof(EdgeLabel) +
+           blocks_.capacity() * sizeof(EdgeLabel*);
+  }
+
+ private:
+  // Get a block from the pool of the calling thread or allocate one
+  static EdgeLabel* AcquireBlock();
+
+  // Blocks of labels. EdgeLabel is trivially destructible, so labels are
+  // constructed in place and never destroyed.
+  std::vector<EdgeLabel*> blocks_;
+  uint32_t size_;
+};
+
+}
+}
+
+#endif  // VALHALLA_SIF_EDGELABELSTORE_H_
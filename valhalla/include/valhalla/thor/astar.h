@@ -11,6 +11,7 @@
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/pathlocation.h>
 #include <valhalla/baldr/double_bucket_queue.h>
+#include <valhalla/sif/directcost.h>
 #include <valhalla/sif/dynamiccost.h>
 #include <valhalla/sif/edgelabel.h>
 #include <valhalla/sif/hierarchylimits.h>
@@ -77,7 +78,7 @@ class AStarPathAlgorithm : public PathAlgorithm {
   AStarHeuristic astarheuristic_;
 
   // Vector of edge labels (requires access by index).
-  std::vector<sif::EdgeLabel> edgelabels_;
+  sif::EdgeLabelStore edgelabels_;
 
   // Adjacency list - approximate double bucket sort
   std::shared_ptr<baldr::DoubleBucketQueue> adjacencylist_;
@@ -97,6 +98,22 @@ class AStarPathAlgorithm : public PathAlgorithm {
   virtual void Init(const PointLL& origll, const PointLL& destll,
             const std::shared_ptr<sif::DynamicCost>& costing);
 
+  /**
+   * Expand from the seeded adjacency list until a destination edge is
+   * settled. Templated on the costing so the costing calls in the
+   * expansion can be inlined.
+   * @param  costing      Costing calls bound to the costing method.
+   * @param  origin       Origin location
+   * @param  dest         Destination location
+   * @param  graphreader  Graph reader for accessing routing graph.
+   * @param  mindist      Distance from the origin to the destination.
+   * @return Returns the path edges or an empty path if no route is found.
+   */
+  template <class costing_t>
+  std::vector<PathInfo> Expand(const sif::DirectCost<costing_t>& costing,
+          const baldr::PathLocation& origin, const baldr::PathLocation& dest,
+          baldr::GraphReader& graphreader, float mindist);
+
   /**
    * Convenience method to add an edge to the adjacency list and temporarily
    * label it. This must be called before adding the edge label (so it uses
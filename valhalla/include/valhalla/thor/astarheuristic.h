@@ -4,6 +4,8 @@
 #include <valhalla/midgard/distanceapproximator.h>
 #include <valhalla/midgard/pointll.h>
 #include <valhalla/midgard/util.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/thor/landmarks.h>
 
 namespace valhalla {
 namespace thor {
@@ -35,6 +37,24 @@ class AStarHeuristic {
   void Init(const midgard::PointLL& ll, const float factor) {
     distapprox_.SetTestPoint(ll);
     costfactor_ = factor;
+    landmarks_.Init(nullptr, {}, true);
+  }
+
+  /**
+   * Tighten the heuristic with landmark lower bounds of the distance along
+   * the graph (see Landmarks). Call after Init. The cost factor must hold
+   * for every meter of any edge the costing can take, as it does for the
+   * straight line distance.
+   * @param  landmarks   Landmarks built for the access of the costing.
+   * @param  targets     Nodes the destination edges start at, or the
+   *                     origin edges end at for a reverse search.
+   * @param  to_targets  true if the search heads to the targets (forward
+   *                     search), false if it comes from them (reverse).
+   */
+  void SetLandmarks(const Landmarks* landmarks,
+                    const std::vector<baldr::GraphId>& targets,
+                    const bool to_targets) {
+    landmarks_.Init(landmarks, targets, to_targets);
   }
 
   /**
@@ -79,10 +99,30 @@ class AStarHeuristic {
     return  dist * costfactor_;
   }
 
+  /**
+   * Get the A* heuristic of a node given its lat,lng. The landmark bound
+   * is used where it is larger than the straight line distance. Also
+   * return the straight line distance via an argument.
+   * @param   ll    Lat,lng of the node.
+   * @param   node  Node.
+   * @param   distance  Distance (meters) to the destination.
+   * @return  Returns an estimate of the cost to the destination.
+   *          For A* shortest path this MUST UNDERESTIMATE the true cost.
+   */
+  float Get(const midgard::PointLL& ll, const baldr::GraphId& node,
+            float& dist) const {
+    dist = sqrtf(distapprox_.DistanceSquared(ll));
+    if (landmarks_.enabled()) {
+      return std::max(dist, landmarks_.Get(node)) * costfactor_;
+    }
+    return dist * costfactor_;
+  }
+
  private:
   midgard::DistanceApproximator distapprox_;  // Distance approximation
   float costfactor_;    // Cost factor - ensures the cost estimate
                         // underestimates the true cost.
+  LandmarkBounds landmarks_;  // Landmark lower bounds, if enabled
 };
 
 }
@@ -8,11 +8,13 @@
 #include <memory>
 
 #include <valhalla/baldr/double_bucket_queue.h>
+#include <valhalla/sif/directcost.h>
 #include <valhalla/sif/edgelabel.h>
 #include <valhalla/sif/hierarchylimits.h>
 #include <valhalla/thor/pathalgorithm.h>
 #include <valhalla/thor/astarheuristic.h>
 #include <valhalla/thor/edgestatus.h>
+#include <valhalla/thor/landmarks.h>
 
 namespace valhalla {
 namespace thor {
@@ -63,6 +65,15 @@ class BidirectionalAStar : public PathAlgorithm {
    */
   void Clear();
 
+  /**
+   * Use landmark distances to tighten the A* heuristics of costings whose
+   * access the landmarks were built for.
+   * @param  landmarks  Landmarks, nullptr to only use straight line distances.
+   */
+  void set_landmarks(const std::shared_ptr<const Landmarks>& landmarks) {
+    landmarks_ = landmarks;
+  }
+
  protected:
   // Access mode used by the costing method
   uint32_t access_mode_;
@@ -84,9 +95,12 @@ class BidirectionalAStar : public PathAlgorithm {
   AStarHeuristic astarheuristic_forward_;
   AStarHeuristic astarheuristic_reverse_;
 
+  // Landmarks for the A* heuristics, if any
+  std::shared_ptr<const Landmarks> landmarks_;
+
   // Vector of edge labels (requires access by index).
-  std::vector<sif::EdgeLabel> edgelabels_forward_;
-  std::vector<sif::EdgeLabel> edgelabels_reverse_;
+  sif::EdgeLabelStore edgelabels_forward_;
+  sif::EdgeLabelStore edgelabels_reverse_;
 
   // Adjacency list - approximate double bucket sort
   std::shared_ptr<baldr::DoubleBucketQueue> adjacencylist_forward_;
@@ -109,10 +123,37 @@ class BidirectionalAStar : public PathAlgorithm {
    */
   void Init(const PointLL& origll, const PointLL& destll);
 
+  /**
+   * Set the landmark targets of the A* heuristics if there are landmarks
+   * for the access of the costing. The forward search heads to the nodes
+   * the destination edges start at, the reverse search to the nodes the
+   * origin edges end at.
+   * @param  graphreader  Graph tile reader.
+   * @param  origin       Origin location.
+   * @param  dest         Destination location.
+   */
+  void SetLandmarks(baldr::GraphReader& graphreader,
+                    const baldr::PathLocation& origin,
+                    const baldr::PathLocation& dest);
+
+  /**
+   * Run the search from the seeded adjacency lists until the forward and
+   * reverse trees meet. Templated on the costing so the costing calls in
+   * the expansion can be inlined.
+   * @param  costing      Costing calls bound to the costing method.
+   * @param  graphreader  Graph tile reader.
+   * @return Returns the path edges or an empty path if no route is found.
+   */
+  template <class costing_t>
+  std::vector<PathInfo> Expand(const sif::DirectCost<costing_t>& costing,
+                               baldr::GraphReader& graphreader);
+
   /**
    * Expand from the node along the forward search path.
    */
-  void ExpandForward(baldr::GraphReader& graphreader,
+  template <class costing_t>
+  void ExpandForward(const sif::DirectCost<costing_t>& costing,
+           baldr::GraphReader& graphreader,
            const baldr::GraphTile* tile,
            const baldr::GraphId& node, const baldr::NodeInfo* nodeinfo,
            sif::EdgeLabel& pred, const uint32_t pred_idx,
@@ -121,7 +162,9 @@ class BidirectionalAStar : public PathAlgorithm {
   /**
    * Expand from the node along the reverse search path.
    */
-  void ExpandReverse(baldr::GraphReader& graphreader,
+  template <class costing_t>
+  void ExpandReverse(const sif::DirectCost<costing_t>& costing,
+           baldr::GraphReader& graphreader,
            const baldr::GraphTile* tile,
            const baldr::GraphId& node, const baldr::NodeInfo* nodeinfo,
            sif::EdgeLabel& pred, const uint32_t pred_idx,
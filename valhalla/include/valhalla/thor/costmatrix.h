@@ -7,13 +7,17 @@
 #include <unordered_map>
 #include <utility>
 #include <memory>
+#include <mutex>
 #include <cstdint>
 
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/pathlocation.h>
 #include <valhalla/baldr/double_bucket_queue.h>
+#include <valhalla/midgard/worker_pool.h>
+#include <valhalla/sif/directcost.h>
 #include <valhalla/sif/dynamiccost.h>
+#include <valhalla/sif/edgecostcache.h>
 #include <valhalla/sif/edgelabel.h>
 #include <valhalla/thor/edgestatus.h>
 
@@ -101,6 +105,20 @@ class CostMatrix {
    */
   CostMatrix(float initial_cost_threshold = kCostThresholdDefault);
 
+  /**
+   * Constructor with cost threshold and graph readers for worker threads.
+   * The source and target searches are then spread over the calling thread
+   * and one additional thread per reader. The threads are started here and
+   * kept until the matrix is destroyed, so keep the matrix around to reuse
+   * them. The readers must not be used by anything else during
+   * SourceToTarget. They should share a SynchronizedTileCache so tiles are
+   * only loaded once.
+   * @param initial_cost_threshold  Cost threshold for termination.
+   * @param worker_readers          Graph readers for the worker threads.
+   */
+  CostMatrix(float initial_cost_threshold,
+             const std::vector<std::shared_ptr<baldr::GraphReader>>& worker_readers);
+
   /**
    * Forms a time distance matrix from the set of source locations
    * to the set of target locations.
@@ -124,6 +142,15 @@ class CostMatrix {
    */
   void Clear();
 
+  /**
+   * Enable reading edge costs from per tile tables precomputed once per
+   * costing profile (see sif::EdgeCostCache).
+   * @param  enable  true to use the edge cost cache
+   */
+  void set_edge_cost_cache(const bool enable) {
+    use_edge_cost_cache_ = enable;
+  }
+
  protected:
   // Access mode used by the costing method
   uint32_t access_mode_;
@@ -151,19 +178,38 @@ class CostMatrix {
   // source location (forward traversal)
   std::vector<std::vector<sif::HierarchyLimits>> source_hierarchy_limits_;
   std::vector<std::shared_ptr<baldr::DoubleBucketQueue>> source_adjacency_;
-  std::vector<std::vector<sif::EdgeLabel>> source_edgelabel_;
+  std::vector<sif::EdgeLabelStore> source_edgelabel_;
   std::vector<EdgeStatus> source_edgestatus_;
 
   // Adjacency lists, EdgeLabels, EdgeStatus, and hierarchy limits for each
   // target location (reverse traversal)
   std::vector<std::vector<sif::HierarchyLimits>> target_hierarchy_limits_;
   std::vector<std::shared_ptr<baldr::DoubleBucketQueue>> target_adjacency_;
-  std::vector<std::vector<sif::EdgeLabel>> target_edgelabel_;
+  std::vector<sif::EdgeLabelStore> target_edgelabel_;
   std::vector<EdgeStatus> target_edgestatus_;
 
   // Mark each target edge with a list of target indexes that have reached it
   std::unordered_map<baldr::GraphId, std::vector<uint32_t>> targets_;
 
+  // Edges reached by each target since targets_ was last updated. Backward
+  // searches only record here so they can run concurrently.
+  std::vector<std::vector<baldr::GraphId>> target_reached_;
+
+  // Graph readers for the worker threads (empty if single threaded)
+  std::vector<std::shared_ptr<baldr::GraphReader>> worker_readers_;
+
+  // Threads running the searches, one per worker reader besides the
+  // calling thread
+  std::unique_ptr<midgard::WorkerPool> workers_;
+
+  // Edge cost caches, one per worker, only used if enabled
+  bool use_edge_cost_cache_;
+  std::vector<sif::EdgeCostCache> edge_cost_caches_;
+
+  // Guards the source and target status, which searches on other threads
+  // update when they find connections
+  std::mutex status_mutex_;
+
   // List of best connections found so far
   std::vector<BestCandidate> best_connection_;
 
@@ -178,28 +224,57 @@ class CostMatrix {
       const std::vector<baldr::PathLocation>& source_location_list,
       const std::vector<baldr::PathLocation>& target_location_list);
 
+  /**
+   * Add the edges reached by the backward searches since the last call
+   * to the target edge markings.
+   */
+  void MarkTargetEdges();
+
+  /**
+   * Get the memory used by the edge labels of all the searches.
+   * @return Returns the size in bytes.
+   */
+  size_t EdgeLabelMemoryUse() const;
+
+  /**
+   * Run the forward and backward searches until all of them are done.
+   * Templated on the costing so the costing calls in the expansion can be
+   * inlined.
+   * @param  costing      Costing calls bound to the costing method.
+   * @param  graphreader  Graph reader for accessing routing graph.
+   */
+  template <class costing_t>
+  void Expand(const sif::DirectCost<costing_t>& costing,
+              baldr::GraphReader& graphreader);
+
   /**
    * Iterate the forward search from the source/origin location.
+   * @param  costing      Costing calls bound to the costing method.
    * @param  index        Index of the source location.
    * @param  n            Iteration counter.
    * @param  graphreader  Graph reader for accessing routing graph.
-   * @param  costing      Costing methods.
    */
-  void ForwardSearch(const uint32_t index, const uint32_t n,
+  template <class costing_t>
+  void ForwardSearch(const sif::DirectCost<costing_t>& costing,
+                     const uint32_t index, const uint32_t n,
                      baldr::GraphReader& graphreader);
 
-  void ExpandForward(baldr::GraphReader& graphreader,
+  template <class costing_t>
+  void ExpandForward(const sif::DirectCost<costing_t>& costing,
+                     baldr::GraphReader& graphreader,
                      const baldr::GraphTile* tile,
                      const baldr::GraphId& node,
                      const baldr::NodeInfo* nodeinfo,
                      sif::EdgeLabel& pred, const uint32_t pred_idx,
                      std::vector<sif::HierarchyLimits>& hierarchy_limits,
-                     std::vector<sif::EdgeLabel>& edgelabels,
+                     sif::EdgeLabelStore& edgelabels,
                      EdgeStatus& edgestate,
                      std::shared_ptr<baldr::DoubleBucketQueue>& adj,
                      const bool from_transition);
 
-  void ExpandReverse(baldr::GraphReader& graphreader,
+  template <class costing_t>
+  void ExpandReverse(const sif::DirectCost<costing_t>& costing,
+                     baldr::GraphReader& graphreader,
                      const baldr::GraphTile* tile,
                      const baldr::GraphId& node,
                      const baldr::NodeInfo* nodeinfo,
@@ -207,7 +282,7 @@ class CostMatrix {
                      sif::EdgeLabel& pred, const uint32_t pred_idx,
                      const baldr::DirectedEdge* opp_pred_edge,
                      std::vector<sif::HierarchyLimits>& hierarchy_limits,
-                     std::vector<sif::EdgeLabel>& edgelabels,
+                     sif::EdgeLabelStore& edgelabels,
                      EdgeStatus& edgestate,
                      std::shared_ptr<baldr::DoubleBucketQueue>& adj,
                      const bool from_transition);
@@ -231,10 +306,13 @@ class CostMatrix {
 
   /**
    * Iterate the backward search from the target/destination location.
+   * @param  costing      Costing calls bound to the costing method.
    * @param  index        Index of the target location.
    * @param  graphreader  Graph reader for accessing routing graph.
    */
-  void BackwardSearch(const uint32_t index,
+  template <class costing_t>
+  void BackwardSearch(const sif::DirectCost<costing_t>& costing,
+                      const uint32_t index,
                       baldr::GraphReader& graphreader);
 
   /**
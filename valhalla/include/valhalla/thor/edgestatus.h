@@ -1,14 +1,18 @@
 #ifndef VALHALLA_THOR_EDGESTATUS_H_
 #define VALHALLA_THOR_EDGESTATUS_H_
 
+#include <algorithm>
+#include <limits>
 #include <unordered_map>
+#include <vector>
 #include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphtile.h>
 
 namespace valhalla {
 namespace thor {
 
-// Default size to reserve for the EdgeStatus unordered map
-constexpr uint32_t kDefaultEdgeStatusSize = 2000000;
+// Tile index used when no tile has been looked up yet
+constexpr uint32_t kInvalidTile = std::numeric_limits<uint32_t>::max();
 
 // Edge label status
 enum class EdgeSet : uint8_t {
@@ -48,16 +52,19 @@ struct EdgeStatusInfo {
 
 /**
  * Class to define / lookup the status and index of an edge in the edge label
- * list during shortest path algorithms.
+ * list during shortest path algorithms. Status is kept in a dense array per
+ * tile, indexed by the directed edge index within the tile. Arrays are
+ * allocated the first time an edge of a tile is set, sized from the tile's
+ * directed edge count when the tile is known.
  */
 class EdgeStatus {
  public:
   /**
-   * Constructor given an initial size.
-   * @param  sz  Size to reserve for edgestatus unordered map.
+   * Constructor.
    */
-  EdgeStatus(const uint32_t sz = kDefaultEdgeStatusSize) {
-    edgestatus_.reserve(sz);
+  EdgeStatus()
+      : last_tile_id_(kInvalidTile),
+        last_tile_(nullptr) {
   }
 
   /**
@@ -65,6 +72,8 @@ class EdgeStatus {
    */
   void Init() {
     edgestatus_.clear();
+    last_tile_id_ = kInvalidTile;
+    last_tile_ = nullptr;
   }
 
   /**
@@ -72,10 +81,12 @@ class EdgeStatus {
    * @param  edgeid   GraphId of the directed edge to set.
    * @param  set      Label set for this directed edge.
    * @param  index    Index of the edge label.
+   * @param  tile     Tile of the directed edge (optional). Used to size the
+   *                  status array of the tile in one go.
    */
   void Set(const baldr::GraphId& edgeid, const EdgeSet set,
-           const uint32_t index) {
-    edgestatus_[edgeid.value] = { set, index };
+           const uint32_t index, const baldr::GraphTile* tile = nullptr) {
+    Status(edgeid, tile) = { set, index };
   }
 
   /**
@@ -84,7 +95,7 @@ class EdgeStatus {
    * @param  set      Label set for this directed edge.
    */
   void Update(const baldr::GraphId& edgeid, const EdgeSet set) {
-    edgestatus_[edgeid.value].status.set = static_cast<uint32_t>(set);
+    Status(edgeid, nullptr).status.set = static_cast<uint32_t>(set);
   }
 
   /**
@@ -92,15 +103,72 @@ class EdgeStatus {
    * @param   edgeid  GraphId of the directed edge.
    * @return  Returns edge status info.
    */
+  EdgeStatusInfo Get(const baldr::GraphId& edgeid) {
+    const std::vector<EdgeStatusInfo>* tile = Find(TileIndex(edgeid));
+    return (tile == nullptr || edgeid.id() >= tile->size()) ?
+              EdgeStatusInfo() : (*tile)[edgeid.id()];
+  }
+
+  /**
+   * Get the status info of a directed edge given its GraphId. Does not
+   * touch the last tile lookup so it is safe to call from several threads
+   * as long as nobody modifies the status concurrently.
+   * @param   edgeid  GraphId of the directed edge.
+   * @return  Returns edge status info.
+   */
   EdgeStatusInfo Get(const baldr::GraphId& edgeid) const {
-    auto p = edgestatus_.find(edgeid.value);
-    return (p == edgestatus_.end()) ? EdgeStatusInfo() : p->second;
+    auto tile = edgestatus_.find(TileIndex(edgeid));
+    return (tile == edgestatus_.end() || edgeid.id() >= tile->second.size()) ?
+              EdgeStatusInfo() : tile->second[edgeid.id()];
   }
 
  private:
-  // Map to store the status and index of GraphIds that have been encountered.
-  // Any unreached edges are not added to the map.
-  std::unordered_map<uint64_t, EdgeStatusInfo> edgestatus_;
+  // Tile id and level combined into a single key
+  static uint32_t TileIndex(const baldr::GraphId& edgeid) {
+    return static_cast<uint32_t>(edgeid.Tile_Base().value);
+  }
+
+  // Find the status array of a tile, remembering the last one looked up
+  // since consecutive accesses mostly hit the same tile
+  std::vector<EdgeStatusInfo>* Find(const uint32_t tile_index) {
+    if (tile_index != last_tile_id_) {
+      auto p = edgestatus_.find(tile_index);
+      if (p == edgestatus_.end()) {
+        return nullptr;
+      }
+      last_tile_id_ = tile_index;
+      last_tile_ = &p->second;
+    }
+    return last_tile_;
+  }
+
+  // Get the status of an edge, allocating or growing the tile's status
+  // array as needed
+  EdgeStatusInfo& Status(const baldr::GraphId& edgeid, const baldr::GraphTile* tile) {
+    uint32_t tile_index = TileIndex(edgeid);
+    std::vector<EdgeStatusInfo>* statuses = Find(tile_index);
+    if (statuses == nullptr) {
+      statuses = &edgestatus_[tile_index];
+      if (tile != nullptr && tile->id() == edgeid.Tile_Base()) {
+        statuses->resize(tile->header()->directededgecount());
+      }
+      last_tile_id_ = tile_index;
+      last_tile_ = statuses;
+    }
+    if (edgeid.id() >= statuses->size()) {
+      statuses->resize(std::max<size_t>(edgeid.id() + 1, statuses->size() * 2));
+    }
+    return (*statuses)[edgeid.id()];
+  }
+
+  // Status arrays per tile, indexed by the directed edge index. Tiles that
+  // have not been encountered have no array. Unreached edges have the
+  // default (unreached) status.
+  std::unordered_map<uint32_t, std::vector<EdgeStatusInfo>> edgestatus_;
+
+  // Last tile looked up
+  uint32_t last_tile_id_;
+  std::vector<EdgeStatusInfo>* last_tile_;
 };
 
 }
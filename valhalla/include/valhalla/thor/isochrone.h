@@ -8,6 +8,7 @@
 #include <memory>
 
 #include <valhalla/midgard/gridded_data.h>
+#include <valhalla/midgard/worker_pool.h>
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/pathlocation.h>
@@ -31,6 +32,17 @@ class Isochrone {
    */
   Isochrone();
 
+  /**
+   * Constructor with graph readers for worker threads. The edge shapes are
+   * then rasterized into the isotile on the calling thread and one
+   * additional thread per reader. The threads are started here and kept
+   * until the isochrone is destroyed. The readers must not be used by
+   * anything else while computing and should share a SynchronizedTileCache
+   * so tiles are only loaded once.
+   * @param  worker_readers  Graph readers for the worker threads.
+   */
+  Isochrone(const std::vector<std::shared_ptr<baldr::GraphReader>>& worker_readers);
+
   /**
    * Destructor
    */
@@ -95,7 +107,7 @@ class Isochrone {
   uint32_t tile_creation_date_; // Tile creation date
 
   // Vector of edge labels (requires access by index).
-  std::vector<sif::EdgeLabel> edgelabels_;
+  sif::EdgeLabelStore edgelabels_;
 
   // Adjacency list - approximate double bucket sort
   std::shared_ptr<baldr::DoubleBucketQueue> adjacencylist_;
@@ -106,6 +118,24 @@ class Isochrone {
   // Isochrone gridded time data
   std::shared_ptr<GriddedData<midgard::PointLL> > isotile_;
 
+  // An edge settled by the expansion that still has to be marked in the
+  // isotile, along with the times at its begin and end node.
+  struct SettledEdge {
+    baldr::GraphId edgeid;
+    float secs0;
+    float secs1;
+  };
+
+  // Settled edges to mark in the isotile once the expansion is done
+  std::vector<SettledEdge> settled_edges_;
+
+  // Graph readers for the worker threads (empty if single threaded)
+  std::vector<std::shared_ptr<baldr::GraphReader>> worker_readers_;
+
+  // Threads rasterizing the edge shapes, one per worker reader besides the
+  // calling thread
+  std::unique_ptr<midgard::WorkerPool> workers_;
+
   /**
    * Initialize prior to computing the isocrhones. Creates adjacency list,
    * edgestatus support, and reserves edgelabels.
@@ -126,6 +156,7 @@ class Isochrone {
   /**
    * Updates the isotile using the edge information from the predecessor edge
    * label. This is the edge being settled (lowest cost found to the edge).
+   * The edge is queued and its shape is marked by FillIsoTile.
    * @param  pred         Predecessor edge label (edge being settled).
    * @param  graphreader  Graph reader
    * @param  ll           Lat,lon at the end of the edge.
@@ -135,6 +166,25 @@ class Isochrone {
                      baldr::GraphReader& graphreader,
                      const midgard::PointLL& ll);
 
+  /**
+   * Marks the shapes of all settled edges in the isotile. With worker
+   * threads each worker marks a share of the edges in its own copy of the
+   * grid and the copies are merged by taking the lowest time per cell.
+   * @param  graphreader  Graph reader
+   * @return Returns the isotile.
+   */
+  std::shared_ptr<const GriddedData<midgard::PointLL> > FillIsoTile(
+               baldr::GraphReader& graphreader);
+
+  /**
+   * Marks the shape of a settled edge in a grid.
+   * @param  settled      Settled edge.
+   * @param  graphreader  Graph reader
+   * @param  grid         Grid to mark.
+   */
+  void MarkEdge(const SettledEdge& settled, baldr::GraphReader& graphreader,
+                GriddedData<midgard::PointLL>& grid) const;
+
   /**
    * Check if edge is temporarily labeled and this path has less cost. If
    * less cost the predecessor is updated and the sort cost is decremented
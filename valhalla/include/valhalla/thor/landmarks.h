@@ -0,0 +1,225 @@
+#ifndef VALHALLA_THOR_LANDMARKS_H_
+#define VALHALLA_THOR_LANDMARKS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
+
+namespace valhalla {
+namespace thor {
+
+// Distance of a node a landmark does not reach or is not reached from
+constexpr uint32_t kLandmarkUnreached = std::numeric_limits<uint32_t>::max();
+
+// Default number of landmarks
+constexpr uint32_t kDefaultLandmarkCount = 8;
+
+/**
+ * Shortest path distances (meters) between a few landmark nodes and every
+ * node of the graph, for ALT (A*, landmarks, triangle inequality) lower
+ * bounds. By the triangle inequality the distance from a node v to a node
+ * t is at least d(L,t) - d(L,v) and d(v,L) - d(t,L) for any landmark L,
+ * which is much tighter than the straight line distance on long routes.
+ * Distances are computed over the edges with the given access, ignoring
+ * restrictions and turn costs, so they underestimate the distance along
+ * any path a costing using a subset of that access can take. They are
+ * computed once over the tile set, stored in a sidecar file next to the
+ * tiles and loaded read only, so any number of threads can use them.
+ *
+ * Each node stores its distance from and to every landmark, 8 bytes per
+ * landmark and node.
+ */
+class Landmarks {
+ public:
+  /**
+   * Choose landmarks spread over the graph and compute the distances of
+   * all the nodes of the tile set. The first landmark is the node farthest
+   * from a node of the highway level, each next one is the node farthest
+   * from the landmarks chosen so far.
+   * @param  reader       Graph reader for the tile set.
+   * @param  count        Number of landmarks.
+   * @param  access_mode  Access (bit mask) of the edges to follow.
+   * @return Returns the landmarks.
+   */
+  static std::shared_ptr<Landmarks> Build(baldr::GraphReader& reader,
+                                          const uint32_t count,
+                                          const uint32_t access_mode);
+
+  /**
+   * Load landmarks from a file. Throws if the file can not be read.
+   * @param  file  File written by Save.
+   * @return Returns the landmarks.
+   */
+  static std::shared_ptr<Landmarks> Load(const std::string& file);
+
+  /**
+   * Write the landmarks to a file. Throws if the file can not be written.
+   * @param  file  File to write.
+   */
+  void Save(const std::string& file) const;
+
+  /**
+   * Get the number of landmarks.
+   * @return Returns the number of landmarks.
+   */
+  uint32_t count() const {
+    return count_;
+  }
+
+  /**
+   * Get the access of the edges the distances follow.
+   * @return Returns the access (bit mask).
+   */
+  uint32_t access_mode() const {
+    return access_mode_;
+  }
+
+  /**
+   * Get the landmark nodes.
+   * @return Returns the landmark nodes.
+   */
+  const std::vector<baldr::GraphId>& landmarks() const {
+    return landmarks_;
+  }
+
+  /**
+   * Can the distances bound the costs of a costing? They can if the edges
+   * the costing has access to are all followed by the distances.
+   * @param  access_mode  Access mode of the costing.
+   * @return Returns true if the costing can use the landmarks.
+   */
+  bool Supports(const uint32_t access_mode) const {
+    return (access_mode & ~access_mode_) == 0;
+  }
+
+  /**
+   * Get the distances of a node, from each landmark followed by to each
+   * landmark. Either may be kLandmarkUnreached.
+   * @param  node  Node.
+   * @return Returns the 2 * count() distances or nullptr if the node is
+   *         not in the tile set the landmarks were built on.
+   */
+  const uint32_t* distances(const baldr::GraphId& node) const {
+    const uint64_t idx = index(node);
+    return idx == kNoNode ? nullptr : &distances_[idx * 2 * count_];
+  }
+
+ private:
+  // Index of nodes, and offset of tiles, not in the tile set
+  static constexpr uint64_t kNoNode = std::numeric_limits<uint64_t>::max();
+
+  Landmarks() : count_(0), access_mode_(0) {
+  }
+
+  // Get the index of a node within the tile set
+  uint64_t index(const baldr::GraphId& node) const {
+    if (node.level() >= tile_offsets_.size() ||
+        node.tileid() >= tile_offsets_[node.level()].size()) {
+      return kNoNode;
+    }
+    const uint64_t offset = tile_offsets_[node.level()][node.tileid()];
+    return offset == kNoNode ? kNoNode : offset + node.id();
+  }
+
+  // Shortest distances of all the nodes from (or to) a node
+  void Distances(baldr::GraphReader& reader, const baldr::GraphId& source,
+                 const bool reverse, std::vector<uint32_t>& dist) const;
+
+  // Set the tiles and index them by level and tile id. Returns the number
+  // of nodes.
+  uint64_t SetTiles(const std::vector<std::pair<baldr::GraphId, uint32_t>>& tiles);
+
+  uint32_t count_;
+  uint32_t access_mode_;
+  std::vector<baldr::GraphId> landmarks_;
+
+  // Tiles and their node counts, in the order they are stored
+  std::vector<std::pair<baldr::GraphId, uint32_t>> tiles_;
+
+  // Index of the first node of each tile, per level and tile id
+  std::vector<std::vector<uint64_t>> tile_offsets_;
+
+  // Distances from and to each landmark of each node
+  std::vector<uint32_t> distances_;
+};
+
+/**
+ * Lower bounds of the distance between nodes and a set of target nodes
+ * from the landmark distances. Used by the A* heuristic.
+ */
+class LandmarkBounds {
+ public:
+  LandmarkBounds() : landmarks_(nullptr), to_targets_(true) {
+  }
+
+  /**
+   * Set the targets. Paths to the destination end at one of the nodes
+   * the destination edges start at, paths from the origin start at one of
+   * the nodes the origin edges end at.
+   * @param  landmarks   Landmarks, nullptr to clear the targets.
+   * @param  targets     Target nodes.
+   * @param  to_targets  true to bound the distance from a node to the
+   *                     targets, false from the targets to a node.
+   */
+  void Init(const Landmarks* landmarks,
+            const std::vector<baldr::GraphId>& targets,
+            const bool to_targets);
+
+  /**
+   * Are there targets to bound the distances to?
+   * @return Returns true if the bounds are set.
+   */
+  bool enabled() const {
+    return landmarks_ != nullptr;
+  }
+
+  /**
+   * Get a lower bound of the distance between a node and the targets.
+   * @param  node  Node.
+   * @return Returns the distance in meters, 0 if nothing is known.
+   */
+  float Get(const baldr::GraphId& node) const {
+    const uint32_t* dist = landmarks_->distances(node);
+    if (dist == nullptr) {
+      return 0.0f;
+    }
+
+    // Bound against each landmark, terms with unreached nodes are skipped
+    const uint32_t count = landmarks_->count();
+    int64_t bound = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint32_t from = dist[i];
+      const uint32_t to = dist[count + i];
+      if (from != kLandmarkUnreached && from_[i] != kLandmarkUnreached) {
+        bound = std::max(bound, to_targets_ ?
+            int64_t(from_[i]) - from : int64_t(from) - from_[i]);
+      }
+      if (to != kLandmarkUnreached && to_[i] != kLandmarkUnreached) {
+        bound = std::max(bound, to_targets_ ?
+            int64_t(to) - to_[i] : int64_t(to_[i]) - to);
+      }
+    }
+    return static_cast<float>(bound);
+  }
+
+ private:
+  const Landmarks* landmarks_;
+  bool to_targets_;
+
+  // Distances of the targets to use for each landmark, the nearest or
+  // farthest target depending on the side of the bound, kLandmarkUnreached
+  // if any target is unreached.
+  std::vector<uint32_t> from_;
+  std::vector<uint32_t> to_;
+};
+
+}
+}
+
+#endif  // VALHALLA_THOR_LANDMARKS_H_
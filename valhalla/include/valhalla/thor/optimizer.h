@@ -1,6 +1,7 @@
 #ifndef VALHALLA_THOR_OPTIMIZER_H_
 #define VALHALLA_THOR_OPTIMIZER_H_
 
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 #include <random>
@@ -30,14 +31,34 @@ struct TourAlteration {
   AlterationType alt; // Type of alteration
 };
 
+// Smallest cost improvement the local search accepts. Keeps float round
+// off from making it cycle between equivalent tours.
+constexpr float kMinImprovement = 0.001f;
+
+// Longest segment the local search tries to move to another place in the
+// tour (Or-opt).
+constexpr uint32_t kMaxMoveLength = 3;
+
 /**
  * Optimization method using simulated annealing. Optimizes the order of
  * locations - keeping the first location (origin) and last location
- * (destination) fixed.
+ * (destination) fixed. Several independent annealing chains can be run,
+ * optionally on several threads, each followed by a local search (2-opt
+ * and Or-opt). The best tour found by any of them is returned. Each chain
+ * gets its own random generator seeded from the optimizer's one, so the
+ * result does not depend on the number of threads or their timing.
  */
 class Optimizer {
 public:
 
+  /**
+   * Constructor
+   * @param  chain_count   Number of independent annealing chains to run.
+   * @param  thread_count  Number of threads to run them on, including the
+   *                       calling one.
+   */
+  Optimizer(const uint32_t chain_count = 1, const uint32_t thread_count = 1);
+
   /**
    * Optimize the tour through a set of locations given the cost matrix
    * among all locations. The first location (origin) and last location
@@ -60,47 +81,123 @@ public:
   }
 
 protected:
-  // Random number generation: 0 <= r < 1
+  // State of one annealing chain
+  struct Chain {
+    // Random number generation: 0 <= r < 1
+    std::mt19937_64 random_generator;
+    std::uniform_real_distribution<float> uniform_distribution { 0.0, 1.0 };
+
+    uint32_t ntry;                    // # of attempts (for debugging)
+    float best_cost;                  // Current best cost
+    std::vector<uint32_t> tour;       // Current tour (order of locations)
+    std::vector<uint32_t> best_tour;  // Best tour so far
+
+    // Cost along the current tour up to each location, in tour order and
+    // in reverse order. Gives the cost of reversing any part in O(1).
+    std::vector<float> forward_costs;
+    std::vector<float> reverse_costs;
+
+    /**
+     * Convenience method to return a random floating point value: 0 <= r < 1
+     * @return  Returns a random value between 0 and 1.
+     */
+    float r01() {
+      return uniform_distribution(random_generator);
+    }
+  };
+
+  // Seeds the random generators of the chains
   std::mt19937_64 random_generator_;
-  std::uniform_real_distribution<float> uniform_distribution_ { 0.0, 1.0 };
 
-  uint32_t ntry_;                    // # of attempts (for debugging)
+  uint32_t chain_count_;             // # of annealing chains
+  uint32_t thread_count_;            // # of threads to run them on
   uint32_t count_;                   // # of locations
   uint32_t attempts_;                // # of attempts per annealing cycle
   uint32_t successes_;               // # of success per annealing cycle
-  float best_cost_;                  // Current best cost
-  std::vector<uint32_t> tour_;       // Current tour (order of locations)
-  std::vector<uint32_t> best_tour_;  // Best tour so far
+
+  /**
+   * Run one annealing chain from a random tour, then improve its best tour
+   * with a local search.
+   * @param  chain  Chain to run, its random generator seeded.
+   * @param  costs  2-D cost matrix.
+   */
+  void RunChain(Chain& chain, const std::vector<float>& costs) const;
 
   /*
    * Perform the annealing process.
+   * @param  chain        Annealing chain.
    * @param  costs        2-D cost matrix.
    * @param  temperature  Current temperature.
    * @return Returns number of successes.
    */
-  uint32_t Anneal(const std::vector<float>& costs, float temperature);
+  uint32_t Anneal(Chain& chain, const std::vector<float>& costs,
+                  float temperature) const;
 
   /**
    * Select a potential alteration of the tour.
+   * @param  chain  Annealing chain.
    * @return  Returns a candidate tour alteration: type and location indexes.
    */
-  TourAlteration GetTourAlteration();
+  TourAlteration GetTourAlteration(Chain& chain) const;
 
   /**
-   * Get the temperature difference (based on change in tour cost) given
-   * an alteration to the tour.
+   * Get the change in tour cost given an alteration to the tour. Only looks
+   * at the connections that change, so it takes constant time.
+   * @param  chain       Annealing chain.
    * @param  costs       2-D cost matrix.
    * @param  alteration  Tour alteration.
    * @return Returns the cost difference.
    */
-  float TemperatureDifference(const std::vector<float>& costs,
-                              const TourAlteration& alteration);
+  float CostDifference(const Chain& chain, const std::vector<float>& costs,
+                       const TourAlteration& alteration) const;
 
   /**
    * Create a random initial tour. The first and last locations must remain
    * fixed as the tour begin and end locations do not change.
+   * @param  chain  Annealing chain.
+   */
+  void CreateRandomTour(Chain& chain) const;
+
+  /**
+   * Compute the cost along a tour up to each location, in tour order and
+   * in reverse order.
+   * @param  costs          2-D cost matrix.
+   * @param  tour           Order that locations are traversed.
+   * @param  forward_costs  (OUT) Costs up to each location in tour order.
+   * @param  reverse_costs  (OUT) Costs up to each location in reverse order.
    */
-  void CreateRandomTour();
+  void UpdateTourCosts(const std::vector<float>& costs,
+                       const std::vector<uint32_t>& tour,
+                       std::vector<float>& forward_costs,
+                       std::vector<float>& reverse_costs) const;
+
+  /**
+   * Get the change in tour cost of reversing the locations between a start
+   * and an end index (both included). Costs need not be symmetric, the
+   * connections within the reversed part are taken from the reverse costs.
+   * @param  costs          2-D cost matrix.
+   * @param  tour           Order that locations are traversed.
+   * @param  forward_costs  Costs up to each location in tour order.
+   * @param  reverse_costs  Costs up to each location in reverse order.
+   * @param  start          Index of the first location to reverse.
+   * @param  end            Index of the last location to reverse.
+   * @return Returns the cost difference.
+   */
+  float ReverseCostDifference(const std::vector<float>& costs,
+                              const std::vector<uint32_t>& tour,
+                              const std::vector<float>& forward_costs,
+                              const std::vector<float>& reverse_costs,
+                              const uint32_t start, const uint32_t end) const;
+
+  /**
+   * Improve a tour with 2-opt (reversing a part of the tour) and Or-opt
+   * (moving a few successive locations elsewhere) until neither finds an
+   * improvement.
+   * @param  costs  2-D cost matrix.
+   * @param  tour   Tour to improve.
+   */
+  void LocalSearch(const std::vector<float>& costs,
+                   std::vector<uint32_t>& tour) const;
 
   /**
    * Get the cost for the specified tour (order of locations).
@@ -124,14 +221,6 @@ protected:
              const uint32_t loc2) const {
     return costs[(loc1 * count_) + loc2];
   }
-
-  /**
-   * Convenience method to return a random floating point value: 0 <= r < 1
-   * @return  Returns a random value between 0 and 1.
-   */
-  float r01() {
-    return uniform_distribution_(random_generator_);
-  }
 };
 
 }
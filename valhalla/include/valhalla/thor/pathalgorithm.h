@@ -12,6 +12,7 @@
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/pathlocation.h>
 #include <valhalla/sif/dynamiccost.h>
+#include <valhalla/sif/edgecostcache.h>
 #include <valhalla/thor/pathinfo.h>
 
 namespace valhalla {
@@ -29,7 +30,7 @@ class PathAlgorithm {
   /**
    * Constructor
    */
-  PathAlgorithm():interrupt(nullptr) { }
+  PathAlgorithm():interrupt(nullptr), use_edge_cost_cache_(false) { }
 
   /**
    * Destructor
@@ -64,8 +65,26 @@ class PathAlgorithm {
    */
   void set_interrupt(const std::function<void ()>* interrupt_callback) { interrupt = interrupt_callback; }
 
+  /**
+   * Enable reading edge costs from per tile tables precomputed once per
+   * costing profile (see sif::EdgeCostCache). Pays off for services that
+   * route many requests with the same costing options.
+   *
+   * @param enable  true to use the edge cost cache
+   */
+  void set_edge_cost_cache(const bool enable) { use_edge_cost_cache_ = enable; }
+
  protected:
   const std::function<void()>* interrupt;
+
+  // Edge cost cache, only used if enabled
+  bool use_edge_cost_cache_;
+  sif::EdgeCostCache edge_cost_cache_;
+
+  // Get the edge cost cache to hand to the costing, null if disabled
+  sif::EdgeCostCache* edge_cost_cache() {
+    return use_edge_cost_cache_ ? &edge_cost_cache_ : nullptr;
+  }
 };
 
 }
@@ -21,6 +21,8 @@
 #include <valhalla/thor/trippathbuilder.h>
 #include <valhalla/thor/trip_path_controller.h>
 #include <valhalla/thor/isochrone.h>
+#include <valhalla/thor/costmatrix.h>
+#include <valhalla/thor/timedistancematrix.h>
 #include <valhalla/meili/map_matcher_factory.h>
 
 
@@ -120,13 +122,22 @@ class thor_worker_t {
   std::vector<baldr::PathLocation> correlated_t;
   sif::CostFactory<sif::DynamicCost> factory;
   valhalla::sif::cost_ptr_t mode_costing[static_cast<int>(sif::TravelMode::kMaxTravelMode)];
+  // Graph readers for the threads of matrix and isochrone requests besides
+  // this one, sharing their tiles with each other
+  std::vector<std::shared_ptr<baldr::GraphReader>> worker_readers;
   // Path algorithms (TODO - perhaps use a map?))
   AStarPathAlgorithm astar;
   BidirectionalAStar bidir_astar;
   MultiModalPathAlgorithm multi_modal_astar;
   Isochrone isochrone_gen;
+  CostMatrix costmatrix;
+  TimeDistanceMatrix timedistancematrix;
   float long_request;
+  // Annealing chains the optimizer runs for a tour and the threads it runs them on
+  uint32_t optimizer_chains;
+  uint32_t optimizer_threads;
   SOURCE_TO_TARGET_ALGORITHM source_to_target_algorithm;
+  bool edge_cost_cache;
   boost::optional<int> date_time_type;
   valhalla::meili::MapMatcherFactory matcher_factory;
   valhalla::baldr::GraphReader& reader;
@@ -11,6 +11,7 @@
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/pathlocation.h>
 #include <valhalla/baldr/double_bucket_queue.h>
+#include <valhalla/midgard/worker_pool.h>
 #include <valhalla/sif/dynamiccost.h>
 #include <valhalla/sif/edgelabel.h>
 #include <valhalla/thor/edgestatus.h>
@@ -56,6 +57,21 @@ class TimeDistanceMatrix {
    */
   TimeDistanceMatrix(float initial_cost_threshold = kDefaultCostThreshold);
 
+  /**
+   * Constructor with cost threshold and graph readers for worker threads.
+   * SourceToTarget then runs the one to many (or many to one) searches
+   * concurrently on the calling thread and one additional thread per
+   * reader, each thread with its own label storage that is reused from one
+   * search to the next. The threads are started here and kept until the
+   * matrix is destroyed. The readers must not be used by anything else
+   * during SourceToTarget. They should share a SynchronizedTileCache so
+   * tiles are only loaded once.
+   * @param initial_cost_threshold  Cost threshold for termination.
+   * @param worker_readers          Graph readers for the worker threads.
+   */
+  TimeDistanceMatrix(float initial_cost_threshold,
+                     const std::vector<std::shared_ptr<baldr::GraphReader>>& worker_readers);
+
   /**
    * One to many time and distance cost matrix. Computes time and distance
    * matrix from one origin location to many other locations.
@@ -145,7 +161,7 @@ class TimeDistanceMatrix {
   std::unordered_map<baldr::GraphId, std::vector<uint32_t>> dest_edges_;
 
   // Vector of edge labels (requires access by index).
-  std::vector<sif::EdgeLabel> edgelabels_;
+  sif::EdgeLabelStore edgelabels_;
 
   // Adjacency list - approximate double bucket sort
   std::shared_ptr<baldr::DoubleBucketQueue> adjacencylist_;
@@ -156,6 +172,18 @@ class TimeDistanceMatrix {
   AStarHeuristic astarheuristic_;
 
   sif::TravelMode mode_;
+
+  // Graph readers for the worker threads (empty if single threaded)
+  std::vector<std::shared_ptr<baldr::GraphReader>> worker_readers_;
+
+  // Searches run by the worker threads, kept so their label storage is
+  // reused across calls
+  std::vector<std::unique_ptr<TimeDistanceMatrix>> worker_matrices_;
+
+  // Threads running the searches, one per worker reader besides the
+  // calling thread
+  std::unique_ptr<midgard::WorkerPool> workers_;
+
   /**
    * Sets the origin for a many to one time+distance matrix computation.
    * @param  graphreader   Graph reader for accessing routing graph.
@@ -92,6 +92,7 @@ const std::string kShape = "shape";
 
 // Categories
 const std::string kNodeCategory = "node.";
+const std::string kNodeIntersectingEdgeCategory = "node.intersecting_edge.";
 const std::string kAdminCategory = "admin.";
 
 
@@ -52,6 +52,7 @@ class TripPathBuilder {
    * @param  directededge  Directed edge information.
    * @param  trip_node     Trip node to add the edge information to.
    * @param  graphtile     Graph tile for accessing data.
+   * @param  shape         Shape of the edge info of the directed edge.
    * @param   current_time Current time (seconds from midnight).
    * @param  length_pct    Scale for the edge length for the partial distance
    *                       at begin and end edges
@@ -65,6 +66,7 @@ class TripPathBuilder {
                                           const baldr::DirectedEdge* directededge,
                                           odin::TripPath_Node* trip_node,
                                           const baldr::GraphTile* graphtile,
+                                          const std::vector<midgard::PointLL>& shape,
                                           const uint32_t current_time,
                                           const float length_percentage = 1.f);
 
@@ -1,21 +1,101 @@
 #include "baldr/connectivity_map.h"
 #include "baldr/json.h"
 #include "baldr/graphtile.h"
-#include "baldr/graphreader.h"
 
 #include "midgard/pointll.h"
+#include "midgard/worker_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <list>
 #include <iomanip>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <unordered_set>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "midgard/logging.h"
 
 using namespace valhalla::baldr;
 using namespace valhalla::midgard;
 
 namespace {
+  constexpr uint32_t kConnectivityMagic = 0x504d4e43; // "CNMP"
+  constexpr uint32_t kConnectivityVersion = 2;
+
+  // Sidecar layout: the header, an entry per level, then per level the
+  // (tile id, color) pairs sorted by tile id. The header identifies the tile
+  // set the colors were computed for.
+  struct header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t level_count;
+    uint32_t tile_count;
+    uint64_t tile_digest;
+  };
+
+  // Add a tile to the digest of a tile set. The hashes are summed so the
+  // order the tiles are visited in does not matter.
+  void add_to_digest(uint64_t& digest, const GraphId& id) {
+    uint64_t hash = id.Tile_Base().value + 0x9e3779b97f4a7c15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    digest += hash ^ (hash >> 31);
+  }
+
+  struct level_entry_t {
+    uint32_t level;
+    uint32_t tile_count;
+    uint64_t offset;
+  };
+
+  // Map a file read only, the memory is unmapped with the last reference
+  std::shared_ptr<const char> map_file(const std::string& file, size_t& size) {
+#ifdef _WIN32
+    std::ifstream in(file, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+      throw std::runtime_error(file + ": could not open connectivity map");
+    auto data = std::make_shared<std::vector<char> >(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(data->data(), data->size()))
+      throw std::runtime_error(file + ": could not read connectivity map");
+    size = data->size();
+    return std::shared_ptr<const char>(data, data->data());
+#else
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd == -1)
+      throw std::runtime_error(file + "(open): " + strerror(errno));
+    struct stat s;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &s) == 0 && s.st_size > 0)
+      p = mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+      throw std::runtime_error(file + "(mmap): " + strerror(errno));
+    size = s.st_size;
+    return std::shared_ptr<const char>(static_cast<const char*>(p), [size](const char* p) {
+      munmap(const_cast<char*>(p), size);
+    });
+#endif
+  }
+
+  bool file_exists(const std::string& file) {
+    std::ifstream in(file);
+    return in.is_open();
+  }
+
 /*
    { "type": "FeatureCollection",
     "features": [
@@ -208,36 +288,250 @@ namespace {
 namespace valhalla {
   namespace baldr {
     connectivity_map_t::connectivity_map_t(const std::shared_ptr<GraphTileStorage>& storage, const boost::property_tree::ptree& pt)
-      :tile_hierarchy(storage) {
-      // See what kind of tiles we are dealing with here by getting a graphreader
-      GraphReader reader(storage, pt);
-      auto tiles = reader.GetTileSet();
+      :blob_size(0), tile_hierarchy(storage) {
       transit_level = tile_hierarchy.levels().rbegin()->second.level + 1;
 
-      // Populate a map for each level of the tiles that exist
-      for(const auto& t : tiles) {
-        auto& level_colors = colors.insert({t.level(), std::unordered_map<uint32_t, size_t>{}}).first->second;
-        level_colors.insert({t.tileid(), 0});
+      const auto tile_set = storage->FindTiles(tile_hierarchy);
+      uint64_t tile_digest = 0;
+      for (const auto& t : tile_set)
+        add_to_digest(tile_digest, t);
+
+      // Map the sidecar if there is one, if it was computed for another tile
+      // set the regions touching the tiles that changed are recolored
+      auto file = pt.get<std::string>("connectivity_map", "");
+      bool mapped_sidecar = false;
+      if (!file.empty() && file_exists(file)) {
+        try {
+          size_t size;
+          auto mapped = map_file(file, size);
+          index(mapped, size);
+          const auto* header = reinterpret_cast<const header_t*>(blob.get());
+          if (header->tile_count == tile_set.size() && header->tile_digest == tile_digest)
+            return;
+          LOG_WARN("Updating the connectivity map, the tile set changed since it was saved");
+          mapped_sidecar = update(tile_set) > 0;
+        }
+        catch (const std::exception& e) {
+          LOG_WARN(std::string("Recomputing the connectivity map: ") + e.what());
+        }
+      }
+
+      // All tiles have color 0 (not connected), go through and connect them
+      // (build the color map) level by level
+      if (!mapped_sidecar) {
+        std::map<uint32_t, std::unordered_map<uint32_t, size_t> > levels;
+        std::unordered_set<uint32_t> changed;
+        for (const auto& t : tile_set) {
+          levels[t.level()].emplace(t.tileid(), 0);
+          changed.insert(t.level());
+        }
+        recolor(levels, changed);
       }
 
-      // All tiles have color 0 (not connected), go through and connect
-      // (build the ColorMap). Transit level uses local hierarchy tiles
-      for (auto& color : colors) {
-        if (color.first == transit_level)
-          tile_hierarchy.levels().rbegin()->second.tiles.ColorMap(color.second);
-        else
-          tile_hierarchy.levels().find(color.first)->second.tiles.ColorMap(color.second);
+      // Save it for the next time
+      if (!file.empty()) {
+        try {
+          save(file);
+        }
+        catch (const std::exception& e) {
+          LOG_WARN(std::string("Failed to save the connectivity map: ") + e.what());
+        }
+      }
+    }
+
+    connectivity_map_t::connectivity_map_t(const std::shared_ptr<GraphTileStorage>& storage, const std::string& file)
+      :blob_size(0), tile_hierarchy(storage) {
+      transit_level = tile_hierarchy.levels().rbegin()->second.level + 1;
+      size_t size;
+      auto mapped = map_file(file, size);
+      index(mapped, size);
+    }
+
+    void connectivity_map_t::save(const std::string& file) const {
+      // Write next to it and move it over so processes that mapped the old
+      // file keep reading the old one. The name is unique so processes
+      // saving at the same time do not write into each other's file.
+#ifdef _WIN32
+      const std::string temp = file + "." + std::to_string(GetCurrentProcessId()) + ".tmp";
+#else
+      std::vector<char> temp_name(file.begin(), file.end());
+      const std::string suffix = ".XXXXXX";
+      temp_name.insert(temp_name.end(), suffix.begin(), suffix.end());
+      temp_name.push_back('\0');
+      int fd = mkstemp(temp_name.data());
+      if (fd == -1)
+        throw std::runtime_error(file + "(mkstemp): " + strerror(errno));
+      fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+      close(fd);
+      const std::string temp(temp_name.data());
+#endif
+      {
+        std::ofstream out(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(blob.get(), blob_size);
+        if (!out) {
+          std::remove(temp.c_str());
+          throw std::runtime_error(temp + ": could not write connectivity map");
+        }
+      }
+      if (std::rename(temp.c_str(), file.c_str()) != 0) {
+        const std::string error = strerror(errno);
+        std::remove(temp.c_str());
+        throw std::runtime_error(file + "(rename): " + error);
       }
     }
 
+    void connectivity_map_t::update(const std::unordered_set<GraphId>& added, const std::unordered_set<GraphId>& removed) {
+      // Unpack the colors
+      std::map<uint32_t, std::unordered_map<uint32_t, size_t> > levels;
+      for (const auto& level : colors) {
+        auto& level_colors = levels[level.first];
+        level_colors.reserve(level.second.end - level.second.begin);
+        for (auto t = level.second.begin; t != level.second.end; ++t)
+          level_colors.emplace(t->tileid, t->color);
+      }
+
+      // Regions that lost a tile may have split and regions next to an added
+      // tile may have merged, they are recolored
+      std::unordered_set<uint32_t> changed;
+      std::map<uint32_t, std::unordered_set<uint32_t> > stale;
+      for (const auto& id : removed) {
+        auto level = levels.find(id.level());
+        if (level == levels.end())
+          continue;
+        auto tile = level->second.find(id.tileid());
+        if (tile == level->second.end())
+          continue;
+        stale[id.level()].insert(tile->second);
+        level->second.erase(tile);
+        changed.insert(id.level());
+      }
+      for (const auto& id : added) {
+        auto& level = levels[id.level()];
+        if (!level.emplace(id.tileid(), 0).second)
+          continue;
+        changed.insert(id.level());
+        const auto& level_tiles = tiles(id.level());
+        int32_t tileid = id.tileid();
+        for (auto neighbor : {level_tiles.LeftNeighbor(tileid), level_tiles.RightNeighbor(tileid),
+                              level_tiles.TopNeighbor(tileid), level_tiles.BottomNeighbor(tileid)}) {
+          auto tile = level.find(neighbor);
+          if (tile != level.end() && tile->second > 0)
+            stale[id.level()].insert(tile->second);
+        }
+      }
+      for (const auto& level : stale) {
+        for (auto& tile : levels[level.first]) {
+          if (level.second.find(tile.second) != level.second.cend())
+            tile.second = 0;
+        }
+      }
+
+      recolor(levels, changed);
+    }
+
+    size_t connectivity_map_t::update(const std::unordered_set<GraphId>& tiles) {
+      std::unordered_set<GraphId> added, removed;
+      for (const auto& level : colors) {
+        for (auto t = level.second.begin; t != level.second.end; ++t) {
+          GraphId id(t->tileid, level.first, 0);
+          if (tiles.find(id) == tiles.cend())
+            removed.insert(id);
+        }
+      }
+      for (const auto& id : tiles) {
+        if (get_color(id) == 0)
+          added.insert(id.Tile_Base());
+      }
+      if (!added.empty() || !removed.empty())
+        update(added, removed);
+      return added.size() + removed.size();
+    }
+
+    void connectivity_map_t::index(const std::shared_ptr<const char>& new_blob, size_t size) {
+      if (size < sizeof(header_t))
+        throw std::runtime_error("Connectivity map is truncated");
+      const auto* header = reinterpret_cast<const header_t*>(new_blob.get());
+      if (header->magic != kConnectivityMagic || header->version != kConnectivityVersion)
+        throw std::runtime_error("Not a connectivity map");
+      if (size < sizeof(header_t) + header->level_count * sizeof(level_entry_t))
+        throw std::runtime_error("Connectivity map is truncated");
+
+      std::map<uint32_t, level_colors_t> new_colors;
+      const auto* entry = reinterpret_cast<const level_entry_t*>(header + 1);
+      for (uint32_t i = 0; i < header->level_count; ++i, ++entry) {
+        if (entry->offset + entry->tile_count * sizeof(tile_color_t) > size)
+          throw std::runtime_error("Connectivity map is truncated");
+        const auto* begin = reinterpret_cast<const tile_color_t*>(new_blob.get() + entry->offset);
+        new_colors[entry->level] = {begin, begin + entry->tile_count};
+      }
+      colors.swap(new_colors);
+      blob = new_blob;
+      blob_size = size;
+    }
+
+    void connectivity_map_t::recolor(std::map<uint32_t, std::unordered_map<uint32_t, size_t> >& levels,
+                                     const std::unordered_set<uint32_t>& changed) {
+      // Color and sort the levels in parallel, one worker per level
+      std::vector<uint32_t> level_ids;
+      for (const auto& level : levels)
+        level_ids.push_back(level.first);
+      std::vector<std::vector<tile_color_t> > sorted(level_ids.size());
+      midgard::WorkerPool workers(level_ids.size());
+      workers.Run([&](const uint32_t worker) {
+        for (size_t i = worker; i < level_ids.size(); i += workers.size()) {
+          auto& level_colors = levels.at(level_ids[i]);
+          if (changed.find(level_ids[i]) != changed.cend())
+            tiles(level_ids[i]).ColorMap(level_colors);
+          sorted[i].reserve(level_colors.size());
+          for (const auto& tile : level_colors)
+            sorted[i].push_back({tile.first, static_cast<uint32_t>(tile.second)});
+          std::sort(sorted[i].begin(), sorted[i].end(), [](const tile_color_t& a, const tile_color_t& b) {
+            return a.tileid < b.tileid;
+          });
+        }
+      });
+
+      // Lay them out in a new blob
+      size_t size = sizeof(header_t) + level_ids.size() * sizeof(level_entry_t);
+      size_t tile_count = 0;
+      uint64_t tile_digest = 0;
+      for (size_t i = 0; i < level_ids.size(); ++i) {
+        size += sorted[i].size() * sizeof(tile_color_t);
+        tile_count += sorted[i].size();
+        for (const auto& tile : sorted[i])
+          add_to_digest(tile_digest, GraphId(tile.tileid, level_ids[i], 0));
+      }
+      auto data = std::make_shared<std::vector<char> >(size);
+      auto* header = reinterpret_cast<header_t*>(data->data());
+      *header = {kConnectivityMagic, kConnectivityVersion, static_cast<uint32_t>(level_ids.size()),
+                 static_cast<uint32_t>(tile_count), tile_digest};
+      auto* entry = reinterpret_cast<level_entry_t*>(header + 1);
+      uint64_t offset = sizeof(header_t) + level_ids.size() * sizeof(level_entry_t);
+      for (size_t i = 0; i < level_ids.size(); ++i, ++entry) {
+        *entry = {level_ids[i], static_cast<uint32_t>(sorted[i].size()), offset};
+        if (!sorted[i].empty())
+          std::memcpy(data->data() + offset, sorted[i].data(), sorted[i].size() * sizeof(tile_color_t));
+        offset += sorted[i].size() * sizeof(tile_color_t);
+      }
+      index(std::shared_ptr<const char>(data, data->data()), size);
+    }
+
+    const Tiles<PointLL>& connectivity_map_t::tiles(uint32_t level) const {
+      auto tile_level = tile_hierarchy.levels().find(level == transit_level ? transit_level - 1 : level);
+      if (tile_level == tile_hierarchy.levels().cend())
+        throw std::runtime_error("hierarchy level not found");
+      return tile_level->second.tiles;
+    }
+
     size_t connectivity_map_t::get_color(const GraphId& id) const {
       auto level = colors.find(id.level());
       if(level == colors.cend())
         return 0;
-      auto color = level->second.find(id.tileid());
-      if(color == level->second.cend())
+      auto color = std::lower_bound(level->second.begin, level->second.end, id.tileid(),
+        [](const tile_color_t& tile, uint32_t tileid) { return tile.tileid < tileid; });
+      if(color == level->second.end || color->tileid != id.tileid())
         return 0;
-      return color->second;
+      return color->color;
     }
 
     std::unordered_set<size_t> connectivity_map_t::get_colors(uint32_t hierarchy_level,
@@ -256,9 +550,9 @@ namespace valhalla {
         //then while iterating create a tile for each tile col,row pair, get its aabb2 and call
         //aabb2::intersects(edge.projected, radius), if it returns true, get the color as below
         auto id = tiles.TileId(edge.projected);
-        auto color = level->second.find(id);
-        if(color != level->second.cend())
-          result.emplace(color->second);
+        auto color = get_color(GraphId(id, hierarchy_level, 0));
+        if(color != 0)
+          result.emplace(color);
       }
       return result;
     }
@@ -275,12 +569,12 @@ namespace valhalla {
       std::unordered_map<size_t, std::unordered_set<uint32_t> > regions;
       auto level = colors.find(hierarchy_level);
       if(level != colors.cend()) {
-        for(const auto& tile : level->second) {
-          auto region = regions.find(tile.second);
+        for(auto tile = level->second.begin; tile != level->second.end; ++tile) {
+          auto region = regions.find(tile->color);
           if(region == regions.end())
-            regions.emplace(tile.second, std::unordered_set<uint32_t>{tile.first});
+            regions.emplace(tile->color, std::unordered_set<uint32_t>{tile->tileid});
           else
-            region->second.emplace(tile.first);
+            region->second.emplace(tile->tileid);
         }
       }
 
@@ -310,10 +604,9 @@ namespace valhalla {
       std::vector<size_t> tiles(bbox->second.tiles.nrows() * bbox->second.tiles.ncolumns(), static_cast<uint32_t>(0));
       auto level = colors.find(hierarchy_level);
       if (level != colors.cend()) {
-        for(size_t i = 0; i < tiles.size(); ++i) {
-          const auto color = level->second.find(static_cast<uint32_t>(i));
-          if(color != level->second.cend())
-            tiles[i] = color->second;
+        for(auto tile = level->second.begin; tile != level->second.end; ++tile) {
+          if(tile->tileid < tiles.size())
+            tiles[tile->tileid] = tile->color;
         }
       }
 
@@ -1,7 +1,11 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <bitset>
 #include <fstream>
+#include <utility>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
@@ -21,6 +25,65 @@ namespace {
 
 const boost::gregorian::date pivot_date_ = boost::gregorian::from_undelimited_string(kPivotDate);
 
+const boost::posix_time::ptime epoch_(boost::gregorian::date(1970, 1, 1));
+
+constexpr int64_t kSecondsPerDay = 86400;
+
+// Days since epoch of a civil date, valid for any proleptic gregorian date
+int64_t days_from_civil(int64_t y, const int64_t m, const int64_t d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// Civil date of a number of days since epoch
+void civil_from_days(int64_t z, int& y, int& m, int& d) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const int64_t doe = z - era * 146097;
+  const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int64_t mp = (5 * doy + 2) / 153;
+  d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  y = static_cast<int>(yoe + era * 400 + (m <= 2));
+}
+
+const int64_t pivot_days_ = (pivot_date_ - epoch_.date()).days();
+
+// Parse a number of digits, returns false if any of them is not a digit
+bool parse_digits(const std::string& str, const size_t pos, const size_t count,
+                  int& value) {
+  value = 0;
+  for (size_t i = pos; i < pos + count; ++i) {
+    if (str[i] < '0' || str[i] > '9')
+      return false;
+    value = value * 10 + (str[i] - '0');
+  }
+  return true;
+}
+
+// Parse a valid date time in the format of 2015-05-06T08:00 without
+// allocating. Anything else is left to boost.
+bool parse_iso_local(const std::string& date_time, int& year, int& month,
+                     int& day, int& hour, int& minute) {
+  if (date_time.size() != 16 || date_time[4] != '-' || date_time[7] != '-' ||
+      date_time[10] != 'T' || date_time[13] != ':')
+    return false;
+  if (!parse_digits(date_time, 0, 4, year) ||
+      !parse_digits(date_time, 5, 2, month) ||
+      !parse_digits(date_time, 8, 2, day) ||
+      !parse_digits(date_time, 11, 2, hour) ||
+      !parse_digits(date_time, 14, 2, minute))
+    return false;
+  if (year < 1400 || month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59)
+    return false;
+  return day <= boost::gregorian::gregorian_calendar::end_of_month_day(year, month);
+}
+
 }
 
 namespace valhalla {
@@ -34,19 +97,107 @@ tz_db_t::tz_db_t() {
   load_from_stream(ss);
   //unfortunately boosts object has its map marked as private... so we have to keep our own
   regions = region_list();
+
+  //precompile the zones by index so looking them up needs no strings
+  first_offset_seconds = days_from_civil(kFirstOffsetYear, 1, 1) * kSecondsPerDay;
+  last_offset_seconds = days_from_civil(kLastOffsetYear + 1, 1, 1) * kSecondsPerDay;
+  zones.reserve(regions.size());
+  zone_offsets.reserve(regions.size());
+  for (size_t i = 0; i < regions.size(); ++i) {
+    region_indexes.emplace(regions[i], i + 1);
+    auto tz = time_zone_from_region(regions[i]);
+    zones.push_back(tz);
+
+    zone_offsets.emplace_back();
+    auto& zone = zone_offsets.back();
+    zone.posix = tz->to_posix_string();
+    zone.std_abbrev = tz->std_zone_abbrev();
+    zone.dst_abbrev = tz->dst_zone_abbrev();
+    const int32_t base = tz->base_utc_offset().total_seconds();
+    if (!tz->has_dst()) {
+      zone.offsets.push_back(base);
+      zone.dst.push_back(false);
+      continue;
+    }
+
+    //dst starts at the local start time and ends at the local end time
+    //less the dst offset, both in standard time. local_date_time::is_dst
+    //only checks the end on the end day so the end never moves before it.
+    const int32_t dst = tz->dst_offset().total_seconds();
+    std::vector<std::pair<int64_t, bool> > changes;
+    for (int year = kFirstOffsetYear; year <= kLastOffsetYear; ++year) {
+      const auto end = tz->dst_local_end_time(year);
+      const auto end_std = std::max(end - tz->dst_offset(),
+                                    boost::posix_time::ptime(end.date()));
+      changes.emplace_back((tz->dst_local_start_time(year) - epoch_).total_seconds() - base, true);
+      changes.emplace_back((end_std - epoch_).total_seconds() - base, false);
+    }
+    std::sort(changes.begin(), changes.end());
+    zone.offsets.push_back(changes.front().second ? base : base + dst);
+    zone.dst.push_back(!changes.front().second);
+    for (const auto& change : changes) {
+      zone.transitions.push_back(change.first);
+      zone.offsets.push_back(change.second ? base + dst : base);
+      zone.dst.push_back(change.second);
+    }
+  }
 }
 
 size_t tz_db_t::to_index(const std::string& region) const {
-  auto it = std::find(regions.cbegin(), regions.cend(), region);
-  if(it == regions.cend())
+  auto it = region_indexes.find(region);
+  if(it == region_indexes.cend())
     return 0;
-  return (it - regions.cbegin()) + 1;
+  return it->second;
 }
 
 boost::shared_ptr<boost::local_time::tz_database::time_zone_base_type> tz_db_t::from_index(size_t index) const {
-  if(index < 1 || index > regions.size())
+  if(index < 1 || index > zones.size())
     return {};
-  return time_zone_from_region(regions[index - 1]);
+  return zones[index - 1];
+}
+
+size_t tz_db_t::offset_position(const zone_offsets_t& zone, int64_t utc_seconds) const {
+  return std::upper_bound(zone.transitions.cbegin(), zone.transitions.cend(), utc_seconds) -
+         zone.transitions.cbegin();
+}
+
+int32_t tz_db_t::utc_offset(size_t index, int64_t utc_seconds) const {
+  if(index < 1 || index > zones.size())
+    return 0;
+  //outside of the precompiled years let boost apply the zone rules
+  if(utc_seconds < first_offset_seconds || utc_seconds >= last_offset_seconds) {
+    boost::local_time::local_date_time ldt(epoch_ + boost::posix_time::seconds(utc_seconds),
+                                           zones[index - 1]);
+    return (ldt.local_time() - ldt.utc_time()).total_seconds();
+  }
+  const auto& zone = zone_offsets[index - 1];
+  return zone.offsets[offset_position(zone, utc_seconds)];
+}
+
+bool tz_db_t::is_dst(size_t index, int64_t utc_seconds) const {
+  if(index < 1 || index > zones.size())
+    return false;
+  if(utc_seconds < first_offset_seconds || utc_seconds >= last_offset_seconds) {
+    boost::local_time::local_date_time ldt(epoch_ + boost::posix_time::seconds(utc_seconds),
+                                           zones[index - 1]);
+    return ldt.is_dst();
+  }
+  const auto& zone = zone_offsets[index - 1];
+  return zone.dst[offset_position(zone, utc_seconds)];
+}
+
+const std::string& tz_db_t::posix_string(size_t index) const {
+  static const std::string empty;
+  if(index < 1 || index > zones.size())
+    return empty;
+  return zone_offsets[index - 1].posix;
+}
+
+const std::string& tz_db_t::abbrev(size_t index, bool dst) const {
+  static const std::string empty;
+  if(index < 1 || index > zones.size())
+    return empty;
+  return dst ? zone_offsets[index - 1].dst_abbrev : zone_offsets[index - 1].std_abbrev;
 }
 
 const tz_db_t& get_tz_db() {
@@ -578,8 +729,22 @@ uint32_t seconds_from_midnight(const std::string& date_time) {
   //please see GTFS spec:
   //https://developers.google.com/transit/gtfs/reference#stop_times_fields
 
-  boost::posix_time::time_duration td;
   std::size_t found = date_time.find("T"); // YYYY-MM-DDTHH:MM
+
+  //HH:MM and HH:MM:SS are parsed in place, anything else by boost
+  size_t pos = (found != std::string::npos) ? found + 1 : 0;
+  size_t colon = date_time.find(':', pos);
+  int hours, minutes, seconds = 0;
+  if (colon != std::string::npos && colon > pos && colon - pos <= 6 &&
+      parse_digits(date_time, pos, colon - pos, hours) &&
+      (date_time.size() == colon + 3 ||
+       (date_time.size() == colon + 6 && date_time[colon + 3] == ':' &&
+        parse_digits(date_time, colon + 4, 2, seconds))) &&
+      parse_digits(date_time, colon + 1, 2, minutes)) {
+    return static_cast<uint32_t>(hours * 3600 + minutes * 60 + seconds);
+  }
+
+  boost::posix_time::time_duration td;
   if (found != std::string::npos)
     td = boost::posix_time::duration_from_string(date_time.substr(found+1));
   else
@@ -655,6 +820,41 @@ std::string get_duration(const std::string& date_time, const uint32_t seconds,
   return formatted_date_time;
 }
 
+//add x seconds to a date_time and return a ISO date_time string.
+//date_time in the format of 2015-05-06T08:00 is handled with the
+//precompiled offsets of the timezone, anything else by the above.
+std::string get_duration(const std::string& date_time, const uint32_t seconds,
+                         const size_t tz_index) {
+  const auto& tz_db = get_tz_db();
+  int year, month, day, hour, minute;
+  if (tz_db.posix_string(tz_index).empty() ||
+      !parse_iso_local(date_time, year, month, day, hour, minute))
+    return get_duration(date_time, seconds, tz_db.from_index(tz_index));
+
+  const int64_t date = days_from_civil(year, month, day);
+  if (date < pivot_days_)
+    return "";
+
+  //like above the local end time is taken as utc to check for dst
+  const int64_t end = date * kSecondsPerDay + hour * 3600 + minute * 60 + seconds;
+  const bool dst = tz_db.is_dst(tz_index, end);
+  const int32_t offset = tz_db.utc_offset(tz_index, end);
+
+  const int64_t end_days = end / kSecondsPerDay;
+  const int64_t end_secs = end % kSecondsPerDay;
+  civil_from_days(end_days, year, month, day);
+  const int32_t offset_minutes = std::abs(offset) / 60;
+  char formatted[48];
+  snprintf(formatted, sizeof(formatted), "%04d-%02d-%02dT%02d:%02d%c%02d:%02d ",
+           year, month, day, static_cast<int>(end_secs / 3600),
+           static_cast<int>((end_secs % 3600) / 60), offset < 0 ? '-' : '+',
+           offset_minutes / 60, offset_minutes % 60);
+
+  std::string formatted_date_time(formatted);
+  formatted_date_time += tz_db.abbrev(tz_index, dst);
+  return formatted_date_time;
+}
+
 // checks if string is in the format of %Y-%m-%dT%H:%M
 bool is_iso_local(const std::string& date_time) {
 
@@ -7,11 +7,34 @@ namespace baldr {
 // bucket sort, and a bucket size. All costs above mincost + range are
 // stored in an "overflow" bucket.
 DoubleBucketQueue::DoubleBucketQueue(const float mincost, const float range,
-          const uint32_t bucketsize, const LabelCost& labelcost) {
+          const uint32_t bucketsize) {
+  reuse(mincost, range, bucketsize);
+}
+
+// Destructor
+DoubleBucketQueue::~DoubleBucketQueue() {
+}
+
+// Clear all labels from the low-level buckets and the overflow buckets.
+void DoubleBucketQueue::clear() {
+  // Empty the overflow bucket and each bucket. Bucket memory is kept.
+  overflowbucket_.clear();
+  for (auto& bucket : buckets_) {
+    bucket.clear();
+  }
+
+  // Reset current bucket and cost
+  currentcost_ = mincost_;
+  currentbucket_ = 0;
+  currentpos_ = 0;
+}
+
+// Clears the queue and sets up a new cost range, reusing bucket memory.
+void DoubleBucketQueue::reuse(const float mincost, const float range,
+          const uint32_t bucketsize) {
   // Adjust min cost to be the start of a bucket
   uint32_t c = static_cast<uint32_t>(mincost);
-  currentcost_ = (c - (c % bucketsize));
-  mincost_ = currentcost_;
+  mincost_ = (c - (c % bucketsize));
   bucketrange_ = range;
   bucketsize_ = static_cast<float>(bucketsize);
   inv_ = 1.0f / bucketsize_;
@@ -20,68 +43,64 @@ DoubleBucketQueue::DoubleBucketQueue(const float mincost, const float range,
   maxcost_ = mincost + bucketrange_;
 
   // Allocate the low-level buckets
-  bucketcount_ = (range / bucketsize_) + 1;
+  bucketcount_ = static_cast<uint32_t>((range / bucketsize_) + 1);
   buckets_.resize(bucketcount_);
 
   // Set the current bucket to the lowest cost low level bucket
-  currentbucket_ = buckets_.begin();
-
-  // Set the cost function.
-  labelcost_ = labelcost;
-}
-
-// Destructor
-DoubleBucketQueue::~DoubleBucketQueue() {
   clear();
 }
 
-// Clear all labels from the low-level buckets and the overflow buckets.
-void DoubleBucketQueue::clear() {
-  // Empty the overflow bucket and each bucket
-  overflowbucket_.clear();
-  while (currentbucket_ != buckets_.end()) {
-    currentbucket_->clear();
-    currentbucket_++;
+// The specified label now has a smaller cost.  Reorders it in the sorted list
+void DoubleBucketQueue::decrease(const uint32_t label, const float newcost) {
+  // Nothing needs to be done if the old cost and the new cost are in the
+  // same bucket (other than remembering the cost of overflow labels)
+  const position_t prev = positions_[label];
+  const uint32_t newbucket = get_bucket(newcost);
+  if (prev.bucket == newbucket) {
+    if (newbucket == bucketcount_) {
+      overflowbucket_[prev.pos].second = newcost;
+    }
+    return;
   }
 
-  // Reset current bucket and cost
-  currentcost_ = mincost_;
-  currentbucket_ = buckets_.begin();
-}
-
-// The specified label now has a smaller cost.  Reorders it in the sorted list
-void DoubleBucketQueue::decrease(const uint32_t label, const float newcost,
-                                 const float previouscost) {
-  // Get the buckets of the previous and new costs. Nothing needs to be done
-  // if old cost and the new cost are in the same buckets.
-  auto& prevbucket = get_bucket(previouscost);
-  auto& newbucket  = get_bucket(newcost);
-  if (prevbucket != newbucket) {
-    // Remove the label index from the old bucket and add to end of newbucket
-    for (auto it = prevbucket.begin(); it != prevbucket.end(); ++it) {
-      if (*it == label) {
-        prevbucket.erase(it);
-        break;
-      }
+  // Invalidate the label in the old bucket and add it to the end of the
+  // new bucket
+  if (prev.bucket == bucketcount_) {
+    if (prev.pos < overflowbucket_.size() && overflowbucket_[prev.pos].first == label) {
+      overflowbucket_[prev.pos].first = kInvalidLabel;
+    }
+  } else {
+    auto& prevbucket = buckets_[prev.bucket];
+    if (prev.pos < prevbucket.size() && prevbucket[prev.pos] == label) {
+      prevbucket[prev.pos] = kInvalidLabel;
     }
-    newbucket.push_back(label);
   }
+  push(label, newcost, newbucket);
 }
 
 // Remove the label with the lowest cost
 uint32_t DoubleBucketQueue::pop() {
+  // Return the next valid label from the lowest non-empty bucket. Buckets
+  // are emptied once all their labels have been returned.
   const auto nextlabel = [this]() {
-    uint32_t label = currentbucket_->front();
-    currentbucket_->pop_front();
-    return label;
+    for ( ; currentbucket_ < bucketcount_; currentbucket_++,
+            currentcost_ += bucketsize_) {
+      auto& bucket = buckets_[currentbucket_];
+      while (currentpos_ < bucket.size()) {
+        uint32_t label = bucket[currentpos_++];
+        if (label != kInvalidLabel) {
+          return label;
+        }
+      }
+      bucket.clear();
+      currentpos_ = 0;
+    }
+    return kInvalidLabel;
   };
 
-  // Return a label from lowest non-empty bucket.
-  for ( ; currentbucket_ != buckets_.end(); currentbucket_++,
-          currentcost_ += bucketsize_) {
-    if (!currentbucket_->empty()) {
-      return nextlabel();
-    }
+  uint32_t label = nextlabel();
+  if (label != kInvalidLabel) {
+    return label;
   }
 
   // No labels found in the low-level buckets. Return an invalid label if no
@@ -89,7 +108,7 @@ uint32_t DoubleBucketQueue::pop() {
   if (overflowbucket_.empty()) {
     // Reset currentbucket to the last bucket - in case another access of
     // adjacency list is done
-    currentbucket_--;
+    currentbucket_ = bucketcount_ - 1;
     return kInvalidLabel;
   }
 
@@ -97,49 +116,40 @@ uint32_t DoubleBucketQueue::pop() {
   // smallest bucket that is not empty and set it as the currentbucket and
   // return its first label.
   empty_overflow();
-  for (currentbucket_ = buckets_.begin(); currentbucket_ != buckets_.end();
-           currentbucket_++, currentcost_ += bucketsize_) {
-    if (!currentbucket_->empty()) {
-      return nextlabel();
-    }
-  }
-  return kInvalidLabel;
+  currentbucket_ = 0;
+  currentpos_ = 0;
+  return nextlabel();
 }
 
 // Empties the overflow bucket by placing the labels into the
 // low level buckets.
 void DoubleBucketQueue::empty_overflow() {
   bool found = false;
-  std::vector<uint32_t> tmp;
   while (!found && !overflowbucket_.empty()) {
     // Adjust cost range
     mincost_ += bucketrange_;
     maxcost_ += bucketrange_;
     currentcost_ = mincost_;
 
-    tmp.clear();
-    while (!overflowbucket_.empty()) {
-      uint32_t label = overflowbucket_.front();
-      overflowbucket_.pop_front();
-
-      // Get the cost (using the label cost function)
-      float cost = labelcost_(label);
-      if (cost < maxcost_) {
-        buckets_[static_cast<uint32_t>((cost-mincost_)*inv_)].push_back(label);
+    // Move labels within the new range into the low level buckets and
+    // compact the ones that lie outside the new range in place
+    uint32_t count = 0;
+    for (const auto& entry : overflowbucket_) {
+      if (entry.first == kInvalidLabel) {
+        continue;
+      }
+      if (entry.second < maxcost_) {
+        push(entry.first, entry.second,
+             static_cast<uint32_t>((entry.second - mincost_) * inv_));
         found = true;
       } else {
-        tmp.push_back(label);
+        positions_[entry.first] = { bucketcount_, count };
+        overflowbucket_[count++] = entry;
       }
     }
-
-    // Clear overflow and add any labels that lie outside the new range
-    overflowbucket_.clear();
-    for (auto label : tmp) {
-      overflowbucket_.push_back(label);
-    }
+    overflowbucket_.resize(count);
   }
 }
 
 }
 }
-
@@ -77,25 +77,37 @@ std::vector<std::string> EdgeInfo::GetNames() const {
   // Get each name
   std::vector<std::string> names; names.reserve(name_count());
   for (uint32_t i = 0; i < name_count(); i++) {
-    uint32_t offset = GetNameOffset(i);
-
-    if (offset < names_list_length_) {
-      names.push_back(names_list_ + offset);
-    } else {
-      throw std::runtime_error("GetNames: offset exceeds size of text list");
-    }
+    names.push_back(name(i));
   }
   return names;
 }
 
+// Get a name without copying it
+const char* EdgeInfo::name(uint8_t index) const {
+  uint32_t offset = GetNameOffset(index);
+  if (offset < names_list_length_) {
+    return names_list_ + offset;
+  }
+  throw std::runtime_error("GetNames: offset exceeds size of text list");
+}
+
 // Returns shape as a vector of PointLL
 const std::vector<PointLL>& EdgeInfo::shape() const {
   //if we haven't yet decoded the shape, do so
   if(encoded_shape_ != nullptr && shape_.empty())
-    shape_ = midgard::decode7<std::vector<PointLL> >(encoded_shape_, item_->encoded_shape_size);
+    midgard::decode7(encoded_shape_, item_->encoded_shape_size, shape_);
   return shape_;
 }
 
+// Decodes the shape into the vector
+void EdgeInfo::DecodeShape(std::vector<PointLL>& shape) const {
+  if (encoded_shape_ != nullptr) {
+    midgard::decode7(encoded_shape_, item_->encoded_shape_size, shape);
+  } else {
+    shape = shape_;
+  }
+}
+
 // Returns the encoded shape string
 std::string EdgeInfo::encoded_shape() const {
   return encoded_shape_ == nullptr ? midgard::encode7(shape_) : std::string(encoded_shape_, item_->encoded_shape_size);
@@ -18,20 +18,140 @@ namespace {
 namespace valhalla {
 namespace baldr {
 
+// Constructor for the lru tile cache
+TileCacheLRU::TileCacheLRU(size_t max_size)
+    : cache_size_(0),
+      max_cache_size_(max_size) {
+}
+
+// Reserves enough cache to hold (max_cache_size / tile_size) tiles.
+void TileCacheLRU::Reserve(size_t tile_size) {
+  cache_.reserve(max_cache_size_ / tile_size);
+}
+
+// Checks if tile exists in the cache.
+bool TileCacheLRU::Contains(const GraphId& graphid) const {
+  return cache_.find(graphid) != cache_.end();
+}
+
+// Puts a copy of a tile into the cache. Does not evict anything so that
+// pointers to cached tiles stay valid until the next Trim.
+const GraphTile* TileCacheLRU::Put(const GraphId& graphid, const GraphTile& tile, size_t size) {
+  auto cached = cache_.find(graphid);
+  if (cached != cache_.end()) {
+    lru_.splice(lru_.begin(), lru_, cached->second);
+    return &cached->second->tile;
+  }
+
+  lru_.push_front({graphid, tile, size});
+  cache_.emplace(graphid, lru_.begin());
+  cache_size_ += size;
+  return &lru_.front().tile;
+}
+
+// Get a pointer to a graph tile object given a GraphId. Marks the tile as
+// the most recently used one.
+const GraphTile* TileCacheLRU::Get(const GraphId& graphid) {
+  auto cached = cache_.find(graphid);
+  if (cached == cache_.end()) {
+    return nullptr;
+  }
+  if (cached->second != lru_.begin()) {
+    lru_.splice(lru_.begin(), lru_, cached->second);
+  }
+  return &cached->second->tile;
+}
+
+// Returns true if the cache is over committed with respect to the limit
+bool TileCacheLRU::OverCommitted() const {
+  return max_cache_size_ < cache_size_;
+}
+
+// Clears the cache
+void TileCacheLRU::Clear() {
+  cache_size_ = 0;
+  cache_.clear();
+  lru_.clear();
+}
+
+// Evicts tiles until the cache is within its limit
+void TileCacheLRU::Trim() {
+  MakeRoom(0);
+}
+
+// Evict least recently used tiles until the requested number of bytes fits
+void TileCacheLRU::MakeRoom(size_t size) {
+  while (!lru_.empty() && cache_size_ + size > max_cache_size_) {
+    const auto& entry = lru_.back();
+    cache_size_ -= entry.size;
+    cache_.erase(entry.id);
+    lru_.pop_back();
+  }
+}
+
+// Constructor for the shared tile cache
+SynchronizedTileCache::SynchronizedTileCache(size_t max_size)
+    : cache_(max_size) {
+  cache_.Reserve(AVERAGE_TILE_SIZE);
+}
+
+// Checks if tile exists in the cache.
+bool SynchronizedTileCache::Contains(const GraphId& graphid) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.Contains(graphid);
+}
+
+// Copies a tile out of the cache. The copy shares the tile memory.
+bool SynchronizedTileCache::Get(const GraphId& graphid, GraphTile& tile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const GraphTile* cached = cache_.Get(graphid);
+  if (cached == nullptr) {
+    return false;
+  }
+  tile = *cached;
+  return true;
+}
+
+// Puts a copy of a tile into the cache. Readers hold their own copies so
+// older tiles can be evicted right away.
+void SynchronizedTileCache::Put(const GraphId& graphid, const GraphTile& tile, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.Put(graphid, tile, size);
+  cache_.Trim();
+}
+
+// Clears the cache
+void SynchronizedTileCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.Clear();
+}
+
+// Evicts the least recently used tiles until the cache fits its limit.
+// Readers hold their own copies so evicting here invalidates nothing.
+void SynchronizedTileCache::Trim() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.Trim();
+}
+
 // Constructor using separate tile files
 GraphReader::GraphReader(const std::shared_ptr<GraphTileStorage>& tile_storage, const boost::property_tree::ptree& pt)
-    : tile_hierarchy_(tile_storage),
-      cache_size_(0) {
-  max_cache_size_ = pt.get<size_t>("max_cache_size", DEFAULT_MAX_CACHE_SIZE);
+    : GraphReader(tile_storage, pt, nullptr) {
+}
 
+// Constructor sharing tiles with readers on other threads
+GraphReader::GraphReader(const std::shared_ptr<GraphTileStorage>& tile_storage, const boost::property_tree::ptree& pt,
+                         const std::shared_ptr<SynchronizedTileCache>& shared_cache)
+    : tile_hierarchy_(tile_storage),
+      cache_(new TileCacheLRU(pt.get<size_t>("max_cache_size", DEFAULT_MAX_CACHE_SIZE))),
+      shared_cache_(shared_cache) {
   // Assume avg of 2 megs per tile
   // TODO: for mmapped tiles, should assume 4KB per tile
-  cache_.reserve(max_cache_size_/AVERAGE_TILE_SIZE);
+  cache_->Reserve(AVERAGE_TILE_SIZE);
 }
 
 // Method to test if tile exists
 bool GraphReader::DoesTileExist(const GraphId& graphid) const {
-  if(cache_.find(graphid) != cache_.end())
+  if(cache_->Contains(graphid) || (shared_cache_ && shared_cache_->Contains(graphid)))
     return true;
   return DoesTileExist(tile_hierarchy_, graphid);
 }
@@ -43,8 +163,6 @@ bool GraphReader::DoesTileExist(const TileHierarchy& tile_hierarchy, const Graph
 // Get a pointer to a graph tile object given a GraphId. Return nullptr
 // if the tile is not found/empty
 const GraphTile* GraphReader::GetGraphTile(const GraphId& graphid) {
-  //TODO: clear the cache automatically once we become overcommitted by a certain amount
-
   // Return nullptr if not a valid tile
   if (!graphid.Is_Valid()) {
     return nullptr;
@@ -52,20 +170,28 @@ const GraphTile* GraphReader::GetGraphTile(const GraphId& graphid) {
 
   // Check if the level/tileid combination is in the cache
   auto base = graphid.Tile_Base();
-  auto cached = cache_.find(base);
-  if(cached != cache_.end()) {
-    return &cached->second;
+  if(const GraphTile* cached = cache_->Get(base)) {
+    return cached;
+  }
+
+  // Try the cache shared with other threads before going to storage
+  GraphTile tile;
+  if (shared_cache_ && shared_cache_->Get(base, tile)) {
+    return cache_->Put(base, tile, tile.header()->end_offset());
   }
 
   // This reads the tile from disk
-  GraphTile tile(tile_hierarchy_, base);
+  tile = GraphTile(tile_hierarchy_, base);
   if (!tile.header())
     return nullptr;
 
-  // Keep a copy in the cache and return it
-  cache_size_ += tile.header()->end_offset();
-  auto inserted = cache_.emplace(base, std::move(tile));
-  return &inserted.first->second;
+  // Keep a copy in the cache(s) and return it. The local cache is only
+  // trimmed between requests so tiles in use are never evicted
+  size_t size = tile.header()->end_offset();
+  if (shared_cache_) {
+    shared_cache_->Put(base, tile, size);
+  }
+  return cache_->Put(base, tile, size);
 }
 
 const GraphTile* GraphReader::GetGraphTile(const PointLL& pointll, const uint8_t level){
@@ -83,13 +209,17 @@ const TileHierarchy& GraphReader::GetTileHierarchy() const {
 
 // Clears the cache
 void GraphReader::Clear() {
-  cache_size_ = 0;
-  cache_.clear();
+  cache_->Clear();
+}
+
+// Evicts the least recently used tiles until the cache is within its limit
+void GraphReader::Trim() {
+  cache_->Trim();
 }
 
 // Returns true if the cache is over committed with respect to the limit
 bool GraphReader::OverCommitted() const {
-  return max_cache_size_ < cache_size_;
+  return cache_->OverCommitted();
 }
 
 // Convenience method to get an opposing directed edge graph Id.
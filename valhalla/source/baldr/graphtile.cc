@@ -6,6 +6,7 @@
 #include "midgard/pointll.h"
 #include "midgard/logging.h"
 
+#include <algorithm>
 #include <ctime>
 #include <string>
 #include <vector>
@@ -14,6 +15,8 @@
 #include <locale>
 #include <iomanip>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
 #include <boost/algorithm/string.hpp>
 
 namespace {
@@ -38,11 +41,67 @@ namespace {
   }
   const std::locale dir_locale(std::locale("C"), new dir_facet());
   const AABB2<PointLL> world_box(PointLL(-180, -90), PointLL(180, 90));
+
+  // Orders records sorted by edge index against an edge index
+  template <class record_t>
+  struct edgeindex_less {
+    bool operator()(const record_t& record, const uint32_t idx) const {
+      return record.edgeindex() < idx;
+    }
+    bool operator()(const uint32_t idx, const record_t& record) const {
+      return idx < record.edgeindex();
+    }
+  };
+
+  // Orders departures sorted by line Id against a line Id
+  struct lineid_less {
+    bool operator()(const valhalla::baldr::TransitDeparture& dep, const uint32_t lineid) const {
+      return dep.lineid() < lineid;
+    }
+    bool operator()(const uint32_t lineid, const valhalla::baldr::TransitDeparture& dep) const {
+      return lineid < dep.lineid();
+    }
+  };
 }
 
 namespace valhalla {
 namespace baldr {
 
+// Most data kept attached to a tile. Edge costs take 9 bytes per edge for
+// each costing profile, so only the profiles used last are kept.
+constexpr size_t kMaxAttachments = 4;
+
+// Data attached to a tile, keyed by whoever attached it. There are only a
+// few so they are searched in order, most recently used first, and the least
+// recently used is dropped first.
+struct GraphTile::attachments_t {
+  std::mutex mutex;
+  std::vector<std::pair<uint64_t, std::shared_ptr<const void>>> data;
+
+  // Find the data attached with a key and make it the most recently used
+  std::shared_ptr<const void>* find(const uint64_t key) {
+    for (auto it = data.begin(); it != data.end(); ++it) {
+      if (it->first == key) {
+        std::rotate(data.begin(), it, it + 1);
+        return &data.front().second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// Number of decoded shapes kept per tile
+constexpr uint32_t kShapeCacheBits = 8;
+constexpr uint32_t kShapeCacheSize = 1 << kShapeCacheBits;
+
+// Decoded shapes, direct mapped by edge info offset. An entry is replaced by
+// the next shape that maps to it, readers hold their own references.
+struct GraphTile::shape_cache_t {
+  std::mutex mutex;
+  uint32_t offsets[kShapeCacheSize];
+  std::shared_ptr<const std::vector<PointLL>> shapes[kShapeCacheSize];
+};
+
 // Default constructor
 GraphTile::GraphTile()
     : header_(nullptr),
@@ -77,13 +136,11 @@ GraphTile::GraphTile(const TileHierarchy& hierarchy, const GraphId& graphid): he
   if (!graphid.Is_Valid())
     return;
 
-  std::vector<char> tile_data;
-  if (hierarchy.tile_storage()->ReadTile(graphid, hierarchy, tile_data)) {
-    graphtile_.reset(new std::vector<char>(tile_data.size()));
-    std::copy(tile_data.begin(), tile_data.end(), graphtile_->data());
-
+  // Take over the tile memory from the storage, no copy needed
+  size_t tile_size = 0;
+  if (hierarchy.tile_storage()->ReadTile(graphid, hierarchy, graphtile_, tile_size)) {
     // Set pointers to internal data structures
-    Initialize(graphid, graphtile_->data(), graphtile_->size());
+    Initialize(graphid, const_cast<char*>(graphtile_.get()), tile_size);
   }
   else {
     LOG_DEBUG("Tile " + file_location + " was not found");
@@ -102,6 +159,8 @@ GraphTile::~GraphTile() {
 // Set pointers to internal tile data structures
 void GraphTile::Initialize(const GraphId& graphid, char* tile_ptr,
                            const size_t tile_size) {
+  attachments_ = std::make_shared<attachments_t>();
+  shape_cache_ = std::make_shared<shape_cache_t>();
   char* ptr = tile_ptr;
   header_ = reinterpret_cast<GraphTileHeader*>(ptr);
   ptr += sizeof(GraphTileHeader);
@@ -384,25 +443,10 @@ std::vector<ComplexRestriction> GraphTile::GetRestrictions(const bool forward,
                                                            const GraphId id,
                                                            const uint64_t modes) const {
   std::vector<ComplexRestriction> cr_vector;
-  size_t offset = 0;
-
-  if (forward) {
-    while (offset < complex_restriction_forward_size_) {
-
-      ComplexRestriction cr(complex_restriction_forward_ + offset);
-      offset += cr.SizeOf();
-      if (cr.to_id() == id && (cr.modes() & modes))
-        cr_vector.push_back(cr);
-    }
-  } else {
-    while (offset < complex_restriction_reverse_size_) {
-
-      ComplexRestriction cr(complex_restriction_reverse_ + offset);
-      offset += cr.SizeOf();
-      if (cr.from_id() == id && (cr.modes() & modes))
-        cr_vector.push_back(cr);
-    }
-  }
+  VisitRestrictions(forward, id, modes, [&cr_vector](const ComplexRestriction& cr) {
+    cr_vector.push_back(cr);
+    return true;
+  });
   return cr_vector;
 }
 
@@ -422,6 +466,34 @@ std::vector<std::string> GraphTile::GetNames(const uint32_t edgeinfo_offset) con
   return edgeinfo(edgeinfo_offset).GetNames();
 }
 
+// Get the shape of an edge, decoding it only if it is not in the cache
+std::shared_ptr<const std::vector<PointLL>> GraphTile::GetShape(const uint32_t edgeinfo_offset) const {
+  if (!shape_cache_) {
+    auto shape = std::make_shared<std::vector<PointLL>>();
+    edgeinfo(edgeinfo_offset).DecodeShape(*shape);
+    return shape;
+  }
+
+  // Offsets are the byte offsets of variable size records, mix them up a bit
+  const uint32_t slot = (edgeinfo_offset * 2654435761u) >> (32 - kShapeCacheBits);
+  {
+    std::lock_guard<std::mutex> lock(shape_cache_->mutex);
+    const auto& shape = shape_cache_->shapes[slot];
+    if (shape && shape_cache_->offsets[slot] == edgeinfo_offset) {
+      return shape;
+    }
+  }
+
+  // Decode outside of the lock
+  auto shape = std::make_shared<std::vector<PointLL>>();
+  edgeinfo(edgeinfo_offset).DecodeShape(*shape);
+
+  std::lock_guard<std::mutex> lock(shape_cache_->mutex);
+  shape_cache_->offsets[slot] = edgeinfo_offset;
+  shape_cache_->shapes[slot] = shape;
+  return shape;
+}
+
 // Get the admininfo at the specified index.
 AdminInfo GraphTile::admininfo(const size_t idx) const {
   if (idx < header_->admincount()) {
@@ -451,49 +523,37 @@ std::string GraphTile::GetName(const uint32_t textlist_offset) const {
   }
 }
 
+// Get the text at an offset in the text list without copying it
+const char* GraphTile::text(const uint32_t textlist_offset) const {
+  if (textlist_offset < textlist_size_) {
+    return textlist_ + textlist_offset;
+  }
+  throw std::runtime_error("GraphTile text offset exceeds size of text list");
+}
+
 // Convenience method to get the signs for an edge given the
 // directed edge index.
 std::vector<SignInfo> GraphTile::GetSigns(const uint32_t idx) const {
-  uint32_t count = header_->signcount();
   std::vector<SignInfo> signs;
-  if (count == 0) {
-    return signs;
-  }
-
-  // Signs are sorted by edge index.
-  // Binary search to find a sign with matching edge index.
-  int32_t low = 0;
-  int32_t high = count-1;
-  int32_t mid;
-  int32_t found = count;
-  while (low <= high) {
-    mid = (low + high) / 2;
-    const auto& sign = signs_[mid];
-    //matching edge index
-    if (idx == sign.edgeindex()) {
-      found = mid;
-      high = mid - 1;
-    }//need a smaller index
-    else if (idx < sign.edgeindex()) {
-      high = mid - 1;
-    }//need a bigger index
-    else {
-      low = mid + 1;
-    }
-  }
-
-  // Add signs
-  for(; found < count && signs_[found].edgeindex() == idx; ++found) {
-    if (signs_[found].text_offset() < textlist_size_)
-      signs.emplace_back(signs_[found].type(), (textlist_ + signs_[found].text_offset()));
+  for (const auto& sign : this->signs(idx)) {
+    if (sign.text_offset() < textlist_size_)
+      signs.emplace_back(sign.type(), (textlist_ + sign.text_offset()));
     else
       throw std::runtime_error("GetSigns: offset exceeds size of text list");
   }
-  if (signs.size() == 0)
+  if (signs.size() == 0 && header_->signcount() > 0)
     LOG_ERROR("No signs found for idx = " + std::to_string(idx));
   return signs;
 }
 
+// Get the signs of an edge in place. Signs are sorted by edge index.
+midgard::iterable_t<const Sign> GraphTile::signs(const uint32_t idx) const {
+  const Sign* first = signs_;
+  const Sign* last = signs_ + header_->signcount();
+  const auto range = std::equal_range(first, last, idx, edgeindex_less<Sign>());
+  return midgard::iterable_t<const Sign>(range.first, range.second);
+}
+
 // Get the next departure given the directed line Id and the current
 // time (seconds from midnight).
 const TransitDeparture* GraphTile::GetNextDeparture(const uint32_t lineid,
@@ -572,50 +632,21 @@ const TransitDeparture* GraphTile::GetNextDeparture(const uint32_t lineid,
 // Get the departure given the line Id and tripid
 const TransitDeparture* GraphTile::GetTransitDeparture(const uint32_t lineid,
                      const uint32_t tripid, const uint32_t current_time) const {
-  uint32_t count = header_->departurecount();
-  if (count == 0) {
-    return nullptr;
-  }
-
-  // Departures are sorted by edge Id and then by departure time.
-  // Binary search to find a departure with matching line Id.
-  int32_t low = 0;
-  int32_t high = count-1;
-  int32_t mid;
-  int32_t found = count;
-  while (low <= high) {
-    mid = (low + high) / 2;
-    const auto& dep = departures_[mid];
-    //find the first matching lineid in the list
-    if (lineid == dep.lineid()) {
-      found = mid;
-      high = mid - 1;
-    }//need a smaller lineid
-    else if (lineid < dep.lineid()) {
-      high = mid - 1;
-    }//need a bigger lineid
-    else {
-      low = mid + 1;
-    }
-  }
-
-  // Iterate through departures until one is found with matching trip id
-  for(; found < count && departures_[found].lineid() == lineid; ++found) {
-    if (departures_[found].tripid() == tripid) {
+  // Iterate through the departures of the line until one is found with
+  // matching trip id
+  for (const auto& d : departures(lineid)) {
+    if (d.tripid() == tripid) {
 
-      if (departures_[found].type() == kFixedSchedule)
-        return &departures_[found];
+      if (d.type() == kFixedSchedule)
+        return &d;
 
-      uint32_t departure_time = departures_[found].departure_time();
-      uint32_t end_time = departures_[found].end_time();
-      uint32_t frequency = departures_[found].frequency();
+      uint32_t departure_time = d.departure_time();
+      uint32_t end_time = d.end_time();
+      uint32_t frequency = d.frequency();
       while (departure_time < current_time && departure_time < end_time)
         departure_time += frequency;
 
       if (departure_time >= current_time && departure_time < end_time) {
-
-        const auto& d = departures_[found];
-
         const TransitDeparture *dep = new TransitDeparture(d.lineid(),d.tripid(), d.routeid(),
                                                            d.blockid(), d.headsign_offset(), departure_time,
                                                            d.end_time(),d.frequency(),
@@ -643,6 +674,15 @@ std::unordered_map<uint32_t,TransitDeparture*> GraphTile::GetTransitDepartures()
   return deps;
 }
 
+// Get the departures of a line in place. Departures are sorted by line Id
+// and then by departure time.
+midgard::iterable_t<const TransitDeparture> GraphTile::departures(const uint32_t lineid) const {
+  const TransitDeparture* first = departures_;
+  const TransitDeparture* last = departures_ + header_->departurecount();
+  const auto range = std::equal_range(first, last, lineid, lineid_less());
+  return midgard::iterable_t<const TransitDeparture>(range.first, range.second);
+}
+
 // Get the stop onestops in this tile
 std::unordered_map<std::string, tile_index_pair>
 GraphTile::GetStopOneStops() const {
@@ -700,44 +740,26 @@ const TransitSchedule* GraphTile::GetTransitSchedule(const uint32_t idx) const {
 std::vector<AccessRestriction> GraphTile::GetAccessRestrictions(const uint32_t idx,
                                                                 const uint32_t access) const {
 
-  std::vector<AccessRestriction> restrictions;
-  uint32_t count = header_->access_restriction_count();
-  if (count == 0) {
-    return restrictions;
-  }
-
-  // Access restriction are sorted by edge Id.
-  // Binary search to find a access restriction with matching edge Id.
-  int32_t low = 0;
-  int32_t high = count-1;
-  int32_t mid;
-  int32_t found = count;
-  while (low <= high) {
-    mid = (low + high) / 2;
-    const auto& res = access_restrictions_[mid];
-    //find the first matching index in the list
-    if (idx == res.edgeindex()) {
-      found = mid;
-      high = mid - 1;
-    }//need a smaller index
-    else if (idx < res.edgeindex()) {
-      high = mid - 1;
-    }//need a bigger index
-    else {
-      low = mid + 1;
-    }
-  }
-
   // Add restrictions for only the access that we are interested in
-  for (; found < count && access_restrictions_[found].edgeindex() == idx; ++found)
-    if (access_restrictions_[found].modes() & access)
-      restrictions.emplace_back(access_restrictions_[found]);
+  std::vector<AccessRestriction> restrictions;
+  for (const auto& restriction : access_restrictions(idx))
+    if (restriction.modes() & access)
+      restrictions.emplace_back(restriction);
 
-  if (restrictions.size() == 0)
+  if (restrictions.size() == 0 && header_->access_restriction_count() > 0)
     LOG_ERROR("No restrictions found for edge index = " + std::to_string(idx));
   return restrictions;
 }
 
+// Get the access restrictions of an edge in place. Access restrictions are
+// sorted by edge index.
+midgard::iterable_t<const AccessRestriction> GraphTile::access_restrictions(const uint32_t idx) const {
+  const AccessRestriction* first = access_restrictions_;
+  const AccessRestriction* last = access_restrictions_ + header_->access_restriction_count();
+  const auto range = std::equal_range(first, last, idx, edgeindex_less<AccessRestriction>());
+  return midgard::iterable_t<const AccessRestriction>(range.first, range.second);
+}
+
 // Get the array of graphids for this bin
 midgard::iterable_t<GraphId> GraphTile::GetBin(size_t column, size_t row) const {
   auto offsets = header_->bin_offset(column, row);
@@ -749,6 +771,38 @@ midgard::iterable_t<GraphId> GraphTile::GetBin(size_t index) const {
   return iterable_t<GraphId>{edge_bins_ + offsets.first, edge_bins_ + offsets.second};
 }
 
+// Get the data attached with the key
+std::shared_ptr<const void> GraphTile::GetAttachment(const uint64_t key) const {
+  if (!attachments_) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(attachments_->mutex);
+  auto found = attachments_->find(key);
+  return found == nullptr ? nullptr : *found;
+}
+
+// Attach data, keeps what was already attached with the key if anything.
+// Tiles that were never initialized have nowhere to store it.
+std::shared_ptr<const void> GraphTile::Attach(const uint64_t key,
+                            const std::shared_ptr<const void>& data) const {
+  if (!attachments_) {
+    return data;
+  }
+  std::lock_guard<std::mutex> lock(attachments_->mutex);
+  auto found = attachments_->find(key);
+  if (found != nullptr) {
+    return *found;
+  }
+
+  // Drop the least recently used attachment, whoever holds it keeps their
+  // reference
+  if (attachments_->data.size() == kMaxAttachments) {
+    attachments_->data.pop_back();
+  }
+  attachments_->data.emplace(attachments_->data.begin(), key, data);
+  return data;
+}
+
 // Get traffic segment(s) associated to this edge.
 std::vector<TrafficSegment> GraphTile::GetTrafficSegments(const size_t idx) const {
   if (idx < header_->traffic_id_count()) {
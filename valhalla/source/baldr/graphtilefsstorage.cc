@@ -11,6 +11,9 @@
 #include <iomanip>
 #include <mutex>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
@@ -153,10 +156,16 @@ bool GraphTileFsStorage::ReadTile(const GraphId& graphid, const TileHierarchy& t
     else {
       std::ifstream file(file_location + ".gz", std::ios::in | std::ios::binary | std::ios::ate);
       if (file.is_open()) {
-        // Pre-allocate assuming 3.25:1 compression ratio (based on scanning some large NA tiles)
+        // Pre-allocate from the uncompressed size (mod 2^32) in the gzip trailer
         size_t filesize = file.tellg();
+        unsigned char isize[4] = { 0, 0, 0, 0 };
+        if (filesize >= sizeof(isize)) {
+          file.seekg(filesize - sizeof(isize), std::ios::beg);
+          file.read(reinterpret_cast<char*>(isize), sizeof(isize));
+        }
         file.seekg(0, std::ios::beg);
-        tile_data.reserve(filesize * 3 + filesize/4);  // TODO: read the gzip footer and get the real size?
+        tile_data.reserve(static_cast<size_t>(isize[0]) | (static_cast<size_t>(isize[1]) << 8) |
+                          (static_cast<size_t>(isize[2]) << 16) | (static_cast<size_t>(isize[3]) << 24));
 
         // Decompress tile into memory
         boost::iostreams::filtering_ostream os;
@@ -170,6 +179,41 @@ bool GraphTileFsStorage::ReadTile(const GraphId& graphid, const TileHierarchy& t
   return false;
 }
 
+bool GraphTileFsStorage::ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::shared_ptr<const char>& tile_memory, size_t& tile_size) const {
+  if (tile_extract_->tiles.size()) {
+    // Reference the tile inside the extract, the extract stays alive with it
+    auto it = tile_extract_->tiles.find(graphid);
+    if (it != tile_extract_->tiles.cend()) {
+      tile_memory = std::shared_ptr<const char>(tile_extract_, it->second.first);
+      tile_size = it->second.second;
+      return true;
+    }
+    return false;
+  }
+
+  // Map uncompressed tiles, compressed ones have to be read into memory
+  std::string file_location = tile_dir_ + "/" + FileSuffix(graphid.Tile_Base(), tile_hierarchy);
+  int fd = open(file_location.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return GraphTileStorage::ReadTile(graphid, tile_hierarchy, tile_memory, tile_size);
+  }
+  struct stat s;
+  void* ptr = MAP_FAILED;
+  if (fstat(fd, &s) == 0 && s.st_size > 0) {
+    ptr = mmap(nullptr, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return GraphTileStorage::ReadTile(graphid, tile_hierarchy, tile_memory, tile_size);
+  }
+  size_t size = s.st_size;
+  tile_memory = std::shared_ptr<const char>(static_cast<const char*>(ptr), [size](const char* p) {
+    munmap(const_cast<char*>(p), size);
+  });
+  tile_size = size;
+  return true;
+}
+
 bool GraphTileFsStorage::ReadTileRealTimeSpeeds(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<uint8_t>& rts_data) const {
   // Try to load the speeds file
   auto tileid = graphid.tileid();
@@ -2,8 +2,12 @@
 #include <valhalla/midgard/pointll.h>
 #include <valhalla/midgard/aabb2.h>
 #include <valhalla/midgard/tiles.h>
+#include <valhalla/midgard/logging.h>
 
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <climits>
 #include <locale>
 #include <iomanip>
 #include <boost/algorithm/string.hpp>
@@ -50,94 +54,115 @@ namespace {
     if (flags & (1 << 1)) { // FCRC
       offset += 2;
     }
+    if (offset + 8 > in_size) {
+      return false;
+    }
+
+    // The gzip trailer holds the uncompressed size (mod 2^32), use it to
+    // size the output once and inflate straight into it in a single call.
+    // A tile that does not fit (its size wrapped past 4GB) is rejected.
+    size_t out_size = static_cast<size_t>(in[in_size - 4]) | (static_cast<size_t>(in[in_size - 3]) << 8) |
+                      (static_cast<size_t>(in[in_size - 2]) << 16) | (static_cast<size_t>(in[in_size - 1]) << 24);
+    out.resize(std::max(out_size, in_size));
 
-    char buf[4096];
     ::mz_stream infstream;
     std::memset(&infstream, 0, sizeof(infstream));
     infstream.zalloc = NULL;
     infstream.zfree = NULL;
     infstream.opaque = NULL;
-    int err = MZ_OK;
-    infstream.avail_in = static_cast<unsigned int>(in_size - offset - 4); // size of input
+    infstream.avail_in = static_cast<unsigned int>(in_size - offset - 8); // size of input without the trailer
     infstream.next_in = &in[offset];
-    infstream.avail_out = sizeof(buf); // size of output
-    infstream.next_out = reinterpret_cast<unsigned char *>(&buf[0]); // output char array
+    infstream.avail_out = static_cast<unsigned int>(std::min(out.size(), static_cast<size_t>(UINT_MAX))); // size of output
+    infstream.next_out = reinterpret_cast<unsigned char *>(&out[0]); // output char array
     ::mz_inflateInit2(&infstream, -MZ_DEFAULT_WINDOW_BITS);
-    do {
-      infstream.avail_out = sizeof(buf); // size of output
-      infstream.next_out = reinterpret_cast<unsigned char *>(&buf[0]); // output char array
-      err = ::mz_inflate(&infstream, infstream.avail_in > 0 ? MZ_NO_FLUSH : MZ_FINISH);
-      if (err != MZ_OK && err != MZ_STREAM_END) {
-        break;
-      }
-      out.insert(out.end(), buf, buf + sizeof(buf) - infstream.avail_out);
-    } while (err != MZ_STREAM_END);
+    int err = ::mz_inflate(&infstream, MZ_FINISH);
     ::mz_inflateEnd(&infstream);
-    return err == MZ_OK || err == MZ_STREAM_END;
+    out.resize(infstream.total_out);
+    return err == MZ_STREAM_END;
   }
 }
 
 namespace valhalla {
 namespace baldr {
 
-GraphTileMBTStorage::GraphTileMBTStorage(const std::vector<std::shared_ptr<sqlite3pp::database>>& dbs)
-    : mbt_dbs_(dbs) {
+GraphTileMBTStorage::GraphTileMBTStorage(const std::vector<std::shared_ptr<sqlite3pp::database>>& dbs) {
+  for (auto& db : dbs) {
+    std::unique_ptr<ConnectionPool> pool(new ConnectionPool());
+    std::unique_ptr<Connection> connection(new Connection { db, nullptr });
+    pool->idle.push_back(connection.get());
+    pool->connections.push_back(std::move(connection));
+    pools_.push_back(std::move(pool));
+  }
 }
 
-std::unordered_set<GraphId> GraphTileMBTStorage::FindTiles(const TileHierarchy& tile_hierarchy) const {
-  std::unordered_set<GraphId> graphids;
-  for (auto& mbt_db : mbt_dbs_) {
-    try {
-      sqlite3pp::query query(*mbt_db, "SELECT zoom_level, tile_column, tile_row FROM tiles");
-      for (auto it = query.begin(); it != query.end(); it++) {
-        int z = (*it).get<int>(0);
-        int x = (*it).get<int>(1);
-        int y = (*it).get<int>(2);
-        graphids.insert(ToGraphId(std::make_tuple(z, x, y), tile_hierarchy));
+GraphTileMBTStorage::GraphTileMBTStorage(const std::vector<std::string>& db_files, size_t pool_size) {
+  for (auto& db_file : db_files) {
+    std::unique_ptr<ConnectionPool> pool(new ConnectionPool());
+    for (size_t i = 0; i < std::max(pool_size, size_t(1)); i++) {
+      auto db = std::make_shared<sqlite3pp::database>();
+      if (db->connect_v2(db_file.c_str(), SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX) != SQLITE_OK) {
+        throw std::runtime_error("Failed to open routing database " + db_file);
       }
-    } catch (const std::exception&) {
+      std::unique_ptr<Connection> connection(new Connection { db, nullptr });
+      pool->idle.push_back(connection.get());
+      pool->connections.push_back(std::move(connection));
     }
+    pools_.push_back(std::move(pool));
+  }
+}
+
+GraphTileMBTStorage::~GraphTileMBTStorage() {
+}
+
+std::unordered_set<GraphId> GraphTileMBTStorage::FindTiles(const TileHierarchy& tile_hierarchy) const {
+  BuildTileIndex(tile_hierarchy);
+  std::unordered_set<GraphId> graphids;
+  graphids.reserve(tile_index_.size());
+  for (const auto& tile : tile_index_) {
+    graphids.insert(tile.first);
   }
   return graphids;
 }
 
 bool GraphTileMBTStorage::DoesTileExist(const GraphId& graphid, const TileHierarchy& tile_hierarchy) const {
-  for (auto& mbt_db : mbt_dbs_) {
-    try {
-      std::tuple<int, int, int> tile_coords = FromGraphId(graphid, tile_hierarchy);
-      sqlite3pp::query query(*mbt_db, "SELECT COUNT(*) FROM tiles WHERE zoom_level=:z AND tile_row=:y and tile_column=:y");
-      query.bind(":z", std::get<0>(tile_coords));
-      query.bind(":x", std::get<1>(tile_coords));
-      query.bind(":y", std::get<2>(tile_coords));
-      for (auto it = query.begin(); it != query.end(); it++) {
-        if ((*it).get<int>(0) > 0) {
-          return true;
-        }
-      }
-    } catch (const std::exception&) {
-    }
-  }
-  return false;
+  BuildTileIndex(tile_hierarchy);
+  return tile_index_.find(graphid.Tile_Base()) != tile_index_.end();
 }
 
 bool GraphTileMBTStorage::ReadTile(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<char>& tile_data) const {
-  for (auto& mbt_db : mbt_dbs_) {
-    try {
-      std::tuple<int, int, int> tile_coords = FromGraphId(graphid, tile_hierarchy);
-      sqlite3pp::query query(*mbt_db, "SELECT tile_data FROM tiles WHERE zoom_level=:z AND tile_row=:y and tile_column=:x");
-      query.bind(":z", std::get<0>(tile_coords));
-      query.bind(":x", std::get<1>(tile_coords));
-      query.bind(":y", std::get<2>(tile_coords));
-      for (auto it = query.begin(); it != query.end(); it++) {
-        std::size_t data_size = (*it).column_bytes(0);
-        const unsigned char* data_ptr = static_cast<const unsigned char*>((*it).get<const void*>(0));
-        tile_data.clear();
-        return inflate(data_ptr, data_size, tile_data);
-      }
-    } catch (const std::exception&) {
+  BuildTileIndex(tile_hierarchy);
+  auto tile = tile_index_.find(graphid.Tile_Base());
+  if (tile == tile_index_.end()) {
+    return false;
+  }
+
+  ConnectionPool& pool = *pools_[tile->second];
+  Connection* connection = pool.Acquire();
+  bool success = false;
+  try {
+    // Prepare the statement once per connection, afterwards only rebind it
+    if (!connection->tile_query) {
+      connection->tile_query.reset(new sqlite3pp::query(*connection->db, "SELECT tile_data FROM tiles WHERE zoom_level=:z AND tile_row=:y and tile_column=:x"));
     }
+    sqlite3pp::query& query = *connection->tile_query;
+    std::tuple<int, int, int> tile_coords = FromGraphId(graphid, tile_hierarchy);
+    query.bind(":z", std::get<0>(tile_coords));
+    query.bind(":x", std::get<1>(tile_coords));
+    query.bind(":y", std::get<2>(tile_coords));
+    for (auto it = query.begin(); it != query.end(); it++) {
+      std::size_t data_size = (*it).column_bytes(0);
+      const unsigned char* data_ptr = static_cast<const unsigned char*>((*it).get<const void*>(0));
+      tile_data.clear();
+      success = inflate(data_ptr, data_size, tile_data);
+      break;
+    }
+    query.reset();
+  } catch (const std::exception& e) {
+    LOG_ERROR("Failed to read tile " + std::to_string(graphid.tileid()) + " level " + std::to_string(graphid.level()) + ": " + e.what());
+    connection->tile_query.reset();
   }
-  return false;
+  pool.Release(connection);
+  return success;
 }
 
 bool GraphTileMBTStorage::ReadTileRealTimeSpeeds(const GraphId& graphid, const TileHierarchy& tile_hierarchy, std::vector<uint8_t>& rts_data) const {
@@ -153,6 +178,44 @@ std::tuple<int, int, int> GraphTileMBTStorage::FromGraphId(const GraphId& graphi
   return std::tuple<int, int, int>(graphid.level(), coords.second, coords.first);
 }
 
+void GraphTileMBTStorage::BuildTileIndex(const TileHierarchy& tile_hierarchy) const {
+  std::call_once(tile_index_flag_, [this, &tile_hierarchy]() {
+    // Tiles found in earlier databases take precedence
+    for (size_t i = 0; i < pools_.size(); i++) {
+      ConnectionPool& pool = *pools_[i];
+      Connection* connection = pool.Acquire();
+      try {
+        sqlite3pp::query query(*connection->db, "SELECT zoom_level, tile_column, tile_row FROM tiles");
+        for (auto it = query.begin(); it != query.end(); it++) {
+          int z = (*it).get<int>(0);
+          int x = (*it).get<int>(1);
+          int y = (*it).get<int>(2);
+          tile_index_.emplace(ToGraphId(std::make_tuple(z, x, y), tile_hierarchy), i);
+        }
+      } catch (const std::exception& e) {
+        LOG_ERROR(std::string("Failed to list tiles: ") + e.what());
+      }
+      pool.Release(connection);
+    }
+  });
+}
+
+GraphTileMBTStorage::Connection* GraphTileMBTStorage::ConnectionPool::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex);
+  available.wait(lock, [this]() { return !idle.empty(); });
+  Connection* connection = idle.back();
+  idle.pop_back();
+  return connection;
+}
+
+void GraphTileMBTStorage::ConnectionPool::Release(Connection* connection) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(connection);
+  }
+  available.notify_one();
+}
+
 GraphId GraphTileMBTStorage::ToGraphId(const std::tuple<int, int, int>& tile_coords, const TileHierarchy& tile_hierarchy) {
   auto it = tile_hierarchy.levels().find(std::get<0>(tile_coords));
   if (it == tile_hierarchy.levels().end()) {
@@ -0,0 +1,201 @@
+#include "baldr/graphtilemmapstorage.h"
+#include <valhalla/midgard/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+  constexpr uint32_t EXTRACT_MAGIC = 0x58485456; // "VTHX"
+  constexpr uint32_t EXTRACT_VERSION = 1;
+  constexpr uint64_t TILE_ALIGNMENT = 8;
+}
+
+namespace valhalla {
+namespace baldr {
+
+// Read-only mapping of the whole extract file
+struct GraphTileMMapStorage::mapping_t {
+  mapping_t(const std::string& file_name): ptr(nullptr), size(0) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error(file_name + ": could not open extract");
+    }
+    LARGE_INTEGER file_size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+      mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (mapping == nullptr) {
+      throw std::runtime_error(file_name + ": could not map extract");
+    }
+    ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (ptr == nullptr) {
+      throw std::runtime_error(file_name + ": could not map extract");
+    }
+    size = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::runtime_error(file_name + "(open): " + strerror(errno));
+    }
+    struct stat s;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &s) == 0 && s.st_size > 0) {
+      p = mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (p == MAP_FAILED) {
+      throw std::runtime_error(file_name + "(mmap): " + strerror(errno));
+    }
+    ptr = static_cast<const char*>(p);
+    size = s.st_size;
+#endif
+  }
+
+  ~mapping_t() {
+#ifdef _WIN32
+    UnmapViewOfFile(ptr);
+#else
+    munmap(const_cast<char*>(ptr), size);
+#endif
+  }
+
+  mapping_t(const mapping_t&) = delete;
+  mapping_t& operator=(const mapping_t&) = delete;
+
+  const char* ptr;
+  size_t size;
+};
+
+GraphTileMMapStorage::GraphTileMMapStorage(const std::string& extract_file)
+    : mapping_(std::make_shared<mapping_t>(extract_file)) {
+  // Validate the header and the index before trusting any offsets
+  if (mapping_->size < sizeof(header_t)) {
+    throw std::runtime_error(extract_file + ": not a tile extract");
+  }
+  const header_t* header = reinterpret_cast<const header_t*>(mapping_->ptr);
+  if (header->magic != EXTRACT_MAGIC || header->version != EXTRACT_VERSION ||
+      header->tile_count > (mapping_->size - sizeof(header_t)) / sizeof(index_entry_t)) {
+    throw std::runtime_error(extract_file + ": not a tile extract or unsupported version");
+  }
+  index_begin_ = reinterpret_cast<const index_entry_t*>(mapping_->ptr + sizeof(header_t));
+  index_end_ = index_begin_ + header->tile_count;
+  for (auto entry = index_begin_; entry != index_end_; ++entry) {
+    if (entry->offset > mapping_->size || entry->size > mapping_->size - entry->offset) {
+      throw std::runtime_error(extract_file + ": corrupt tile index");
+    }
+  }
+  LOG_INFO("Tile extract " + extract_file + " mapped with " + std::to_string(header->tile_count) + " tiles");
+}
+
+std::unordered_set<GraphId> GraphTileMMapStorage::FindTiles(const TileHierarchy&) const {
+  std::unordered_set<GraphId> graphids;
+  graphids.reserve(index_end_ - index_begin_);
+  for (auto entry = index_begin_; entry != index_end_; ++entry) {
+    graphids.emplace(entry->graphid);
+  }
+  return graphids;
+}
+
+bool GraphTileMMapStorage::DoesTileExist(const GraphId& graphid, const TileHierarchy&) const {
+  return Find(graphid) != nullptr;
+}
+
+bool GraphTileMMapStorage::ReadTile(const GraphId& graphid, const TileHierarchy&, std::vector<char>& tile_data) const {
+  const index_entry_t* entry = Find(graphid);
+  if (entry == nullptr) {
+    return false;
+  }
+  const char* tile_ptr = mapping_->ptr + entry->offset;
+  tile_data.assign(tile_ptr, tile_ptr + entry->size);
+  return true;
+}
+
+bool GraphTileMMapStorage::ReadTile(const GraphId& graphid, const TileHierarchy&, std::shared_ptr<const char>& tile_memory, size_t& tile_size) const {
+  const index_entry_t* entry = Find(graphid);
+  if (entry == nullptr) {
+    return false;
+  }
+  tile_memory = std::shared_ptr<const char>(mapping_, mapping_->ptr + entry->offset);
+  tile_size = entry->size;
+  return true;
+}
+
+bool GraphTileMMapStorage::ReadTileRealTimeSpeeds(const GraphId&, const TileHierarchy&, std::vector<uint8_t>&) const {
+  return false;
+}
+
+const GraphTileMMapStorage::index_entry_t* GraphTileMMapStorage::Find(const GraphId& graphid) const {
+  uint64_t id = graphid.Tile_Base();
+  auto entry = std::lower_bound(index_begin_, index_end_, id,
+                                [](const index_entry_t& e, uint64_t id) { return e.graphid < id; });
+  return (entry != index_end_ && entry->graphid == id) ? entry : nullptr;
+}
+
+bool GraphTileMMapStorage::Create(const GraphTileStorage& storage, const TileHierarchy& tile_hierarchy, const std::string& extract_file) {
+  auto tileset = storage.FindTiles(tile_hierarchy);
+  std::vector<GraphId> tiles(tileset.begin(), tileset.end());
+  std::sort(tiles.begin(), tiles.end());
+
+  std::ofstream file(extract_file, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    LOG_ERROR("Could not open " + extract_file + " for writing");
+    return false;
+  }
+
+  // Write the header and leave room for the index, it is filled in once
+  // the tile sizes are known
+  header_t header { EXTRACT_MAGIC, EXTRACT_VERSION, tiles.size() };
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  std::vector<index_entry_t> index;
+  index.reserve(tiles.size());
+  uint64_t offset = sizeof(header_t) + tiles.size() * sizeof(index_entry_t);
+  file.seekp(offset);
+
+  std::vector<char> tile_data;
+  const char padding[TILE_ALIGNMENT] = { };
+  for (const auto& graphid : tiles) {
+    tile_data.clear();
+    if (!storage.ReadTile(graphid, tile_hierarchy, tile_data)) {
+      LOG_WARN("Skipping unreadable tile " + std::to_string(graphid.tileid()) + " level " + std::to_string(graphid.level()));
+      continue;
+    }
+    // Keep every tile aligned so GraphTile can use it in place
+    uint64_t pad = (TILE_ALIGNMENT - offset % TILE_ALIGNMENT) % TILE_ALIGNMENT;
+    file.write(padding, pad);
+    offset += pad;
+    index.push_back({ graphid.value, offset, tile_data.size() });
+    file.write(tile_data.data(), tile_data.size());
+    offset += tile_data.size();
+  }
+
+  // Now that we know which tiles made it in, write the final header and index
+  header.tile_count = index.size();
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(index_entry_t));
+  file.close();
+  if (file.fail()) {
+    LOG_ERROR("Failed to write tile extract " + extract_file);
+    return false;
+  }
+  return true;
+}
+
+}
+}
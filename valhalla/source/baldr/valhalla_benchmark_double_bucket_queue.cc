@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/double_bucket_queue.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+// Same as the path algorithms
+constexpr uint32_t kBucketCount = 20000;
+constexpr uint32_t kBucketSize = 1;
+
+// The double bucket queue as it was before buckets were reused and
+// decrease became constant time: deque buckets, a linear search to move a
+// label on decrease and label costs looked up through a functor when the
+// overflow bucket is emptied.
+class LegacyDoubleBucketQueue {
+ public:
+  using LabelCost = std::function<float (const uint32_t label)>;
+
+  LegacyDoubleBucketQueue(const float mincost, const float range,
+                          const uint32_t bucketsize, const LabelCost& labelcost) {
+    uint32_t c = static_cast<uint32_t>(mincost);
+    currentcost_ = (c - (c % bucketsize));
+    mincost_ = currentcost_;
+    bucketrange_ = range;
+    bucketsize_ = static_cast<float>(bucketsize);
+    inv_ = 1.0f / bucketsize_;
+    maxcost_ = mincost + bucketrange_;
+    buckets_.resize((range / bucketsize_) + 1);
+    currentbucket_ = buckets_.begin();
+    labelcost_ = labelcost;
+  }
+
+  void add(const uint32_t label, const float cost) {
+    get_bucket(cost).push_back(label);
+  }
+
+  void decrease(const uint32_t label, const float newcost,
+                const float previouscost) {
+    auto& prevbucket = get_bucket(previouscost);
+    auto& newbucket  = get_bucket(newcost);
+    if (&prevbucket != &newbucket) {
+      for (auto it = prevbucket.begin(); it != prevbucket.end(); ++it) {
+        if (*it == label) {
+          prevbucket.erase(it);
+          break;
+        }
+      }
+      newbucket.push_back(label);
+    }
+  }
+
+  uint32_t pop() {
+    for ( ; currentbucket_ != buckets_.end(); currentbucket_++,
+            currentcost_ += bucketsize_) {
+      if (!currentbucket_->empty()) {
+        return next_label();
+      }
+    }
+    if (overflowbucket_.empty()) {
+      currentbucket_--;
+      return kInvalidLabel;
+    }
+    empty_overflow();
+    for (currentbucket_ = buckets_.begin(); currentbucket_ != buckets_.end();
+             currentbucket_++, currentcost_ += bucketsize_) {
+      if (!currentbucket_->empty()) {
+        return next_label();
+      }
+    }
+    return kInvalidLabel;
+  }
+
+ private:
+  uint32_t next_label() {
+    uint32_t label = currentbucket_->front();
+    currentbucket_->pop_front();
+    return label;
+  }
+
+  std::deque<uint32_t>& get_bucket(const float cost) {
+    return (cost < currentcost_) ? *currentbucket_ :
+             (cost < maxcost_) ?
+               buckets_[static_cast<uint32_t>((cost - mincost_) * inv_)] :
+               overflowbucket_;
+  }
+
+  void empty_overflow() {
+    bool found = false;
+    std::vector<uint32_t> tmp;
+    while (!found && !overflowbucket_.empty()) {
+      mincost_ += bucketrange_;
+      maxcost_ += bucketrange_;
+      currentcost_ = mincost_;
+      tmp.clear();
+      while (!overflowbucket_.empty()) {
+        uint32_t label = overflowbucket_.front();
+        overflowbucket_.pop_front();
+        float cost = labelcost_(label);
+        if (cost < maxcost_) {
+          buckets_[static_cast<uint32_t>((cost - mincost_) * inv_)].push_back(label);
+          found = true;
+        } else {
+          tmp.push_back(label);
+        }
+      }
+      overflowbucket_.assign(tmp.begin(), tmp.end());
+    }
+  }
+
+  float bucketrange_;
+  float bucketsize_;
+  float inv_;
+  float mincost_;
+  float maxcost_;
+  float currentcost_;
+  std::vector<std::deque<uint32_t>> buckets_;
+  std::vector<std::deque<uint32_t>>::iterator currentbucket_;
+  std::deque<uint32_t> overflowbucket_;
+  LabelCost labelcost_;
+};
+
+// A queue operation recorded from a search
+struct op_t {
+  enum type_t : uint8_t { kAdd, kDecrease, kPop };
+  type_t type;
+  uint32_t label;
+  float cost;
+  float previouscost;
+};
+
+// Dijkstra from a node over the edges of the graph with their travel time
+// at the edge speed as cost, recording the queue operations. Shortcuts are
+// skipped and transition edges cost nothing.
+std::vector<op_t> Record(GraphReader& reader, const GraphId& source,
+                         const size_t max_pops) {
+  std::vector<op_t> ops;
+  std::vector<float> costs;
+  std::vector<bool> settled;
+  std::vector<GraphId> nodes;
+  std::unordered_map<uint64_t, uint32_t> labels;
+  DoubleBucketQueue queue(0.0f, kBucketCount * kBucketSize, kBucketSize);
+
+  labels.emplace(source.value, 0);
+  nodes.push_back(source);
+  costs.push_back(0.0f);
+  settled.push_back(false);
+  queue.add(0, 0.0f);
+  ops.push_back({op_t::kAdd, 0, 0.0f, 0.0f});
+  for (size_t pops = 0; pops < max_pops; ++pops) {
+    const uint32_t label = queue.pop();
+    ops.push_back({op_t::kPop, label, 0.0f, 0.0f});
+    if (label == kInvalidLabel) {
+      break;
+    }
+    settled[label] = true;
+
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    const GraphTile* tile = reader.GetGraphTile(nodes[label]);
+    if (tile == nullptr) {
+      continue;
+    }
+    const NodeInfo* nodeinfo = tile->node(nodes[label]);
+    const DirectedEdge* edge = tile->directededge(nodeinfo->edge_index());
+    for (uint32_t i = 0; i < nodeinfo->edge_count(); ++i, ++edge) {
+      if (edge->is_shortcut()) {
+        continue;
+      }
+      const bool transition = edge->trans_up() || edge->trans_down();
+      const float cost = costs[label] + (transition ? 0.0f :
+          edge->length() * 3.6f / std::max(edge->speed(), 1u));
+      auto found = labels.find(edge->endnode().value);
+      if (found == labels.end()) {
+        const uint32_t idx = nodes.size();
+        labels.emplace(edge->endnode().value, idx);
+        nodes.push_back(edge->endnode());
+        costs.push_back(cost);
+        settled.push_back(false);
+        queue.add(idx, cost);
+        ops.push_back({op_t::kAdd, idx, cost, 0.0f});
+      } else if (!settled[found->second] && cost < costs[found->second]) {
+        ops.push_back({op_t::kDecrease, found->second, cost, costs[found->second]});
+        queue.decrease(found->second, cost);
+        costs[found->second] = cost;
+      }
+    }
+  }
+  return ops;
+}
+
+// Replay the operations of the searches on a queue, each search on the
+// empty queue handed out for it. Returns the number of labels popped.
+template <class queue_t>
+size_t Replay(const std::vector<std::vector<op_t>>& traces,
+              std::vector<float>& costs,
+              const std::function<queue_t& ()>& next_queue) {
+  size_t popped = 0;
+  for (const auto& ops : traces) {
+    queue_t& queue = next_queue();
+    for (const auto& op : ops) {
+      switch (op.type) {
+        case op_t::kAdd:
+          if (op.label >= costs.size()) {
+            costs.resize(op.label + 1);
+          }
+          costs[op.label] = op.cost;
+          queue.add(op.label, op.cost);
+          break;
+        case op_t::kDecrease:
+          costs[op.label] = op.cost;
+          queue.decrease(op.label, op.cost, op.previouscost);
+          break;
+        case op_t::kPop:
+          popped += queue.pop() != kInvalidLabel;
+          break;
+      }
+    }
+  }
+  return popped;
+}
+
+// Adapts the current queue to the replay, it does not need the previous cost
+class CurrentQueue : public DoubleBucketQueue {
+ public:
+  CurrentQueue()
+      : DoubleBucketQueue(0.0f, kBucketCount * kBucketSize, kBucketSize) {
+  }
+  void decrease(const uint32_t label, const float newcost, const float) {
+    DoubleBucketQueue::decrease(label, newcost);
+  }
+};
+
+}
+
+// Records the queue operations of Dijkstra searches from a fixed, seeded
+// set of nodes of the tile set and replays them on the current double
+// bucket queue and on the one it replaced, reporting the time per
+// operation of each.
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: valhalla_benchmark_double_bucket_queue CONFIG [SEARCHES] [MAX_POPS] [ROUNDS]"
+              << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const size_t search_count = argc > 2 ? std::stoul(argv[2]) : 10;
+  const size_t max_pops = argc > 3 ? std::stoul(argv[3]) : 100000;
+  const size_t rounds = argc > 4 ? std::stoul(argv[4]) : 5;
+
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  GraphReader reader(storage, config.get_child("mjolnir"));
+
+  // Nodes to search from, in tile order so the same tiles give the same
+  // searches
+  const auto tile_set = reader.GetTileSet();
+  std::vector<GraphId> tiles(tile_set.begin(), tile_set.end());
+  std::sort(tiles.begin(), tiles.end());
+  std::vector<GraphId> nodes;
+  for (const auto& tile_id : tiles) {
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    for (uint32_t i = 0; tile != nullptr && i < tile->header()->nodecount(); ++i) {
+      nodes.push_back(tile_id + static_cast<uint64_t>(i));
+    }
+  }
+  if (nodes.empty()) {
+    std::cout << "No nodes in the tile set" << std::endl;
+    return 1;
+  }
+
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+  std::vector<std::vector<op_t>> traces;
+  size_t op_count = 0;
+  for (size_t i = 0; i < search_count; ++i) {
+    traces.push_back(Record(reader, nodes[pick(generator)], max_pops));
+    op_count += traces.back().size();
+  }
+  std::cout << traces.size() << " searches, " << op_count << " queue operations"
+            << std::endl;
+
+  std::vector<float> costs;
+  auto time = [&](const std::string& name, const std::function<size_t ()>& replay) {
+    size_t popped = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+      popped = replay();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(1) << name << ": "
+              << elapsed / (rounds * op_count) << " ns/operation, " << popped
+              << " popped" << std::endl;
+    return popped;
+  };
+  // The legacy queue was created for every search, the current one is
+  // reset and reused like the path algorithms do now
+  std::unique_ptr<LegacyDoubleBucketQueue> legacy_queue;
+  const size_t legacy = time("Legacy DoubleBucketQueue", [&]() {
+    return Replay<LegacyDoubleBucketQueue>(traces, costs,
+        [&costs, &legacy_queue]() -> LegacyDoubleBucketQueue& {
+      legacy_queue.reset(new LegacyDoubleBucketQueue(0.0f, kBucketCount * kBucketSize,
+          kBucketSize, [&costs](const uint32_t label) { return costs[label]; }));
+      return *legacy_queue;
+    });
+  });
+  CurrentQueue current_queue;
+  const size_t current = time("DoubleBucketQueue", [&]() {
+    return Replay<CurrentQueue>(traces, costs, [&current_queue]() -> CurrentQueue& {
+      current_queue.reuse(0.0f, kBucketCount * kBucketSize, kBucketSize);
+      return current_queue;
+    });
+  });
+
+  if (legacy != current) {
+    std::cout << "Queues popped a different number of labels" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "midgard/encoded.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+
+// Times decoding the shapes of all the edges of the tiles. Compares popping
+// the points one by one, the bulk decoder and the decoded shape cache of the
+// tiles, and checks they all give the same shapes.
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: valhalla_benchmark_shape_decoding CONFIG [ROUNDS]" << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const size_t rounds = argc > 2 ? std::stoul(argv[2]) : 10;
+
+  // Each edge info once, its forward edge has it. The tiles are held for the
+  // whole run so the reader is never trimmed, it keeps all of them.
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  GraphReader reader(storage, config.get_child("mjolnir"));
+  std::vector<std::pair<const GraphTile*, uint32_t>> edges;
+  size_t bytes = 0;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    if (tile == nullptr) {
+      continue;
+    }
+    for (uint32_t i = 0; i < tile->header()->directededgecount(); ++i) {
+      const DirectedEdge* edge = tile->directededge(i);
+      if (edge->forward()) {
+        edges.emplace_back(tile, edge->edgeinfo_offset());
+        bytes += tile->edgeinfo(edge->edgeinfo_offset()).encoded_shape_size();
+      }
+    }
+  }
+  std::cout << edges.size() << " shapes, " << bytes << " bytes" << std::endl;
+
+  // Make sure they agree
+  std::vector<PointLL> shape;
+  for (const auto& edge : edges) {
+    auto info = edge.first->edgeinfo(edge.second);
+    auto decoder = info.lazy_shape();
+    info.DecodeShape(shape);
+    auto cached = edge.first->GetShape(edge.second);
+    std::vector<PointLL> reference;
+    while (!decoder.empty()) {
+      reference.emplace_back(decoder.pop());
+    }
+    if (shape != reference || *cached != reference) {
+      std::cout << "Shapes differ" << std::endl;
+      return 1;
+    }
+  }
+
+  auto time = [&](const std::string& name, const std::function<void ()>& decode) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+      decode();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed / (rounds * edges.size()) << " ns/shape, "
+              << bytes * rounds / (elapsed * 1e-3) << " MB/s" << std::endl;
+  };
+
+  size_t points = 0;
+  time("Shape7Decoder", [&]() {
+    for (const auto& edge : edges) {
+      auto decoder = edge.first->edgeinfo(edge.second).lazy_shape();
+      shape.clear();
+      while (!decoder.empty()) {
+        shape.emplace_back(decoder.pop());
+      }
+      points += shape.size();
+    }
+  });
+  time("decode7", [&]() {
+    for (const auto& edge : edges) {
+      edge.first->edgeinfo(edge.second).DecodeShape(shape);
+      points += shape.size();
+    }
+  });
+  time("GraphTile::GetShape", [&]() {
+    for (const auto& edge : edges) {
+      points += edge.first->GetShape(edge.second)->size();
+    }
+  });
+  std::cout << points << " points decoded" << std::endl;
+
+  return 0;
+}
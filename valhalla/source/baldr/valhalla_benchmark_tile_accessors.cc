@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphconstants.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+
+// Times walking all the edges of the tiles and getting their names, signs,
+// access restrictions and complex restrictions. Compares the accessors that
+// copy them into vectors with the ones that look at them in place, and checks
+// they find the same things.
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: valhalla_benchmark_tile_accessors CONFIG [ROUNDS]" << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const size_t rounds = argc > 2 ? std::stoul(argv[2]) : 10;
+
+  // The copying accessors complain about edges without signs or restrictions
+  valhalla::midgard::logging::Configure({{"type", ""}});
+
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  // The tiles are held for the whole run so the reader is never trimmed, it
+  // keeps all of them
+  GraphReader reader(storage, config.get_child("mjolnir"));
+  std::vector<const GraphTile*> tiles;
+  size_t edges = 0;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    if (tile != nullptr) {
+      tiles.push_back(tile);
+      edges += tile->header()->directededgecount();
+    }
+  }
+  std::cout << tiles.size() << " tiles, " << edges << " edges" << std::endl;
+
+  // Walk all the edges of all the tiles
+  auto walk = [&tiles](const std::function<size_t (const GraphTile*, GraphId,
+                                                   const DirectedEdge*)>& get) {
+    size_t found = 0;
+    for (const GraphTile* tile : tiles) {
+      const DirectedEdge* edge = tile->directededge(0);
+      for (uint32_t i = 0; i < tile->header()->directededgecount(); ++i, ++edge) {
+        found += get(tile, tile->id() + static_cast<uint64_t>(i), edge);
+      }
+    }
+    return found;
+  };
+  auto time = [&](const std::string& name,
+                  const std::function<size_t (const GraphTile*, GraphId,
+                                              const DirectedEdge*)>& get) {
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+      found = walk(get);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed / (rounds * edges) << " ns/edge, "
+              << found << " found" << std::endl;
+    return found;
+  };
+
+  // Names, counting their characters so the text is looked at either way
+  const size_t names = time("EdgeInfo::GetNames", [](const GraphTile* tile, GraphId,
+                                                     const DirectedEdge* edge) {
+    size_t chars = 0;
+    for (const auto& name : tile->edgeinfo(edge->edgeinfo_offset()).GetNames()) {
+      chars += name.size();
+    }
+    return chars;
+  });
+  const size_t names_in_place = time("EdgeInfo::name", [](const GraphTile* tile, GraphId,
+                                                          const DirectedEdge* edge) {
+    auto edgeinfo = tile->edgeinfo(edge->edgeinfo_offset());
+    size_t chars = 0;
+    for (uint32_t i = 0; i < edgeinfo.name_count(); ++i) {
+      chars += std::strlen(edgeinfo.name(i));
+    }
+    return chars;
+  });
+
+  // Signs, counting the characters of their text
+  const size_t signs = time("GraphTile::GetSigns", [](const GraphTile* tile, GraphId id,
+                                                      const DirectedEdge* edge) {
+    size_t chars = 0;
+    if (edge->exitsign()) {
+      for (const auto& sign : tile->GetSigns(id.id())) {
+        chars += sign.text().size();
+      }
+    }
+    return chars;
+  });
+  const size_t signs_in_place = time("GraphTile::signs", [](const GraphTile* tile, GraphId id,
+                                                            const DirectedEdge* edge) {
+    size_t chars = 0;
+    if (edge->exitsign()) {
+      for (const auto& sign : tile->signs(id.id())) {
+        chars += std::strlen(tile->text(sign.text_offset()));
+      }
+    }
+    return chars;
+  });
+
+  // Access restrictions, for trucks as TruckCost looks at them
+  const size_t access = time("GraphTile::GetAccessRestrictions", [](const GraphTile* tile,
+                                                                    GraphId id,
+                                                                    const DirectedEdge* edge) {
+    return edge->access_restriction() ?
+        tile->GetAccessRestrictions(id.id(), kTruckAccess).size() : 0;
+  });
+  const size_t access_in_place = time("GraphTile::access_restrictions", [](const GraphTile* tile,
+                                                                           GraphId id,
+                                                                           const DirectedEdge* edge) {
+    size_t count = 0;
+    if (edge->access_restriction()) {
+      for (const auto& restriction : tile->access_restrictions(id.id())) {
+        count += (restriction.modes() & kTruckAccess) != 0;
+      }
+    }
+    return count;
+  });
+
+  // Complex restrictions ending at the edge as DynamicCost looks at them,
+  // counting their vias
+  const size_t complex = time("GraphTile::GetRestrictions", [](const GraphTile* tile,
+                                                               GraphId id,
+                                                               const DirectedEdge* edge) {
+    size_t vias = 0;
+    if (edge->end_restriction() & kAutoAccess) {
+      for (const auto& cr : tile->GetRestrictions(true, id, kAutoAccess)) {
+        vias += cr.GetVias().size();
+      }
+    }
+    return vias;
+  });
+  const size_t complex_in_place = time("GraphTile::VisitRestrictions", [](const GraphTile* tile,
+                                                                          GraphId id,
+                                                                          const DirectedEdge* edge) {
+    size_t vias = 0;
+    if (edge->end_restriction() & kAutoAccess) {
+      tile->VisitRestrictions(true, id, kAutoAccess, [&vias](const ComplexRestriction& cr) {
+        vias += cr.vias().size();
+        return true;
+      });
+    }
+    return vias;
+  });
+
+  if (names != names_in_place || signs != signs_in_place || access != access_in_place ||
+      complex != complex_in_place) {
+    std::cout << "Accessors differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
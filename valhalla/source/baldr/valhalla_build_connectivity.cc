@@ -0,0 +1,53 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/connectivity_map.h"
+#include "baldr/graphtilefsstorage.h"
+#include "baldr/tilehierarchy.h"
+
+using namespace valhalla::baldr;
+
+// Writes the connectivity map sidecar of a tile set for the
+// mjolnir.connectivity_map setting. If the sidecar exists already it is
+// brought up to date with the tiles, only recoloring the regions touched by
+// tiles that were added or removed since, for example by a tile package.
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cout << "usage: valhalla_build_connectivity CONFIG OUTPUT" << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const std::string output = argv[2];
+
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  if (std::ifstream(output).is_open()) {
+    try {
+      connectivity_map_t connectivity_map(storage, output);
+      TileHierarchy tile_hierarchy(storage);
+      const size_t changes = connectivity_map.update(storage->FindTiles(tile_hierarchy));
+      std::cout << changes << " tiles added or removed" << std::endl;
+      if (changes > 0) {
+        connectivity_map.save(output);
+      }
+      return 0;
+    }
+    catch (const std::exception& e) {
+      // An older or broken file, it is replaced
+      std::cout << "Recomputing " << output << ": " << e.what() << std::endl;
+    }
+  }
+
+  // Compute it from scratch, it is saved to the output
+  auto mjolnir = config.get_child("mjolnir");
+  mjolnir.put("connectivity_map", output);
+  connectivity_map_t connectivity_map(storage, mjolnir);
+  return 0;
+}
@@ -140,7 +140,7 @@ namespace valhalla {
       //correlate the various locations to the underlying graph
       std::unordered_map<size_t, size_t> color_counts;
       try{
-        const auto searched = loki::Search(sources_targets, reader, edge_filter, node_filter);
+        const auto searched = loki::Search(sources_targets, reader, worker_readers, *search_workers, edge_filter, node_filter);
         for(size_t i = 0; i < sources_targets.size(); ++i) {
           const auto& l = sources_targets[i];
           const auto& projection = searched.at(l);
@@ -2,9 +2,11 @@
 #include "loki/search.h"
 #include "midgard/linesegment2.h"
 #include "midgard/distanceapproximator.h"
+#include "midgard/worker_pool.h"
 
 #include <unordered_set>
 #include <list>
+#include <atomic>
 #include <math.h>
 
 using namespace valhalla::midgard;
@@ -262,11 +264,12 @@ PathLocation correlate_edge(GraphReader& reader, const Location& location, const
 // Model a segment (2 consecutive points in an edge in a bin).
 struct Segment {
   Segment() = default;
-  Segment(const GraphTile* tile, const GraphId& edge_id, const DirectedEdge* edge):
+  Segment(const GraphTile* tile, const GraphId& edge_id, const DirectedEdge* edge,
+          const std::shared_ptr<const EdgeInfo>& edge_info):
     edge_id(edge_id),
     tile(tile),
     edge(edge),
-    edge_info(std::make_shared<const EdgeInfo>(tile->edgeinfo(edge->edgeinfo_offset()))) {
+    edge_info(edge_info) {
   }
   GraphId edge_id;
   const GraphTile* tile = nullptr;
@@ -275,6 +278,25 @@ struct Segment {
   size_t idx = 0;
 };
 
+// Edge infos with their decoded shapes, keyed by tile and edge info offset
+// so an edge and its opposing edge share one entry. Every shape is decoded
+// once per search no matter how many bins and locations it is tested in.
+class ShapeCache {
+ public:
+  const std::shared_ptr<const EdgeInfo>& get(const GraphTile* tile, const DirectedEdge* edge) {
+    uint64_t key = (static_cast<uint64_t>(edge->edgeinfo_offset()) << 32) | tile->id().Tile_Base().value;
+    auto cached = cache_.find(key);
+    if (cached == cache_.end()) {
+      auto info = std::make_shared<const EdgeInfo>(tile->edgeinfo(edge->edgeinfo_offset()));
+      info->shape();
+      cached = cache_.emplace(key, std::move(info)).first;
+    }
+    return cached->second;
+  }
+ private:
+  std::unordered_map<uint64_t, std::shared_ptr<const EdgeInfo> > cache_;
+};
+
 std::function<std::tuple<int32_t, unsigned short, float>()>
 make_binner(const PointLL& p, const GraphReader& reader) {
   const auto& tiles = reader.GetTileHierarchy().levels().rbegin()->second.tiles;
@@ -283,17 +305,17 @@ make_binner(const PointLL& p, const GraphReader& reader) {
 
 // This structure contains the context of the projection of a
 // Location.  At the creation, a bin is affected to the point.  The
-// test() method should be called to each valid segment of the bin.
-// When the bin is finished, next_bin() switch to the next possible
-// interesting bin.  if has_bin() is false, then the best projection
-// is found.
+// segments of the bin are tested by handle_bin together with all
+// other points in the same bin.  When the bin is finished, next_bin()
+// switch to the next possible interesting bin.  if has_bin() is false,
+// then the best projection is found.
 struct ProjectPoint {
   ProjectPoint(const Location& location, GraphReader& reader):
     b(new Box(location, reader)),
     lon_scale(cosf(location.latlng_.lat() * kRadPerDeg)),
+    m_per_lng_degree(DistanceApproximator::MetersPerLngDegree(location.latlng_.lat())),
     lat(location.latlng_.lat()),
-    lng(location.latlng_.lng()),
-    approx(location.latlng_) {
+    lng(location.latlng_.lng()) {
     next_bin(reader);
   }
 
@@ -308,10 +330,10 @@ struct ProjectPoint {
   const PointLL& point() const { return b->location.latlng_; }
   const Location& location() const { return b->location; }
   const Segment& closest_segment() const { return b-> closest_segment; }
-  const GraphTile* cur_tile() const { return b->cur_tile; }
+  const GraphId& cur_tile_id() const { return b->cur_tile_id; }
   unsigned short bin_index() const { return b->bin_index; }
   float closest_distance() const { return sqrt(sq_closest_distance); }
-  bool has_bin() const { return b->cur_tile != nullptr; }
+  bool has_bin() const { return b->cur_tile_id.Is_Valid(); }
   bool projection_found() const { return b->closest_point.IsValid(); }
 
   // Get the best projection found so far.
@@ -322,16 +344,17 @@ struct ProjectPoint {
   // Sort the ProjectPoint by bin, with finished (i.e. no bin) at the
   // end.
   bool operator<(const ProjectPoint& other) const {
-    if (b->cur_tile != other.b->cur_tile)
-      return b->cur_tile > other.b->cur_tile;// nullptr at the end
+    if (has_bin() != other.has_bin())
+      return has_bin();
+    if (b->cur_tile_id != other.b->cur_tile_id)
+      return b->cur_tile_id < other.b->cur_tile_id;
     return b->bin_index < other.b->bin_index;
   }
 
   bool has_same_bin(const ProjectPoint& other) const {
-    return b->cur_tile == other.b->cur_tile && b->bin_index == other.b->bin_index;
+    return b->cur_tile_id == other.b->cur_tile_id && b->bin_index == other.b->bin_index;
   }
 
-
   // Advance to the next bin. Must not be called if has_bin() is false.
   void next_bin(GraphReader& reader) {
     do {
@@ -340,49 +363,23 @@ struct ProjectPoint {
       //TODO: make configurable the radius at which we give up searching
       //the closest thing in this bin is further than what we have already
       if(std::get<2>(bin) > SEARCH_CUTOFF || std::get<2>(bin) > closest_distance()) {
-        b->cur_tile = nullptr;
+        b->cur_tile_id = GraphId();
         break;
       }
 
-      //grab the tile the lat, lon is in
+      //grab the tile the lat, lon is in, skip bins of missing tiles
       auto tile_id = GraphId(std::get<0>(bin), b->level, 0);
-      if (b->cur_tile == nullptr || b->cur_tile->id() != tile_id) {
-          b->cur_tile = reader.GetGraphTile(tile_id);
+      if (b->cur_tile_id != tile_id) {
+        b->cur_tile_id = reader.GetGraphTile(tile_id) ? tile_id : GraphId();
       }
       b->bin_index = std::get<1>(bin);
-    } while (! b->cur_tile);
+    } while (! b->cur_tile_id.Is_Valid());
   }
 
-  // Test if a segment is a candidate to the projection.  This method
-  // is performance critical.  Copy, function call, cache locality and
-  // useless computation must be handled with care.
-  void test(const PointLL& u, const PointLL& v, const Segment& segment) {
-    //project a onto b where b is the origin vector representing this segment
-    //and a is the origin vector to the point we are projecting, (a.b/b.b)*b
-    auto bx = v.first - u.first;
-    auto by = v.second - u.second;
-
-    // Scale longitude when finding the projection. Avoid divided-by-zero
-    // which gives a NaN scale, otherwise comparisons below will fail
-    auto bx2 = bx * lon_scale;
-    auto sq = bx2*bx2 + by*by;
-    auto scale = sq > 0 ? ((lng - u.lng())*lon_scale*bx2 + (lat - u.lat())*by) / sq : 0.f;
-
-    PointLL point;
-    //projects along the ray before u
-    if(scale <= 0.f) {
-      point = u;
-    }//projects along the ray after v
-    else if(scale >= 1.f) {
-      point = v;
-    }//projects along the ray between u and v
-    else {
-      point = { u.first+bx*scale, u.second+by*scale };
-    }
-    //check if this point is better
-    const auto sq_distance = approx.DistanceSquared(point);
+  // Take over a projection found by handle_bin if it is better than the
+  // best one so far.
+  void update(const PointLL& point, const float sq_distance, const Segment& segment) {
     if(sq_distance < sq_closest_distance) {
-      // this block is not in the hot spot
       b->closest_segment = segment;
       sq_closest_distance = sq_distance;
       b->closest_point = point;
@@ -390,16 +387,15 @@ struct ProjectPoint {
   }
 
  private:
-  // To limit the size of the struct and optimize cache locality of
-  // the data used in the hot spot, we box the data not used in the
-  // hot spot.
+  // To limit the size of the struct, we box the data not needed to
+  // group and load the points.
   struct Box {
     Box(const Location& location, GraphReader& reader)
       : binner(make_binner(location.latlng_, reader)),
         location(location),
         level(reader.GetTileHierarchy().levels().rbegin()->first) {}
     std::function<std::tuple<int32_t, unsigned short, float>()> binner;
-    const GraphTile* cur_tile = nullptr;
+    GraphId cur_tile_id;
     Segment closest_segment;
     PointLL closest_point{};
     Location location;
@@ -408,12 +404,67 @@ struct ProjectPoint {
   };
   std::unique_ptr<Box> b;
 
-  // critical data
+ public:
+  // critical data, loaded into BinPoints for the segment tests
   float lon_scale;
+  float m_per_lng_degree;
   float lat;
   float lng;
   float sq_closest_distance = std::numeric_limits<float>::max();
-  DistanceApproximator approx;
+};
+
+// The points handled together in a bin, laid out as arrays so the loop
+// testing a segment against all of them has no branches or calls and
+// can be vectorized by the compiler. Reused from bin to bin.
+struct BinPoints {
+  void load(std::vector<ProjectPoint>::iterator begin, std::vector<ProjectPoint>::iterator end) {
+    size_t n = end - begin;
+    lng.resize(n); lat.resize(n); lon_scale.resize(n); m_per_lng_degree.resize(n);
+    sq_distance.resize(n); best_lng.resize(n); best_lat.resize(n); best_segment.resize(n);
+    for (size_t i = 0; i < n; ++i, ++begin) {
+      lng[i] = begin->lng;
+      lat[i] = begin->lat;
+      lon_scale[i] = begin->lon_scale;
+      m_per_lng_degree[i] = begin->m_per_lng_degree;
+      sq_distance[i] = begin->sq_closest_distance;
+      best_segment[i] = -1;
+    }
+  }
+
+  // Test a segment against all points.  This method is performance
+  // critical, it is the hot spot of the whole search.
+  void test(const PointLL& u, const PointLL& v, const int32_t segment) {
+    //project a onto b where b is the origin vector representing this segment
+    //and a is the origin vector to the point we are projecting, (a.b/b.b)*b
+    const float bx = v.first - u.first;
+    const float by = v.second - u.second;
+    const size_t n = lng.size();
+    for (size_t i = 0; i < n; ++i) {
+      // Scale longitude when finding the projection. Avoid divided-by-zero
+      // which gives a NaN scale, otherwise comparisons below will fail
+      float bx2 = bx * lon_scale[i];
+      float sq = bx2*bx2 + by*by;
+      float dot = (lng[i] - u.lng())*lon_scale[i]*bx2 + (lat[i] - u.lat())*by;
+      float scale = sq > 0 ? dot / (sq > 0 ? sq : 1.f) : 0.f;
+      //projects along the ray before u, after v or between them. the ends
+      //are taken as is so snapping to them can compare exactly
+      float x = scale <= 0.f ? u.first : (scale >= 1.f ? v.first : u.first + bx*scale);
+      float y = scale <= 0.f ? u.second : (scale >= 1.f ? v.second : u.second + by*scale);
+      //check if this point is better
+      float latm = (y - lat[i]) * kMetersPerDegreeLat;
+      float lngm = (x - lng[i]) * m_per_lng_degree[i];
+      float d = latm * latm + lngm * lngm;
+      bool better = d < sq_distance[i];
+      sq_distance[i] = better ? d : sq_distance[i];
+      best_lng[i] = better ? x : best_lng[i];
+      best_lat[i] = better ? y : best_lat[i];
+      best_segment[i] = better ? segment : best_segment[i];
+    }
+  }
+
+  std::vector<float> lng, lat, lon_scale, m_per_lng_degree;
+  std::vector<float> sq_distance, best_lng, best_lat;
+  std::vector<int32_t> best_segment;
 };
 
 //TODO: this is frought with peril. to properly to this we need to know
@@ -491,17 +542,36 @@ std::unordered_set<GraphId> island(const PathLocation& location,
   return (todo.size() == 0) ? done : std::unordered_set<GraphId>{};
 }
 
+// Per thread state of the search
+struct SearchWorker {
+  SearchWorker(GraphReader& reader): reader(reader) {}
+
+  GraphReader& reader;
+  ShapeCache shapes;
+  BinPoints points;
+  // the edges of the current bin and its segments as (edge, shape index)
+  std::vector<Segment> edges;
+  std::vector<std::pair<uint32_t, uint32_t> > segments;
+};
+
 // Handle a bin for a range of ProjectPoint.  Every ProjectPoint in
-// the range must be on the same bin.  The bin will be read, the
-// segment passed to the ProjectPoints and the ProjectPoints will
-// advance their bins.
+// the range must be on the same bin.  The bin will be read, its
+// segments tested against all the ProjectPoints and the ProjectPoints
+// will advance their bins.
 template<typename ProjectPointIter>
 void handle_bin(const ProjectPointIter pp_begin,
                 const ProjectPointIter pp_end,
-                GraphReader& reader,
+                SearchWorker& worker,
                 const EdgeFilter& edge_filter) {
+  auto& reader = worker.reader;
+  auto& points = worker.points;
+  auto& segments = worker.segments;
+  points.load(pp_begin, pp_end);
+  worker.edges.clear();
+  segments.clear();
+
   //iterate over the edges in the bin
-  auto tile = pp_begin->cur_tile();
+  auto tile = reader.GetGraphTile(pp_begin->cur_tile_id());
   auto edges = tile->GetBin(pp_begin->bin_index());
   for(auto e : edges) {
     //get the tile and edge
@@ -517,24 +587,25 @@ void handle_bin(const ProjectPointIter pp_begin,
       continue;
     }
 
-    Segment segment(tile, e, edge);
-    auto shape = segment.edge_info->lazy_shape();
-    PointLL v;
-    if (! shape.empty()) {
-      v = shape.pop();
-    }
-    for(; ! shape.empty(); ++segment.idx) {
-      const auto u = v;
-      v = shape.pop();
-      for (auto it = pp_begin; it != pp_end; ++it) {
-        it->test(u, v, segment);
-      }
+    //test all points against each segment of the shape
+    worker.edges.emplace_back(tile, e, edge, worker.shapes.get(tile, edge));
+    const auto& shape = worker.edges.back().edge_info->shape();
+    for(size_t i = 1; i < shape.size(); ++i) {
+      points.test(shape[i - 1], shape[i], segments.size());
+      segments.emplace_back(worker.edges.size() - 1, i - 1);
     }
   }
 
-  // bin is finished, advance the ProjectPoints to their respective
-  // next bin.
-  for (auto it = pp_begin; it != pp_end; ++it) {
+  // bin is finished, take over the better projections and advance the
+  // ProjectPoints to their respective next bin.
+  size_t i = 0;
+  for (auto it = pp_begin; it != pp_end; ++it, ++i) {
+    if (points.best_segment[i] >= 0) {
+      const auto& best = segments[points.best_segment[i]];
+      Segment segment = worker.edges[best.first];
+      segment.idx = best.second;
+      it->update(PointLL(points.best_lng[i], points.best_lat[i]), points.sq_distance[i], segment);
+    }
     it->next_bin(reader);
   }
 }
@@ -569,23 +640,20 @@ PathLocation finalize(const ProjectPoint& pp, GraphReader& reader, const EdgeFil
   return correlate_edge(reader, pp.location(), edge_filter, closest_point, pp.closest_segment().edge, pp.closest_segment().edge_id, *pp.closest_segment().edge_info);
 }
 
-// Find the best range to do.  The given vector should be sorted for
-// interesting grouping.  Returns the greatest range of non empty
-// equal bins.
-std::pair<std::vector<ProjectPoint>::iterator, std::vector<ProjectPoint>::iterator>
-find_best_range(std::vector<ProjectPoint>& pps) {
-  auto best = std::make_pair(pps.begin(), pps.begin());
-  auto cur = best;
-  while (cur.second != pps.end()) {
-    cur.first = cur.second;
-    cur.second = std::find_if_not(cur.first, pps.end(), [&](const ProjectPoint& pp) {
-      return cur.first->has_same_bin(pp);
-    });
-    if (cur.first->has_bin() && cur.second - cur.first > best.second - best.first) {
-      best = cur;
-    }
+// Split the ProjectPoints into ranges of equal bins.  The given vector
+// should be sorted so that equal bins are adjacent and finished points
+// are at the end.  Finished points are not part of any range.
+std::vector<std::pair<size_t, size_t> > find_bin_ranges(const std::vector<ProjectPoint>& pps) {
+  std::vector<std::pair<size_t, size_t> > ranges;
+  size_t begin = 0;
+  while (begin < pps.size() && pps[begin].has_bin()) {
+    size_t end = begin + 1;
+    while (end < pps.size() && pps[begin].has_same_bin(pps[end]))
+      ++end;
+    ranges.emplace_back(begin, end);
+    begin = end;
   }
-  return best;
+  return ranges;
 }
 
 }
@@ -595,9 +663,26 @@ namespace loki {
 
 std::unordered_map<Location, PathLocation>
 Search(const std::vector<Location>& locations, GraphReader& reader, const EdgeFilter& edge_filter, const NodeFilter& node_filter) {
+  return Search(locations, reader, {}, edge_filter, node_filter);
+}
+
+std::unordered_map<Location, PathLocation>
+Search(const std::vector<Location>& locations, GraphReader& reader,
+  const std::vector<std::shared_ptr<GraphReader> >& worker_readers,
+  const EdgeFilter& edge_filter, const NodeFilter& node_filter) {
+  WorkerPool pool(worker_readers.size() + 1);
+  return Search(locations, reader, worker_readers, pool, edge_filter, node_filter);
+}
+
+std::unordered_map<Location, PathLocation>
+Search(const std::vector<Location>& locations, GraphReader& reader,
+  const std::vector<std::shared_ptr<GraphReader> >& worker_readers, WorkerPool& pool,
+  const EdgeFilter& edge_filter, const NodeFilter& node_filter) {
   std::unordered_map<Location, PathLocation> searched;
   if(locations.empty())
     return searched;
+  if(pool.size() != worker_readers.size() + 1)
+    throw std::runtime_error("Search needs one pool worker per worker reader and the calling thread");
 
   // Get the unique set of input locations
   std::unordered_set<Location> uniq_locations(locations.begin(), locations.end());
@@ -607,20 +692,44 @@ Search(const std::vector<Location>& locations, GraphReader& reader, const EdgeFi
     pps.emplace_back(loc, reader);
   }
 
-  // We keep pps sorted at each round to group the bins together
-  // and test that every projection finished by just testing the
-  // first one (finished projections are at the end when sorted).
-  for (std::sort(pps.begin(), pps.end()); pps.front().has_bin(); std::sort(pps.begin(), pps.end())) {
-    auto range = find_best_range(pps);
-    handle_bin(range.first, range.second, reader, edge_filter);
+  // Every thread has its own reader, shape cache and scratch space
+  std::vector<SearchWorker> workers;
+  workers.reserve(pool.size());
+  workers.emplace_back(reader);
+  for (const auto& worker_reader : worker_readers) {
+    workers.emplace_back(*worker_reader);
+  }
+
+  // We sort pps at each round to group the bins together. Every bin
+  // of a round is handled once for all points in it, the bins are
+  // distributed over the workers. Finished projections are at the end
+  // when sorted so we are done once no bins are left.
+  std::sort(pps.begin(), pps.end());
+  for (auto ranges = find_bin_ranges(pps); !ranges.empty(); ranges = find_bin_ranges(pps)) {
+    std::atomic<size_t> next_range(0);
+    pool.Run([&](const uint32_t w) {
+      for (size_t r = next_range++; r < ranges.size(); r = next_range++) {
+        handle_bin(pps.begin() + ranges[r].first, pps.begin() + ranges[r].second,
+                   workers[w], edge_filter);
+      }
+    });
+    std::sort(pps.begin(), pps.end());
   }
 
   // At this point we have candidates for each location so now we
   // need to go get the actual correlated location with edge_id etc.
-  for (const auto& pp: pps) {
-    if (pp.projection_found()) {
-      // Correlate
-      auto inserted = searched.insert({pp.location(), finalize(pp, reader, edge_filter)});
+  std::vector<std::vector<std::pair<Location, PathLocation> > > correlated(pool.size());
+  pool.Run([&](const uint32_t w) {
+    for (size_t i = w; i < pps.size(); i += pool.size()) {
+      if (pps[i].projection_found()) {
+        // Correlate
+        correlated[w].emplace_back(pps[i].location(), finalize(pps[i], workers[w].reader, edge_filter));
+      }
+    }
+  });
+  for (auto& worker_correlated : correlated) {
+    for (auto& location : worker_correlated) {
+      searched.insert(std::move(location));
     }
   }
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <stdexcept>
@@ -106,6 +107,25 @@ namespace {
 
     return d;
   }
+
+  constexpr size_t kDefaultSharedCacheSize = 1073741824; //1 gig
+
+  // Graph readers for the threads correlating the locations of a request
+  // besides the calling one. They share one tile cache so each tile is only
+  // loaded once among them.
+  std::vector<std::shared_ptr<GraphReader>> make_worker_readers(const boost::property_tree::ptree& config) {
+    std::vector<std::shared_ptr<GraphReader>> readers;
+    const uint32_t thread_count = std::max(config.get<uint32_t>("loki.search_threads", 1), 1u);
+    if (thread_count <= 1)
+      return readers;
+    const auto& mjolnir = config.get_child("mjolnir");
+    auto shared_cache = std::make_shared<SynchronizedTileCache>(
+        mjolnir.get<size_t>("max_cache_size", kDefaultSharedCacheSize));
+    auto storage = std::make_shared<GraphTileFsStorage>(mjolnir);
+    for (uint32_t i = 1; i < thread_count; ++i)
+      readers.emplace_back(std::make_shared<GraphReader>(storage, mjolnir, shared_cache));
+    return readers;
+  }
 }
 
 namespace valhalla {
@@ -215,7 +235,10 @@ namespace valhalla {
     }
 
     loki_worker_t::loki_worker_t(const boost::property_tree::ptree& config):
-        config(config), reader(config.get_child("mjolnir")), connectivity_map(std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir")), config.get_child("mjolnir")),
+        config(config), reader(config.get_child("mjolnir")),
+        worker_readers(make_worker_readers(config)),
+        search_workers(new midgard::WorkerPool(worker_readers.size() + 1)),
+        connectivity_map(std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir")), config.get_child("mjolnir")),
         long_request(config.get<float>("loki.logging.long_request")),
         max_contours(config.get<size_t>("service_limits.isochrone.max_contours")),
         max_time(config.get<size_t>("service_limits.isochrone.max_time")),
@@ -356,8 +379,9 @@ namespace valhalla {
       sources.clear();
       targets.clear();
       shape.clear();
-      if(reader.OverCommitted())
-        reader.Clear();
+      reader.Trim();
+      for (auto& worker_reader : worker_readers)
+        worker_reader->Trim();
     }
 
     void run_service(const boost::property_tree::ptree& config) {
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "baldr/location.h"
+#include "baldr/pathlocation.h"
+#include "loki/search.h"
+#include "midgard/worker_pool.h"
+#include "sif/autocost.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::sif;
+
+namespace {
+
+constexpr size_t kDefaultSharedCacheSize = 1073741824; //1 gig
+
+// Offset of the locations from the nodes they are drawn from, in degrees,
+// so they snap to edges rather than exactly onto the nodes
+constexpr float kMaxOffset = 0.001f;
+
+}
+
+// Correlates a fixed set of locations to the graph with the serial search
+// and with the search spread over a pool of worker threads and readers, and
+// reports the locations per second of each. The locations are drawn near
+// the nodes of the local level with a fixed seed, so the same tiles always
+// give the same locations. Both searches must correlate them the same way.
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: valhalla_benchmark_loki CONFIG [LOCATIONS] [THREADS] [ROUNDS]"
+              << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const size_t location_count = argc > 2 ? std::stoul(argv[2]) : 10000;
+  const uint32_t threads = std::max(argc > 3 ? std::stoul(argv[3]) : 4ul, 1ul);
+  const size_t rounds = argc > 4 ? std::stoul(argv[4]) : 5;
+
+  const auto& mjolnir = config.get_child("mjolnir");
+  auto storage = std::make_shared<GraphTileFsStorage>(mjolnir);
+  GraphReader reader(storage, mjolnir);
+  auto shared_cache = std::make_shared<SynchronizedTileCache>(
+      mjolnir.get<size_t>("max_cache_size", kDefaultSharedCacheSize));
+  std::vector<std::shared_ptr<GraphReader>> worker_readers;
+  for (uint32_t i = 1; i < threads; ++i) {
+    worker_readers.emplace_back(std::make_shared<GraphReader>(storage, mjolnir, shared_cache));
+  }
+  WorkerPool pool(threads);
+
+  // Nodes of the local level to draw the locations from, in tile order
+  std::vector<PointLL> nodes;
+  std::vector<GraphId> tiles;
+  const uint8_t local_level = reader.GetTileHierarchy().levels().rbegin()->first;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    if (tile_id.level() == local_level) {
+      tiles.push_back(tile_id);
+    }
+  }
+  std::sort(tiles.begin(), tiles.end());
+  for (const auto& tile_id : tiles) {
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    for (uint32_t i = 0; tile != nullptr && i < tile->header()->nodecount(); ++i) {
+      nodes.push_back(tile->node(i)->latlng());
+    }
+  }
+  if (nodes.empty()) {
+    std::cout << "No local nodes in the tile set" << std::endl;
+    return 1;
+  }
+
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+  std::uniform_real_distribution<float> offset(-kMaxOffset, kMaxOffset);
+  std::vector<Location> locations;
+  for (size_t i = 0; i < location_count; ++i) {
+    const PointLL& node = nodes[pick(generator)];
+    locations.emplace_back(PointLL(node.lng() + offset(generator),
+                                   node.lat() + offset(generator)));
+  }
+
+  auto costing = CreateAutoCost(config.get_child("costing_options.auto",
+                                                 boost::property_tree::ptree()));
+  const auto edge_filter = costing->GetEdgeFilter();
+  const auto node_filter = costing->GetNodeFilter();
+  using searched_t = std::unordered_map<Location, PathLocation>;
+  auto time = [&](const std::string& name, const std::function<searched_t ()>& search) {
+    searched_t searched;
+    // Warm the tile caches so every round reads the tiles from memory
+    search();
+    reader.Trim();
+    for (auto& worker_reader : worker_readers) {
+      worker_reader->Trim();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+      searched = search();
+    }
+    auto elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(1) << name << ": "
+              << rounds * locations.size() / elapsed << " locations/second, "
+              << searched.size() << " correlated" << std::endl;
+    return searched;
+  };
+  const auto serial = time("1 thread", [&]() {
+    return valhalla::loki::Search(locations, reader, edge_filter, node_filter);
+  });
+  const auto parallel = time(std::to_string(threads) + " threads", [&]() {
+    return valhalla::loki::Search(locations, reader, worker_readers, pool,
+                                  edge_filter, node_filter);
+  });
+
+  // Same edges for every location
+  size_t mismatches = serial.size() != parallel.size();
+  for (const auto& location : serial) {
+    auto found = parallel.find(location.first);
+    if (found == parallel.end() ||
+        found->second.edges.size() != location.second.edges.size()) {
+      mismatches++;
+      continue;
+    }
+    for (size_t i = 0; i < location.second.edges.size(); ++i) {
+      if (found->second.edges[i].id != location.second.edges[i].id) {
+        mismatches++;
+        break;
+      }
+    }
+  }
+  if (mismatches > 0) {
+    std::cout << mismatches << " locations differ between the searches" << std::endl;
+    return 1;
+  }
+  return 0;
+}
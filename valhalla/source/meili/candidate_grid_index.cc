@@ -0,0 +1,174 @@
+#include "meili/candidate_grid_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace valhalla {
+namespace meili {
+
+// Sort and pack the (cell, edge) pairs into the compressed rows
+CandidateGridIndex::CandidateGridIndex(const midgard::AABB2<midgard::PointLL>& bbox,
+                                       float cell_width, float cell_height,
+                                       std::vector<std::pair<uint32_t, baldr::GraphId>>& items)
+    : grid_(bbox.minx(), bbox.miny(), cell_width, cell_height,
+            ceil((bbox.maxx() - bbox.minx()) / cell_width),
+            ceil((bbox.maxy() - bbox.miny()) / cell_height)),
+      ncols_(ceil((bbox.maxx() - bbox.minx()) / cell_width)),
+      nrows_(ceil((bbox.maxy() - bbox.miny()) / cell_height)) {
+  std::sort(items.begin(), items.end());
+  items.erase(std::unique(items.begin(), items.end()), items.end());
+
+  edges_.reserve(items.size());
+  for (const auto& item : items) {
+    if (cells_.empty() || cells_.back() != item.first) {
+      cells_.push_back(item.first);
+      offsets_.push_back(edges_.size());
+    }
+    edges_.push_back(item.second);
+  }
+  offsets_.push_back(edges_.size());
+
+  cells_.shrink_to_fit();
+  offsets_.shrink_to_fit();
+  items.clear();
+}
+
+// Add each road linestring's line segments into grid. Only one side
+// of directed edges is added
+std::shared_ptr<const CandidateGridIndex>
+CandidateGridIndex::Build(const baldr::GraphTile& tile, const int32_t bin_index,
+                          baldr::GraphReader& reader, float cell_width, float cell_height) {
+  const auto bbox = tile.BoundingBox(reader.GetTileHierarchy());
+  const int ncols = ceil((bbox.maxx() - bbox.minx()) / cell_width);
+  const int nrows = ceil((bbox.maxy() - bbox.miny()) / cell_height);
+  GridTraversal<midgard::PointLL> grid(bbox.minx(), bbox.miny(), cell_width, cell_height, ncols, nrows);
+
+  // Get the edges within the specified bin.
+  std::vector<std::pair<uint32_t, baldr::GraphId>> items;
+  auto edge_ids = tile.GetBin(bin_index);
+  for(const auto& edge_id : edge_ids) {
+    // Get the right tile (edges in a bin can be in a different tile if they
+    // pass through the tile but do not start or end in the tile). Skip if
+    // tile is null.
+    const auto* bin_tile = edge_id.tileid() == tile.header()->graphid().tileid() ?
+                  &tile : reader.GetGraphTile(edge_id);
+    if(bin_tile == nullptr) continue;
+
+    // Get the edge. Skip transition edges and transit connection edges.
+    const auto* edge = bin_tile->directededge(edge_id);
+    if(edge->trans_up() || edge->trans_down() ||
+       edge->use() == baldr::Use::kTransitConnection) continue;
+
+    // Get shape and add to grid. Use lazy_shape to avoid allocations.
+    auto shape = bin_tile->edgeinfo(edge->edgeinfo_offset()).lazy_shape();
+    if (!shape.empty()) {
+      midgard::PointLL v = shape.pop();
+      while (!shape.empty()) {
+        const midgard::PointLL u = v;
+        v = shape.pop();
+        for (const auto& square : grid.Traverse(u, v)) {
+          items.emplace_back(square.first + square.second * ncols, edge_id);
+        }
+      }
+    }
+  }
+
+  return std::make_shared<const CandidateGridIndex>(bbox, cell_width, cell_height, items);
+}
+
+// Append the edges of all cells intersecting the range. Each row of the
+// range is a contiguous run of cell ids so it is one binary search per row.
+void CandidateGridIndex::Query(const midgard::AABB2<midgard::PointLL>& range,
+                               std::vector<baldr::GraphId>& edges) const {
+  int mincol, minrow, maxcol, maxrow;
+  std::tie(mincol, minrow) = grid_.SquareAtPoint(range.minpt());
+  std::tie(maxcol, maxrow) = grid_.SquareAtPoint(range.maxpt());
+
+  // Normalize
+  mincol = std::max(0, std::min(mincol, ncols_ - 1));
+  maxcol = std::max(0, std::min(maxcol, ncols_ - 1));
+  minrow = std::max(0, std::min(minrow, nrows_ - 1));
+  maxrow = std::max(0, std::min(maxrow, nrows_ - 1));
+
+  for (int row = minrow; row <= maxrow; ++row) {
+    const uint32_t first = mincol + row * ncols_;
+    const uint32_t last = maxcol + row * ncols_;
+    auto cell = std::lower_bound(cells_.begin(), cells_.end(), first);
+    for (; cell != cells_.end() && *cell <= last; ++cell) {
+      const auto i = cell - cells_.begin();
+      edges.insert(edges.end(), edges_.begin() + offsets_[i], edges_.begin() + offsets_[i + 1]);
+    }
+  }
+}
+
+// Approximate memory used by the index
+size_t CandidateGridIndex::MemoryUse() const {
+  return sizeof(CandidateGridIndex) +
+         cells_.capacity() * sizeof(uint32_t) +
+         offsets_.capacity() * sizeof(uint32_t) +
+         edges_.capacity() * sizeof(baldr::GraphId);
+}
+
+// Constructor
+CandidateGridCache::CandidateGridCache(float cell_width, float cell_height, size_t max_size)
+    : cell_width_(cell_width),
+      cell_height_(cell_height),
+      cache_size_(0),
+      max_cache_size_(max_size) {
+}
+
+// Get the index of a bin, marks it as the most recently used one
+std::shared_ptr<const CandidateGridIndex> CandidateGridCache::Get(const int32_t bin_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto cached = cache_.find(bin_id);
+  if (cached == cache_.end()) {
+    return nullptr;
+  }
+  if (cached->second != lru_.begin()) {
+    lru_.splice(lru_.begin(), lru_, cached->second);
+  }
+  return cached->second->index;
+}
+
+// Put the index of a bin into the cache. Evicting is safe at any time as
+// queries hold their own references to the indexes they use.
+std::shared_ptr<const CandidateGridIndex>
+CandidateGridCache::Put(const int32_t bin_id, const std::shared_ptr<const CandidateGridIndex>& index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto cached = cache_.find(bin_id);
+  if (cached != cache_.end()) {
+    lru_.splice(lru_.begin(), lru_, cached->second);
+    return cached->second->index;
+  }
+
+  const size_t size = index->MemoryUse();
+  lru_.push_front({bin_id, index, size});
+  cache_.emplace(bin_id, lru_.begin());
+  cache_size_ += size;
+
+  // Evict the least recently used bins, but never the one just added
+  while (cache_size_ > max_cache_size_ && lru_.size() > 1) {
+    const auto& entry = lru_.back();
+    cache_size_ -= entry.size;
+    cache_.erase(entry.bin_id);
+    lru_.pop_back();
+  }
+  return index;
+}
+
+// Number of cached bins
+size_t CandidateGridCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.size();
+}
+
+// Clears the cache
+void CandidateGridCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_size_ = 0;
+  cache_.clear();
+  lru_.clear();
+}
+
+}
+}
@@ -55,10 +55,10 @@ CandidateQuery::WithinSquaredDistance(const midgard::PointLL& location,
       throw std::logic_error("edges feed in candidate filtering should be at the same level as its endnode and opposite edge");
     }
 
-    // NOTE a pointer to edgeinfo is needed here because it returns
-    // an unique ptr
-    const auto edgeinfo = tile->edgeinfo(edge->edgeinfo_offset());
-    const auto& shape = edgeinfo.shape();
+    // Nearby edges are looked at again and again for each measurement so
+    // the shape comes from the decoded shape cache of the tile
+    const auto shape_ptr = tile->GetShape(edge->edgeinfo_offset());
+    const auto& shape = *shape_ptr;
     if (shape.empty()) {
       // Otherwise Project will fail
       continue;
@@ -122,46 +122,16 @@ CandidateQuery::WithinSquaredDistance(const midgard::PointLL& location,
 }
 
 
-// Add each road linestring's line segments into grid. Only one side
-// of directed edges is added
-void IndexBin(const baldr::GraphTile& tile, const int32_t bin_index,
-               baldr::GraphReader& reader, CandidateGridQuery::grid_t& grid)
-{
-  // Get the edges within the specified bin.
-  auto edge_ids = tile.GetBin(bin_index);
-  for(const auto& edge_id : edge_ids) {
-    // Get the right tile (edges in a bin can be in a different tile if they
-    // pass through the tile but do not start or end in the tile). Skip if
-    // tile is null.
-    const auto* bin_tile = edge_id.tileid() == tile.header()->graphid().tileid() ?
-                  &tile : reader.GetGraphTile(edge_id);
-    if(bin_tile == nullptr) continue;
-
-    // Get the edge. Skip transition edges and transit connection edges.
-    const auto* edge = bin_tile->directededge(edge_id);
-    if(edge->trans_up() || edge->trans_down() ||
-       edge->use() == baldr::Use::kTransitConnection) continue;
-
-    // Get shape and add to grid. Use lazy_shape to avoid allocations.
-    auto shape = bin_tile->edgeinfo(edge->edgeinfo_offset()).lazy_shape();
-    if (!shape.empty()) {
-      PointLL v = shape.pop();
-      while (!shape.empty()) {
-        const PointLL u = v;
-        v = shape.pop();
-        grid.AddLineSegment(edge_id, {u, v});
-      }
-    }
-  }
+CandidateGridQuery::CandidateGridQuery(baldr::GraphReader& reader, float cell_width, float cell_height)
+    : CandidateGridQuery(reader, std::make_shared<CandidateGridCache>(cell_width, cell_height)) {
 }
 
 
-CandidateGridQuery::CandidateGridQuery(baldr::GraphReader& reader, float cell_width, float cell_height)
+CandidateGridQuery::CandidateGridQuery(baldr::GraphReader& reader,
+                                       const std::shared_ptr<CandidateGridCache>& grid_cache)
     : CandidateQuery(reader),
       hierarchy_(reader.GetTileHierarchy()),
-      cell_width_(cell_width),
-      cell_height_(cell_height),
-      grid_cache_() {
+      grid_cache_(grid_cache) {
   bin_level_ = hierarchy_.levels().rbegin()->second.level;
 }
 
@@ -169,14 +139,14 @@ CandidateGridQuery::CandidateGridQuery(baldr::GraphReader& reader, float cell_wi
 CandidateGridQuery::~CandidateGridQuery() {}
 
 
-inline const CandidateGridQuery::grid_t*
+inline std::shared_ptr<const CandidateGridIndex>
 CandidateGridQuery::GetGrid(const int32_t bin_id, const Tiles<PointLL>& tiles,
                             const Tiles<PointLL>& bins) const
 {
   // Check if the bin is in the cache
-  const auto it = grid_cache_.find(bin_id);
-  if (it != grid_cache_.end()) {
-    return &(it->second);
+  auto grid = grid_cache_->Get(bin_id);
+  if (grid) {
+    return grid;
   }
 
   // Not in the cache. Get the tile and Index the bin within the tile.
@@ -194,15 +164,16 @@ CandidateGridQuery::GetGrid(const int32_t bin_id, const Tiles<PointLL>& tiles,
   int32_t bin_col = rc.second % ndiv;
   int32_t bin_index = (bin_row * ndiv) + bin_col;
 
-  // Insert the bin into the cache and index the bin
-  const auto inserted = grid_cache_.emplace(bin_id,
-          grid_t(tile->BoundingBox(hierarchy_), cell_width_, cell_height_));
-  IndexBin(*tile, bin_index, reader_, inserted.first->second);
-  return &(inserted.first->second);
+  // Index the bin and insert it into the cache. Another query may have
+  // beaten us to it, in which case its index is used
+  grid = CandidateGridIndex::Build(*tile, bin_index, reader_,
+                                   grid_cache_->cell_width(), grid_cache_->cell_height());
+  return grid_cache_->Put(bin_id, grid);
 }
 
-std::unordered_set<baldr::GraphId>
-CandidateGridQuery::RangeQuery(const AABB2<midgard::PointLL>& range) const
+void
+CandidateGridQuery::RangeQuery(const AABB2<midgard::PointLL>& range,
+                               std::vector<baldr::GraphId>& edgeids) const
 {
   // Get the tiles object from the tile hierarchy and create the bin tiles
   // (subidivisions within the tile)
@@ -215,15 +186,16 @@ CandidateGridQuery::RangeQuery(const AABB2<midgard::PointLL>& range) const
   auto bin_list = bins.TileList(range);
 
   // Iterate through the bins and query grids to get results
-  std::unordered_set<baldr::GraphId> result;
   for (auto bin_id : bin_list) {
     auto grid = GetGrid(bin_id, tiles, bins);
     if (grid) {
-      const auto& set = grid->Query(range);
-      result.insert(set.begin(), set.end());
+      grid->Query(range, edgeids);
     }
   }
-  return result;
+
+  // Edges are found once per cell and bin they pass through
+  std::sort(edgeids.begin(), edgeids.end());
+  edgeids.erase(std::unique(edgeids.begin(), edgeids.end()), edgeids.end());
 }
 
 
@@ -237,7 +209,8 @@ CandidateGridQuery::Query(const midgard::PointLL& location,
   }
 
   const auto& range = helpers::ExpandMeters(location, std::sqrt(sq_search_radius));
-  const auto& edgeids = RangeQuery(range);
+  std::vector<baldr::GraphId> edgeids;
+  RangeQuery(range, edgeids);
   return WithinSquaredDistance(location, sq_search_radius,
                                edgeids.begin(), edgeids.end(), filter);
 }
@@ -14,6 +14,9 @@ namespace {
 using namespace valhalla;
 using namespace valhalla::meili;
 
+// How many match measurements online matching may hold back at most
+constexpr Time kDefaultOnlineMaxLag = 32;
+
 
 inline float
 GreatCircleDistanceSquared(const Measurement& left,
@@ -65,9 +68,8 @@ InterpolateMeasurement(const MapMatching& mapmatching,
       continue;
     }
 
-    const auto edgeinfo = tile->edgeinfo(directededge->edgeinfo_offset());
-
-    const auto& shape = edgeinfo.shape();
+    const auto shape_ptr = tile->GetShape(directededge->edgeinfo_offset());
+    const auto& shape = *shape_ptr;
     if (shape.empty()) {
       continue;
     }
@@ -188,11 +190,12 @@ InterpolateMeasurements(const MapMatching& mapmatching,
 
 
 // Interplolate measurements grouped by previous match measurement
-// time
+// time. The state after state_rbegin is invalid unless the path goes on
 std::unordered_map<Time, std::vector<MatchResult>>
 InterpolateTimedMeasurements(const MapMatching& mapmatching,
                              const MapMatching::state_iterator& state_rbegin,
                              const MapMatching::state_iterator& state_rend,
+                             const MapMatching::state_iterator& state_after,
                              const std::unordered_map<Time, std::vector<Measurement>>& interpolated_measurements,
                              Time time)
 {
@@ -200,7 +203,7 @@ InterpolateTimedMeasurements(const MapMatching& mapmatching,
 
   for (auto previous_state = std::next(state_rbegin),
                      state = state_rbegin,
-                next_state = MapMatching::state_iterator(nullptr);
+                next_state = state_after;
        state != state_rend;
        next_state = state, state++, previous_state = std::next(state)) {
 
@@ -264,11 +267,13 @@ FindMatchResult(const MapMatching::state_iterator& previous_state,
 }
 
 
-// Find the corresponding match results of a list of states
+// Find the corresponding match results of a list of states. The state
+// after state_rbegin is invalid unless the path goes on
 std::vector<MatchResult>
 FindMatchResults(const MapMatching& mapmatching,
                  const MapMatching::state_iterator& state_rbegin,
                  const MapMatching::state_iterator& state_rend,
+                 const MapMatching::state_iterator& state_after,
                  Time time)
 {
   if (state_rbegin == state_rend) {
@@ -279,7 +284,7 @@ FindMatchResults(const MapMatching& mapmatching,
 
   for (auto previous_state = std::next(state_rbegin),
                      state = state_rbegin,
-                next_state = MapMatching::state_iterator(nullptr);
+                next_state = state_after;
        state != state_rend;
        next_state = state, state++, previous_state = std::next(state)) {
     if (state.IsValid()) {
@@ -296,14 +301,14 @@ FindMatchResults(const MapMatching& mapmatching,
 
 
 // Insert the interpolated results into the result list, and
-// return a new result list
+// return a new result list. The first result is at the time
 std::vector<MatchResult>
 MergeMatchResults(const std::vector<MatchResult>& results,
-                  const std::unordered_map<Time, std::vector<MatchResult>>& interpolated_results)
+                  const std::unordered_map<Time, std::vector<MatchResult>>& interpolated_results,
+                  Time time)
 {
   std::vector<MatchResult> merged_results;
 
-  Time time = 0;
   for (const auto& result: results) {
     merged_results.push_back(result);
 
@@ -337,7 +342,9 @@ MapMatcher::MapMatcher(const boost::property_tree::ptree& config,
       mode_costing_(mode_costing),
       travelmode_(travelmode),
       mapmatching_(graphreader_, mode_costing_, travelmode_, config_),
-      interrupt_(nullptr) {}
+      interrupt_(nullptr),
+      online_time_(kInvalidTime),
+      online_interpolated_() {}
 
 
 MapMatcher::~MapMatcher() {}
@@ -347,6 +354,8 @@ std::vector<MatchResult>
 MapMatcher::OfflineMatch(const std::vector<Measurement>& measurements)
 {
   mapmatching_.Clear();
+  online_time_ = kInvalidTime;
+  online_interpolated_.clear();
 
   const auto begin = measurements.begin(),
                end = measurements.end();
@@ -378,7 +387,8 @@ MapMatcher::OfflineMatch(const std::vector<Measurement>& measurements)
 
   const auto state_rbegin = mapmatching_.SearchPath(time),
                state_rend = std::next(state_rbegin, match_count);
-  const auto& results = FindMatchResults(mapmatching_, state_rbegin, state_rend, time);
+  const auto& results = FindMatchResults(mapmatching_, state_rbegin, state_rend,
+                                         MapMatching::state_iterator(nullptr), time);
 
   // Done if no measurements to interpolate
   if (interpolated_measurements.empty()) {
@@ -390,11 +400,110 @@ MapMatcher::OfflineMatch(const std::vector<Measurement>& measurements)
       mapmatching_,
       state_rbegin,
       state_rend,
+      MapMatching::state_iterator(nullptr),
       interpolated_measurements,
       time);
 
   // Insert the interpolated results into the result list
-  return MergeMatchResults(results, interpolated_results);
+  return MergeMatchResults(results, interpolated_results, 0);
+}
+
+
+std::vector<MatchResult>
+MapMatcher::OnlineMatch(const Measurement& measurement)
+{
+  // Start a new trace
+  if (online_time_ == kInvalidTime) {
+    mapmatching_.Clear();
+    online_interpolated_.clear();
+    online_time_ = 0;
+  }
+
+  // The states behind the results returned last time are not needed any
+  // more, except the one right before the next result
+  if (0 < online_time_) {
+    mapmatching_.Prune(online_time_ - 1);
+  }
+
+  // Interpolate measurements close to the latest match measurement
+  if (0 < mapmatching_.size()) {
+    const auto interpolation_distance = config_.get<float>("interpolation_distance");
+    const Time time = mapmatching_.size() - 1;
+    const auto sq_distance = GreatCircleDistanceSquared(mapmatching_.measurement(time), measurement);
+    if (sq_distance <= interpolation_distance * interpolation_distance) {
+      online_interpolated_[time].push_back(measurement);
+      return {};
+    }
+  }
+
+  const auto time = AppendMeasurement(measurement);
+  mapmatching_.SearchWinner(time);
+
+  // The result at a time depends on the routes from and to its
+  // neighbours, so results are final up to right before the convergence
+  const auto max_lag = config_.get<Time>("online_max_lag", kDefaultOnlineMaxLag);
+  const auto converged = mapmatching_.Converge(max_lag);
+  if (converged.time() == kInvalidTime || converged.time() <= online_time_) {
+    return {};
+  }
+  return OnlineResults(std::next(converged), converged);
+}
+
+
+std::vector<MatchResult>
+MapMatcher::FinishOnlineMatch()
+{
+  if (online_time_ == kInvalidTime || mapmatching_.size() == 0) {
+    online_time_ = kInvalidTime;
+    return {};
+  }
+
+  if (0 < online_time_) {
+    mapmatching_.Prune(online_time_ - 1);
+  }
+
+  // Always match the last measurement
+  Time time = mapmatching_.size() - 1;
+  const auto it = online_interpolated_.find(time);
+  if (it != online_interpolated_.end() && !it->second.empty()) {
+    const auto measurement = it->second.back();
+    it->second.pop_back();
+    time = AppendMeasurement(measurement);
+  }
+
+  const auto& results = OnlineResults(mapmatching_.SearchPath(time),
+                                      MapMatching::state_iterator(nullptr));
+  online_time_ = kInvalidTime;
+  online_interpolated_.clear();
+  return results;
+}
+
+
+std::vector<MatchResult>
+MapMatcher::OnlineResults(const MapMatching::state_iterator& state_rbegin,
+                          const MapMatching::state_iterator& state_after)
+{
+  const auto time = state_rbegin.time();
+  const auto state_rend = std::next(state_rbegin, time - online_time_ + 1);
+  const auto& results = FindMatchResults(mapmatching_, state_rbegin, state_rend, state_after, time);
+
+  std::unordered_map<Time, std::vector<MatchResult>> interpolated_results;
+  if (!online_interpolated_.empty()) {
+    interpolated_results = InterpolateTimedMeasurements(
+        mapmatching_,
+        state_rbegin,
+        state_rend,
+        state_after,
+        online_interpolated_,
+        time);
+    for (auto t = online_time_; t <= time; t++) {
+      online_interpolated_.erase(t);
+    }
+  }
+
+  const auto first_time = online_time_;
+  online_time_ = time + 1;
+  return MergeMatchResults(results, interpolated_results, first_time);
 }
 
 
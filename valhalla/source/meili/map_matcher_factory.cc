@@ -5,6 +5,7 @@
 #include "sif/bicyclecost.h"
 #include "sif/pedestriancost.h"
 #include "baldr/graphreader.h"
+#include "midgard/logging.h"
 
 #include "meili/candidate_search.h"
 #include "meili/map_matcher.h"
@@ -23,6 +24,23 @@ local_tile_size(const valhalla::baldr::GraphReader& graphreader)
   return tiles.TileSize();
 }
 
+// Bytes the candidate grids may take up. The old meili.grid.cache_size
+// counted grids, it can not be turned into bytes so it falls back to the
+// default budget
+size_t
+grid_cache_size(const boost::property_tree::ptree& root)
+{
+  const auto max_size = root.get_optional<size_t>("meili.grid.max_cache_size");
+  if (max_size) {
+    return *max_size;
+  }
+  if (root.get_optional<std::string>("meili.grid.cache_size")) {
+    LOG_WARN("meili.grid.cache_size is deprecated and ignored, set meili.grid.max_cache_size "
+             "in bytes instead. Using " + std::to_string(valhalla::meili::kDefaultMaxGridCacheSize));
+  }
+  return valhalla::meili::kDefaultMaxGridCacheSize;
+}
+
 }
 
 
@@ -32,10 +50,11 @@ namespace meili {
 MapMatcherFactory::MapMatcherFactory(const boost::property_tree::ptree& root)
     : config_(root.get_child("meili")),
       graphreader_(root.get_child("mjolnir")),
-      candidatequery_(graphreader_,
-                      local_tile_size(graphreader_)/root.get<size_t>("meili.grid.size"),
-                      local_tile_size(graphreader_)/root.get<size_t>("meili.grid.size")),
-      max_grid_cache_size_(root.get<float>("meili.grid.cache_size"))
+      grid_cache_(std::make_shared<CandidateGridCache>(
+          local_tile_size(graphreader_)/root.get<size_t>("meili.grid.size"),
+          local_tile_size(graphreader_)/root.get<size_t>("meili.grid.size"),
+          grid_cache_size(root))),
+      candidatequery_(graphreader_, grid_cache_)
       { 
   cost_factory_.Register("auto", sif::CreateAutoCost);
   cost_factory_.Register("bicycle", sif::CreateBicycleCost);
@@ -130,13 +149,8 @@ sif::cost_ptr_t MapMatcherFactory::get_costing(const boost::property_tree::ptree
 
 void MapMatcherFactory::ClearFullCache()
 {
-  if(graphreader_.OverCommitted()) {
-    graphreader_.Clear();
-  }
-
-  if (candidatequery_.size() > max_grid_cache_size_) {
-    candidatequery_.Clear();
-  }
+  // The grid cache keeps itself within its budget
+  graphreader_.Trim();
 }
 
 
@@ -27,7 +27,8 @@ State::State(const StateId id, const Time time, const baldr::PathLocation& candi
     : id_(id),
       time_(time),
       candidate_(candidate),
-      labelset_(nullptr),
+      routed_(false),
+      labels_(),
       label_idx_() {}
 
 
@@ -38,8 +39,9 @@ State::route(const std::vector<const State*>& states,
              const midgard::DistanceApproximator& approximator,
              float search_radius,
              sif::cost_ptr_t costing,
-             std::shared_ptr<const sif::EdgeLabel> edgelabel,
-             const float turn_cost_table[181]) const
+             const sif::EdgeLabel* edgelabel,
+             const float turn_cost_table[181],
+             LabelSet& labelset) const
 {
   // Prepare locations
   std::vector<baldr::PathLocation> locations;
@@ -49,13 +51,15 @@ State::route(const std::vector<const State*>& states,
     locations.push_back(state->candidate());
   }
 
-  // Route
-  labelset_ = std::make_shared<LabelSet>(std::ceil(max_route_distance));
-  // TODO pass labelset_ as shared_ptr
+  // Route, labels costing more than the max route distance are rejected
+  labelset.recycle(std::move(labels_));
+  labelset.reuse(std::ceil(max_route_distance));
   const auto& results = find_shortest_path(
-      graphreader, locations, 0, *labelset_,
+      graphreader, locations, 0, labelset,
       approximator, search_radius,
       costing, edgelabel, turn_cost_table);
+  labels_ = labelset.release_labels();
+  routed_ = true;
 
   // Cache results
   label_idx_.clear();
@@ -75,12 +79,23 @@ State::last_label(const State& state) const
 {
   const auto it = label_idx_.find(state.id());
   if (it != label_idx_.end()) {
-    return &labelset_->label(it->second);
+    return &labels_[it->second];
   }
   return nullptr;
 }
 
 
+std::vector<Label>
+State::release_labels() const
+{
+  std::vector<Label> labels;
+  labels.swap(labels_);
+  label_idx_.clear();
+  routed_ = false;
+  return labels;
+}
+
+
 MapMatching::MapMatching(baldr::GraphReader& graphreader,
                          const sif::cost_ptr_t* mode_costing,
                          const sif::TravelMode mode,
@@ -101,7 +116,8 @@ MapMatching::MapMatching(baldr::GraphReader& graphreader,
       breakage_distance_(breakage_distance),
       max_route_distance_factor_(max_route_distance_factor),
       turn_penalty_factor_(turn_penalty_factor),
-      turn_cost_table_{0.f}
+      turn_cost_table_{0.f},
+      labelset_(0)
 {
   if (sigma_z_ <= 0.f) {
     throw std::invalid_argument("Expect sigma_z to be positive");
@@ -142,12 +158,44 @@ MapMatching::~MapMatching()
 void
 MapMatching::Clear()
 {
+  for (const auto& column : states_) {
+    RecycleLabels(column);
+  }
   measurements_.clear();
   states_.clear();
   ViterbiSearch<State>::Clear();
 }
 
 
+void
+MapMatching::Prune(Time time)
+{
+  // The base class throws before forgetting anything if the states were
+  // not searched yet
+  if (time <= time_base_ + winner_.size()) {
+    for (auto t = time_base_; t < time; t++) {
+      RecycleLabels(states_[t - time_base_]);
+    }
+  }
+
+  const auto base = time_base_;
+  ViterbiSearch<State>::Prune(time);
+  for (auto t = base; t < time_base_; t++) {
+    measurements_.pop_front();
+    states_.pop_front();
+  }
+}
+
+
+void
+MapMatching::RecycleLabels(const std::vector<const State*>& column)
+{
+  for (const auto state : column) {
+    labelset_.recycle(state->release_labels());
+  }
+}
+
+
 inline float
 MapMatching::MaxRouteDistance(const State& left, const State& right) const
 {
@@ -160,7 +208,7 @@ float
 MapMatching::TransitionCost(const State& left, const State& right) const
 {
   if (!left.routed()) {
-    std::shared_ptr<const sif::EdgeLabel> edgelabel;
+    const sif::EdgeLabel* edgelabel;
     const auto prev_stateid = predecessor(left.id());
     if (prev_stateid != kInvalidStateId) {
       const auto& prev_state = state(prev_stateid);
@@ -175,7 +223,7 @@ MapMatching::TransitionCost(const State& left, const State& right) const
                                " Check if you have misused the TransitionCost method");
       }
       const auto label = prev_state.last_label(left);
-      edgelabel = label? label->edgelabel : nullptr;
+      edgelabel = label? label->edgelabel_ptr() : nullptr;
     } else {
       edgelabel = nullptr;
     }
@@ -185,10 +233,10 @@ MapMatching::TransitionCost(const State& left, const State& right) const
     // cached routes of a state. We should be careful with it and
     // do not use it for purposes like getting transition cost of
     // two *arbitrary* states.
-    left.route(unreached_states_[right.time()], graphreader_,
+    left.route(unreached_states_[right.time() - time_base_], graphreader_,
                MaxRouteDistance(left, right),
                approximator, measurement(right).search_radius(),
-               costing(), edgelabel, turn_cost_table_);
+               costing(), edgelabel, turn_cost_table_, labelset_);
   }
   // TODO: test it state.route(...); assert(state.routed());
 
@@ -191,8 +191,8 @@ EdgeSegment::Shape(baldr::GraphReader& graphreader) const
   const baldr::GraphTile* tile = nullptr;
   const auto edge = helpers::edge_directededge(graphreader, edgeid, tile);
   if (edge && !edge->trans_up() && !edge->trans_down()) {
-    const auto edgeinfo = tile->edgeinfo(edge->edgeinfo_offset());
-    const auto& shape = edgeinfo.shape();
+    const auto shape_ptr = tile->GetShape(edge->edgeinfo_offset());
+    const auto& shape = *shape_ptr;
     if (edge->forward()) {
       return helpers::ClipLineString(shape.cbegin(), shape.cend(), source, target);
     } else {
@@ -18,13 +18,98 @@ namespace valhalla {
 
 namespace meili {
 
+constexpr uint64_t StatusMap::kEmptyKey;
+
+
+StatusMap::StatusMap()
+    : mask_(0) {}
+
+
+void
+StatusMap::emplace(uint64_t key, uint32_t label_idx)
+{
+  // Keep the table at most half full
+  if (slots_.size() <= used_.size() * 2) {
+    grow();
+  }
+  auto i = slot_idx(key);
+  while (slots_[i].key != kEmptyKey) {
+    i = (i + 1) & mask_;
+  }
+  slots_[i] = {key, Status(label_idx)};
+  used_.push_back(i);
+}
+
+
+void
+StatusMap::clear()
+{
+  for (const auto i : used_) {
+    slots_[i].key = kEmptyKey;
+  }
+  used_.clear();
+}
+
+
+void
+StatusMap::grow()
+{
+  std::vector<Slot> slots(std::max<size_t>(64, slots_.size() * 2), {kEmptyKey, Status(0)});
+  slots_.swap(slots);
+  mask_ = slots_.size() - 1;
+  std::vector<uint32_t> used;
+  used.swap(used_);
+  for (const auto i : used) {
+    const auto& slot = slots[i];
+    auto j = slot_idx(slot.key);
+    while (slots_[j].key != kEmptyKey) {
+      j = (j + 1) & mask_;
+    }
+    slots_[j] = slot;
+    used_.push_back(j);
+  }
+}
+
+
 LabelSet::LabelSet(typename BucketQueue<uint32_t, kInvalidLabelIndex>::size_type count, float size)
     : queue_(count, size) {}
 
 
+void
+LabelSet::reuse(typename BucketQueue<uint32_t, kInvalidLabelIndex>::size_type count)
+{
+  queue_.reset(count);
+  clear_status();
+  if (labels_.capacity() == 0 && !pool_.empty()) {
+    labels_.swap(pool_.back());
+    pool_.pop_back();
+  }
+  labels_.clear();
+}
+
+
+std::vector<Label>
+LabelSet::release_labels()
+{
+  std::vector<Label> labels;
+  labels.swap(labels_);
+  return labels;
+}
+
+
+void
+LabelSet::recycle(std::vector<Label>&& labels)
+{
+  if (labels.capacity() > 0 && pool_.size() < kMaxPooledLabelLists) {
+    labels.clear();
+    pool_.push_back(std::move(labels));
+  }
+}
+
+
 bool
 LabelSet::put(const baldr::GraphId& nodeid, sif::TravelMode travelmode,
-              std::shared_ptr<const sif::EdgeLabel> edgelabel)
+              const sif::EdgeLabel* edgelabel)
 {
   return put(nodeid, {},         // nodeid, (dummy) edgeid
              0.f, 0.f,           // source, target
@@ -42,15 +127,15 @@ LabelSet::put(const baldr::GraphId& nodeid,
               uint32_t predecessor,
               const baldr::DirectedEdge* edge,
               sif::TravelMode travelmode,
-              std::shared_ptr<const sif::EdgeLabel> edgelabel)
+              const sif::EdgeLabel* edgelabel)
 {
   if (!nodeid.Is_Valid()) {
     throw std::runtime_error("invalid nodeid");
   }
-  const auto it = node_status_.find(nodeid);
+  const auto status_ptr = node_status_.find(nodeid.value);
 
   // Create a new label and push it to the queue
-  if (it == node_status_.end()) {
+  if (!status_ptr) {
     const uint32_t idx = labels_.size();
     const bool added = queue_.add(idx, sortcost);
     if (added) {
@@ -59,14 +144,14 @@ LabelSet::put(const baldr::GraphId& nodeid,
                            cost, turn_cost, sortcost,
                            predecessor,
                            edge, travelmode, edgelabel);
-      node_status_.emplace(nodeid, idx);
+      node_status_.emplace(nodeid.value, idx);
       return true;
     }
     // !added -> rejected silently since queue's full
 
   } else {
     // Decrease cost of the existing label
-    const auto& status = it->second;
+    const auto& status = *status_ptr;
     if (!status.permanent && sortcost < labels_[status.label_idx].sortcost) {
       // TODO check if it goes through constructor
       labels_[status.label_idx] = {nodeid, edgeid,
@@ -85,7 +170,7 @@ LabelSet::put(const baldr::GraphId& nodeid,
 
 bool
 LabelSet::put(uint16_t dest, sif::TravelMode travelmode,
-              std::shared_ptr<const sif::EdgeLabel> edgelabel)
+              const sif::EdgeLabel* edgelabel)
 {
   return put(dest, {},           // dest, (dummy) edgeid
              0.f, 0.f,           // source, target
@@ -103,16 +188,16 @@ LabelSet::put(uint16_t dest,
               uint32_t predecessor,
               const baldr::DirectedEdge* edge,
               sif::TravelMode travelmode,
-              std::shared_ptr<const sif::EdgeLabel> edgelabel)
+              const sif::EdgeLabel* edgelabel)
 {
   if (dest == kInvalidDestination) {
     throw std::runtime_error("invalid destination");
   }
 
-  const auto it = dest_status_.find(dest);
+  const auto status_ptr = dest_status_.find(dest);
 
   // Create a new label and push it to the queue
-  if (it == dest_status_.end()) {
+  if (!status_ptr) {
     const uint32_t idx = labels_.size();
     const bool added = queue_.add(idx, sortcost);
     if (added) {
@@ -128,7 +213,7 @@ LabelSet::put(uint16_t dest,
 
   } else {
     // Decrease cost of the existing label
-    const auto& status = it->second;
+    const auto& status = *status_ptr;
     if (!status.permanent && sortcost < labels_[status.label_idx].sortcost) {
       // TODO check if it goes through constructor
       labels_[status.label_idx] = {dest, edgeid,
@@ -154,15 +239,15 @@ LabelSet::pop()
   if (idx != kInvalidLabelIndex) {
     const auto& label = labels_[idx];
     if (label.nodeid.Is_Valid()) {
-      const auto it = node_status_.find(label.nodeid);
+      const auto status_ptr = node_status_.find(label.nodeid.value);
 
       // When these logic errors happen, go check LabelSet::put
-      if (it == node_status_.end()) {
+      if (!status_ptr) {
         // No exception, unless BucketQueue::put was wrong: it said it
         // added but actually failed
         throw std::logic_error("all nodes in the queue should have its status");
       }
-      auto& status = it->second;
+      auto& status = *status_ptr;
       if (status.label_idx != idx) {
         throw std::logic_error("the index stored in the status " + std::to_string(status.label_idx) +
                                " is not synced up with the index poped from the queue" + std::to_string(idx));
@@ -178,12 +263,12 @@ LabelSet::pop()
 
       status.permanent = true;
     } else {  // assert(label.dest != kInvalidDestination)
-      const auto it = dest_status_.find(label.dest);
+      const auto status_ptr = dest_status_.find(label.dest);
 
-      if (it == dest_status_.end()) {
+      if (!status_ptr) {
         throw std::logic_error("all dests in the queue should have its status");
       }
-      auto& status = it->second;
+      auto& status = *status_ptr;
       if (status.label_idx != idx) {
         throw std::logic_error("the index stored in the status " + std::to_string(status.label_idx) +
                                " is not synced up with the index poped from the queue" + std::to_string(idx));
@@ -205,7 +290,7 @@ inline bool
 IsEdgeAllowed(const baldr::DirectedEdge* edge,
               const baldr::GraphId& edgeid,
               const sif::cost_ptr_t costing,
-              const std::shared_ptr<const sif::EdgeLabel>& pred_edgelabel,
+              const sif::EdgeLabel* pred_edgelabel,
               const baldr::GraphTile* tile)
 {
   if (costing && pred_edgelabel) {
@@ -229,7 +314,7 @@ void set_origin(baldr::GraphReader& reader,
                 LabelSet& labelset,
                 const sif::TravelMode travelmode,
                 sif::cost_ptr_t costing,
-                std::shared_ptr<const sif::EdgeLabel> edgelabel)
+                const sif::EdgeLabel* edgelabel)
 {
   const baldr::GraphTile* tile = nullptr;
 
@@ -312,8 +397,8 @@ get_inbound_edgelabel_heading(baldr::GraphReader& graphreader,
     return nodeinfo.heading(idx);
   } else {
     const auto directededge = helpers::edge_directededge(graphreader, edgelabel.edgeid(), tile);
-    const auto edgeinfo = tile->edgeinfo(directededge->edgeinfo_offset());
-    const auto& shape = edgeinfo.shape();
+    const auto shape_ptr = tile->GetShape(directededge->edgeinfo_offset());
+    const auto& shape = *shape_ptr;
     if (shape.size() >= 2) {
       float heading;
       if (directededge->forward()) {
@@ -338,8 +423,8 @@ get_outbound_edge_heading(const baldr::GraphTile* tile,
   if (idx < 8) {
     return nodeinfo.heading(idx);
   } else {
-    const auto edgeinfo = tile->edgeinfo(outbound_edge->edgeinfo_offset());
-    const auto& shape = edgeinfo.shape();
+    const auto shape_ptr = tile->GetShape(outbound_edge->edgeinfo_offset());
+    const auto& shape = *shape_ptr;
     if (shape.size() >= 2) {
       float heading;
       if (outbound_edge->forward()) {
@@ -398,7 +483,7 @@ find_shortest_path(baldr::GraphReader& reader,
                    const midgard::DistanceApproximator& approximator,
                    float search_radius,
                    sif::cost_ptr_t costing,
-                   std::shared_ptr<const sif::EdgeLabel> edgelabel,
+                   const sif::EdgeLabel* edgelabel,
                    const float turn_cost_table[181])
 {
   // Destinations at nodes
@@ -432,7 +517,7 @@ find_shortest_path(baldr::GraphReader& reader,
 
     // Find the first non-transition edgelabel
     // Note only use edgelabel to determine if edge is allowed or not
-    auto pred_edgelabel = label.edgelabel;
+    auto pred_edgelabel_idx = label_idx;
     {
       auto pred_idx = label_idx;
       auto pred_edgeid = label.edgeid;
@@ -440,12 +525,20 @@ find_shortest_path(baldr::GraphReader& reader,
              && pred_edgeid.Is_Valid()
              && isTransition(reader, pred_edgeid, tile)) {
         const auto& pred_label = labelset.label(pred_idx);
+        pred_edgelabel_idx = pred_idx;
         pred_idx = pred_label.predecessor;
         pred_edgeid = pred_label.edgeid;
-        pred_edgelabel = pred_label.edgelabel;
       }
     }
 
+    // Copied since adding labels may move the labels
+    sif::EdgeLabel pred_edgelabel_copy;
+    const sif::EdgeLabel* pred_edgelabel = nullptr;
+    if (labelset.label(pred_edgelabel_idx).has_edgelabel) {
+      pred_edgelabel_copy = labelset.label(pred_edgelabel_idx).edgelabel;
+      pred_edgelabel = &pred_edgelabel_copy;
+    }
+
     if (label.nodeid.Is_Valid()) {
       const auto nodeid = label.nodeid;
 
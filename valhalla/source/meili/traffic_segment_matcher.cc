@@ -1,21 +1,25 @@
 #include <vector>
 #include <string>
+#include <atomic>
+#include <stdexcept>
 #include <boost/property_tree/json_parser.hpp>
 
 #include "midgard/logging.h"
 #include "midgard/pointll.h"
 
+#include "baldr/graphtilefsstorage.h"
 #include "meili/traffic_segment_matcher.h"
 
 using namespace valhalla::baldr;
 
 namespace {
 
+constexpr size_t kDefaultSharedCacheSize = 1073741824; //1 gig
+
 float GetEdgeDist(const valhalla::meili::MatchResult& res,
-                  std::shared_ptr<valhalla::meili::MapMatcher> matcher) {
+                  const valhalla::meili::MapMatcher& matcher) {
   if (res.HasState()) {
-    bool found = false;
-    const auto& state = matcher->mapmatching().state(res.stateid());
+    const auto& state = matcher.mapmatching().state(res.stateid());
     PathLocation loc = state.candidate();
     for (const auto& e : loc.edges) {
      if (e.id == res.edgeid()) {
@@ -26,77 +30,69 @@ float GetEdgeDist(const valhalla::meili::MatchResult& res,
   return 1.0f;
 }
 
+template <class T>
+void write(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
 };
 
 namespace valhalla {
 namespace meili {
 
-TrafficSegmentMatcher::TrafficSegmentMatcher(const boost::property_tree::ptree& config)
+TrafficSegmentMatcher::TrafficSegmentMatcher(const boost::property_tree::ptree& config,
+                                             const uint32_t thread_count)
     : reader(config.get_child("mjolnir")),
-      matcher_factory(config) {
-}
-
-std::string  TrafficSegmentMatcher::match(const std::string& json) {
-  // From ptree from JSON string
-  boost::property_tree::ptree request;
-  try {
-    std::stringstream stream(json);
-    boost::property_tree::read_json(stream, request);
-  } catch (...) {
-    LOG_ERROR("Error parsing JSON= " + json);
-    return "{\"foo\":\"bar\"}";
-  }
-
-  // Form trace positions
-  std::vector<PointLL> trace;
-  std::vector<uint32_t> times;
-  auto trace_pts = request.get_child_optional("trace");
-
-  if (trace_pts) {
-    for (const auto& pt : *trace_pts) {
-      float lat = pt.second.get<float>("lat");
-      float lon = pt.second.get<float>("lon");
-      trace.emplace_back(lon, lat);
-      times.push_back(pt.second.get<int>("time"));
-    }
-  } else {
-    LOG_ERROR("Could not form trace from input JSON= " + json);
-    return "{\"foo\":\"bar\"}";
-  }
-
+      matcher_factory(config),
+      workers(thread_count) {
   // Need to add a ptree to set the mode to use within matching
   // TODO - do we need to overrides to defaults?
   // TODO - later could input a mode in the request?
   boost::property_tree::ptree trace_config;
   trace_config.put<std::string>("mode", "auto");
 
-  // Call Meili for map matching to get a collection of pathLocation Edges
-  // Create a matcher
-  std::shared_ptr<valhalla::meili::MapMatcher> matcher;
-  try {
-    matcher.reset(matcher_factory.Create(trace_config));
-  } catch (const std::invalid_argument& ex) {
-    // TODO - what to return?
-    return "{\"foo\":\"bar\"}";
+  // The calling thread uses the reader and candidate query of the factory.
+  // The other threads get their own, sharing tiles and candidate grids with
+  // each other, and share the costing of the first matcher.
+  matchers.emplace_back(matcher_factory.Create(trace_config));
+  const auto& mjolnir = config.get_child("mjolnir");
+  auto shared_cache = std::make_shared<SynchronizedTileCache>(
+      mjolnir.get<size_t>("max_cache_size", kDefaultSharedCacheSize));
+  auto storage = std::make_shared<GraphTileFsStorage>(mjolnir);
+  for (uint32_t i = 1; i < workers.size(); ++i) {
+    worker_readers.emplace_back(new GraphReader(storage, mjolnir, shared_cache));
+    worker_queries.emplace_back(new CandidateGridQuery(*worker_readers.back(),
+                                                       matcher_factory.grid_cache()));
+    matchers.emplace_back(new MapMatcher(matchers.front()->config(),
+                                         *worker_readers.back(),
+                                         *worker_queries.back(),
+                                         matchers.front()->mode_costing(),
+                                         matchers.front()->travelmode()));
   }
+}
 
+// Matches a GPS trace to Valhalla edges and then associates those to
+// traffic segments
+bool TrafficSegmentMatcher::match_segments(MapMatcher& matcher, const TrafficTrace& trace,
+                                           std::vector<MatchedTrafficSegment>& traffic_segment) {
   // Populate a measurement sequence to pass to the map matcher
+  const float gps_accuracy = matcher.config().get<float>("gps_accuracy");
+  const float search_radius = matcher.config().get<float>("search_radius");
   std::vector<valhalla::meili::Measurement> sequence;
-  for (const auto& coord : trace) {
-    sequence.emplace_back(coord,
-                          matcher->config().get<float>("gps_accuracy"),
-                          matcher->config().get<float>("search_radius"));
+  sequence.reserve(trace.shape.size());
+  for (const auto& coord : trace.shape) {
+    sequence.emplace_back(coord, gps_accuracy, search_radius);
   }
 
   // Create the vector of matched path results
   std::vector<valhalla::meili::MatchResult> results;
   if (sequence.size() > 0) {
-    results = matcher->OfflineMatch(sequence);
+    results = matcher.OfflineMatch(sequence);
   }
 
-  if (sequence.size() != results.size()) {
+  if (sequence.size() != results.size() || trace.times.size() != results.size()) {
     LOG_ERROR("Sequence size not equal to match result size");
-    return "{\"foo\":\"bar\"}";
+    return false;
   }
 
   // TODO - more robust list of edges. Handle cases where multiple
@@ -109,7 +105,7 @@ std::string  TrafficSegmentMatcher::match(const std::string& json) {
   for (const auto& res : results) {
     // Make sure edge is valid
     if (res.edgeid().Is_Valid()) {
-      trace_edges.emplace_back(EdgeOnTrace{res.edgeid(), GetEdgeDist(res, matcher), static_cast<float>(times[idx])});
+      trace_edges.emplace_back(EdgeOnTrace{res.edgeid(), GetEdgeDist(res, matcher), static_cast<float>(trace.times[idx])});
     }
     idx++;
   }
@@ -145,11 +141,11 @@ std::string  TrafficSegmentMatcher::match(const std::string& json) {
   //means that the time is now floating point (or only second resolution)
 
   GraphId prior_segment;
-  std::vector<MatchedTrafficSegment> traffic_segment;
+  traffic_segment.clear();
   for (const auto& edge : edges) {
     // Get the directed edge Id and tile
     GraphId edge_id = edge.edge_id;
-    const GraphTile* tile = matcher->graphreader().GetGraphTile(edge_id);
+    const GraphTile* tile = matcher.graphreader().GetGraphTile(edge_id);
     const DirectedEdge* directededge = tile->directededge(edge_id);
 
     // Compute the length of the trace along this edge
@@ -238,6 +234,42 @@ std::string  TrafficSegmentMatcher::match(const std::string& json) {
     prior_edge = edge_id;
   }
 
+  return true;
+}
+
+std::string  TrafficSegmentMatcher::match(const std::string& json) {
+  // From ptree from JSON string
+  boost::property_tree::ptree request;
+  try {
+    std::stringstream stream(json);
+    boost::property_tree::read_json(stream, request);
+  } catch (...) {
+    LOG_ERROR("Error parsing JSON= " + json);
+    return "{\"foo\":\"bar\"}";
+  }
+
+  // Form trace positions
+  TrafficTrace trace{0, {}, {}};
+  auto trace_pts = request.get_child_optional("trace");
+
+  if (trace_pts) {
+    for (const auto& pt : *trace_pts) {
+      float lat = pt.second.get<float>("lat");
+      float lon = pt.second.get<float>("lon");
+      trace.shape.emplace_back(lon, lat);
+      trace.times.push_back(pt.second.get<int>("time"));
+    }
+  } else {
+    LOG_ERROR("Could not form trace from input JSON= " + json);
+    return "{\"foo\":\"bar\"}";
+  }
+
+  // Match it with the matcher of the calling thread
+  std::vector<MatchedTrafficSegment> traffic_segment;
+  if (!match_segments(*matchers.front(), trace, traffic_segment)) {
+    return "{\"foo\":\"bar\"}";
+  }
+
   // Serialize and return as a string
   auto segments = json::array({});
   for (const auto& seg : traffic_segment) {
@@ -259,5 +291,54 @@ std::string  TrafficSegmentMatcher::match(const std::string& json) {
   return ss.str();
 }
 
+// Matches a batch of traces, the threads take the next trace not matched
+// yet until none are left since traces vary a lot in length
+void TrafficSegmentMatcher::match(const std::vector<TrafficTrace>& traces,
+                                  const traffic_segment_callback_t& callback) {
+  std::atomic<size_t> next_trace(0);
+  workers.Run([&](const uint32_t worker) {
+    MapMatcher& matcher = *matchers[worker];
+    std::vector<MatchedTrafficSegment> segments;
+    for (size_t i = next_trace++; i < traces.size(); i = next_trace++) {
+      // A trace that fails to match is reported without segments, the rest
+      // of the batch is still matched
+      try {
+        if (!match_segments(matcher, traces[i], segments)) {
+          segments.clear();
+        }
+      }
+      catch (const std::exception& e) {
+        LOG_ERROR("Failed to match trace " + std::to_string(traces[i].id) + ": " + e.what());
+        segments.clear();
+      }
+
+      // Tiles are only evicted when trimmed, keep the cache of this thread
+      // within its limit between traces
+      if (matcher.graphreader().OverCommitted()) {
+        matcher.graphreader().Trim();
+      }
+
+      std::lock_guard<std::mutex> lock(callback_mutex);
+      callback(traces[i], segments);
+    }
+  });
+}
+
+// Writes the record of a trace
+void TrafficSegmentWriter::operator()(const TrafficTrace& trace,
+                                      const std::vector<MatchedTrafficSegment>& segments) {
+  write(*out_, trace.id);
+  write(*out_, static_cast<uint32_t>(segments.size()));
+  for (const auto& seg : segments) {
+    write(*out_, seg.segment_id.value);
+    write(*out_, seg.start_time);
+    write(*out_, seg.end_time);
+    write(*out_, seg.length);
+    write(*out_, static_cast<uint32_t>(seg.begin_shape_index));
+    write(*out_, static_cast<uint32_t>(seg.end_shape_index));
+    write(*out_, static_cast<uint8_t>((seg.partial_start ? 1 : 0) | (seg.partial_end ? 2 : 0)));
+  }
+}
+
 }
 }
@@ -56,6 +56,61 @@ bool GriddedData<coord_t>::SetIfLessThan(const int tile_id, const float value) {
   return false;
 }
 
+// Set the values along a polyline if less than the current values
+template <class coord_t>
+void GriddedData<coord_t>::SetIfLessThan(const std::vector<coord_t>& polyline,
+                                         float value, const float delta) {
+  const auto set_cell = [this, &value](int32_t x, int32_t y) {
+    if (x < 0 || y < 0 || x >= this->ncolumns_ || y >= this->nrows_) {
+      return true;
+    }
+    float& cell = data_[y * this->ncolumns_ + x];
+    if (value < cell) {
+      cell = value;
+    }
+    return false;
+  };
+
+  // Convert to cell coordinates once per point, each segment reuses the
+  // coordinates of the previous segment's end
+  const auto& bounds = this->tilebounds_;
+  float x0 = 0.0f, y0 = 0.0f;
+  for (size_t i = 0; i < polyline.size(); i++) {
+    float x1 = (polyline[i].first - bounds.minx()) / bounds.Width() * this->ncolumns_;
+    float y1 = (polyline[i].second - bounds.miny()) / bounds.Height() * this->nrows_;
+    if (i > 0) {
+      int ix0 = std::floor(x0), ix1 = std::floor(x1);
+      int iy0 = std::floor(y0), iy1 = std::floor(y1);
+      int dx = ix0 - ix1, dy = iy0 - iy1;
+      int ds = dx * dx + dy * dy;
+      // Mostly the segment is within one cell or crosses into an adjacent
+      // one, otherwise rasterize it
+      if (ds == 0) {
+        set_cell(ix0, iy0);
+      } else if (ds == 1) {
+        set_cell(ix0, iy0);
+        set_cell(ix1, iy1);
+      } else {
+        bresenham_line(x0, y0, x1, y1, set_cell);
+      }
+      value += delta;
+    }
+    x0 = x1;
+    y0 = y1;
+  }
+}
+
+// Merge values gridded separately over the same tiles
+template <class coord_t>
+void GriddedData<coord_t>::SetIfLessThan(const std::vector<float>& values) {
+  size_t count = std::min(values.size(), data_.size());
+  for (size_t i = 0; i < count; i++) {
+    if (values[i] < data_[i]) {
+      data_[i] = values[i];
+    }
+  }
+}
+
 // Get the array of times
 template <class coord_t>
 const std::vector<float>& GriddedData<coord_t>::data() const {
@@ -0,0 +1,212 @@
+#include "midgard/shape_decoder.h"
+
+#include <algorithm>
+#include <utility>
+
+// The block decoding needs SSSE3. Builds that do not target it everywhere
+// compile it for SSSE3 anyway on x86 and check the cpu at run time.
+#if defined(__SSSE3__)
+#define SHAPE_DECODER_BLOCKS
+#define SHAPE_DECODER_SSSE3
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHAPE_DECODER_BLOCKS
+#define SHAPE_DECODER_SSSE3 __attribute__((target("ssse3")))
+#define SHAPE_DECODER_CHECK_CPU
+#endif
+
+#if defined(SHAPE_DECODER_BLOCKS)
+#include <tmmintrin.h>
+#endif
+
+namespace {
+
+// Running sums of the lat and lon offsets. They alternate so the sums are
+// swapped after each offset. Summing while decoding, rather than in another
+// pass, saves reloading each value right after it was stored.
+struct coordinates_t {
+  int32_t* out;
+  int32_t next;
+  int32_t other;
+
+  void add(const int32_t offset) {
+    next += offset;
+    *out++ = next;
+    std::swap(next, other);
+  }
+};
+
+// Decode one varint a byte at a time, this is what Shape7Decoder does
+inline const uint8_t* decode_varint(const uint8_t* begin, const uint8_t* end,
+                                    coordinates_t& coords) {
+  int32_t byte, shift = 0, result = 0;
+  do {
+    if (begin == end) throw std::runtime_error("Bad encoded polyline");
+    byte = int32_t(*begin++);
+    result |= (byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  coords.add((result & 1 ? ~result : result) >> 1);
+  return begin;
+}
+
+#if defined(SHAPE_DECODER_BLOCKS)
+
+// Number of bytes whose continuation bits select how a block is decoded
+constexpr uint32_t kMaskBits = 12;
+
+// How to decode the varints at the start of a block, given which of its
+// first kMaskBits bytes are continued. Up to 8 varints of 1 or 2 bytes are
+// shuffled into 16 bit lanes, or up to 4 of 1 to 3 bytes into 32 bit lanes.
+struct block_layout_t {
+  int8_t shuffle[16];   // Source byte of each lane byte, -1 to zero it
+  uint8_t count;        // Number of varints, 0 if none can be shuffled
+  uint8_t length;       // Number of bytes they take up
+  bool wide;            // 32 bit lanes
+};
+
+// Work out the layouts of all the possible continuation bits
+struct block_layouts_t {
+  block_layout_t layouts[1 << kMaskBits];
+
+  block_layouts_t() {
+    for (uint32_t mask = 0; mask < (1u << kMaskBits); ++mask) {
+      // Lengths of the varints ending within the first kMaskBits bytes
+      uint32_t lengths[kMaskBits], count = 0, start = 0;
+      for (uint32_t i = 0; i < kMaskBits; ++i) {
+        if (!(mask & (1u << i))) {
+          lengths[count++] = i + 1 - start;
+          start = i + 1;
+        }
+      }
+
+      // Count how many leading varints fit each lane width
+      uint32_t narrow = 0, wide = 0;
+      while (narrow < count && narrow < 8 && lengths[narrow] <= 2) ++narrow;
+      while (wide < count && wide < 4 && lengths[wide] <= 3) ++wide;
+
+      block_layout_t& layout = layouts[mask];
+      layout.wide = wide > narrow;
+      layout.count = layout.wide ? wide : narrow;
+      const uint32_t lane_size = layout.wide ? 4 : 2;
+      std::fill(layout.shuffle, layout.shuffle + 16, -1);
+      start = 0;
+      for (uint32_t v = 0; v < layout.count; ++v) {
+        for (uint32_t b = 0; b < lengths[v]; ++b) {
+          layout.shuffle[v * lane_size + b] = start + b;
+        }
+        start += lengths[v];
+      }
+      layout.length = start;
+    }
+  }
+};
+
+const block_layouts_t& block_layouts() {
+  static const block_layouts_t layouts;
+  return layouts;
+}
+
+// Undo the bit flipping and sum up the offsets of 4 lanes, 2 points, adding
+// the first point to the second and the previous point to both.
+SHAPE_DECODER_SSSE3 inline __m128i sum_offsets(__m128i values, __m128i& carry) {
+  const __m128i sign = _mm_sub_epi32(_mm_setzero_si128(),
+                                     _mm_and_si128(values, _mm_set1_epi32(1)));
+  values = _mm_xor_si128(_mm_srli_epi32(values, 1), sign);
+  values = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+  values = _mm_add_epi32(values, carry);
+  carry = _mm_shuffle_epi32(values, _MM_SHUFFLE(3, 2, 3, 2));
+  return values;
+}
+
+// Decode the varints 16 bytes at a time. The high bits of the bytes say
+// where the varints end, which picks a shuffle putting each short varint in
+// a lane of its own where the 7 bit groups are put back together. Longer
+// varints are decoded one at a time. Returns where it stopped, whatever is
+// left is less than a block.
+SHAPE_DECODER_SSSE3 const uint8_t* decode_blocks(const uint8_t* begin,
+    const uint8_t* end, coordinates_t& coords) {
+  const block_layouts_t& layouts = block_layouts();
+  while (end - begin >= 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const uint32_t mask = _mm_movemask_epi8(bytes) & ((1u << kMaskBits) - 1);
+    const block_layout_t& layout = layouts.layouts[mask];
+    if (layout.count == 0) {
+      begin = decode_varint(begin, end, coords);
+      continue;
+    }
+
+    // All the lanes are stored though only count of them are varints. There
+    // is room for it as there are at least as many bytes left as values.
+    const __m128i lanes = _mm_shuffle_epi8(bytes,
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(layout.shuffle)));
+    __m128i carry = _mm_setr_epi32(coords.next, coords.other, coords.next, coords.other);
+    if (layout.wide) {
+      const __m128i values = _mm_or_si128(
+          _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi32(0x7f)),
+                       _mm_and_si128(_mm_srli_epi32(lanes, 1), _mm_set1_epi32(0x3f80))),
+          _mm_and_si128(_mm_srli_epi32(lanes, 2), _mm_set1_epi32(0x1fc000)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(coords.out), sum_offsets(values, carry));
+    } else {
+      const __m128i values = _mm_or_si128(
+          _mm_and_si128(lanes, _mm_set1_epi16(0x7f)),
+          _mm_and_si128(_mm_srli_epi16(lanes, 1), _mm_set1_epi16(0x3f80)));
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i low = sum_offsets(_mm_unpacklo_epi16(values, zero), carry);
+      const __m128i high = sum_offsets(_mm_unpackhi_epi16(values, zero), carry);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(coords.out), low);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(coords.out + 4), high);
+    }
+
+    // The last 2 values are the sums to carry on with, the previous sum if
+    // there was only one value
+    const int32_t previous = coords.other;
+    coords.out += layout.count;
+    coords.other = coords.out[-1];
+    coords.next = layout.count > 1 ? coords.out[-2] : previous;
+    begin += layout.length;
+  }
+  return begin;
+}
+
+// Whether the cpu can decode blocks
+bool has_ssse3() {
+#if defined(SHAPE_DECODER_CHECK_CPU)
+  static const bool supported = __builtin_cpu_supports("ssse3");
+  return supported;
+#else
+  return true;
+#endif
+}
+
+#endif
+
+}
+
+namespace valhalla {
+namespace midgard {
+
+// Decode the offsets and sum them up
+size_t decode7_fixed_point(const char* encoded, const size_t length,
+                           int32_t* values) noexcept(false) {
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(encoded);
+  const uint8_t* end = begin + length;
+  coordinates_t coords{values, 0, 0};
+#if defined(SHAPE_DECODER_BLOCKS)
+  if (has_ssse3()) {
+    begin = decode_blocks(begin, end, coords);
+  }
+#endif
+  while (begin != end) {
+    begin = decode_varint(begin, end, coords);
+  }
+
+  // Every lat needs its lon
+  const size_t count = coords.out - values;
+  if (count & 1) {
+    throw std::runtime_error("Bad encoded polyline");
+  }
+  return count;
+}
+
+}
+}
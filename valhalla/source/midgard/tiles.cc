@@ -2,37 +2,12 @@
 #include "midgard/polyline2.h"
 #include "midgard/util.h"
 #include "midgard/distanceapproximator.h"
+#include <algorithm>
 #include <cmath>
 #include <set>
 
 namespace {
 
-  //this is modified to include all pixels that are intersected by the floating point line
-  //at each step it decides to either move in the x or y direction based on which pixels midpoint
-  //forms a smaller triangle with the line. to avoid edge cases we allow set_pixel to make the
-  //the loop bail if we leave the valid drawing region
-  void bresenham_line(float x0, float y0, float x1, float y1, const std::function<bool (int32_t, int32_t)>& set_pixel) {
-    //this one for sure
-    bool outside = set_pixel(std::floor(x0), std::floor(y0));
-    //steps in the proper direction and constants for shoelace formula
-    float sx = x0 < x1 ? 1 : -1, dx = x1 - x0, x = std::floor(x0) + .5f;
-    float sy = y0 < y1 ? 1 : -1, dy = y1 - y0, y = std::floor(y0) + .5f;
-    //keep going until we make it to the ending pixel
-    while(std::floor(x) != std::floor(x1) || std::floor(y) != std::floor(y1)) {
-      float tx = std::abs(dx*(y - y0) - dy*((x + sx) - x0));
-      float ty = std::abs(dx*((y + sy) - y0) - dy*(x - x0));
-      //less error moving in the x
-      if(tx < ty) { x += sx; }
-      //less error moving in the y
-      else { y += sy; }
-      //mark this pixel
-      bool o = set_pixel(std::floor(x), std::floor(y));
-      if(outside == false && o == true)
-        return;
-      outside = o;
-    }
-  }
-
   //a functor to generate closest first subdivisions of a set of tiles
   template <class coord_t>
   struct closest_first_generator_t {
@@ -413,15 +388,19 @@ std::vector<int> Tiles<coord_t>::TileList(const AABB2<coord_t>& bbox) const {
 
 // Color a "connectivity map" starting with a sparse map of uncolored tiles.
 // Any 2 tiles that have a connected path between them will have the same
-// value in the connectivity map.
+// value in the connectivity map. Tiles that already have a color keep it,
+// the uncolored ones get colors after the largest one in use.
 template <class coord_t>
 void Tiles<coord_t>::ColorMap(std::unordered_map<uint32_t,
                               size_t>& connectivity_map) const {
   // Connectivity map - all connected regions will have a unique Id. If any 2
   // tile Ids have a different Id they are judged to be not-connected.
+  size_t color = 1;
+  for (const auto& tile : connectivity_map) {
+    color = std::max(color, tile.second + 1);
+  }
 
   // Iterate through tiles
-  size_t color = 1;
   for (auto& tile : connectivity_map) {
     // Continue if already visited
     if (tile.second > 0) {
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <cctype>
+#include <cmath>
 #include <stdlib.h>
 #include <sstream>
 #include <fstream>
@@ -193,6 +194,29 @@ container_t resample_spherical_polyline(const container_t& polyline, double reso
   return resampled;
 }
 
+// Rasterize a line, marking every pixel it passes through
+void bresenham_line(float x0, float y0, float x1, float y1, const std::function<bool (int32_t, int32_t)>& set_pixel) {
+  //this one for sure
+  bool outside = set_pixel(std::floor(x0), std::floor(y0));
+  //steps in the proper direction and constants for shoelace formula
+  float sx = x0 < x1 ? 1 : -1, dx = x1 - x0, x = std::floor(x0) + .5f;
+  float sy = y0 < y1 ? 1 : -1, dy = y1 - y0, y = std::floor(y0) + .5f;
+  //keep going until we make it to the ending pixel
+  while(std::floor(x) != std::floor(x1) || std::floor(y) != std::floor(y1)) {
+    float tx = std::abs(dx*(y - y0) - dy*((x + sx) - x0));
+    float ty = std::abs(dx*((y + sy) - y0) - dy*(x - x0));
+    //less error moving in the x
+    if(tx < ty) { x += sx; }
+    //less error moving in the y
+    else { y += sy; }
+    //mark this pixel
+    bool o = set_pixel(std::floor(x), std::floor(y));
+    if(outside == false && o == true)
+      return;
+    outside = o;
+  }
+}
+
 //explicit instantiations
 template std::vector<PointLL> resample_spherical_polyline<std::vector<PointLL> >(const std::vector<PointLL>&, double, bool);
 template std::vector<Point2> resample_spherical_polyline<std::vector<Point2> >(const std::vector<Point2>&, double, bool);
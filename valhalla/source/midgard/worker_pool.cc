@@ -0,0 +1,101 @@
+#include "midgard/worker_pool.h"
+
+namespace valhalla {
+namespace midgard {
+
+// Start the threads, the calling thread is worker 0
+WorkerPool::WorkerPool(const uint32_t worker_count)
+    : job_(nullptr),
+      generation_(0),
+      running_(0),
+      stop_(false) {
+  for (uint32_t i = 1; i < worker_count; i++) {
+    threads_.emplace_back(&WorkerPool::Work, this, i);
+  }
+}
+
+// Stop and join the threads
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+// Run a job on all workers and wait for them to finish
+void WorkerPool::Run(const std::function<void(const uint32_t)>& job) {
+  if (threads_.empty()) {
+    job(0);
+    return;
+  }
+
+  // Wake up the threads
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &job;
+    running_ = threads_.size();
+    error_ = nullptr;
+    generation_++;
+  }
+  start_.notify_all();
+
+  // Do our share, then wait for the others
+  std::exception_ptr error;
+  try {
+    job(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return running_ == 0; });
+  job_ = nullptr;
+  if (!error) {
+    error = error_;
+  }
+  lock.unlock();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Thread loop, runs the current job once per generation
+void WorkerPool::Work(const uint32_t worker) {
+  uint64_t generation = 0;
+  while (true) {
+    const std::function<void(const uint32_t)>* job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [this, generation]() {
+        return stop_ || generation_ != generation;
+      });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      job = job_;
+    }
+
+    std::exception_ptr error;
+    try {
+      (*job)(worker);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error && !error_) {
+        error_ = error;
+      }
+      running_--;
+    }
+    done_.notify_one();
+  }
+}
+
+}
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <stdexcept>
 
 #include <boost/property_tree/ptree.hpp>
@@ -36,6 +39,76 @@ std::unordered_map<K, V> as_unordered_map(
 namespace valhalla {
 namespace odin {
 
+PhraseTemplate::PhraseTemplate()
+    : defined_(false) {
+}
+
+// Split the phrase into literal text and <TAG> tokens. Anything between
+// angle brackets that is not an upper case tag name stays literal text.
+PhraseTemplate::PhraseTemplate(const std::string& phrase)
+    : text_(phrase),
+      defined_(true) {
+  size_t literal = 0;
+  size_t open = text_.find('<');
+  while (open != std::string::npos) {
+    size_t close = text_.find('>', open + 1);
+    if (close == std::string::npos) {
+      break;
+    }
+    bool tag = close > open + 1 && std::all_of(
+        text_.begin() + open + 1, text_.begin() + close, [](const char c) {
+          return std::isupper(static_cast<unsigned char>(c)) || c == '_';
+        });
+    if (tag) {
+      if (open > literal) {
+        tokens_.push_back({static_cast<uint32_t>(literal),
+                           static_cast<uint32_t>(open - literal), false});
+      }
+      tokens_.push_back({static_cast<uint32_t>(open),
+                         static_cast<uint32_t>(close + 1 - open), true});
+      literal = close + 1;
+      open = text_.find('<', literal);
+    } else {
+      open = text_.find('<', open + 1);
+    }
+  }
+  if (literal < text_.size()) {
+    tokens_.push_back({static_cast<uint32_t>(literal),
+                       static_cast<uint32_t>(text_.size() - literal), false});
+  }
+}
+
+// Append the literal text and the tag values in one pass
+void PhraseTemplate::Render(std::string& output,
+                            std::initializer_list<PhraseTagValue> values) const {
+  for (const auto& token : tokens_) {
+    const std::string* value = nullptr;
+    if (token.tag) {
+      for (const auto& tag_value : values) {
+        if (token.length == std::strlen(tag_value.tag) &&
+            text_.compare(token.offset, token.length, tag_value.tag) == 0) {
+          value = &tag_value.value;
+          break;
+        }
+      }
+    }
+    if (value != nullptr) {
+      output.append(*value);
+    } else {
+      output.append(text_, token.offset, token.length);
+    }
+  }
+}
+
+const PhraseTemplate& PhraseSet::phrase(const uint32_t phrase_id) const {
+  if (phrase_id >= phrase_templates.size() ||
+      !phrase_templates[phrase_id].defined()) {
+    throw std::out_of_range("Phrase " + std::to_string(phrase_id) +
+                            " does not exist");
+  }
+  return phrase_templates[phrase_id];
+}
+
 NarrativeDictionary::NarrativeDictionary(
     const std::string language_tag,
     const boost::property_tree::ptree& narrative_pt) {
@@ -330,6 +403,23 @@ void NarrativeDictionary::Load(PhraseSet& phrase_handle,
 
   phrase_handle.phrases = as_unordered_map<std::string, std::string>(
       phrase_pt, kPhrasesKey);
+
+  // Parse the phrases with numeric ids into templates
+  phrase_handle.phrase_templates.clear();
+  for (const auto& phrase : phrase_handle.phrases) {
+    const std::string& key = phrase.first;
+    if (key.empty() || key.size() > 4 ||
+        !std::all_of(key.begin(), key.end(), [](const char c) {
+          return std::isdigit(static_cast<unsigned char>(c));
+        })) {
+      continue;
+    }
+    const size_t phrase_id = std::stoul(key);
+    if (phrase_id >= phrase_handle.phrase_templates.size()) {
+      phrase_handle.phrase_templates.resize(phrase_id + 1);
+    }
+    phrase_handle.phrase_templates[phrase_id] = PhraseTemplate(phrase.second);
+  }
 }
 
 void NarrativeDictionary::Load(
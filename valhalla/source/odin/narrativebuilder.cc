@@ -47,7 +47,12 @@ NarrativeBuilder::NarrativeBuilder(
     : directions_options_(directions_options),
       trip_path_(trip_path),
       dictionary_(dictionary),
-      articulated_preposition_enabled_(false) {
+      articulated_preposition_enabled_(false),
+      verbal_enabled_(true) {
+}
+
+void NarrativeBuilder::set_verbal_enabled(const bool verbal_enabled) {
+  verbal_enabled_ = verbal_enabled;
 }
 
 void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
@@ -62,18 +67,20 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         // Set instruction
         maneuver.set_instruction(std::move(FormStartInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(
-                FormVerbalStartInstruction(maneuver)));
-
-        // Set verbal post transition instruction only if there are
-        // begin street names
-        if (maneuver.HasBeginStreetNames()) {
-          maneuver.set_verbal_post_transition_instruction(
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
               std::move(
-                  FormVerbalPostTransitionInstruction(
-                      maneuver, maneuver.HasBeginStreetNames())));
+                  FormVerbalStartInstruction(maneuver)));
+
+          // Set verbal post transition instruction only if there are
+          // begin street names
+          if (maneuver.HasBeginStreetNames()) {
+            maneuver.set_verbal_post_transition_instruction(
+                std::move(
+                    FormVerbalPostTransitionInstruction(
+                        maneuver, maneuver.HasBeginStreetNames())));
+          }
         }
         break;
       }
@@ -84,13 +91,15 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormDestinationInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertDestinationInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertDestinationInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalDestinationInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalDestinationInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kBecomes: {
@@ -98,15 +107,17 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormBecomesInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalBecomesInstruction(maneuver, prev_maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalBecomesInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(
-                FormVerbalPostTransitionInstruction(
-                    maneuver, maneuver.HasBeginStreetNames())));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(
+                  FormVerbalPostTransitionInstruction(
+                      maneuver, maneuver.HasBeginStreetNames())));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kSlightRight:
@@ -119,19 +130,21 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormTurnInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertTurnInstruction(maneuver, prev_maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertTurnInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalTurnInstruction(maneuver, prev_maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalTurnInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(
-                FormVerbalPostTransitionInstruction(
-                    maneuver, maneuver.HasBeginStreetNames())));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(
+                  FormVerbalPostTransitionInstruction(
+                      maneuver, maneuver.HasBeginStreetNames())));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kUturnRight:
@@ -140,17 +153,19 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormUturnInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertUturnInstruction(maneuver, prev_maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertUturnInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalUturnInstruction(maneuver, prev_maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalUturnInstruction(maneuver, prev_maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kRampStraight: {
@@ -158,19 +173,21 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormRampStraightInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertRampStraightInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertRampStraightInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalRampStraightInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalRampStraightInstruction(maneuver)));
 
-        // Only set verbal post if > min ramp length
-        if (maneuver.length() > kVerbalPostMinimumRampLength) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Only set verbal post if > min ramp length
+          if (maneuver.length() > kVerbalPostMinimumRampLength) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          }
         }
         break;
       }
@@ -179,19 +196,21 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         // Set instruction
         maneuver.set_instruction(std::move(FormRampInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertRampInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertRampInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalRampInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalRampInstruction(maneuver)));
 
-        // Only set verbal post if > min ramp length
-        if (maneuver.length() > kVerbalPostMinimumRampLength) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Only set verbal post if > min ramp length
+          if (maneuver.length() > kVerbalPostMinimumRampLength) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          }
         }
         break;
       }
@@ -200,19 +219,21 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         // Set instruction
         maneuver.set_instruction(std::move(FormExitInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertExitInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertExitInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalExitInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalExitInstruction(maneuver)));
 
-        // Only set verbal post if > min ramp length
-        if (maneuver.length() > kVerbalPostMinimumRampLength) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Only set verbal post if > min ramp length
+          if (maneuver.length() > kVerbalPostMinimumRampLength) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          }
         }
         break;
       }
@@ -224,37 +245,41 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
           maneuver.set_instruction(
               std::move(FormKeepToStayOnInstruction(maneuver)));
 
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(
-              std::move(FormVerbalAlertKeepToStayOnInstruction(maneuver)));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(
-              std::move(FormVerbalKeepToStayOnInstruction(maneuver)));
-
-          // Only set verbal post if > min ramp length
-          if (maneuver.length() > kVerbalPostMinimumRampLength) {
-            // Set verbal post transition instruction
-            maneuver.set_verbal_post_transition_instruction(
-                std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          if (verbal_enabled_) {
+            // Set verbal transition alert instruction
+            maneuver.set_verbal_transition_alert_instruction(
+                std::move(FormVerbalAlertKeepToStayOnInstruction(maneuver)));
+
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(
+                std::move(FormVerbalKeepToStayOnInstruction(maneuver)));
+
+            // Only set verbal post if > min ramp length
+            if (maneuver.length() > kVerbalPostMinimumRampLength) {
+              // Set verbal post transition instruction
+              maneuver.set_verbal_post_transition_instruction(
+                  std::move(FormVerbalPostTransitionInstruction(maneuver)));
+            }
           }
         } else {
           // Set instruction
           maneuver.set_instruction(std::move(FormKeepInstruction(maneuver)));
 
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(
-              std::move(FormVerbalAlertKeepInstruction(maneuver)));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(
-              std::move(FormVerbalKeepInstruction(maneuver)));
-
-          // Only set verbal post if > min ramp length
-          if (maneuver.length() > kVerbalPostMinimumRampLength) {
-            // Set verbal post transition instruction
-            maneuver.set_verbal_post_transition_instruction(
-                std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          if (verbal_enabled_) {
+            // Set verbal transition alert instruction
+            maneuver.set_verbal_transition_alert_instruction(
+                std::move(FormVerbalAlertKeepInstruction(maneuver)));
+
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(
+                std::move(FormVerbalKeepInstruction(maneuver)));
+
+            // Only set verbal post if > min ramp length
+            if (maneuver.length() > kVerbalPostMinimumRampLength) {
+              // Set verbal post transition instruction
+              maneuver.set_verbal_post_transition_instruction(
+                  std::move(FormVerbalPostTransitionInstruction(maneuver)));
+            }
           }
         }
         break;
@@ -263,22 +288,24 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         // Set instruction
         maneuver.set_instruction(std::move(FormMergeInstruction(maneuver)));
 
-        // Set verbal transition alert instruction if previous maneuver
-        // is greater than 2 km
-        if (prev_maneuver
-            && (prev_maneuver->length(DirectionsOptions_Units_kKilometers)
-                > kVerbalAlertMergePriorManeuverMinimumLength)) {
-          maneuver.set_verbal_transition_alert_instruction(
-              std::move(FormVerbalAlertMergeInstruction(maneuver)));
-        }
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction if previous maneuver
+          // is greater than 2 km
+          if (prev_maneuver
+              && (prev_maneuver->length(DirectionsOptions_Units_kKilometers)
+                  > kVerbalAlertMergePriorManeuverMinimumLength)) {
+            maneuver.set_verbal_transition_alert_instruction(
+                std::move(FormVerbalAlertMergeInstruction(maneuver)));
+          }
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalMergeInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalMergeInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kRoundaboutEnter: {
@@ -286,13 +313,15 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormEnterRoundaboutInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertEnterRoundaboutInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertEnterRoundaboutInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalEnterRoundaboutInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalEnterRoundaboutInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kRoundaboutExit: {
@@ -300,15 +329,17 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormExitRoundaboutInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalExitRoundaboutInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalExitRoundaboutInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(
-                FormVerbalPostTransitionInstruction(
-                    maneuver, maneuver.HasBeginStreetNames())));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(
+                  FormVerbalPostTransitionInstruction(
+                      maneuver, maneuver.HasBeginStreetNames())));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kFerryEnter: {
@@ -316,36 +347,40 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormEnterFerryInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertEnterFerryInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertEnterFerryInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalEnterFerryInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalEnterFerryInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kFerryExit: {
         // Set instruction
         maneuver.set_instruction(std::move(FormExitFerryInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertExitFerryInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertExitFerryInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalExitFerryInstruction(maneuver)));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalExitFerryInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(
-                FormVerbalPostTransitionInstruction(
-                    maneuver, maneuver.HasBeginStreetNames())));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(
+                  FormVerbalPostTransitionInstruction(
+                      maneuver, maneuver.HasBeginStreetNames())));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kTransitConnectionStart: {
@@ -353,13 +388,15 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormTransitConnectionStartInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalTransitConnectionStartInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalTransitConnectionStartInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kTransitConnectionTransfer: {
@@ -367,14 +404,16 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormTransitConnectionTransferInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(
-                FormVerbalTransitConnectionTransferInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(
+                  FormVerbalTransitConnectionTransferInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kTransitConnectionDestination: {
@@ -382,14 +421,16 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_instruction(
             std::move(FormTransitConnectionDestinationInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(
-                FormVerbalTransitConnectionDestinationInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(
+                  FormVerbalTransitConnectionDestinationInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kTransit: {
@@ -397,28 +438,34 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_depart_instruction(
             std::move(FormDepartInstruction(maneuver)));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(
-            std::move(FormVerbalDepartInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal depart instruction
+          maneuver.set_verbal_depart_instruction(
+              std::move(FormVerbalDepartInstruction(maneuver)));
+        }
 
         // Set instruction
         maneuver.set_instruction(std::move(FormTransitInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalTransitInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalTransitInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionTransitInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionTransitInstruction(maneuver)));
+        }
 
         // Set arrive instruction
         maneuver.set_arrive_instruction(
             std::move(FormArriveInstruction(maneuver)));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(
-            std::move(FormVerbalArriveInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal arrive instruction
+          maneuver.set_verbal_arrive_instruction(
+              std::move(FormVerbalArriveInstruction(maneuver)));
+        }
 
         break;
       }
@@ -427,29 +474,35 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_depart_instruction(
             std::move(FormDepartInstruction(maneuver)));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(
-            std::move(FormVerbalDepartInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal depart instruction
+          maneuver.set_verbal_depart_instruction(
+              std::move(FormVerbalDepartInstruction(maneuver)));
+        }
 
         // Set instruction
         maneuver.set_instruction(
             std::move(FormTransitRemainOnInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalTransitRemainOnInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalTransitRemainOnInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionTransitInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionTransitInstruction(maneuver)));
+        }
 
         // Set arrive instruction
         maneuver.set_arrive_instruction(
             std::move(FormArriveInstruction(maneuver)));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(
-            std::move(FormVerbalArriveInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal arrive instruction
+          maneuver.set_verbal_arrive_instruction(
+              std::move(FormVerbalArriveInstruction(maneuver)));
+        }
 
         break;
       }
@@ -458,29 +511,35 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         maneuver.set_depart_instruction(
             std::move(FormDepartInstruction(maneuver)));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(
-            std::move(FormVerbalDepartInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal depart instruction
+          maneuver.set_verbal_depart_instruction(
+              std::move(FormVerbalDepartInstruction(maneuver)));
+        }
 
         // Set instruction
         maneuver.set_instruction(
             std::move(FormTransitTransferInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(FormVerbalTransitTransferInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(FormVerbalTransitTransferInstruction(maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionTransitInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionTransitInstruction(maneuver)));
+        }
 
         // Set arrive instruction
         maneuver.set_arrive_instruction(
             std::move(FormArriveInstruction(maneuver)));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(
-            std::move(FormVerbalArriveInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal arrive instruction
+          maneuver.set_verbal_arrive_instruction(
+              std::move(FormVerbalArriveInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kPostTransitConnectionDestination: {
@@ -489,15 +548,17 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
             std::move(
                 FormPostTransitConnectionDestinationInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(
-                FormVerbalPostTransitConnectionDestinationInstruction(
-                    maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(
+                  FormVerbalPostTransitConnectionDestinationInstruction(
+                      maneuver)));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            std::move(FormVerbalPostTransitionInstruction(maneuver)));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              std::move(FormVerbalPostTransitionInstruction(maneuver)));
+        }
         break;
       }
       case TripDirections_Maneuver_Type_kContinue:
@@ -505,15 +566,17 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
         // Set instruction
         maneuver.set_instruction(std::move(FormContinueInstruction(maneuver)));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            std::move(FormVerbalAlertContinueInstruction(maneuver)));
+        if (verbal_enabled_) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              std::move(FormVerbalAlertContinueInstruction(maneuver)));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            std::move(
-                FormVerbalContinueInstruction(maneuver,
-                                              directions_options.units())));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              std::move(
+                  FormVerbalContinueInstruction(maneuver,
+                                                directions_options.units())));
+        }
 
         // NOTE: No verbal post transition instruction
         break;
@@ -526,7 +589,9 @@ void NarrativeBuilder::Build(const DirectionsOptions& directions_options,
   }
 
   // Iterate over maneuvers to form verbal multi-cue instructions
-  FormVerbalMultiCue(maneuvers);
+  if (verbal_enabled_) {
+    FormVerbalMultiCue(maneuvers);
+  }
 
 }
 
@@ -576,13 +641,11 @@ std::string NarrativeBuilder::FormStartInstruction(Maneuver& maneuver) {
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.start_subset.phrase(phrase_id).Render(instruction, {
+      {kCardinalDirectionTag, cardinal_direction},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -634,17 +697,14 @@ std::string NarrativeBuilder::FormVerbalStartInstruction(
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kLengthTag,
-      FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                 dictionary_.start_verbal_subset.us_customary_lengths));
+  // Render the determined tagged phrase with the tag values
+  dictionary_.start_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kCardinalDirectionTag, cardinal_direction},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names},
+      {kLengthTag,
+       FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                  dictionary_.start_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -688,15 +748,10 @@ std::string NarrativeBuilder::FormDestinationInstruction(Maneuver& maneuver) {
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Render the determined tagged phrase with the tag values
+  dictionary_.destination_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_direction},
+      {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -745,15 +800,10 @@ std::string NarrativeBuilder::FormVerbalAlertDestinationInstruction(
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_alert_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Render the determined tagged phrase with the tag values
+  dictionary_.destination_verbal_alert_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_direction},
+      {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -802,15 +852,10 @@ std::string NarrativeBuilder::FormVerbalDestinationInstruction(
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Render the determined tagged phrase with the tag values
+  dictionary_.destination_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_direction},
+      {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -835,12 +880,10 @@ std::string NarrativeBuilder::FormBecomesInstruction(Maneuver& maneuver,
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.becomes_subset.phrase(phrase_id).Render(instruction, {
+      {kPreviousStreetNamesTag, prev_street_names},
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -871,12 +914,10 @@ std::string NarrativeBuilder::FormVerbalBecomesInstruction(
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.becomes_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kPreviousStreetNamesTag, prev_street_names},
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -905,12 +946,9 @@ std::string NarrativeBuilder::FormContinueInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.continue_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -940,12 +978,9 @@ std::string NarrativeBuilder::FormVerbalAlertContinueInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_alert_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.continue_verbal_alert_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -976,15 +1011,12 @@ std::string NarrativeBuilder::FormVerbalContinueInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-      FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
-                 dictionary_.continue_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.continue_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kLengthTag,
+       FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
+                  dictionary_.continue_verbal_subset.us_customary_lengths)},
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1043,14 +1075,12 @@ std::string NarrativeBuilder::FormTurnInstruction(Maneuver& maneuver,
     phrase_id = 3;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  subset->phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1127,15 +1157,12 @@ std::string NarrativeBuilder::FormVerbalTurnInstruction(
     phrase_id = 3;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeTwoDirection(
-          maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  subset->phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1178,15 +1205,13 @@ std::string NarrativeBuilder::FormUturnInstruction(Maneuver& maneuver,
     phrase_id += 3;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeTwoDirection(maneuver.type(),
-                               dictionary_.uturn_subset.relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.uturn_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeTwoDirection(maneuver.type(),
+                                dictionary_.uturn_subset.relative_directions)},
+      {kStreetNamesTag, street_names},
+      {kCrossStreetNamesTag, cross_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1289,14 +1314,11 @@ std::string NarrativeBuilder::FormVerbalUturnInstruction(
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.uturn_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_dir},
+      {kStreetNamesTag, street_names},
+      {kCrossStreetNamesTag, cross_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1344,14 +1366,11 @@ std::string NarrativeBuilder::FormVerbalUturnInstruction(
         element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.ramp_straight_subset.phrase(phrase_id).Render(instruction, {
+      {kBranchSignTag, exit_branch_sign},
+      {kTowardSignTag, exit_toward_sign},
+      {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1451,14 +1470,11 @@ std::string NarrativeBuilder::FormVerbalRampStraightInstruction(
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.ramp_straight_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kBranchSignTag, exit_branch_sign},
+      {kTowardSignTag, exit_toward_sign},
+      {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1517,16 +1533,14 @@ std::string NarrativeBuilder::FormRampInstruction(
         element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeTwoDirection(maneuver.type(),
-                               dictionary_.ramp_subset.relative_directions));
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.ramp_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeTwoDirection(maneuver.type(),
+                                dictionary_.ramp_subset.relative_directions)},
+      {kBranchSignTag, exit_branch_sign},
+      {kTowardSignTag, exit_toward_sign},
+      {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1650,14 +1664,12 @@ std::string NarrativeBuilder::FormVerbalRampInstruction(
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.ramp_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_dir},
+      {kBranchSignTag, exit_branch_sign},
+      {kTowardSignTag, exit_toward_sign},
+      {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1717,17 +1729,15 @@ std::string NarrativeBuilder::FormExitInstruction(
         element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeTwoDirection(maneuver.type(),
-                               dictionary_.exit_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.exit_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeTwoDirection(maneuver.type(),
+                                dictionary_.exit_subset.relative_directions)},
+      {kNumberSignTag, exit_number_sign},
+      {kBranchSignTag, exit_branch_sign},
+      {kTowardSignTag, exit_toward_sign},
+      {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1850,15 +1860,13 @@ std::string NarrativeBuilder::FormVerbalExitInstruction(
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.exit_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_dir},
+      {kNumberSignTag, exit_number_sign},
+      {kBranchSignTag, exit_branch_sign},
+      {kTowardSignTag, exit_toward_sign},
+      {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1914,16 +1922,14 @@ std::string NarrativeBuilder::FormKeepInstruction(
         element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeThreeDirection(maneuver.type(),
-                                 dictionary_.keep_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.keep_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeThreeDirection(maneuver.type(),
+                                  dictionary_.keep_subset.relative_directions)},
+      {kNumberSignTag, exit_number_sign},
+      {kStreetNamesTag, street_names},
+      {kTowardSignTag, exit_toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2046,14 +2052,12 @@ std::string NarrativeBuilder::FormVerbalKeepInstruction(
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.keep_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_dir},
+      {kNumberSignTag, exit_number_sign},
+      {kStreetNamesTag, street_names},
+      {kTowardSignTag, exit_toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2097,16 +2101,14 @@ std::string NarrativeBuilder::FormKeepToStayOnInstruction(
         element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-      FormRelativeThreeDirection(maneuver.type(),
-                                 dictionary_.keep_to_stay_on_subset.relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.keep_to_stay_on_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag,
+       FormRelativeThreeDirection(maneuver.type(),
+                                  dictionary_.keep_to_stay_on_subset.relative_directions)},
+      {kStreetNamesTag, street_names},
+      {kNumberSignTag, exit_number_sign},
+      {kTowardSignTag, exit_toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2186,15 +2188,12 @@ std::string NarrativeBuilder::FormVerbalKeepToStayOnInstruction(
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.keep_to_stay_on_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kRelativeDirectionTag, relative_dir},
+      {kStreetNamesTag, street_names},
+      {kNumberSignTag, exit_number_sign},
+      {kTowardSignTag, exit_toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2223,11 +2222,9 @@ std::string NarrativeBuilder::FormMergeInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.merge_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2265,12 +2262,9 @@ std::string NarrativeBuilder::FormVerbalMergeInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.merge_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2299,11 +2293,9 @@ std::string NarrativeBuilder::FormEnterRoundaboutInstruction(Maneuver& maneuver)
         maneuver.roundabout_exit_count()-1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.enter_roundabout_subset.phrase(phrase_id).Render(instruction, {
+      {kOrdinalValueTag, ordinal_value}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2333,11 +2325,9 @@ std::string NarrativeBuilder::FormVerbalAlertEnterRoundaboutInstruction(
         maneuver.roundabout_exit_count()-1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.enter_roundabout_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kOrdinalValueTag, ordinal_value}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2367,11 +2357,9 @@ std::string NarrativeBuilder::FormVerbalEnterRoundaboutInstruction(
         maneuver.roundabout_exit_count()-1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.enter_roundabout_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kOrdinalValueTag, ordinal_value}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2408,12 +2396,10 @@ std::string NarrativeBuilder::FormExitRoundaboutInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.exit_roundabout_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2453,12 +2439,10 @@ std::string NarrativeBuilder::FormVerbalExitRoundaboutInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.exit_roundabout_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2493,12 +2477,10 @@ std::string NarrativeBuilder::FormEnterFerryInstruction(Maneuver& maneuver) {
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.enter_ferry_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names},
+      {kFerryLabelTag, ferry_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2543,12 +2525,10 @@ std::string NarrativeBuilder::FormVerbalEnterFerryInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.enter_ferry_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kStreetNamesTag, street_names},
+      {kFerryLabelTag, ferry_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2605,13 +2585,11 @@ std::string NarrativeBuilder::FormExitFerryInstruction(Maneuver& maneuver) {
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_ferry_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.exit_ferry_subset.phrase(phrase_id).Render(instruction, {
+      {kCardinalDirectionTag, cardinal_direction},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2689,13 +2667,11 @@ std::string NarrativeBuilder::FormVerbalExitFerryInstruction(
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_ferry_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.exit_ferry_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kCardinalDirectionTag, cardinal_direction},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2730,12 +2706,10 @@ std::string NarrativeBuilder::FormTransitConnectionStartInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_connection_start_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop},
+      {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2770,12 +2744,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionStartInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_connection_start_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop},
+      {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2810,12 +2782,10 @@ std::string NarrativeBuilder::FormTransitConnectionTransferInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_connection_transfer_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop},
+      {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2850,12 +2820,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionTransferInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_connection_transfer_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop},
+      {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2890,12 +2858,10 @@ std::string NarrativeBuilder::FormTransitConnectionDestinationInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_destination_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_connection_destination_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop},
+      {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2930,12 +2896,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionDestinationInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_connection_destination_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop},
+      {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2959,13 +2923,12 @@ std::string NarrativeBuilder::FormDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-      get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Render the determined tagged phrase with the tag values
+  dictionary_.depart_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop_name},
+      {kTimeTag,
+       get_localized_time(maneuver.GetTransitDepartureTime(),
+                          dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2988,13 +2951,12 @@ std::string NarrativeBuilder::FormVerbalDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-      get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Render the determined tagged phrase with the tag values
+  dictionary_.depart_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop_name},
+      {kTimeTag,
+       get_localized_time(maneuver.GetTransitDepartureTime(),
+                          dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3017,13 +2979,12 @@ std::string NarrativeBuilder::FormArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-      get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Render the determined tagged phrase with the tag values
+  dictionary_.arrive_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop_name},
+      {kTimeTag,
+       get_localized_time(maneuver.GetTransitArrivalTime(),
+                          dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3046,13 +3007,12 @@ std::string NarrativeBuilder::FormVerbalArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-      get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Render the determined tagged phrase with the tag values
+  dictionary_.arrive_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopTag, transit_stop_name},
+      {kTimeTag,
+       get_localized_time(maneuver.GetTransitArrivalTime(),
+                          dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3079,18 +3039,14 @@ std::string NarrativeBuilder::FormTransitInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(
-      instruction,
-      kTransitNameTag,
-      FormTransitName(maneuver,
-                      dictionary_.transit_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitStopCountTag, std::to_string(stop_count)); //TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitStopCountLabelTag, stop_count_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitNameTag,
+       FormTransitName(maneuver,
+                       dictionary_.transit_subset.empty_transit_name_labels)},
+      {kTransitHeadSignTag, transit_headsign},
+      {kTransitStopCountTag, std::to_string(stop_count)},
+      {kTransitStopCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3113,16 +3069,12 @@ std::string NarrativeBuilder::FormVerbalTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(
-      instruction,
-      kTransitNameTag,
-      FormTransitName(maneuver,
-                      dictionary_.transit_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitNameTag,
+       FormTransitName(maneuver,
+                       dictionary_.transit_verbal_subset.empty_transit_name_labels)},
+      {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3149,19 +3101,14 @@ std::string NarrativeBuilder::FormTransitRemainOnInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(
-      instruction,
-      kTransitNameTag,
-      FormTransitName(
-          maneuver,
-          dictionary_.transit_remain_on_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitStopCountTag, std::to_string(stop_count)); //TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitStopCountLabelTag, stop_count_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_remain_on_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitNameTag,
+       FormTransitName(maneuver,
+                       dictionary_.transit_remain_on_subset.empty_transit_name_labels)},
+      {kTransitHeadSignTag, transit_headsign},
+      {kTransitStopCountTag, std::to_string(stop_count)},
+      {kTransitStopCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3186,17 +3133,12 @@ std::string NarrativeBuilder::FormVerbalTransitRemainOnInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(
-      instruction,
-      kTransitNameTag,
-      FormTransitName(
-          maneuver,
-          dictionary_.transit_remain_on_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_remain_on_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitNameTag,
+       FormTransitName(maneuver,
+                       dictionary_.transit_remain_on_verbal_subset.empty_transit_name_labels)},
+      {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3223,19 +3165,14 @@ std::string NarrativeBuilder::FormTransitTransferInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(
-      instruction,
-      kTransitNameTag,
-      FormTransitName(
-          maneuver,
-          dictionary_.transit_transfer_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitStopCountTag, std::to_string(stop_count)); //TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitStopCountLabelTag, stop_count_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_transfer_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitNameTag,
+       FormTransitName(maneuver,
+                       dictionary_.transit_transfer_subset.empty_transit_name_labels)},
+      {kTransitHeadSignTag, transit_headsign},
+      {kTransitStopCountTag, std::to_string(stop_count)},
+      {kTransitStopCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3260,17 +3197,12 @@ std::string NarrativeBuilder::FormVerbalTransitTransferInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(
-      instruction,
-      kTransitNameTag,
-      FormTransitName(
-          maneuver,
-          dictionary_.transit_transfer_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.transit_transfer_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitNameTag,
+       FormTransitName(maneuver,
+                       dictionary_.transit_transfer_verbal_subset.empty_transit_name_labels)},
+      {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3328,14 +3260,11 @@ std::string NarrativeBuilder::FormPostTransitConnectionDestinationInstruction(
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transit_connection_destination_subset.
-      phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.post_transit_connection_destination_subset.phrase(phrase_id).Render(instruction, {
+      {kCardinalDirectionTag, cardinal_direction},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3395,13 +3324,11 @@ std::string NarrativeBuilder::FormVerbalPostTransitConnectionDestinationInstruct
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transit_connection_destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.post_transit_connection_destination_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kCardinalDirectionTag, cardinal_direction},
+      {kStreetNamesTag, street_names},
+      {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3432,16 +3359,13 @@ std::string NarrativeBuilder::FormVerbalPostTransitionInstruction(
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transition_verbal_subset.phrases.at(
-      std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-      FormLength(
-          maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-          dictionary_.post_transition_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.post_transition_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kLengthTag,
+       FormLength(maneuver,
+                  dictionary_.post_transition_verbal_subset.metric_lengths,
+                  dictionary_.post_transition_verbal_subset.us_customary_lengths)},
+      {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3464,12 +3388,10 @@ std::string NarrativeBuilder::FormVerbalPostTransitionTransitInstruction(
       dictionary_.post_transition_transit_verbal_subset
           .transit_stop_count_labels);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transition_transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitStopCountTag, std::to_string(stop_count)); //TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitStopCountLabelTag, stop_count_label);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.post_transition_transit_verbal_subset.phrase(phrase_id).Render(instruction, {
+      {kTransitStopCountTag, std::to_string(stop_count)},
+      {kTransitStopCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3794,12 +3716,10 @@ std::string NarrativeBuilder::FormVerbalMultiCue(Maneuver* maneuver,
           next_maneuver.verbal_pre_transition_instruction();
 
 
-  // Set instruction to the verbal multi-cue
-  instruction = dictionary_.verbal_multi_cue_subset.phrases.at("0");
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCurrentVerbalCueTag, current_verbal_cue);
-  boost::replace_all(instruction, kNextVerbalCueTag, next_verbal_cue);
+  // Render the determined tagged phrase with the tag values
+  dictionary_.verbal_multi_cue_subset.phrase(0).Render(instruction, {
+      {kCurrentVerbalCueTag, current_verbal_cue},
+      {kNextVerbalCueTag, next_verbal_cue}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1,16 +1,19 @@
 #include "sif/dynamiccost.h"
 #include "baldr/double_bucket_queue.h" // For kInvalidLabel
 
+#include <functional>
+#include <string>
+
 using namespace valhalla::baldr;
 
 namespace {
 
 using namespace valhalla::sif;
 
-// Check for complex restriction
-bool IsRestricted(const EdgeLabel& pred, const std::vector<EdgeLabel>& edge_labels,
-                  const std::vector<ComplexRestriction>& restrictions,
-                  const bool forward) {
+// Check for complex restriction, visiting the restrictions in the tile
+bool IsRestricted(const EdgeLabel& pred, const EdgeLabelStore& edge_labels,
+                  const GraphTile* tile, const GraphId& edgeid,
+                  const uint64_t modes, const bool forward) {
   // Lambda to get the next predecessor EdgeLabel (that is not a transition)
   auto next_predecessor = [&edge_labels](const EdgeLabel* label) {
     // Get the next predecessor - make sure it is valid. Continue to get
@@ -30,11 +33,14 @@ bool IsRestricted(const EdgeLabel& pred, const std::vector<EdgeLabel>& edge_labe
     first_pred = next_predecessor(first_pred);
   }
 
-  // Iterate through the restrictions
-  for (const auto& cr : restrictions) {
+  // Iterate through the restrictions, stop at the first one that applies
+  // or whose via edge Ids do not match the path
+  bool restricted = false;
+  tile->VisitRestrictions(forward, edgeid, modes,
+      [&](const ComplexRestriction& cr) -> bool {
     // Walk the via list, break if the via edge Ids do not match the path
     const EdgeLabel* next_pred = first_pred;
-    for (const auto& via_id : cr.GetVias()) {
+    for (const auto& via_id : cr.vias()) {
       if (via_id != next_pred->edgeid()) {
         return false;
       }
@@ -42,12 +48,31 @@ bool IsRestricted(const EdgeLabel& pred, const std::vector<EdgeLabel>& edge_labe
     }
 
     // Check against the start/end of the complex restriction
-    if (( forward && next_pred->edgeid() == cr.from_id()) ||
-        (!forward && next_pred->edgeid() == cr.to_id())) {
-      return true;
+    restricted = ( forward && next_pred->edgeid() == cr.from_id()) ||
+                 (!forward && next_pred->edgeid() == cr.to_id());
+    return !restricted;
+  });
+  return restricted;
+}
+
+// Hash the keys and values of the options in place, so that neither a copy
+// nor a serialization of them is made for every costing created
+uint64_t HashOptions(const boost::property_tree::ptree& pt, uint64_t seed,
+                     const bool skip_avoid_edges) {
+  auto combine = [&seed](const uint64_t hash) {
+    seed ^= hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+  };
+  std::hash<std::string> hash;
+  combine(hash(pt.data()));
+  for (const auto& child : pt) {
+    if (skip_avoid_edges && child.first == "avoid_edges") {
+      continue;
     }
+    combine(hash(child.first));
+    // Nest the children so their position in the tree is part of the hash
+    combine(HashOptions(child.second, child.second.size(), false));
   }
-  return false;
+  return seed;
 }
 
 }
@@ -75,6 +100,11 @@ DynamicCost::DynamicCost(const boost::property_tree::ptree& pt,
       user_avoid_edges_.insert(GraphId(edgeid.second.get_value<uint64_t>()));
     }
   }
+
+  // Hash the options along with the mode so that costings sharing their
+  // edge costs can be recognized. Avoid edges are left out, they do not
+  // change the cost of an edge and can be a long list.
+  options_hash_ = HashOptions(pt, static_cast<uint64_t>(mode), true);
 }
 
 DynamicCost::~DynamicCost() {
@@ -122,7 +152,7 @@ Cost DynamicCost::TransitionCostReverse(
  */
 bool DynamicCost::Restricted(const DirectedEdge* edge,
                              const EdgeLabel& pred,
-                             const std::vector<EdgeLabel>& edgelabels,
+                             const EdgeLabelStore& edgelabels,
                              const baldr::GraphTile*& tile,
                              const baldr::GraphId& edgeid,
                              const bool forward) const {
@@ -132,12 +162,8 @@ bool DynamicCost::Restricted(const DirectedEdge* edge,
       edge->end_restriction()   & access_mode() :
       edge->start_restriction() & access_mode();
   if (has_restriction) {
-    // Get complex restrictions. Return false if no restrictions are found
-    auto restrictions = tile->GetRestrictions(forward, edgeid, access_mode());
-    if (restrictions.size() == 0) {
-      return false;
-    }
-    return IsRestricted(pred, edgelabels, restrictions, forward);
+    // Check the complex restrictions in place, false if none are found
+    return IsRestricted(pred, edgelabels, tile, edgeid, access_mode(), forward);
   } else {
     return false;
   }
@@ -0,0 +1,80 @@
+#include "sif/edgecostcache.h"
+
+#include <typeinfo>
+
+using namespace valhalla::baldr;
+
+namespace valhalla {
+namespace sif {
+
+constexpr uint8_t TileEdgeCosts::kForwardAccess;
+constexpr uint8_t TileEdgeCosts::kReverseAccess;
+constexpr uint8_t TileEdgeCosts::kCostCached;
+
+// Compute the costs of the edges the costing can use in either direction.
+// Edges without access are left to the costing, some costings index
+// tables by values such edges are not guaranteed to have in range.
+TileEdgeCosts::TileEdgeCosts(const DynamicCost& costing, const GraphTile& tile)
+    : costs_(tile.header()->directededgecount()),
+      flags_(tile.header()->directededgecount(), 0) {
+  const uint32_t access_mode = costing.access_mode();
+  for (uint32_t i = 0; i < flags_.size(); i++) {
+    const DirectedEdge* edge = tile.directededge(i);
+    uint8_t flags = 0;
+    if (edge->forwardaccess() & access_mode) {
+      flags |= kForwardAccess;
+    }
+    if (edge->reverseaccess() & access_mode) {
+      flags |= kReverseAccess;
+    }
+    if (flags != 0) {
+      costs_[i] = costing.EdgeCost(edge);
+      flags |= kCostCached;
+    }
+    flags_[i] = flags;
+  }
+}
+
+// Constructor
+EdgeCostCache::EdgeCostCache()
+    : costing_(nullptr),
+      key_(0),
+      last_tile_(nullptr),
+      last_costs_(nullptr) {
+}
+
+// Key the costs by the costing type and options, costings of different
+// types can be created from the same options.
+void EdgeCostCache::Reset(const DynamicCost& costing) {
+  costing_ = &costing;
+  const uint64_t type_hash = typeid(costing).hash_code();
+  const uint64_t options_hash = costing.options_hash();
+  key_ = type_hash ^ (options_hash + 0x9e3779b97f4a7c15ULL +
+                      (type_hash << 6) + (type_hash >> 2));
+  tiles_.clear();
+  last_tile_ = nullptr;
+  last_costs_ = nullptr;
+}
+
+// Find the costs this search already used, else the ones attached to the
+// tile by an earlier search, else compute and attach them
+const TileEdgeCosts* EdgeCostCache::Load(const GraphTile* tile) {
+  const GraphId tile_id = tile->id();
+  auto found = tiles_.find(tile_id);
+  if (found == tiles_.end()) {
+    auto costs = std::static_pointer_cast<const TileEdgeCosts>(
+                        tile->GetAttachment(key_));
+    if (!costs) {
+      costs = std::static_pointer_cast<const TileEdgeCosts>(
+                  tile->Attach(key_, std::make_shared<const TileEdgeCosts>(
+                                                    *costing_, *tile)));
+    }
+    found = tiles_.emplace(tile_id, costs).first;
+  }
+  last_tile_ = tile;
+  last_costs_ = found->second.get();
+  return last_costs_;
+}
+
+}
+}
@@ -0,0 +1,50 @@
+#include "sif/edgelabelstore.h"
+
+namespace {
+
+using namespace valhalla::sif;
+
+// Free label blocks of a thread
+struct block_pool_t {
+  std::vector<EdgeLabel*> blocks;
+
+  ~block_pool_t() {
+    for (auto* block : blocks) {
+      ::operator delete(block);
+    }
+  }
+};
+
+thread_local block_pool_t block_pool;
+
+}
+
+namespace valhalla {
+namespace sif {
+
+// Return the blocks to the pool, free the ones the pool has no room for
+void EdgeLabelStore::clear() {
+  for (auto* block : blocks_) {
+    if (block_pool.blocks.size() < kMaxPooledEdgeLabelBlocks) {
+      block_pool.blocks.push_back(block);
+    } else {
+      ::operator delete(block);
+    }
+  }
+  blocks_.clear();
+  size_ = 0;
+}
+
+// Reuse a pooled block if there is one
+EdgeLabel* EdgeLabelStore::AcquireBlock() {
+  if (!block_pool.blocks.empty()) {
+    EdgeLabel* block = block_pool.blocks.back();
+    block_pool.blocks.pop_back();
+    return block;
+  }
+  return static_cast<EdgeLabel*>(
+      ::operator new(kEdgeLabelBlockSize * sizeof(EdgeLabel)));
+}
+
+}
+}
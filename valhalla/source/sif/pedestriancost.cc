@@ -69,219 +69,6 @@ constexpr float kMaxPedestrianSpeed = 25.0f;
 constexpr uint32_t kCrossingCosts[] = { 0, 0, 1, 1, 2, 3, 5, 15 };
 }
 
-/**
- * Derived class providing dynamic edge costing for pedestrian routes.
- */
-class PedestrianCost : public DynamicCost {
- public:
-  /**
-   * Constructor. Configuration / options for pedestrian costing are provided
-   * via a property tree (JSON).
-   * @param  pt  Property tree with configuration/options.
-   */
-  PedestrianCost(const boost::property_tree::ptree& pt);
-
-  virtual ~PedestrianCost();
-
-  /**
-   * This method overrides the max_distance with the max_distance_mm per segment
-   * distance. An example is a pure walking route may have a max distance of
-   * 10000 meters (10km) but for a multi-modal route a lower limit of 5000
-   * meters per segment (e.g. from origin to a transit stop or from the last
-   * transit stop to the destination).
-   */
-  virtual void UseMaxMultiModalDistance();
-
-  /**
-   * Returns the maximum transfer distance between stops that you are willing
-   * to travel for this mode.  In this case, it is the max walking
-   * distance you are willing to walk between transfers.
-   */
-  virtual uint32_t GetMaxTransferDistanceMM();
-
-  /**
-   * This method overrides the weight for this mode.  The higher the value
-   * the more the mode is favored.
-   */
-  virtual float GetModeWeight();
-
-  /**
-   * Get the access mode used by this costing method.
-   * @return  Returns access mode.
-   */
-  uint32_t access_mode() const;
-
-  /**
-   * Checks if access is allowed for the provided directed edge.
-   * This is generally based on mode of travel and the access modes
-   * allowed on the edge. However, it can be extended to exclude access
-   * based on other parameters.
-   * @param  edge     Pointer to a directed edge.
-   * @param  pred     Predecessor edge information.
-   * @param  tile     current tile
-   * @param  edgeid   edgeid that we care about
-   * @return  Returns true if access is allowed, false if not.
-   */
-  virtual bool Allowed(const baldr::DirectedEdge* edge,
-                       const EdgeLabel& pred,
-                       const baldr::GraphTile*& tile,
-                       const baldr::GraphId& edgeid) const;
-
-  /**
-   * Checks if access is allowed for an edge on the reverse path
-   * (from destination towards origin). Both opposing edges are
-   * provided.
-   * @param  edge           Pointer to a directed edge.
-   * @param  pred           Predecessor edge information.
-   * @param  opp_edge       Pointer to the opposing directed edge.
-   * @param  tile           Tile for the opposing edge (for looking
-   *                        up restrictions).
-   * @param  opp_edgeid     Opposing edge Id
-   * @return  Returns true if access is allowed, false if not.
-   */
-  virtual bool AllowedReverse(const baldr::DirectedEdge* edge,
-                 const EdgeLabel& pred,
-                 const baldr::DirectedEdge* opp_edge,
-                 const baldr::GraphTile*& tile,
-                 const baldr::GraphId& opp_edgeid) const;
-
-  /**
-   * Checks if access is allowed for the provided node. Node access can
-   * be restricted if bollards or gates are present.
-   * @param  edge  Pointer to node information.
-   * @return  Returns true if access is allowed, false if not.
-   */
-  virtual bool Allowed(const baldr::NodeInfo* node) const;
-
-  /**
-   * Get the cost to traverse the specified directed edge. Cost includes
-   * the time (seconds) to traverse the edge.
-   * @param   edge  Pointer to a directed edge.
-   * @return  Returns the cost and time (seconds)
-   */
-  virtual Cost EdgeCost(const baldr::DirectedEdge* edge) const;
-
-  /**
-   * Returns the cost to make the transition from the predecessor edge.
-   * Defaults to 0. Costing models that wish to include edge transition
-   * costs (i.e., intersection/turn costs) must override this method.
-   * @param  edge  Directed edge (the to edge)
-   * @param  node  Node (intersection) where transition occurs.
-   * @param  pred  Predecessor edge information.
-   * @return  Returns the cost and time (seconds)
-   */
-  virtual Cost TransitionCost(const baldr::DirectedEdge* edge,
-                              const baldr::NodeInfo* node,
-                              const EdgeLabel& pred) const;
-
-  /**
-   * Returns the cost to make the transition from the predecessor edge
-   * when using a reverse search (from destination towards the origin).
-   * Defaults to 0. Costing models that wish to include edge transition
-   * costs (i.e., intersection/turn costs) must override this method.
-   * @param  idx   Directed edge local index
-   * @param  node  Node (intersection) where transition occurs.
-   * @param  pred  the opposing current edge in the reverse tree.
-   * @param  edge  the opposing predecessor in the reverse tree
-   * @return  Returns the cost and time (seconds)
-   */
-  virtual Cost TransitionCostReverse(const uint32_t idx,
-                                     const baldr::NodeInfo* node,
-                                     const baldr::DirectedEdge* pred,
-                                     const baldr::DirectedEdge* edge) const;
-
-  /**
-   * Get the cost factor for A* heuristics. This factor is multiplied
-   * with the distance to the destination to produce an estimate of the
-   * minimum cost to the destination. The A* heuristic must underestimate the
-   * cost to the destination. So a time based estimate based on speed should
-   * assume the maximum speed is used to the destination such that the time
-   * estimate is less than the least possible time along roads.
-   */
-  virtual float AStarCostFactor() const;
-
-  /**
-   * Get the current travel type.
-   * @return  Returns the current travel type.
-   */
-  virtual uint8_t travel_type() const;
-
-  /**
-   * Returns a function/functor to be used in location searching which will
-   * exclude and allow ranking results from the search by looking at each
-   * edges attribution and suitability for use as a location by the travel
-   * mode used by the costing method. Function/functor is also used to filter
-   * edges not usable / inaccessible by pedestrians.
-   */
-   virtual const EdgeFilter GetEdgeFilter() const {
-     // Throw back a lambda that checks the access for this type of costing
-     auto access_mask = access_mask_;
-     return [access_mask](const baldr::DirectedEdge* edge) {
-       return !(edge->trans_up() || edge->trans_down() || edge->is_shortcut() ||
-           edge->use() >= Use::kRail ||
-          !(edge->forwardaccess() & access_mask));
-     };
-   }
-
-   virtual const NodeFilter GetNodeFilter() const {
-     //throw back a lambda that checks the access for this type of costing
-     auto access_mask = access_mask_;
-     return [access_mask](const baldr::NodeInfo* node){
-       return !(node->access() & access_mask);
-     };
-   }
-
-  /**
-   * Returns a function/functor to be used in location searching which will
-   * exclude results from the search by looking at each node's attribution
-   * @return Function/functor to be used in filtering out nodes
-   */
-
- private:
-  // Type: foot (default), wheelchair, etc.
-  PedestrianType type_;
-
-  uint32_t access_mask_;
-
-  // Maximum pedestrian distance.
-  uint32_t max_distance_;
-
-  // This is the weight for this mode.  The higher the value the more the
-  // mode is favored.
-  float mode_weight_;
-
-  // Maximum pedestrian distance in meters for multimodal routes.
-  // Maximum distance at the beginning or end of a multimodal route
-  // that you are willing to travel for this mode.  In this case,
-  // it is the max walking distance.
-  uint32_t transit_start_end_max_distance_;
-
-  // Maximum transfer, distance in meters for multimodal routes.
-  // Maximum transfer distance between stops that you are willing
-  // to travel for this mode.  In this case, it is the max distance
-  // you are willing to walk between transfers.
-  uint32_t transit_transfer_max_distance_;
-
-  // Minimal surface type usable by the pedestrian type
-  Surface minimal_allowed_surface_;
-
-  uint32_t max_grade_;    // Maximum grade (percent).
-  float speed_;           // Pedestrian speed.
-  float speedfactor_;     // Speed factor for costing. Based on speed.
-  float walkway_factor_;  // Factor for favoring walkways and paths.
-  float sidewalk_factor_; // Factor for favoring sidewalks.
-  float alley_factor_;    // Avoid alleys factor.
-  float driveway_factor_; // Avoid driveways factor.
-  float step_penalty_;    // Penalty applied to steps/stairs (seconds).
-  float gate_penalty_;    // Penalty (seconds) to go through gate
-  float maneuver_penalty_;          // Penalty (seconds) when inconsistent names
-  float country_crossing_cost_;     // Cost (seconds) to go through toll booth
-  float country_crossing_penalty_;  // Penalty (seconds) to go across a country border
-  float ferry_cost_;                // Cost (seconds) to exit a ferry
-  float ferry_penalty_;             // Penalty (seconds) to enter a ferry
-  float ferry_weight_;              // Weighting to apply to ferry edges
-};
-
 // Constructor. Parse pedestrian options from property tree. If option is
 // not present, set the default.
 PedestrianCost::PedestrianCost(const boost::property_tree::ptree& pt)
@@ -407,63 +194,6 @@ float PedestrianCost::GetModeWeight() {
   return mode_weight_;
 }
 
-// Get the access mode used by this costing method.
-uint32_t PedestrianCost::access_mode() const {
-  return access_mask_;
-}
-
-// Check if access is allowed on the specified edge. Disallow if no
-// access for this pedestrian type, if surface type exceeds (worse than)
-// the minimum allowed surface type, or if max grade is exceeded.
-// Disallow edges where max. distance will be exceeded.
-bool PedestrianCost::Allowed(const baldr::DirectedEdge* edge,
-                             const EdgeLabel& pred,
-                             const baldr::GraphTile*& tile,
-                             const baldr::GraphId& edgeid) const {
-  // TODO - obtain and check the access restrictions.
-
-  if (!(edge->forwardaccess() & access_mask_) ||
-       (edge->surface() > minimal_allowed_surface_) ||
-        edge->is_shortcut() || IsUserAvoidEdge(edgeid) ||
- //      (edge->max_up_slope() > max_grade_ || edge->max_down_slope() > max_grade_) ||
-      ((pred.path_distance() + edge->length()) > max_distance_)) {
-    return false;
-  }
-
-  // Disallow transit connections (except when set for multi-modal routes)
-  if (!allow_transit_connections_ && edge->use() == Use::kTransitConnection) {
-    return false;
-  }
-  return true;
-}
-
-// Checks if access is allowed for an edge on the reverse path (from
-// destination towards origin). Both opposing edges are provided.
-bool PedestrianCost::AllowedReverse(const baldr::DirectedEdge* edge,
-               const EdgeLabel& pred,
-               const baldr::DirectedEdge* opp_edge,
-               const baldr::GraphTile*& tile,
-               const baldr::GraphId& opp_edgeid) const {
-  // TODO - obtain and check the access restrictions.
-
-  // Do not check max walking distance and assume we are not allowing
-  // transit connections. Assume this method is never used in
-  // multimodal routes).
-  if (!(opp_edge->forwardaccess() & access_mask_) ||
-       (opp_edge->surface() > minimal_allowed_surface_) ||
-        opp_edge->is_shortcut() || IsUserAvoidEdge(opp_edgeid) ||
- //      (opp_edge->max_up_slope() > max_grade_ || opp_edge->max_down_slope() > max_grade_) ||
-        opp_edge->use() == Use::kTransitConnection) {
-    return false;
-  }
-  return true;
-}
-
-// Check if access is allowed at the specified node.
-bool PedestrianCost::Allowed(const baldr::NodeInfo* node) const {
-  return (node->access() & access_mask_);
-}
-
 // Returns the cost to traverse the edge and an estimate of the actual time
 // (in seconds) to traverse the edge.
 Cost PedestrianCost::EdgeCost(const baldr::DirectedEdge* edge) const {
@@ -14,8 +14,6 @@ using namespace valhalla::sif;
 namespace valhalla {
 namespace thor {
 
-constexpr uint64_t kInitialEdgeLabelCount = 500000;
-
 // Default constructor
 AStarPathAlgorithm::AStarPathAlgorithm()
     : PathAlgorithm(), mode_(TravelMode::kDrive),
@@ -36,8 +34,10 @@ void AStarPathAlgorithm::Clear() {
   edgelabels_.clear();
   destinations_.clear();
 
-  // Clear elements from the adjacency list
-  adjacencylist_.reset();
+  // Clear elements from the adjacency list (keeps its memory for reuse)
+  if (adjacencylist_) {
+    adjacencylist_->clear();
+  }
 
   // Clear the edge status flags
   edgestatus_.reset();
@@ -55,20 +55,15 @@ void AStarPathAlgorithm::Init(const PointLL& origll, const PointLL& destll,
   // Get the initial cost based on A* heuristic from origin
   float mincost = astarheuristic_.Get(origll);
 
-  // Reserve size for edge labels - do this here rather than in constructor so
-  // to limit how much extra memory is used for persistent objects
-  edgelabels_.reserve(kInitialEdgeLabelCount);
-
-  // Set up lambda to get sort costs
-  const auto edgecost = [this](const uint32_t label) {
-    return edgelabels_[label].sortcost();
-  };
-
   // Construct adjacency list, edge status, and done set
   // Set bucket size and cost range based on DynamicCost.
   uint32_t bucketsize = costing->UnitSize();
   float range = kBucketCount * bucketsize;
-  adjacencylist_.reset(new DoubleBucketQueue(mincost, range, bucketsize, edgecost));
+  if (adjacencylist_) {
+    adjacencylist_->reuse(mincost, range, bucketsize);
+  } else {
+    adjacencylist_.reset(new DoubleBucketQueue(mincost, range, bucketsize));
+  }
   edgestatus_.reset(new EdgeStatus());
 
   // Get hierarchy limits from the costing. Get a copy since we increment
@@ -130,6 +125,33 @@ std::vector<PathInfo> AStarPathAlgorithm::GetBestPath(PathLocation& origin,
   // Update hierarchy limits
   ModifyHierarchyLimits(mindist, density);
 
+  // Run the expansion on the concrete costing type when possible so the
+  // costing calls are not virtual
+  switch (GetDirectCostType(*costing)) {
+    case DirectCostType::kAuto:
+      return Expand(DirectCost<AutoCost>(*costing, edge_cost_cache()),
+                    origin, destination, graphreader, mindist);
+    case DirectCostType::kBicycle:
+      return Expand(DirectCost<BicycleCost>(*costing, edge_cost_cache()),
+                    origin, destination, graphreader, mindist);
+    case DirectCostType::kPedestrian:
+      return Expand(DirectCost<PedestrianCost>(*costing, edge_cost_cache()),
+                    origin, destination, graphreader, mindist);
+    case DirectCostType::kTruck:
+      return Expand(DirectCost<TruckCost>(*costing, edge_cost_cache()),
+                    origin, destination, graphreader, mindist);
+    default:
+      return Expand(DirectCost<DynamicCost>(*costing, edge_cost_cache()),
+                    origin, destination, graphreader, mindist);
+  }
+}
+
+// Expand from the seeded adjacency list until a destination edge is settled
+template <class costing_t>
+std::vector<PathInfo> AStarPathAlgorithm::Expand(
+             const DirectCost<costing_t>& costing, const PathLocation& origin,
+             const PathLocation& destination, GraphReader& graphreader,
+             float mindist) {
   // Find shortest path
   uint32_t nc = 0;       // Count of iterations with no convergence
                          // towards destination
@@ -193,7 +215,7 @@ std::vector<PathInfo> AStarPathAlgorithm::GetBestPath(PathLocation& origin,
 
     // Check access at the node
     const NodeInfo* nodeinfo = tile->node(node);
-    if (!costing->Allowed(nodeinfo)) {
+    if (!costing.Allowed(nodeinfo)) {
       continue;
     }
 
@@ -235,7 +257,7 @@ std::vector<PathInfo> AStarPathAlgorithm::GetBestPath(PathLocation& origin,
         continue;
       }
 
-      if (!costing->Allowed(directededge, pred, tile, edgeid)) {
+      if (!costing.Allowed(directededge, pred, tile, edgeid)) {
         continue;
       }
 
@@ -254,7 +276,7 @@ std::vector<PathInfo> AStarPathAlgorithm::GetBestPath(PathLocation& origin,
       }
 
       // Check for complex restriction
-      if (costing->Restricted(directededge, pred, edgelabels_, tile,
+      if (costing.Restricted(directededge, pred, edgelabels_, tile,
                                edgeid, true)) {
         continue;
       }
@@ -263,8 +285,8 @@ std::vector<PathInfo> AStarPathAlgorithm::GetBestPath(PathLocation& origin,
       shortcuts |= directededge->shortcut();
 
       // Compute the cost to the end of this edge
-      Cost newcost = pred.cost() + costing->EdgeCost(directededge) +
-			     costing->TransitionCost(directededge, nodeinfo, pred);
+      Cost newcost = pred.cost() + costing.EdgeCost(directededge, tile) +
+			     costing.TransitionCost(directededge, nodeinfo, pred);
 
       // If this edge is a destination, subtract the partial/remainder cost
       // (cost from the dest. location to the end of the edge).
@@ -325,7 +347,7 @@ void AStarPathAlgorithm::CheckIfLowerCostPath(const uint32_t idx,
     float oldsortcost = edgelabels_[idx].sortcost();
     float newsortcost = oldsortcost - dc;
     edgelabels_[idx].Update(predindex, newcost, newsortcost);
-    adjacencylist_->decrease(idx, newsortcost, oldsortcost);
+    adjacencylist_->decrease(idx, newsortcost);
   }
 }
 
@@ -463,6 +485,7 @@ std::vector<PathInfo> AStarPathAlgorithm::FormPath(const uint32_t dest) {
   // Metrics to track
   LOG_DEBUG("path_cost::" + std::to_string(edgelabels_[dest].cost().cost));
   LOG_DEBUG("path_iterations::" + std::to_string(edgelabels_.size()));
+  LOG_DEBUG("edgelabel_bytes::" + std::to_string(edgelabels_.MemoryUse()));
 
   // Work backwards from the destination
   std::vector<PathInfo> path;
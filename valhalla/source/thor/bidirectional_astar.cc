@@ -22,8 +22,6 @@ int GetThreshold(const TravelMode mode, const int n) {
 namespace valhalla {
 namespace thor {
 
-constexpr uint64_t kInitialEdgeLabelCountBD = 1000000;
-
 // Default constructor
 BidirectionalAStar::BidirectionalAStar(): PathAlgorithm() {
   threshold_ = 0;
@@ -45,8 +43,12 @@ BidirectionalAStar::~BidirectionalAStar() {
 void BidirectionalAStar::Clear() {
   edgelabels_forward_.clear();
   edgelabels_reverse_.clear();
-  adjacencylist_forward_.reset();
-  adjacencylist_reverse_.reset();
+  if (adjacencylist_forward_) {
+    adjacencylist_forward_->clear();
+  }
+  if (adjacencylist_reverse_) {
+    adjacencylist_reverse_->clear();
+  }
   edgestatus_forward_.reset();
   edgestatus_reverse_.reset();
 }
@@ -59,31 +61,24 @@ void BidirectionalAStar::Init(const PointLL& origll, const PointLL& destll) {
   astarheuristic_forward_.Init(destll, factor);
   astarheuristic_reverse_.Init(origll, factor);
 
-  // Reserve size for edge labels - do this here rather than in constructor so
-  // to limit how much extra memory is used for persistent objects
-  edgelabels_forward_.reserve(kInitialEdgeLabelCountBD);
-  edgelabels_reverse_.reserve(kInitialEdgeLabelCountBD);
-
-  // Set up lambdas to get sort costs
-  const auto forward_edgecost = [this](const uint32_t label) {
-    return edgelabels_forward_[label].sortcost();
-  };
-  const auto reverse_edgecost = [this](const uint32_t label) {
-    return edgelabels_reverse_[label].sortcost();
-  };
-
   // Construct adjacency list, edge status, and done set
   // Set bucket size and cost range based on DynamicCost.
   uint32_t bucketsize = costing_->UnitSize();
   float range = kBucketCount * bucketsize;
   float mincost = astarheuristic_forward_.Get(origll);
-  adjacencylist_forward_.reset(new DoubleBucketQueue(mincost, range, bucketsize,
-                                                 forward_edgecost));
+  if (adjacencylist_forward_) {
+    adjacencylist_forward_->reuse(mincost, range, bucketsize);
+  } else {
+    adjacencylist_forward_.reset(new DoubleBucketQueue(mincost, range, bucketsize));
+  }
   edgestatus_forward_.reset(new EdgeStatus());
 
   mincost = astarheuristic_reverse_.Get(destll);
-  adjacencylist_reverse_.reset(new DoubleBucketQueue(mincost, range, bucketsize,
-                                                 reverse_edgecost));
+  if (adjacencylist_reverse_) {
+    adjacencylist_reverse_->reuse(mincost, range, bucketsize);
+  } else {
+    adjacencylist_reverse_.reset(new DoubleBucketQueue(mincost, range, bucketsize));
+  }
   edgestatus_reverse_.reset(new EdgeStatus());
 
   // Initialize best connection with max cost
@@ -99,8 +94,47 @@ void BidirectionalAStar::Init(const PointLL& origll, const PointLL& destll) {
   hierarchy_limits_reverse_ = costing_->GetHierarchyLimits();
 }
 
+// Set the landmark targets of the A* heuristics
+void BidirectionalAStar::SetLandmarks(GraphReader& graphreader,
+                                      const PathLocation& origin,
+                                      const PathLocation& dest) {
+  if (!landmarks_ || !landmarks_->Supports(access_mode_)) {
+    return;
+  }
+
+  // A route along a single edge never reaches the nodes, keep the straight
+  // line distance for it
+  std::vector<GraphId> origin_nodes;
+  for (const auto& edge : origin.edges) {
+    for (const auto& dest_edge : dest.edges) {
+      if (edge.id == dest_edge.id) {
+        return;
+      }
+    }
+    const DirectedEdge* directededge = graphreader.GetGraphTile(edge.id)->
+        directededge(edge.id);
+    origin_nodes.push_back(directededge->endnode());
+  }
+  std::vector<GraphId> dest_nodes;
+  for (const auto& edge : dest.edges) {
+    const DirectedEdge* opp_edge = graphreader.GetOpposingEdge(edge.id);
+    if (opp_edge == nullptr) {
+      // A start node is unknown, nothing bounds the distance to it
+      dest_nodes.clear();
+      break;
+    }
+    dest_nodes.push_back(opp_edge->endnode());
+  }
+  if (!origin_nodes.empty() && !dest_nodes.empty()) {
+    astarheuristic_forward_.SetLandmarks(landmarks_.get(), dest_nodes, true);
+    astarheuristic_reverse_.SetLandmarks(landmarks_.get(), origin_nodes, false);
+  }
+}
+
 // Expand from a node in the forward direction
-void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
+template <class costing_t>
+void BidirectionalAStar::ExpandForward(const DirectCost<costing_t>& costing,
+       GraphReader& graphreader,
        const GraphTile* tile, const GraphId& node, const NodeInfo* nodeinfo,
        EdgeLabel& pred, const uint32_t pred_idx, const bool from_transition) {
   // Expand from end node in forward direction.
@@ -126,7 +160,7 @@ void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
       GraphId node = directededge->endnode();
       const GraphTile* endtile = graphreader.GetGraphTile(node);
       if (endtile != nullptr) {
-        ExpandForward(graphreader, endtile, node, endtile->node(node),
+        ExpandForward(costing, graphreader, endtile, node, endtile->node(node),
                       pred, pred_idx, true);
       }
       continue;
@@ -134,7 +168,7 @@ void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
 
     // Skip if no access is allowed to this edge (based on costing method)
     // or if this is a superseded edge that match the shortcut mask.
-    if (!costing_->Allowed(directededge, pred, tile, edgeid) ||
+    if (!costing.Allowed(directededge, pred, tile, edgeid) ||
         (shortcuts & directededge->superseded())) {
       continue;
     }
@@ -154,8 +188,8 @@ void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
         hierarchy_limits_reverse_[edgeid.level()+1].StopExpanding()) {
       shortcuts |= directededge->shortcut();
     }
-    Cost tc = costing_->TransitionCost(directededge, nodeinfo, pred);
-    Cost newcost = pred.cost() + tc + costing_->EdgeCost(directededge);
+    Cost tc = costing.TransitionCost(directededge, nodeinfo, pred);
+    Cost newcost = pred.cost() + tc + costing.EdgeCost(directededge, tile);
 
     // Check if edge is temporarily labeled and this path has less cost. If
     // less cost the predecessor is updated and the sort cost is decremented
@@ -166,7 +200,7 @@ void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
     }
 
     // Check for complex restriction
-    if (costing_->Restricted(directededge, pred, edgelabels_forward_, tile,
+    if (costing.Restricted(directededge, pred, edgelabels_forward_, tile,
                              edgeid, true)) {
       continue;
     }
@@ -183,12 +217,13 @@ void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
     // end node of the directed edge.
     float dist = 0.0f;
     float sortcost = newcost.cost + astarheuristic_forward_.Get(
-          t2->node(directededge->endnode())->latlng(), dist);
+          t2->node(directededge->endnode())->latlng(),
+          directededge->endnode(), dist);
 
     // Add edge label, add to the adjacency list and set edge status
     uint32_t idx = edgelabels_forward_.size();
     adjacencylist_forward_->add(idx, sortcost);
-    edgestatus_forward_->Set(edgeid, EdgeSet::kTemporary, idx);
+    edgestatus_forward_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
     edgelabels_forward_.emplace_back(pred_idx, edgeid, oppedge, directededge,
                   newcost, sortcost, dist, mode_, tc,
                   (pred.not_thru_pruning() || !directededge->not_thru()));
@@ -196,7 +231,9 @@ void BidirectionalAStar::ExpandForward(GraphReader& graphreader,
 }
 
 // Expand from a node in reverse direction.
-void BidirectionalAStar::ExpandReverse(GraphReader& graphreader,
+template <class costing_t>
+void BidirectionalAStar::ExpandReverse(const DirectCost<costing_t>& costing,
+         GraphReader& graphreader,
          const GraphTile* tile, const GraphId& node, const NodeInfo* nodeinfo,
          EdgeLabel& pred, const uint32_t pred_idx,
          const DirectedEdge* opp_pred_edge, const bool from_transition) {
@@ -223,7 +260,7 @@ void BidirectionalAStar::ExpandReverse(GraphReader& graphreader,
       GraphId node = directededge->endnode();
       const GraphTile* endtile = graphreader.GetGraphTile(node);
       if (endtile != nullptr) {
-        ExpandReverse(graphreader, endtile, node, endtile->node(node),
+        ExpandReverse(costing, graphreader, endtile, node, endtile->node(node),
                       pred, pred_idx, opp_pred_edge, true);
       }
       continue;
@@ -253,13 +290,13 @@ void BidirectionalAStar::ExpandReverse(GraphReader& graphreader,
 
     // Get opposing directed edge and check if allowed.
     const DirectedEdge* opp_edge = t2->directededge(oppedge);
-    if (!costing_->AllowedReverse(directededge, pred, opp_edge,
+    if (!costing.AllowedReverse(directededge, pred, opp_edge,
                               t2, oppedge)) {
       continue;
     }
 
     // Check for complex restriction
-    if (costing_->Restricted(directededge, pred, edgelabels_reverse_, tile,
+    if (costing.Restricted(directededge, pred, edgelabels_reverse_, tile,
                              edgeid, false)) {
       continue;
     }
@@ -273,9 +310,9 @@ void BidirectionalAStar::ExpandReverse(GraphReader& graphreader,
         hierarchy_limits_reverse_[edgeid.level()+1].StopExpanding()) {
       shortcuts |= directededge->shortcut();
     }
-    Cost tc = costing_->TransitionCostReverse(directededge->localedgeidx(),
+    Cost tc = costing.TransitionCostReverse(directededge->localedgeidx(),
                              nodeinfo, opp_edge, opp_pred_edge);
-    Cost newcost = pred.cost() + costing_->EdgeCost(opp_edge);
+    Cost newcost = pred.cost() + costing.EdgeCost(opp_edge, t2);
     newcost.cost += tc.cost;
 
     // Check if edge is temporarily labeled and this path has less cost. If
@@ -291,12 +328,13 @@ void BidirectionalAStar::ExpandReverse(GraphReader& graphreader,
     // end node of the directed edge.
     float dist = 0.0f;
     float sortcost = newcost.cost + astarheuristic_reverse_.Get(
-       t2->node(directededge->endnode())->latlng(), dist);
+       t2->node(directededge->endnode())->latlng(),
+       directededge->endnode(), dist);
 
     // Add edge label, add to the adjacency list and set edge status
     uint32_t idx = edgelabels_reverse_.size();
     adjacencylist_reverse_->add(idx, sortcost);
-    edgestatus_reverse_->Set(edgeid, EdgeSet::kTemporary, idx);
+    edgestatus_reverse_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
     edgelabels_reverse_.emplace_back(pred_idx, edgeid, oppedge,
                  directededge, newcost, sortcost, dist, mode_, tc,
                  (pred.not_thru_pruning() || !directededge->not_thru()));
@@ -321,6 +359,7 @@ std::vector<PathInfo> BidirectionalAStar::GetBestPath(PathLocation& origin,
 
   // Initialize - create adjacency list, edgestatus support, A*, etc.
   Init(origin.edges.front().projected, destination.edges.front().projected);
+  SetLandmarks(graphreader, origin, destination);
 
   // Set origin and destination locations - seeds the adj. lists
   // Note: because we can correlate to more than one place for a given
@@ -330,6 +369,26 @@ std::vector<PathInfo> BidirectionalAStar::GetBestPath(PathLocation& origin,
   SetOrigin(graphreader, origin);
   SetDestination(graphreader, destination);
 
+  // Run the search on the concrete costing type when possible so the
+  // costing calls in the expansion are not virtual
+  switch (GetDirectCostType(*costing_)) {
+    case DirectCostType::kAuto:
+      return Expand(DirectCost<AutoCost>(*costing_, edge_cost_cache()), graphreader);
+    case DirectCostType::kBicycle:
+      return Expand(DirectCost<BicycleCost>(*costing_, edge_cost_cache()), graphreader);
+    case DirectCostType::kPedestrian:
+      return Expand(DirectCost<PedestrianCost>(*costing_, edge_cost_cache()), graphreader);
+    case DirectCostType::kTruck:
+      return Expand(DirectCost<TruckCost>(*costing_, edge_cost_cache()), graphreader);
+    default:
+      return Expand(DirectCost<DynamicCost>(*costing_, edge_cost_cache()), graphreader);
+  }
+}
+
+// Run the bidirectional search from the seeded adjacency lists
+template <class costing_t>
+std::vector<PathInfo> BidirectionalAStar::Expand(
+             const DirectCost<costing_t>& costing, GraphReader& graphreader) {
   // Find shortest path. Switch between a forward direction and a reverse
   // direction search based on the current costs. Alternating like this
   // prevents one tree from expanding much more quickly (if in a sparser
@@ -435,12 +494,12 @@ std::vector<PathInfo> BidirectionalAStar::GetBestPath(PathLocation& origin,
         continue;
       }
       const NodeInfo* nodeinfo = tile->node(node);
-      if (!costing_->Allowed(nodeinfo)) {
+      if (!costing.Allowed(nodeinfo)) {
         continue;
       }
 
       // Expand from the end node in forward direction.
-      ExpandForward(graphreader, tile, node, nodeinfo, pred,
+      ExpandForward(costing, graphreader, tile, node, nodeinfo, pred,
                     forward_pred_idx, false);
     } else {
       // Expand reverse - set to get next edge from reverse adj. list
@@ -470,7 +529,7 @@ std::vector<PathInfo> BidirectionalAStar::GetBestPath(PathLocation& origin,
         continue;
       }
       const NodeInfo* nodeinfo = tile2->node(node);
-      if (!costing_->Allowed(nodeinfo)) {
+      if (!costing.Allowed(nodeinfo)) {
         continue;
       }
 
@@ -483,7 +542,7 @@ std::vector<PathInfo> BidirectionalAStar::GetBestPath(PathLocation& origin,
                      Tile_Base())->directededge(pred2.opp_edgeid());
 
       // Expand from the end node in reverse direction.
-      ExpandReverse(graphreader, tile2, node, nodeinfo,pred2, reverse_pred_idx,
+      ExpandReverse(costing, graphreader, tile2, node, nodeinfo, pred2, reverse_pred_idx,
                     opp_pred_edge, false);
     }
   }
@@ -503,7 +562,7 @@ void BidirectionalAStar::CheckIfLowerCostPathForward(const uint32_t idx,
     float newsortcost = oldsortcost - dc;
     edgelabels_forward_[idx].Update(predindex, newcost, newsortcost);
     edgelabels_forward_[idx].set_transition_cost(tc);
-    adjacencylist_forward_->decrease(idx, newsortcost, oldsortcost);
+    adjacencylist_forward_->decrease(idx, newsortcost);
   }
 }
 
@@ -521,7 +580,7 @@ void BidirectionalAStar::CheckIfLowerCostPathReverse(const uint32_t idx,
     float newsortcost = oldsortcost - dc;
     edgelabels_reverse_[idx].Update(predindex, newcost, newsortcost);
     edgelabels_reverse_[idx].set_transition_cost(tc);
-    adjacencylist_reverse_->decrease(idx, newsortcost, oldsortcost);
+    adjacencylist_reverse_->decrease(idx, newsortcost);
   }
 }
 
@@ -616,8 +675,9 @@ void BidirectionalAStar::SetOrigin(GraphReader& graphreader,
     // to the destination
     nodeinfo = endtile->node(directededge->endnode());
     Cost cost = costing_->EdgeCost(directededge) * (1.0f - edge.dist);
-    float dist = astarheuristic_forward_.GetDistance(nodeinfo->latlng());
-    float sortcost = cost.cost + astarheuristic_forward_.Get(dist);
+    float dist = 0.0f;
+    float sortcost = cost.cost + astarheuristic_forward_.Get(
+        nodeinfo->latlng(), directededge->endnode(), dist);
 
     // Add EdgeLabel to the adjacency list. Set the predecessor edge index
     // to invalid to indicate the origin of the path.
@@ -677,9 +737,10 @@ void BidirectionalAStar::SetDestination(GraphReader& graphreader,
     // destination edge. Note that the end node of the opposing edge is in the
     // same tile as the directed edge.
     Cost cost = costing_->EdgeCost(directededge) * edge.dist;
-    float dist = astarheuristic_reverse_.GetDistance(tile->node(
-                    opp_dir_edge->endnode())->latlng());
-    float sortcost = cost.cost + astarheuristic_reverse_.Get(dist);
+    float dist = 0.0f;
+    float sortcost = cost.cost + astarheuristic_reverse_.Get(
+        tile->node(opp_dir_edge->endnode())->latlng(),
+        opp_dir_edge->endnode(), dist);
 
     // Add EdgeLabel to the adjacency list. Set the predecessor edge index
     // to invalid to indicate the origin of the path. Make sure the opposing
@@ -708,6 +769,9 @@ std::vector<PathInfo> BidirectionalAStar::FormPath(GraphReader& graphreader) {
   LOG_DEBUG("path_cost::" + std::to_string(pathcost));
   LOG_DEBUG("FormPath path_iterations::" + std::to_string(edgelabels_forward_.size()) +
            "," + std::to_string(edgelabels_reverse_.size()));
+  LOG_DEBUG("FormPath edgelabel_bytes::" +
+           std::to_string(edgelabels_forward_.MemoryUse() +
+                          edgelabels_reverse_.MemoryUse()));
 
   // Work backwards on the forward path
   std::vector<PathInfo> path;
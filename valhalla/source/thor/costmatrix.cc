@@ -2,15 +2,22 @@
 #include <algorithm>
 #include "thor/costmatrix.h"
 #include "midgard/logging.h"
+#include "midgard/worker_pool.h"
 #include "baldr/errorcode_util.h"
 
 using namespace valhalla::baldr;
+using namespace valhalla::midgard;
 using namespace valhalla::sif;
 
 namespace {
 
 constexpr uint32_t kMaxMatrixIterations = 2000000;
 
+// Number of iterations each location advances per round when running on
+// several threads. Keeps the synchronization between rounds cheap compared
+// to the work done in them.
+constexpr uint32_t kParallelIterations = 64;
+
 // Find a threshold to continue the search - should be based on
 // the max edge cost in the adjacency set?
 int GetThreshold(const TravelMode mode, const int n) {
@@ -31,7 +38,17 @@ CostMatrix::CostMatrix(float cost_threshold)
       remaining_sources_(0),
       target_count_(0),
       remaining_targets_(0),
-      cost_threshold_(cost_threshold) {
+      cost_threshold_(cost_threshold),
+      workers_(new WorkerPool(1)),
+      use_edge_cost_cache_(false) {
+}
+
+// Constructor with cost threshold and graph readers for worker threads.
+CostMatrix::CostMatrix(float cost_threshold,
+                 const std::vector<std::shared_ptr<GraphReader>>& worker_readers)
+    : CostMatrix(cost_threshold) {
+  worker_readers_ = worker_readers;
+  workers_.reset(new WorkerPool(worker_readers_.size() + 1));
 }
 
 // Clear the temporary information generated during time + distance matrix
@@ -39,6 +56,7 @@ CostMatrix::CostMatrix(float cost_threshold)
 void CostMatrix::Clear() {
   // Clear the target edge markings
   targets_.clear();
+  target_reached_.clear();
 
   // Clear all source adjacency lists, edge labels, and edge status
   for (auto adj : source_adjacency_) {
@@ -46,14 +64,19 @@ void CostMatrix::Clear() {
   }
   source_adjacency_.clear();
 
-  for (auto el : source_edgelabel_) {
-    el.clear();
-  }
+  // Edge label blocks go back to the pool of the thread clearing them, so
+  // each store is cleared on the worker that filled it
+  const uint32_t worker_count = workers_->size();
+  workers_->Run([this, worker_count](const uint32_t worker) {
+    for (size_t i = worker; i < source_edgelabel_.size(); i += worker_count) {
+      source_edgelabel_[i].clear();
+    }
+    for (size_t i = worker; i < target_edgelabel_.size(); i += worker_count) {
+      target_edgelabel_[i].clear();
+    }
+  });
   source_edgelabel_.clear();
 
-  for (auto es : source_edgestatus_) {
-    es.Init();
-  }
   source_edgestatus_.clear();
 
   // Clear all target adjacency lists, edge labels, and edge status
@@ -62,20 +85,15 @@ void CostMatrix::Clear() {
   }
   target_adjacency_.clear();
 
-  for (auto el : target_edgelabel_) {
-    el.clear();
-  }
   target_edgelabel_.clear();
 
-  for (auto es : target_edgestatus_) {
-    es.Init();
-  }
   target_edgestatus_.clear();
 
   source_hierarchy_limits_.clear();
   target_hierarchy_limits_.clear();
   source_status_.clear();
   target_status_.clear();
+  best_connection_.clear();
 }
 
 // Form a time distance matrix from the set of source locations
@@ -101,35 +119,100 @@ std::vector<TimeDistance> CostMatrix::SourceToTarget(
   // location set.
   Initialize(source_location_list, target_location_list);
 
+  // Run the searches on the concrete costing type when possible so the
+  // costing calls in the expansion are not virtual
+  switch (GetDirectCostType(*costing_)) {
+    case DirectCostType::kAuto:
+      Expand(DirectCost<AutoCost>(*costing_), graphreader);
+      break;
+    case DirectCostType::kBicycle:
+      Expand(DirectCost<BicycleCost>(*costing_), graphreader);
+      break;
+    case DirectCostType::kPedestrian:
+      Expand(DirectCost<PedestrianCost>(*costing_), graphreader);
+      break;
+    case DirectCostType::kTruck:
+      Expand(DirectCost<TruckCost>(*costing_), graphreader);
+      break;
+    default:
+      Expand(DirectCost<DynamicCost>(*costing_), graphreader);
+      break;
+  }
+
+  // Form the time, distance matrix from the destinations list
+  uint32_t idx = 0;
+  std::vector<TimeDistance> td;
+  for (const auto& connection : best_connection_) {
+    td.emplace_back(std::round(connection.cost.secs),
+                    std::round(connection.distance));
+    idx++;
+  }
+  return td;
+}
+
+// Run the forward and backward searches until all of them are done
+template <class costing_t>
+void CostMatrix::Expand(const DirectCost<costing_t>& costing,
+                        GraphReader& graphreader) {
   // Perform backward search from all target locations. Perform forward
   // search from all source locations. Connections between the 2 search
-  // spaces is checked during the forward search.
-  int n = 0;
+  // spaces is checked during the forward search. With worker threads each
+  // worker owns every n-th source and target and all of them advance by a
+  // batch of iterations per round. The reverse trees are not modified while
+  // the forward searches check connections against them.
+  WorkerPool& workers = *workers_;
+  const uint32_t worker_count = workers.size();
+  const uint32_t iterations = (worker_count > 1) ? kParallelIterations : 1;
+  auto worker_reader = [this, &graphreader](const uint32_t worker) -> GraphReader& {
+    return (worker == 0) ? graphreader : *worker_readers_[worker - 1];
+  };
+
+  // Each worker needs its own edge cost cache, it keeps per search state
+  if (use_edge_cost_cache_ && edge_cost_caches_.size() < worker_count) {
+    edge_cost_caches_.resize(worker_count);
+  }
+  std::vector<DirectCost<costing_t>> worker_costing;
+  for (uint32_t w = 0; w < worker_count; w++) {
+    worker_costing.emplace_back(costing.costing(),
+              use_edge_cost_cache_ ? &edge_cost_caches_[w] : nullptr);
+  }
+  uint32_t n = 0;
   while (true) {
     // Iterate all target locations in a backwards search
+    workers.Run([this, &worker_costing, &worker_reader, worker_count, iterations](const uint32_t worker) {
+      GraphReader& reader = worker_reader(worker);
+      for (uint32_t i = worker; i < target_count_; i += worker_count) {
+        for (uint32_t k = 0; k < iterations && target_status_[i].threshold > 0; k++) {
+          target_status_[i].threshold--;
+          BackwardSearch(worker_costing[worker], i, reader);
+        }
+      }
+    });
+    MarkTargetEdges();
     for (uint32_t i = 0; i < target_count_; i++) {
-      if (target_status_[i].threshold > 0) {
-        target_status_[i].threshold--;
-        BackwardSearch(i, graphreader);
-        if (target_status_[i].threshold == 0) {
-          target_status_[i].threshold = -1;
-          if (remaining_targets_ > 0) {
-            remaining_targets_--;
-          }
+      if (target_status_[i].threshold == 0) {
+        target_status_[i].threshold = -1;
+        if (remaining_targets_ > 0) {
+          remaining_targets_--;
         }
       }
     }
 
     // Iterate all source locations in a forward search
+    workers.Run([this, &worker_costing, &worker_reader, worker_count, iterations, n](const uint32_t worker) {
+      GraphReader& reader = worker_reader(worker);
+      for (uint32_t i = worker; i < source_count_; i += worker_count) {
+        for (uint32_t k = 0; k < iterations && source_status_[i].threshold > 0; k++) {
+          source_status_[i].threshold--;
+          ForwardSearch(worker_costing[worker], i, n + k, reader);
+        }
+      }
+    });
     for (uint32_t i = 0; i < source_count_; i++) {
-      if (source_status_[i].threshold > 0) {
-        source_status_[i].threshold--;
-        ForwardSearch(i, n, graphreader);
-        if (source_status_[i].threshold == 0) {
-          source_status_[i].threshold = -1;
-          if (remaining_sources_ > 0) {
-            remaining_sources_--;
-          }
+      if (source_status_[i].threshold == 0) {
+        source_status_[i].threshold = -1;
+        if (remaining_sources_ > 0) {
+          remaining_sources_--;
         }
       }
     }
@@ -137,6 +220,8 @@ std::vector<TimeDistance> CostMatrix::SourceToTarget(
     // Break out when remaining sources and targets to expand are both 0
     if (remaining_sources_ == 0 && remaining_targets_ == 0) {
       LOG_DEBUG("SourceToTarget iterations: n = " + std::to_string(n));
+      LOG_DEBUG("SourceToTarget edgelabel_bytes: " +
+                std::to_string(EdgeLabelMemoryUse()));
       break;
     }
 
@@ -145,18 +230,20 @@ std::vector<TimeDistance> CostMatrix::SourceToTarget(
     if (n >= kMaxMatrixIterations) {
       throw valhalla_exception_t{400, 430};
     }
-    n++;
+    n += iterations;
   }
+}
 
-  // Form the time, distance matrix from the destinations list
-  uint32_t idx = 0;
-  std::vector<TimeDistance> td;
-  for (const auto& connection : best_connection_) {
-    td.emplace_back(std::round(connection.cost.secs),
-                    std::round(connection.distance));
-    idx++;
+// Memory used by the edge labels of all searches
+size_t CostMatrix::EdgeLabelMemoryUse() const {
+  size_t bytes = 0;
+  for (const auto& edgelabels : source_edgelabel_) {
+    bytes += edgelabels.MemoryUse();
   }
-  return td;
+  for (const auto& edgelabels : target_edgelabel_) {
+    bytes += edgelabels.MemoryUse();
+  }
+  return bytes;
 }
 
 // Initialize all time distance to "not found". Any locations that
@@ -208,12 +295,25 @@ void CostMatrix::Initialize(
   }
 }
 
-void CostMatrix::ExpandForward(GraphReader& graphreader,
+// Add the edges reached by the backward searches since the last call to the
+// target edge markings.
+void CostMatrix::MarkTargetEdges() {
+  for (uint32_t i = 0; i < target_count_; i++) {
+    for (const auto& edgeid : target_reached_[i]) {
+      targets_[edgeid].push_back(i);
+    }
+    target_reached_[i].clear();
+  }
+}
+
+template <class costing_t>
+void CostMatrix::ExpandForward(const DirectCost<costing_t>& costing,
+                   GraphReader& graphreader,
                    const GraphTile* tile,
                    const GraphId& node, const NodeInfo* nodeinfo,
                    EdgeLabel& pred, const uint32_t pred_idx,
                    std::vector<HierarchyLimits>& hierarchy_limits,
-                   std::vector<EdgeLabel>& edgelabels,
+                   EdgeLabelStore& edgelabels,
                    EdgeStatus& edgestate,
                    std::shared_ptr<baldr::DoubleBucketQueue>& adj,
                    const bool from_transition) {
@@ -240,7 +340,7 @@ void CostMatrix::ExpandForward(GraphReader& graphreader,
       GraphId node = directededge->endnode();
       const GraphTile* endtile = graphreader.GetGraphTile(node);
       if (endtile != nullptr) {
-        ExpandForward(graphreader, endtile, node, endtile->node(node),
+        ExpandForward(costing, graphreader, endtile, node, endtile->node(node),
                      pred, pred_idx, hierarchy_limits, edgelabels,
                      edgestate, adj, true);
       }
@@ -250,7 +350,7 @@ void CostMatrix::ExpandForward(GraphReader& graphreader,
     // Skip any superseded edges that match the shortcut mask. Also skip
     // if no access is allowed to this edge (based on costing method)
     if ((shortcuts & directededge->superseded()) ||
-        !costing_->Allowed(directededge, pred, tile, edgeid)) {
+        !costing.Allowed(directededge, pred, tile, edgeid)) {
       continue;
     }
 
@@ -262,15 +362,15 @@ void CostMatrix::ExpandForward(GraphReader& graphreader,
     }
 
     // Check for complex restriction
-    if (costing_->Restricted(directededge, pred, edgelabels, tile,
+    if (costing.Restricted(directededge, pred, edgelabels, tile,
                              edgeid, true)) {
       continue;
     }
 
     // Get cost and accumulated distance. Update the_shortcuts mask.
     shortcuts |= directededge->shortcut();
-    Cost tc = costing_->TransitionCost(directededge, nodeinfo, pred);
-    Cost newcost = pred.cost() + tc + costing_->EdgeCost(directededge);
+    Cost tc = costing.TransitionCost(directededge, nodeinfo, pred);
+    Cost newcost = pred.cost() + tc + costing.EdgeCost(directededge, tile);
     uint32_t distance = pred.path_distance() + directededge->length();
 
     // Check if edge is temporarily labeled and this path has less cost. If
@@ -278,9 +378,8 @@ void CostMatrix::ExpandForward(GraphReader& graphreader,
     if (edgestatus.set() == EdgeSet::kTemporary) {
       uint32_t idx = edgestatus.index();
       if (newcost.cost < edgelabels[idx].cost().cost) {
-        float oldsortcost = edgelabels[idx].sortcost();
         edgelabels[idx].Update(pred_idx, newcost, newcost.cost, tc, distance);
-        adj->decrease(idx, newcost.cost, oldsortcost);
+        adj->decrease(idx, newcost.cost);
       }
       continue;
     }
@@ -295,7 +394,7 @@ void CostMatrix::ExpandForward(GraphReader& graphreader,
 
     // Add edge label, add to the adjacency list and set edge status
     adj->add(edgelabels.size(), newcost.cost);
-    edgestate.Set(edgeid, EdgeSet::kTemporary, edgelabels.size());
+    edgestate.Set(edgeid, EdgeSet::kTemporary, edgelabels.size(), tile);
     edgelabels.emplace_back(pred_idx, edgeid, oppedge, directededge,
                     newcost, mode_, tc, distance,
                     (pred.not_thru_pruning() || !directededge->not_thru()));
@@ -303,7 +402,9 @@ void CostMatrix::ExpandForward(GraphReader& graphreader,
 }
 
 // Iterate the forward search from the source/origin location.
-void CostMatrix::ForwardSearch(const uint32_t index, const uint32_t n,
+template <class costing_t>
+void CostMatrix::ForwardSearch(const DirectCost<costing_t>& costing,
+                  const uint32_t index, const uint32_t n,
                   baldr::GraphReader& graphreader) {
   // Get the next edge from the adjacency list for this source location
   auto adj = source_adjacency_[index];
@@ -353,8 +454,8 @@ void CostMatrix::ForwardSearch(const uint32_t index, const uint32_t n,
   const GraphTile* tile = graphreader.GetGraphTile(node);
   if (tile != nullptr) {
     const NodeInfo* nodeinfo = tile->node(node);
-    if (costing_->Allowed(nodeinfo)) {
-      ExpandForward(graphreader, tile, node, nodeinfo, pred, pred_idx,
+    if (costing.Allowed(nodeinfo)) {
+      ExpandForward(costing, graphreader, tile, node, nodeinfo, pred, pred_idx,
                 hierarchy_limits, edgelabels, edgestate, adj, false);
     }
   }
@@ -450,6 +551,8 @@ void CostMatrix::CheckForwardConnections(const uint32_t source,
 
 // Update status when a connection is found.
 void CostMatrix::UpdateStatus(const uint32_t source, const uint32_t target) {
+  std::lock_guard<std::mutex> lock(status_mutex_);
+
   // Remove the target from the source status
   auto& s = source_status_[source].remaining_locations;
   auto it = s.find(target);
@@ -478,13 +581,15 @@ void CostMatrix::UpdateStatus(const uint32_t source, const uint32_t target) {
 }
 
 // Expand from node in reverse direction.
-void CostMatrix::ExpandReverse(GraphReader& graphreader,
+template <class costing_t>
+void CostMatrix::ExpandReverse(const DirectCost<costing_t>& costing,
+                   GraphReader& graphreader,
                    const GraphTile* tile, const GraphId& node,
                    const NodeInfo* nodeinfo, const uint32_t index,
                    EdgeLabel& pred, const uint32_t pred_idx,
                    const DirectedEdge* opp_pred_edge,
                    std::vector<HierarchyLimits>& hierarchy_limits,
-                   std::vector<EdgeLabel>& edgelabels,
+                   EdgeLabelStore& edgelabels,
                    EdgeStatus& edgestate,
                    std::shared_ptr<baldr::DoubleBucketQueue>& adj,
                    const bool from_transition) {
@@ -510,7 +615,7 @@ void CostMatrix::ExpandReverse(GraphReader& graphreader,
       GraphId node = directededge->endnode();
       const GraphTile* endtile = graphreader.GetGraphTile(node);
       if (endtile != nullptr) {
-        ExpandReverse(graphreader, endtile, node, endtile->node(node),
+        ExpandReverse(costing, graphreader, endtile, node, endtile->node(node),
                  index, pred, pred_idx, opp_pred_edge,
                  hierarchy_limits, edgelabels, edgestate, adj, true);
       }
@@ -541,13 +646,13 @@ void CostMatrix::ExpandReverse(GraphReader& graphreader,
 
     // Get opposing directed edge and check if allowed.
     const DirectedEdge* opp_edge = t2->directededge(oppedge);
-    if (!costing_->AllowedReverse(directededge, pred, opp_edge,
+    if (!costing.AllowedReverse(directededge, pred, opp_edge,
                       t2, oppedge)) {
       continue;
     }
 
     // Check for complex restriction
-    if (costing_->Restricted(directededge, pred, edgelabels, tile,
+    if (costing.Restricted(directededge, pred, edgelabels, tile,
                              edgeid, false)) {
       continue;
     }
@@ -555,9 +660,9 @@ void CostMatrix::ExpandReverse(GraphReader& graphreader,
     // Get cost and accumulated distance. Use opposing edge for EdgeCost.
     // Update the shortcut mask
     shortcuts |= directededge->shortcut();
-    Cost tc = costing_->TransitionCostReverse(directededge->localedgeidx(),
+    Cost tc = costing.TransitionCostReverse(directededge->localedgeidx(),
                    nodeinfo, opp_edge, opp_pred_edge);
-    Cost newcost = pred.cost() + tc + costing_->EdgeCost(opp_edge);
+    Cost newcost = pred.cost() + tc + costing.EdgeCost(opp_edge, t2);
     uint32_t distance = pred.path_distance() + directededge->length();
 
     // Check if edge is temporarily labeled and this path has less cost. If
@@ -565,27 +670,28 @@ void CostMatrix::ExpandReverse(GraphReader& graphreader,
     if (edgestatus.set() != EdgeSet::kUnreached) {
       uint32_t idx = edgestatus.index();
       if (newcost.cost < edgelabels[idx].cost().cost) {
-        float oldsortcost = edgelabels[idx].sortcost();
         edgelabels[idx].Update(pred_idx, newcost, newcost.cost, tc, distance);
-        adj->decrease(idx, newcost.cost, oldsortcost);
+        adj->decrease(idx, newcost.cost);
       }
       continue;
     }
 
     // Add edge label, add to the adjacency list and set edge status
-    // Add to the list or targets that have reached this edge
+    // Add to the list of edges this target has reached
     adj->add(edgelabels.size(), newcost.cost);
-    edgestate.Set(edgeid, EdgeSet::kTemporary, edgelabels.size());
+    edgestate.Set(edgeid, EdgeSet::kTemporary, edgelabels.size(), tile);
     edgelabels.emplace_back(pred_idx, edgeid, oppedge,
        directededge, newcost, mode_, tc, distance,
        (pred.not_thru_pruning() || !directededge->not_thru()));
 
-    targets_[edgeid].push_back(index);
+    target_reached_[index].push_back(edgeid);
   }
 }
 
 // Expand the backwards search trees.
-void CostMatrix::BackwardSearch(const uint32_t index,
+template <class costing_t>
+void CostMatrix::BackwardSearch(const DirectCost<costing_t>& costing,
+                 const uint32_t index,
                  baldr::GraphReader& graphreader) {
   // Get the next edge from the adjacency list for this target location
   auto adj = target_adjacency_[index];
@@ -631,7 +737,7 @@ void CostMatrix::BackwardSearch(const uint32_t index,
   const GraphTile* tile = graphreader.GetGraphTile(node);
   if (tile != nullptr) {
     const NodeInfo* nodeinfo = tile->node(node);
-    if (costing_->Allowed(nodeinfo)) {
+    if (costing.Allowed(nodeinfo)) {
       // Get the opposing predecessor directed edge. Need to make sure we get
       // the correct one if a transition occurred
       const DirectedEdge* opp_pred_edge;
@@ -641,7 +747,7 @@ void CostMatrix::BackwardSearch(const uint32_t index,
         opp_pred_edge = graphreader.GetGraphTile(pred.opp_edgeid().
                          Tile_Base())->directededge(pred.opp_edgeid());
       }
-      ExpandReverse(graphreader, tile, node, nodeinfo, index, pred,
+      ExpandReverse(costing, graphreader, tile, node, nodeinfo, index, pred,
                     pred_idx, opp_pred_edge, hierarchy_limits, edgelabels,
                     edgestate, adj, false);
     }
@@ -663,15 +769,10 @@ void CostMatrix::SetSources(baldr::GraphReader& graphreader,
   uint32_t index = 0;
   Cost empty_cost;
   for (const auto& origin : sources) {
-    // Set up lambda to get sort costs
-    const auto edgecost = [this, index](const uint32_t label) -> float {
-      return source_edgelabel_[index][label].sortcost();
-    };
-
     // Allocate the adjacency list and hierarchy limits for this source.
     // Use the cost threshold to size the adjacency list.
     source_adjacency_[index].reset(new DoubleBucketQueue(0, cost_threshold_,
-                                         costing_->UnitSize(), edgecost));
+                                         costing_->UnitSize()));
     source_hierarchy_limits_[index] = costing_->GetHierarchyLimits();
 
     // Iterate through edges and add to adjacency list
@@ -724,20 +825,16 @@ void CostMatrix::SetTargets(baldr::GraphReader& graphreader,
   target_edgestatus_.resize(targets.size());
   target_adjacency_.resize(targets.size());
   target_hierarchy_limits_.resize(targets.size());
+  target_reached_.resize(targets.size());
 
   // Go through each target location
   uint32_t index = 0;
   Cost empty_cost;
   for (const auto& dest : targets) {
-    // Set up lambda to get sort costs
-    const auto edgecost = [this, index](const uint32_t label) {
-      return target_edgelabel_[index][label].sortcost();
-    };
-
     // Allocate the adjacency list and hierarchy limits for target location.
     // Use the cost threshold to size the adjacency list.
     target_adjacency_[index].reset(new DoubleBucketQueue(0, cost_threshold_,
-                                             costing_->UnitSize(), edgecost));
+                                             costing_->UnitSize()));
     target_hierarchy_limits_[index] = costing_->GetHierarchyLimits();
 
     // Iterate through edges and add to adjacency list
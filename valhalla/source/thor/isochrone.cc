@@ -5,6 +5,7 @@
 #include "baldr/datetime.h"
 #include "midgard/distanceapproximator.h"
 #include "midgard/logging.h"
+#include "midgard/worker_pool.h"
 
 using namespace valhalla::midgard;
 using namespace valhalla::baldr;
@@ -43,8 +44,6 @@ namespace valhalla {
 namespace thor {
 
 constexpr uint32_t kBucketCount = 20000;
-constexpr uint64_t kInitialEdgeLabelCount = 500000;
-
 // Default constructor
 Isochrone::Isochrone()
     : access_mode_(kAutoAccess),
@@ -52,7 +51,15 @@ Isochrone::Isochrone()
       shape_interval_(50.0f),
       mode_(TravelMode::kDrive),
       adjacencylist_(nullptr),
-      edgestatus_(nullptr) {
+      edgestatus_(nullptr),
+      workers_(new WorkerPool(1)) {
+}
+
+// Constructor with graph readers for worker threads
+Isochrone::Isochrone(const std::vector<std::shared_ptr<GraphReader>>& worker_readers)
+    : Isochrone() {
+  worker_readers_ = worker_readers;
+  workers_.reset(new WorkerPool(worker_readers_.size() + 1));
 }
 
 // Destructor
@@ -64,7 +71,10 @@ Isochrone::~Isochrone() {
 void Isochrone::Clear() {
   // Clear the edge labels, edge status flags, and adjacency list
   edgelabels_.clear();
-  adjacencylist_.reset();
+  settled_edges_.clear();
+  if (adjacencylist_) {
+    adjacencylist_->clear();
+  }
   edgestatus_.reset();
 }
 
@@ -106,18 +116,16 @@ void Isochrone::ConstructIsoTile(const bool multimodal, const unsigned int max_m
   isotile_.reset(new GriddedData<PointLL>(bounds, grid_size, max_minutes + 5));
 }
 
-// Initialize - create adjacency list, edgestatus support, and reserve
-// edgelabels
+// Initialize - create adjacency list and edgestatus support
 void Isochrone::Initialize(const uint32_t bucketsize) {
-  edgelabels_.reserve(kInitialEdgeLabelCount);
-
-  // Set up lambda to get sort costs
-  const auto edgecost = [this](const uint32_t label) {
-    return edgelabels_[label].sortcost();
-  };
+  settled_edges_.clear();
 
   float range = kBucketCount * bucketsize;
-  adjacencylist_.reset(new DoubleBucketQueue(0.0f, range, bucketsize, edgecost));
+  if (adjacencylist_) {
+    adjacencylist_->reuse(0.0f, range, bucketsize);
+  } else {
+    adjacencylist_.reset(new DoubleBucketQueue(0.0f, range, bucketsize));
+  }
   edgestatus_.reset(new EdgeStatus());
 }
 
@@ -148,7 +156,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::Compute(
     // invalid label indicates there are no edges that can be expanded.
     uint32_t predindex = adjacencylist_->pop();
     if (predindex == kInvalidLabel) {
-      return isotile_;
+      return FillIsoTile(graphreader);
     }
 
     // Copy the EdgeLabel for use in costing and settle the edge.
@@ -170,7 +178,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::Compute(
     // Return after the time interval has been met
     if (pred.cost().secs > max_seconds) {
       LOG_DEBUG("Exceed time interval: n = " + std::to_string(n));
-      return isotile_;
+      return FillIsoTile(graphreader);
     }
 
     // Check access at the node
@@ -199,7 +207,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::Compute(
       if (directededge->trans_up() || directededge->trans_down()) {
         uint32_t idx = edgelabels_.size();
         adjacencylist_->add(idx, pred.sortcost());
-        edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx);
+        edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
         edgelabels_.emplace_back(predindex, edgeid, directededge->endnode(), pred);
         continue;
       }
@@ -227,7 +235,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::Compute(
       // Add to the adjacency list and edge labels.
       uint32_t idx = edgelabels_.size();
       adjacencylist_->add(idx, newcost.cost);
-      edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx);
+      edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
       edgelabels_.emplace_back(predindex, edgeid, directededge,
                     newcost, newcost.cost, 0.0f, mode_, 0);
     }
@@ -263,7 +271,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeReverse(
     // invalid label indicates there are no edges that can be expanded.
     uint32_t predindex = adjacencylist_->pop();
     if (predindex == kInvalidLabel) {
-      return isotile_;
+      return FillIsoTile(graphreader);
     }
 
     // Copy the EdgeLabel for use in costing and settle the edge.
@@ -285,7 +293,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeReverse(
     // Return after the time interval has been met
     if (pred.cost().secs > max_seconds) {
       LOG_DEBUG("Exceed time interval: n = " + std::to_string(n));
-      return isotile_;
+      return FillIsoTile(graphreader);
     }
 
     // Check access at the node
@@ -323,7 +331,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeReverse(
       if (directededge->trans_up() || directededge->trans_down()) {
         uint32_t idx = edgelabels_.size();
         adjacencylist_->add(idx, pred.sortcost());
-        edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx);
+        edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
         edgelabels_.emplace_back(predindex, edgeid, directededge->endnode(), pred);
         continue;
       }
@@ -366,7 +374,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeReverse(
       // Add edge label, add to the adjacency list and set edge status
       uint32_t idx = edgelabels_.size();
       adjacencylist_->add(idx, newcost.cost);
-      edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx);
+      edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
       edgelabels_.emplace_back(predindex, edgeid, oppedge,
                     directededge, newcost, newcost.cost, 0.0f,
                     mode_, tc, false);
@@ -433,7 +441,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeMultiModal(
     // invalid label indicates there are no edges that can be expanded.
     uint32_t predindex = adjacencylist_->pop();
     if (predindex == kInvalidLabel) {
-      return isotile_;
+      return FillIsoTile(graphreader);
     }
 
     // Copy the EdgeLabel for use in costing and settle the edge.
@@ -455,7 +463,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeMultiModal(
     // Return after the time interval has been met
     if (pred.cost().secs > max_seconds) {
       LOG_DEBUG("Exceed time interval: n = " + std::to_string(n));
-      return isotile_;
+      return FillIsoTile(graphreader);
     }
 
     // Check access at the node
@@ -544,7 +552,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeMultiModal(
       if (directededge->trans_up() || directededge->trans_down()) {
         uint32_t idx = edgelabels_.size();
         adjacencylist_->add(idx, pred.sortcost());
-        edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx);
+        edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
         edgelabels_.emplace_back(predindex, edgeid, directededge->endnode(), pred);
         continue;
       }
@@ -699,7 +707,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeMultiModal(
           float newsortcost = oldsortcost - dc;
           edgelabels_[idx].Update(predindex, newcost, newsortcost,
                                   walking_distance, tripid, blockid);
-          adjacencylist_->decrease(idx, newsortcost, oldsortcost);
+          adjacencylist_->decrease(idx, newsortcost);
         }
         continue;
       }
@@ -707,7 +715,7 @@ std::shared_ptr<const GriddedData<PointLL> > Isochrone::ComputeMultiModal(
       // Add edge label, add to the adjacency list and set edge status
       uint32_t idx = edgelabels_.size();
       adjacencylist_->add(idx, newcost.cost);
-      edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx);
+      edgestatus_->Set(edgeid, EdgeSet::kTemporary, idx, tile);
       edgelabels_.emplace_back(predindex, edgeid, directededge,
                     newcost, newcost.cost, 0.0f, mode_, walking_distance,
                     tripid, prior_stop, blockid, operator_id, has_transit);
@@ -726,16 +734,12 @@ void Isochrone::UpdateIsoTile(const EdgeLabel& pred, GraphReader& graphreader,
       return;
   }
 
-  // Get the DirectedEdge because we'll need its shape
+  // Transit lines can't really be "reached" you really just pass through those cells
   const GraphTile* tile = graphreader.GetGraphTile(pred.edgeid().Tile_Base());
   const DirectedEdge* edge = tile->directededge(pred.edgeid());
-  // Transit lines can't really be "reached" you really just pass through those cells
   if(edge->IsTransitLine())
     return;
 
-  // Get time at the end node of the predecessor
-  float secs1 = pred.cost().secs;
-
   // Get the time at the end node of the predecessor
   float secs0;
   uint32_t predindex = pred.predecessor();
@@ -746,6 +750,50 @@ void Isochrone::UpdateIsoTile(const EdgeLabel& pred, GraphReader& graphreader,
     secs0 = edgelabels_[predindex].cost().secs;
   }
 
+  // Queue the edge along with the times at both of its ends
+  settled_edges_.push_back({ pred.edgeid(), secs0, pred.cost().secs });
+}
+
+// Mark the shapes of all settled edges in the isotile
+std::shared_ptr<const GriddedData<PointLL> > Isochrone::FillIsoTile(
+             GraphReader& graphreader) {
+  // Split the edges into contiguous ranges so each worker mostly reads
+  // edges from the same tiles. Workers other than the first mark their own
+  // copy of the grid.
+  WorkerPool& workers = *workers_;
+  const uint32_t worker_count = workers.size();
+  std::vector<std::unique_ptr<GriddedData<PointLL>>> grids(worker_count);
+  for (uint32_t i = 1; i < worker_count; i++) {
+    grids[i].reset(new GriddedData<PointLL>(*isotile_));
+  }
+  const size_t count = settled_edges_.size();
+  workers.Run([this, &graphreader, &grids, worker_count, count](const uint32_t worker) {
+    GraphReader& reader = (worker == 0) ? graphreader : *worker_readers_[worker - 1];
+    GriddedData<PointLL>& grid = (worker == 0) ? *isotile_ : *grids[worker];
+    size_t end = (count * (worker + 1)) / worker_count;
+    for (size_t i = (count * worker) / worker_count; i < end; i++) {
+      MarkEdge(settled_edges_[i], reader, grid);
+    }
+  });
+
+  // Keep the lowest time per cell
+  for (uint32_t i = 1; i < worker_count; i++) {
+    isotile_->SetIfLessThan(grids[i]->data());
+  }
+  settled_edges_.clear();
+  return isotile_;
+}
+
+// Mark the shape of a settled edge in a grid
+void Isochrone::MarkEdge(const SettledEdge& settled, GraphReader& graphreader,
+                         GriddedData<PointLL>& grid) const {
+  // Get the DirectedEdge because we'll need its shape
+  const GraphTile* tile = graphreader.GetGraphTile(settled.edgeid.Tile_Base());
+  if (tile == nullptr) {
+    return;
+  }
+  const DirectedEdge* edge = tile->directededge(settled.edgeid);
+
   // Get the shape and make sure shape is forward
   // direction and resample it to the shape interval.
   auto shape = tile->edgeinfo(edge->edgeinfo_offset()).shape();
@@ -755,19 +803,10 @@ void Isochrone::UpdateIsoTile(const EdgeLabel& pred, GraphReader& graphreader,
   auto resampled = resample_spherical_polyline(shape, shape_interval_);
 
   // Mark grid cells along the shape if time is less than what is
-  // already populated. Get intersection of tiles along each segment
-  // so this doesn't miss shape that crosses tile corners
-  float delta = (shape_interval_ * (secs1 - secs0)) / edge->length();
-  float secs = secs0;
-  auto itr1 = resampled.begin();
-  auto itr2 = itr1 + 1;
-  for (auto itr2 = itr1 + 1; itr2 < resampled.end(); itr1++, itr2++) {
-    secs += delta;
-    auto tiles = isotile_->Intersect(std::list<PointLL>{*itr1, *itr2});
-    for (auto t : tiles) {
-      isotile_->SetIfLessThan(t.first, secs * to_minutes);
-    }
-  }
+  // already populated. Each segment gets the time at its end.
+  float delta = (shape_interval_ * (settled.secs1 - settled.secs0)) / edge->length();
+  grid.SetIfLessThan(resampled, (settled.secs0 + delta) * to_minutes,
+                     delta * to_minutes);
 }
 
 // Check if edge is temporarily labeled and this path has less cost. If
@@ -781,7 +820,7 @@ void Isochrone::CheckIfLowerCostPath(const uint32_t idx,
     float oldsortcost = edgelabels_[idx].sortcost();
     float newsortcost = oldsortcost - dc;
     edgelabels_[idx].Update(predindex, newcost, newsortcost);
-    adjacencylist_->decrease(idx, newsortcost, oldsortcost);
+    adjacencylist_->decrease(idx, newsortcost);
   }
 }
 
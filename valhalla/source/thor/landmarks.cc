@@ -0,0 +1,320 @@
+#include "thor/landmarks.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "baldr/graphtile.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+// Identifies a landmarks file and its layout
+constexpr uint32_t kLandmarksMagic = 0x4b524d4c;
+constexpr uint32_t kLandmarksVersion = 1;
+
+template <class T>
+void write(std::ofstream& file, const T& value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T read(std::ifstream& file) {
+  T value;
+  if (!file.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+    throw std::runtime_error("Landmarks file is truncated");
+  }
+  return value;
+}
+
+}
+
+namespace valhalla {
+namespace thor {
+
+constexpr uint64_t Landmarks::kNoNode;
+
+// Choose the landmarks one after the other and compute their distances
+std::shared_ptr<Landmarks> Landmarks::Build(GraphReader& reader,
+                                            const uint32_t count,
+                                            const uint32_t access_mode) {
+  if (count == 0) {
+    throw std::runtime_error("Landmarks need at least one landmark");
+  }
+  std::shared_ptr<Landmarks> landmarks(new Landmarks());
+  landmarks->count_ = count;
+  landmarks->access_mode_ = access_mode;
+
+  // Tiles sorted so the same tile set always gives the same file
+  std::vector<std::pair<GraphId, uint32_t>> tiles;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    if (tile != nullptr) {
+      tiles.emplace_back(tile_id, tile->header()->nodecount());
+    }
+  }
+  std::sort(tiles.begin(), tiles.end());
+  const uint64_t node_count = landmarks->SetTiles(tiles);
+  LOG_INFO("Computing " + std::to_string(count) + " landmarks over " +
+           std::to_string(node_count) + " nodes");
+
+  // Get a node from its index
+  std::vector<uint64_t> first_nodes;
+  first_nodes.reserve(tiles.size());
+  for (const auto& tile : tiles) {
+    first_nodes.push_back(landmarks->index(tile.first));
+  }
+  auto node_at = [&tiles, &first_nodes](const uint64_t idx) {
+    const size_t t = std::upper_bound(first_nodes.begin(), first_nodes.end(),
+                                      idx) - first_nodes.begin() - 1;
+    return tiles[t].first + (idx - first_nodes[t]);
+  };
+
+  // Get the reached node with the largest distance, an invalid id if all
+  // the reached nodes are at the source
+  auto farthest = [&node_at](const std::vector<uint32_t>& dist) {
+    uint64_t best = kNoNode;
+    for (uint64_t idx = 0; idx < dist.size(); ++idx) {
+      if (dist[idx] != kLandmarkUnreached &&
+          (best == kNoNode || dist[idx] > dist[best])) {
+        best = idx;
+      }
+    }
+    return (best == kNoNode || dist[best] == 0) ? GraphId() : node_at(best);
+  };
+
+  // Start from the node farthest from a node on the highway level
+  GraphId seed;
+  uint32_t seed_level = std::numeric_limits<uint32_t>::max();
+  for (const auto& tile : tiles) {
+    if (tile.second > 0 && tile.first.level() < seed_level) {
+      seed = tile.first;
+      seed_level = seed.level();
+    }
+  }
+  if (!seed.Is_Valid()) {
+    throw std::runtime_error("No nodes to place landmarks on");
+  }
+  std::vector<uint32_t> from(node_count), to(node_count);
+  landmarks->Distances(reader, seed, false, from);
+  GraphId landmark = farthest(from);
+
+  // Each landmark is the node farthest from the ones before it
+  std::vector<uint32_t> spread(node_count, kLandmarkUnreached);
+  landmarks->distances_.resize(node_count * 2 * count);
+  for (uint32_t i = 0; i < count && landmark.Is_Valid(); ++i) {
+    landmarks->landmarks_.push_back(landmark);
+    landmarks->Distances(reader, landmark, false, from);
+    landmarks->Distances(reader, landmark, true, to);
+    for (uint64_t idx = 0; idx < node_count; ++idx) {
+      landmarks->distances_[idx * 2 * count + i] = from[idx];
+      landmarks->distances_[idx * 2 * count + count + i] = to[idx];
+      spread[idx] = std::min(spread[idx], from[idx]);
+    }
+    LOG_INFO("Landmark " + std::to_string(i) + " at node " +
+             std::to_string(landmark.value));
+    landmark = farthest(spread);
+  }
+
+  // Ran out of nodes to place landmarks on, the rest bound nothing
+  for (uint32_t i = landmarks->landmarks_.size(); i < count; ++i) {
+    for (uint64_t idx = 0; idx < node_count; ++idx) {
+      landmarks->distances_[idx * 2 * count + i] = kLandmarkUnreached;
+      landmarks->distances_[idx * 2 * count + count + i] = kLandmarkUnreached;
+    }
+    landmarks->landmarks_.push_back(GraphId());
+  }
+  return landmarks;
+}
+
+// Dijkstra over the graph, following edges in reverse to get the distances
+// to the source rather than from it. Transition edges have no length and
+// shortcuts are skipped since the edges they cover are followed anyway.
+void Landmarks::Distances(GraphReader& reader, const GraphId& source,
+                          const bool reverse,
+                          std::vector<uint32_t>& dist) const {
+  std::fill(dist.begin(), dist.end(), kLandmarkUnreached);
+  using entry_t = std::pair<uint32_t, uint64_t>;
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> queue;
+  dist[index(source)] = 0;
+  queue.emplace(0, source.value);
+  while (!queue.empty()) {
+    const entry_t entry = queue.top();
+    queue.pop();
+    const GraphId node(entry.second);
+    if (entry.first != dist[index(node)]) {
+      continue;
+    }
+
+    // The search covers the whole graph, no tile is held past a node so
+    // the cache can be kept within its limit as it goes
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    const GraphTile* tile = reader.GetGraphTile(node);
+    if (tile == nullptr) {
+      continue;
+    }
+    const NodeInfo* nodeinfo = tile->node(node);
+    const DirectedEdge* edge = tile->directededge(nodeinfo->edge_index());
+    for (uint32_t i = 0; i < nodeinfo->edge_count(); ++i, ++edge) {
+      uint32_t length = 0;
+      if (!edge->trans_up() && !edge->trans_down()) {
+        if (edge->is_shortcut()) {
+          continue;
+        }
+
+        // In reverse the opposing edge is the one leading into this node
+        const DirectedEdge* access_edge = edge;
+        if (reverse) {
+          const GraphTile* endtile = edge->leaves_tile() ?
+              reader.GetGraphTile(edge->endnode()) : tile;
+          if (endtile == nullptr) {
+            continue;
+          }
+          access_edge = endtile->directededge(endtile->GetOpposingEdgeId(edge));
+        }
+        if (!(access_edge->forwardaccess() & access_mode_)) {
+          continue;
+        }
+        length = edge->length();
+      }
+
+      const uint64_t end = index(edge->endnode());
+      if (end != kNoNode && entry.first + length < dist[end]) {
+        dist[end] = entry.first + length;
+        queue.emplace(dist[end], edge->endnode().value);
+      }
+    }
+  }
+}
+
+// Index the tiles from the number of nodes of the tiles before them
+uint64_t Landmarks::SetTiles(
+    const std::vector<std::pair<GraphId, uint32_t>>& tiles) {
+  tiles_ = tiles;
+  tile_offsets_.clear();
+  uint64_t node_count = 0;
+  for (const auto& tile : tiles_) {
+    const GraphId& id = tile.first;
+    if (id.level() >= tile_offsets_.size()) {
+      tile_offsets_.resize(id.level() + 1);
+    }
+    auto& offsets = tile_offsets_[id.level()];
+    if (id.tileid() >= offsets.size()) {
+      offsets.resize(id.tileid() + 1, kNoNode);
+    }
+    offsets[id.tileid()] = node_count;
+    node_count += tile.second;
+  }
+  return node_count;
+}
+
+// Read the header, the landmarks, the tiles and the distances
+std::shared_ptr<Landmarks> Landmarks::Load(const std::string& file) {
+  std::ifstream in(file, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    throw std::runtime_error("Failed to open landmarks file: " + file);
+  }
+  if (read<uint32_t>(in) != kLandmarksMagic ||
+      read<uint32_t>(in) != kLandmarksVersion) {
+    throw std::runtime_error("Not a landmarks file: " + file);
+  }
+
+  std::shared_ptr<Landmarks> landmarks(new Landmarks());
+  landmarks->count_ = read<uint32_t>(in);
+  landmarks->access_mode_ = read<uint32_t>(in);
+  const uint64_t tile_count = read<uint64_t>(in);
+  for (uint32_t i = 0; i < landmarks->count_; ++i) {
+    landmarks->landmarks_.emplace_back(read<uint64_t>(in));
+  }
+  std::vector<std::pair<GraphId, uint32_t>> tiles;
+  tiles.reserve(tile_count);
+  for (uint64_t i = 0; i < tile_count; ++i) {
+    const GraphId tile_id(read<uint64_t>(in));
+    tiles.emplace_back(tile_id, read<uint32_t>(in));
+  }
+  const uint64_t node_count = landmarks->SetTiles(tiles);
+  landmarks->distances_.resize(node_count * 2 * landmarks->count_);
+  if (!in.read(reinterpret_cast<char*>(landmarks->distances_.data()),
+               landmarks->distances_.size() * sizeof(uint32_t))) {
+    throw std::runtime_error("Landmarks file is truncated: " + file);
+  }
+  return landmarks;
+}
+
+// Write the header, the landmarks, the tiles and the distances
+void Landmarks::Save(const std::string& file) const {
+  std::ofstream out(file, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::runtime_error("Failed to open landmarks file: " + file);
+  }
+  write(out, kLandmarksMagic);
+  write(out, kLandmarksVersion);
+  write(out, count_);
+  write(out, access_mode_);
+  write(out, static_cast<uint64_t>(tiles_.size()));
+  for (const auto& landmark : landmarks_) {
+    write(out, landmark.value);
+  }
+  for (const auto& tile : tiles_) {
+    write(out, tile.first.value);
+    write(out, tile.second);
+  }
+  out.write(reinterpret_cast<const char*>(distances_.data()),
+            distances_.size() * sizeof(uint32_t));
+  if (!out) {
+    throw std::runtime_error("Failed to write landmarks file: " + file);
+  }
+}
+
+// Keep the distances of the nearest or farthest target per landmark,
+// whichever gives a bound that holds for all the targets
+void LandmarkBounds::Init(const Landmarks* landmarks,
+                          const std::vector<GraphId>& targets,
+                          const bool to_targets) {
+  landmarks_ = nullptr;
+  to_targets_ = to_targets;
+  if (landmarks == nullptr || targets.empty()) {
+    return;
+  }
+
+  const uint32_t count = landmarks->count();
+  from_.assign(count, to_targets ? kLandmarkUnreached : 0);
+  to_.assign(count, to_targets ? 0 : kLandmarkUnreached);
+  std::vector<bool> from_unreached(count, false), to_unreached(count, false);
+  for (const auto& target : targets) {
+    const uint32_t* dist = landmarks->distances(target);
+    if (dist == nullptr) {
+      return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint32_t from = dist[i];
+      const uint32_t to = dist[count + i];
+      from_unreached[i] = from_unreached[i] || from == kLandmarkUnreached;
+      to_unreached[i] = to_unreached[i] || to == kLandmarkUnreached;
+      from_[i] = to_targets ? std::min(from_[i], from) : std::max(from_[i], from);
+      to_[i] = to_targets ? std::max(to_[i], to) : std::min(to_[i], to);
+    }
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    if (from_unreached[i]) {
+      from_[i] = kLandmarkUnreached;
+    }
+    if (to_unreached[i]) {
+      to_[i] = kLandmarkUnreached;
+    }
+  }
+  landmarks_ = landmarks;
+}
+
+}
+}
@@ -129,20 +129,18 @@ namespace valhalla {
       json::MapPtr json;
       //do the real work
       std::vector<TimeDistance> time_distances;
-      auto costmatrix = [&]() {
-        thor::CostMatrix matrix;
-        return matrix.SourceToTarget(correlated_s, correlated_t, reader, mode_costing, mode);
+      auto cost_matrix = [&]() {
+        return costmatrix.SourceToTarget(correlated_s, correlated_t, reader, mode_costing, mode);
       };
-      auto timedistancematrix = [&]() {
-        thor::TimeDistanceMatrix matrix;
-        return matrix.SourceToTarget(correlated_s, correlated_t, reader, mode_costing, mode);
+      auto time_distance_matrix = [&]() {
+        return timedistancematrix.SourceToTarget(correlated_s, correlated_t, reader, mode_costing, mode);
       };
       switch (source_to_target_algorithm) {
       case SELECT_OPTIMAL:
         if (correlated_s.size() + correlated_t.size() > 100) {
-          time_distances = timedistancematrix();
+          time_distances = time_distance_matrix();
         } else {
-          time_distances = costmatrix();
+          time_distances = cost_matrix();
         }
         /** TODO - test performance of TimeDistanceMatrix vs. CostMatrix for various
             modes and conditions (e.g. number of locations, distances between
@@ -150,18 +148,18 @@ namespace valhalla {
           switch (mode) {
           case TravelMode::kPedestrian:
           case TravelMode::kBicycle:
-            time_distances = timedistancematrix();
+            time_distances = time_distance_matrix();
             break;
           default:
-            time_distances = costmatrix();
+            time_distances = cost_matrix();
           }
         } */
         break;
       case COST_MATRIX:
-        time_distances = costmatrix();
+        time_distances = cost_matrix();
         break;
       case TIME_DISTANCE_MATRIX: {
-        time_distances = timedistancematrix();
+        time_distances = time_distance_matrix();
         break;
       }
       }
@@ -38,8 +38,6 @@ uint32_t GetOperatorId(const GraphTile* tile, uint32_t routeid,
 namespace valhalla {
 namespace thor {
 
-constexpr uint64_t kInitialEdgeLabelCount = 200000;
-
 // Default constructor
 MultiModalPathAlgorithm::MultiModalPathAlgorithm()
     : AStarPathAlgorithm(),
@@ -58,20 +56,15 @@ void MultiModalPathAlgorithm::Init(const PointLL& origll,
   // Disable A* for multimodal
   astarheuristic_.Init(destll, 0.0f);
 
-  // Reserve size for edge labels - do this here rather than in constructor so
-  // to limit how much extra memory is used for persistent objects
-  edgelabels_.reserve(kInitialEdgeLabelCount);
-
-  // Set up lambda to get sort costs
-  const auto edgecost = [this](const uint32_t label) {
-    return edgelabels_[label].sortcost();
-  };
-
   // Construct adjacency list and edge status.
   // Set bucket size and cost range based on DynamicCost.
   uint32_t bucketsize = costing->UnitSize();
   float range = kBucketCount * bucketsize;
-  adjacencylist_.reset(new DoubleBucketQueue(0.0f, range, bucketsize, edgecost));
+  if (adjacencylist_) {
+    adjacencylist_->reuse(0.0f, range, bucketsize);
+  } else {
+    adjacencylist_.reset(new DoubleBucketQueue(0.0f, range, bucketsize));
+  }
   edgestatus_.reset(new EdgeStatus());
 
   // Get hierarchy limits from the costing. Get a copy since we increment
@@ -466,7 +459,7 @@ std::vector<PathInfo> MultiModalPathAlgorithm::GetBestPath(
           float newsortcost = oldsortcost - dc;
           edgelabels_[idx].Update(predindex, newcost, newsortcost,
                                   walking_distance_, tripid, blockid);
-          adjacencylist_->decrease(idx, newsortcost, oldsortcost);
+          adjacencylist_->decrease(idx, newsortcost);
         }
         continue;
       }
@@ -511,20 +504,14 @@ bool MultiModalPathAlgorithm::CanReachDestination(const PathLocation& destinatio
 
   // Local edge labels and edge status info
   EdgeStatus edgestatus;
-  std::vector<EdgeLabel> edgelabels;
-
-  // Set up lambda to get sort costs (use the local edgelabels, not the class
-  // member!)
-  const auto edgecost = [edgelabels](const uint32_t label) {
-    return edgelabels[label].sortcost();
-  };
+  EdgeLabelStore edgelabels;
 
   // Use a simple Dijkstra method - no need to recover the path just need to
   // make sure we can get to a transit stop within the specified max. walking
   // distance
   uint32_t label_idx = 0;
   uint32_t bucketsize = costing->UnitSize();
-  DoubleBucketQueue adjlist(0.0f, kBucketCount * bucketsize, bucketsize, edgecost);
+  DoubleBucketQueue adjlist(0.0f, kBucketCount * bucketsize, bucketsize);
 
   // Add the opposing destination edges to the priority queue
   for (const auto& edge : destination.edges) {
@@ -615,7 +602,7 @@ bool MultiModalPathAlgorithm::CanReachDestination(const PathLocation& destinatio
           float newsortcost = oldsortcost - dc;
           edgelabels[idx].Update(predindex, newcost, newsortcost,
                                   walking_distance, 0, 0);
-          adjlist.decrease(idx, newsortcost, oldsortcost);
+          adjlist.decrease(idx, newsortcost);
         }
         continue;
       }
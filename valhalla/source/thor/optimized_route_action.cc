@@ -44,7 +44,6 @@ namespace valhalla {
     result.messages.emplace_back(std::move(request_str));
 
     // Use CostMatrix to find costs from each location to every other location
-    CostMatrix costmatrix;
     std::vector<thor::TimeDistance> td = costmatrix.SourceToTarget(correlated_s, correlated_t, reader, mode_costing, mode);
 
     // Return an error if any locations are totally unreachable
@@ -65,7 +64,7 @@ namespace valhalla {
       time_costs.emplace_back(static_cast<float>(td[i].time));
     }
 
-    Optimizer optimizer;
+    Optimizer optimizer(optimizer_chains, optimizer_threads);
     //returns the optimal order of the path_locations
     auto order = optimizer.Solve(correlated.size(), time_costs);
     std::vector<PathLocation> best_order;
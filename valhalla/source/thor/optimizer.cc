@@ -1,9 +1,21 @@
+#include <atomic>
+
 #include "thor/optimizer.h"
 #include "midgard/logging.h"
+#include "midgard/worker_pool.h"
 
 namespace valhalla {
 namespace thor {
 
+// Constructor
+Optimizer::Optimizer(const uint32_t chain_count, const uint32_t thread_count)
+    : chain_count_(std::max(chain_count, 1u)),
+      thread_count_(std::max(thread_count, 1u)),
+      count_(0),
+      attempts_(0),
+      successes_(0) {
+}
+
 // Optimize the tour through a set of locations given the cost matrix
 // among all locations. The first location (origin) and last location
 // (destination) remain fixed in the tour.
@@ -22,74 +34,113 @@ std::vector<uint32_t> Optimizer::Solve(const uint32_t count,
     return (TourCost(costs, tour1) < TourCost(costs, tour2)) ? tour1 : tour2;
   }
 
+  // Set a run limit per annealing step and a success limit to break out
+  // early if enough successes are found.
+  attempts_  = 200 * count_;
+  successes_ = 20  * count_;
+
+  // Seed all chains up front so the result does not depend on which
+  // thread runs which chain
+  std::vector<Chain> chains(chain_count_);
+  for (auto& chain : chains) {
+    chain.random_generator.seed(random_generator_());
+  }
+
+  // Run the chains, each worker takes the next chain not started yet
+  std::atomic<uint32_t> next_chain(0);
+  midgard::WorkerPool workers(std::min(thread_count_, chain_count_));
+  workers.Run([this, &chains, &costs, &next_chain](const uint32_t) {
+    for (uint32_t i = next_chain++; i < chains.size(); i = next_chain++) {
+      RunChain(chains[i], costs);
+    }
+  });
+
+  // Return the best tour, the first chain wins ties
+  const Chain* best = &chains.front();
+  uint32_t ntry = 0;
+  for (const auto& chain : chains) {
+    ntry += chain.ntry;
+    if (chain.best_cost < best->best_cost) {
+      best = &chain;
+    }
+  }
+  LOG_DEBUG("Best tour cost = " + std::to_string(best->best_cost) +
+           " ntries = " + std::to_string(ntry));
+  return best->best_tour;
+}
+
+// Run one annealing chain from a random tour, then improve its best tour
+// with a local search.
+void Optimizer::RunChain(Chain& chain, const std::vector<float>& costs) const {
   // Populate the initial tour with a random order. The first and last
   // locations must remain fixed as the tour begin and end locations do not
   // change.
-  CreateRandomTour();
+  CreateRandomTour(chain);
+  UpdateTourCosts(costs, chain.tour, chain.forward_costs, chain.reverse_costs);
 
   // Copy current tour to best tour and get the tour cost. Set the initial
   // temperature based on tour cost
-  best_tour_ = tour_;
-  best_cost_ = TourCost(costs, tour_);
-  float temperature = best_cost_ / count_;
+  chain.best_tour = chain.tour;
+  chain.best_cost = chain.forward_costs.back();
+  float temperature = chain.best_cost / count_;
 
-  // Perform simulated annealing. Set a run limit per annealing step and a
-  // success limit to break out early if enough successes are found.
-  ntry_ = 0;
-  attempts_  = 200 * count_;
-  successes_ = 20  * count_;
+  // Perform simulated annealing.
+  chain.ntry = 0;
   for (uint32_t i = 0; i < 100; i++) {
     // Break if no successes were found during this annealing step.
-    if (Anneal(costs, temperature) == 0)
+    if (Anneal(chain, costs, temperature) == 0)
       break;
 
     // Reduce temperature
     temperature *= kCoolingRate;
   }
 
-  // Return the best tour
-  LOG_DEBUG("Best tour cost = " + std::to_string(best_cost_) +
-           " ntries = " + std::to_string(ntry_));
-  return best_tour_;
+  // Annealing rarely stops right at a local optimum, finish the best tour
+  // with a local search
+  LocalSearch(costs, chain.best_tour);
+  chain.best_cost = TourCost(costs, chain.best_tour);
 }
 
 // Perform the annealing process.
-uint32_t Optimizer::Anneal(const std::vector<float>& costs, float temperature) {
+uint32_t Optimizer::Anneal(Chain& chain, const std::vector<float>& costs,
+                           float temperature) const {
   uint32_t success_count = 0;
+  auto& tour = chain.tour;
   for (uint32_t i = 0; i < attempts_; i++) {
     // Select a potential tour alteration. Get temperature difference.
-    TourAlteration alteration = GetTourAlteration();
-    float diff = TemperatureDifference(costs, alteration);
-    ntry_++;
+    TourAlteration alteration = GetTourAlteration(chain);
+    float diff = CostDifference(chain, costs, alteration) / static_cast<float>(count_);
+    chain.ntry++;
 
     // Check if we should keep this as the new best path. The idea behind
     // simulated annealing is that it tries to avoid becoming trapped in local
     // optima by occasionally allowing worse solutions at a probability that
     // declines with time.
     // (http://www.technical-recipes.com/2012/c-implementation-of-hill-climbing-and-simulated-annealing-applied-to-travelling-salesman-problems/
-    if (diff < 0.0f || r01() < std::exp(-diff / temperature)) {
+    if (diff < 0.0f || chain.r01() < std::exp(-diff / temperature)) {
       if (alteration.alt == KReverse) {
         // Alter the tour by reversing the locations in the tour between a
         // start and end location. Add 1 to the end index since STL algorithm
         // reverse does not include the iterator at position it2
-        auto it1 = tour_.begin() + alteration.start;
-        auto it2 = tour_.begin() + alteration.end + 1;
+        auto it1 = tour.begin() + alteration.start;
+        auto it2 = tour.begin() + alteration.end + 1;
         std::reverse(it1, it2);
       } else {
         // Alter the tour by rotating the locations about a middle point.
         // The middle location becomes the new first location.
-        auto it1 = tour_.begin() + alteration.start;
-        auto it2 = tour_.begin() + alteration.mid;
-        auto it3 = tour_.begin() + alteration.end;
+        auto it1 = tour.begin() + alteration.start;
+        auto it2 = tour.begin() + alteration.mid;
+        auto it3 = tour.begin() + alteration.end;
         std::rotate(it1, it2, it3);
       }
       success_count++;
 
-      // Get the tour cost and update the best tour if less cost
-      float cost = TourCost(costs, tour_);
-      if (cost < best_cost_) {
-        best_cost_ = cost;
-        best_tour_ = tour_;
+      // Update the costs along the tour and the best tour if less cost
+      UpdateTourCosts(costs, tour, chain.forward_costs, chain.reverse_costs);
+      float cost = chain.forward_costs.back();
+      if (cost < chain.best_cost) {
+        chain.best_cost = cost;
+        chain.best_tour = tour;
       }
     }
     if (success_count >= successes_)
@@ -100,25 +151,26 @@ uint32_t Optimizer::Anneal(const std::vector<float>& costs, float temperature) {
 
 // Create a random initial tour. The first and last locations must remain
 // fixed as the tour begin and end locations do not change.
-void Optimizer::CreateRandomTour() {
-  tour_.clear();
+void Optimizer::CreateRandomTour(Chain& chain) const {
+  auto& tour = chain.tour;
+  tour.clear();
   for (uint32_t i = 1; i < count_ - 1; i++) {
-    tour_.push_back(i);
+    tour.push_back(i);
   }
-  std::random_shuffle(tour_.begin(), tour_.end());
-  tour_.insert(tour_.begin(), 0);
-  tour_.push_back(count_ - 1);
+  std::shuffle(tour.begin(), tour.end(), chain.random_generator);
+  tour.insert(tour.begin(), 0);
+  tour.push_back(count_ - 1);
 }
 
 // Select a potential alteration of the tour.
-TourAlteration Optimizer::GetTourAlteration() {
+TourAlteration Optimizer::GetTourAlteration(Chain& chain) const {
   // Select three unique locations between 1 and count-2
   std::vector<uint32_t> loc(3);
   while (true) {
     // TODO - is there a better way to choose 3 random locations?
-    loc[0] = static_cast<uint32_t>(r01() * (count_ - 2) + 1);
-    loc[1] = static_cast<uint32_t>(r01() * (count_ - 2) + 1);
-    loc[2] = static_cast<uint32_t>(r01() * (count_ - 2) + 1);
+    loc[0] = static_cast<uint32_t>(chain.r01() * (count_ - 2) + 1);
+    loc[1] = static_cast<uint32_t>(chain.r01() * (count_ - 2) + 1);
+    loc[2] = static_cast<uint32_t>(chain.r01() * (count_ - 2) + 1);
     if (loc[0] != loc[1] && loc[0] != loc[2] && loc[1] != loc[2]) {
       break;
     }
@@ -131,41 +183,116 @@ TourAlteration Optimizer::GetTourAlteration() {
 
   // Randomly select the alteration type and return the
   // tour alteration (indexes and type).
-  AlterationType t = (r01() < 0.5f) ? KReverse : kRotate;
+  AlterationType t = (chain.r01() < 0.5f) ? KReverse : kRotate;
   return { loc[0], loc[1], loc[2], t };
 }
 
-float Optimizer::TemperatureDifference(const std::vector<float>& costs,
-                    const TourAlteration& alteration) {
-  float c = 0;
+// Get the change in tour cost given an alteration to the tour.
+float Optimizer::CostDifference(const Chain& chain, const std::vector<float>& costs,
+                                const TourAlteration& alteration) const {
+  const auto& tour = chain.tour;
   uint32_t start = alteration.start;
   uint32_t end = alteration.end;
   if (alteration.alt == kRotate) {
-    // Subtract costs of connections that are broken
+    // Rotating moves the locations from mid to end-1 in front of the ones
+    // from start to mid-1. Only the connections at the borders change.
     uint32_t mid = alteration.mid;
-    c -= Cost(costs, tour_[start-1], tour_[start]);
-    c -= Cost(costs, tour_[end], tour_[end+1]);
-    c -= Cost(costs, tour_[mid], tour_[mid-1]);
-
-    // Add costs for the new connections
-    c += Cost(costs, tour_[start-1], tour_[mid]);
-    c += Cost(costs, tour_[end], tour_[start]);
-    c += Cost(costs, tour_[end-1], tour_[start]);
+    float c = 0;
+    c -= Cost(costs, tour[start-1], tour[start]);
+    c -= Cost(costs, tour[mid-1], tour[mid]);
+    c -= Cost(costs, tour[end-1], tour[end]);
+    c += Cost(costs, tour[start-1], tour[mid]);
+    c += Cost(costs, tour[end-1], tour[start]);
+    c += Cost(costs, tour[mid-1], tour[end]);
+    return c;
   } else {
-    // Reverse tour locations between a start and an end index.
-    // Subtract costs between successive locations from start-1 to end+1
-    for (uint32_t i = start - 1, j = i+1; i <= end; i++, j++) {
-      c -= Cost(costs, tour_[i], tour_[j]);
+    return ReverseCostDifference(costs, tour, chain.forward_costs,
+                                 chain.reverse_costs, start, end);
+  }
+}
+
+// Get the cost along a tour up to each location, in both directions
+void Optimizer::UpdateTourCosts(const std::vector<float>& costs,
+                                const std::vector<uint32_t>& tour,
+                                std::vector<float>& forward_costs,
+                                std::vector<float>& reverse_costs) const {
+  forward_costs.resize(count_);
+  reverse_costs.resize(count_);
+  forward_costs[0] = 0.0f;
+  reverse_costs[0] = 0.0f;
+  for (uint32_t i = 1; i < count_; i++) {
+    forward_costs[i] = forward_costs[i-1] + Cost(costs, tour[i-1], tour[i]);
+    reverse_costs[i] = reverse_costs[i-1] + Cost(costs, tour[i], tour[i-1]);
+  }
+}
+
+// Get the change in tour cost of reversing the locations from start to end
+float Optimizer::ReverseCostDifference(const std::vector<float>& costs,
+                                       const std::vector<uint32_t>& tour,
+                                       const std::vector<float>& forward_costs,
+                                       const std::vector<float>& reverse_costs,
+                                       const uint32_t start, const uint32_t end) const {
+  // Subtract the connections from start-1 to end+1, add the new ones at
+  // both ends and the connections within in reverse order
+  float c = 0;
+  c -= Cost(costs, tour[start-1], tour[start]);
+  c -= forward_costs[end] - forward_costs[start];
+  c -= Cost(costs, tour[end], tour[end+1]);
+  c += Cost(costs, tour[start-1], tour[end]);
+  c += reverse_costs[end] - reverse_costs[start];
+  c += Cost(costs, tour[start], tour[end+1]);
+  return c;
+}
+
+// Improve a tour with 2-opt and Or-opt moves until neither finds any
+void Optimizer::LocalSearch(const std::vector<float>& costs,
+                            std::vector<uint32_t>& tour) const {
+  std::vector<float> forward_costs, reverse_costs;
+  UpdateTourCosts(costs, tour, forward_costs, reverse_costs);
+  bool improved = true;
+  while (improved) {
+    improved = false;
+
+    // 2-opt: reverse the locations from i to j
+    for (uint32_t i = 1; i < count_ - 2; i++) {
+      for (uint32_t j = i + 1; j < count_ - 1; j++) {
+        if (ReverseCostDifference(costs, tour, forward_costs, reverse_costs, i, j) < -kMinImprovement) {
+          std::reverse(tour.begin() + i, tour.begin() + j + 1);
+          UpdateTourCosts(costs, tour, forward_costs, reverse_costs);
+          improved = true;
+        }
+      }
     }
 
-    // Add costs for the new connections and the reversed order
-    c += Cost(costs, tour_[start-1], tour_[end]);
-    c += Cost(costs, tour_[start], tour_[end+1]);
-    for (uint32_t i = end, j = i-1; i > start; i--, j--) {
-      c += Cost(costs, tour_[i], tour_[j]);
+    // Or-opt: move the locations from i to last between the locations at
+    // p and p+1
+    for (uint32_t length = 1; length <= kMaxMoveLength; length++) {
+      for (uint32_t i = 1; i + length < count_; i++) {
+        const uint32_t last = i + length - 1;
+        const float removed = Cost(costs, tour[i-1], tour[i]) +
+                              Cost(costs, tour[last], tour[last+1]) -
+                              Cost(costs, tour[i-1], tour[last+1]);
+        for (uint32_t p = 0; p < count_ - 1; p++) {
+          if (p + 1 >= i && p <= last) {
+            continue;
+          }
+          const float added = Cost(costs, tour[p], tour[i]) +
+                              Cost(costs, tour[last], tour[p+1]) -
+                              Cost(costs, tour[p], tour[p+1]);
+          if (added - removed < -kMinImprovement) {
+            if (p < i) {
+              std::rotate(tour.begin() + p + 1, tour.begin() + i, tour.begin() + last + 1);
+            } else {
+              std::rotate(tour.begin() + i, tour.begin() + last + 1, tour.begin() + p + 1);
+            }
+            UpdateTourCosts(costs, tour, forward_costs, reverse_costs);
+            improved = true;
+            break;
+          }
+        }
+      }
     }
   }
-  return (c / static_cast<float>(count_));
 }
 
 // Get the cost for the specified tour (order of locations).
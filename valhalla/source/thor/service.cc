@@ -14,6 +14,7 @@
 #include "baldr/json.h"
 #include "baldr/geojson.h"
 #include "baldr/errorcode_util.h"
+#include "baldr/graphtilefsstorage.h"
 
 #include <prime_server/prime_server.hpp>
 
@@ -33,6 +34,39 @@ namespace {
   const headers_t::value_type CORS{"Access-Control-Allow-Origin", "*"};
   const headers_t::value_type JSON_MIME{"Content-type", "application/json;charset=utf-8"};
   const headers_t::value_type JS_MIME{"Content-type", "application/javascript;charset=utf-8"};
+  constexpr size_t kDefaultSharedCacheSize = 1073741824; //1 gig
+
+  // Threads a matrix or isochrone request runs on, including the calling one
+  uint32_t matrix_threads(const boost::property_tree::ptree& config) {
+    return std::max(config.get<uint32_t>("thor.matrix_threads", 1), 1u);
+  }
+  uint32_t isochrone_threads(const boost::property_tree::ptree& config) {
+    return std::max(config.get<uint32_t>("thor.isochrone_threads", 1), 1u);
+  }
+
+  // Graph readers for the threads of a request besides the calling one.
+  // They share one tile cache so each tile is only loaded once among them.
+  std::vector<std::shared_ptr<GraphReader>> make_worker_readers(const boost::property_tree::ptree& config) {
+    std::vector<std::shared_ptr<GraphReader>> readers;
+    const uint32_t thread_count = std::max(matrix_threads(config), isochrone_threads(config));
+    if (thread_count <= 1)
+      return readers;
+    const auto& mjolnir = config.get_child("mjolnir");
+    auto shared_cache = std::make_shared<SynchronizedTileCache>(
+        mjolnir.get<size_t>("max_cache_size", kDefaultSharedCacheSize));
+    auto storage = std::make_shared<GraphTileFsStorage>(mjolnir);
+    for (uint32_t i = 1; i < thread_count; ++i)
+      readers.emplace_back(std::make_shared<GraphReader>(storage, mjolnir, shared_cache));
+    return readers;
+  }
+
+  // The first readers of the pool, for a request running on thread_count
+  // threads
+  std::vector<std::shared_ptr<GraphReader>> first_readers(
+      const std::vector<std::shared_ptr<GraphReader>>& readers, const uint32_t thread_count) {
+    return std::vector<std::shared_ptr<GraphReader>>(readers.begin(),
+        readers.begin() + std::min<size_t>(thread_count - 1, readers.size()));
+  }
 
   std::vector<baldr::PathLocation> store_correlated_locations(const boost::property_tree::ptree& request, const std::vector<baldr::Location>& locations) {
     //we require correlated locations
@@ -65,8 +99,14 @@ namespace valhalla {
 
     thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config):
       mode(valhalla::sif::TravelMode::kPedestrian),
-      config(config), matcher_factory(config), reader(matcher_factory.graphreader()),
-      long_request(config.get<float>("thor.logging.long_request")){
+      config(config), worker_readers(make_worker_readers(config)),
+      isochrone_gen(first_readers(worker_readers, isochrone_threads(config))),
+      costmatrix(kCostThresholdDefault, first_readers(worker_readers, matrix_threads(config))),
+      timedistancematrix(kDefaultCostThreshold, first_readers(worker_readers, matrix_threads(config))),
+      matcher_factory(config), reader(matcher_factory.graphreader()),
+      long_request(config.get<float>("thor.logging.long_request")),
+      optimizer_chains(config.get<uint32_t>("thor.optimizer.chains", 1)),
+      optimizer_threads(config.get<uint32_t>("thor.optimizer.threads", 1)){
       // Register edge/node costing methods
       factory.Register("auto", sif::CreateAutoCost);
       factory.Register("auto_shorter", sif::CreateAutoShorterCost);
@@ -93,6 +133,20 @@ namespace valhalla {
         source_to_target_algorithm = SELECT_OPTIMAL;
       }
 
+      // Precomputed edge costs per tile pay off when most requests share
+      // their costing options, off unless configured
+      edge_cost_cache = config.get<bool>("thor.edge_cost_cache", false);
+      astar.set_edge_cost_cache(edge_cost_cache);
+      bidir_astar.set_edge_cost_cache(edge_cost_cache);
+      costmatrix.set_edge_cost_cache(edge_cost_cache);
+
+      // Landmark distances tighten the A* heuristic on long routes, they
+      // are built by valhalla_build_landmarks
+      auto landmarks_file = config.get_optional<std::string>("thor.landmarks");
+      if (landmarks_file) {
+        bidir_astar.set_landmarks(Landmarks::Load(*landmarks_file));
+      }
+
       interrupt_callback = nullptr;
     }
 
@@ -339,9 +393,11 @@ namespace valhalla {
       correlated_s.clear();
       correlated_t.clear();
       isochrone_gen.Clear();
+      costmatrix.Clear();
       matcher_factory.ClearFullCache();
-      if(reader.OverCommitted())
-        reader.Clear();
+      reader.Trim();
+      for (auto& worker_reader : worker_readers)
+        worker_reader->Trim();
     }
 
     void run_service(const boost::property_tree::ptree& config) {
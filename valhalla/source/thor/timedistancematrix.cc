@@ -1,9 +1,12 @@
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include "thor/timedistancematrix.h"
 #include "midgard/logging.h"
+#include "midgard/worker_pool.h"
 
 using namespace valhalla::baldr;
+using namespace valhalla::midgard;
 using namespace valhalla::sif;
 
 namespace {
@@ -30,7 +33,19 @@ namespace thor {
 TimeDistanceMatrix::TimeDistanceMatrix(float initial_cost_threshold)
     : settled_count_(0),
       initial_cost_threshold_(initial_cost_threshold),
-      cost_threshold_(initial_cost_threshold) {
+      cost_threshold_(initial_cost_threshold),
+      workers_(new WorkerPool(1)) {
+}
+
+// Constructor with cost threshold and graph readers for worker threads.
+TimeDistanceMatrix::TimeDistanceMatrix(float initial_cost_threshold,
+        const std::vector<std::shared_ptr<GraphReader>>& worker_readers)
+    : TimeDistanceMatrix(initial_cost_threshold) {
+  worker_readers_ = worker_readers;
+  for (size_t i = 0; i < worker_readers_.size(); ++i) {
+    worker_matrices_.emplace_back(new TimeDistanceMatrix(initial_cost_threshold));
+  }
+  workers_.reset(new WorkerPool(worker_readers_.size() + 1));
 }
 
 // Clear the temporary information generated during time + distance matrix
@@ -41,11 +56,15 @@ void TimeDistanceMatrix::Clear() {
   destinations_.clear();
   dest_edges_.clear();
 
-  // Clear elements from the adjacency list
-  adjacencylist_.reset();
+  // Clear elements from the adjacency list (keeps its memory for reuse)
+  if (adjacencylist_) {
+    adjacencylist_->clear();
+  }
 
-  // Clear the edge status flags
-  edgestatus_.reset();
+  // Clear the edge status flags (keeps the status map for reuse)
+  if (edgestatus_) {
+    edgestatus_->Init();
+  }
 }
 
 // Calculate time and distance from one origin location to many destination
@@ -67,13 +86,16 @@ std::vector<TimeDistance> TimeDistanceMatrix::OneToMany(
   // factor (needed for setting the origin).
   astarheuristic_.Init(origin.latlng_, 0.0f);
   uint32_t bucketsize = costing->UnitSize();
-  // Set up lambda to get sort costs
-  const auto edgecost = [this](const uint32_t label) {
-    return edgelabels_[label].sortcost();
-  };
-  adjacencylist_.reset(new DoubleBucketQueue(0.0f, initial_cost_threshold_,
-                                             bucketsize, edgecost));
-  edgestatus_.reset(new EdgeStatus());
+  if (adjacencylist_) {
+    adjacencylist_->reuse(0.0f, initial_cost_threshold_, bucketsize);
+  } else {
+    adjacencylist_.reset(new DoubleBucketQueue(0.0f, initial_cost_threshold_, bucketsize));
+  }
+  if (edgestatus_) {
+    edgestatus_->Init();
+  } else {
+    edgestatus_.reset(new EdgeStatus());
+  }
 
   // Initialize the origin and destination locations
   settled_count_ = 0;
@@ -180,7 +202,7 @@ std::vector<TimeDistance> TimeDistanceMatrix::OneToMany(
           float newsortcost = oldsortcost - dc;
           edgelabels_[idx].Update(predindex, newcost, newsortcost,
                                   distance, 0, 0);
-          adjacencylist_->decrease(idx, newsortcost, oldsortcost);
+          adjacencylist_->decrease(idx, newsortcost);
         }
         continue;
       }
@@ -220,12 +242,16 @@ std::vector<TimeDistance> TimeDistanceMatrix::ManyToOne(
   // factor (needed for setting the origin).
   astarheuristic_.Init(dest.latlng_, 0.0f);
   uint32_t bucketsize = costing->UnitSize();
-  const auto edgecost = [this](const uint32_t label) {
-    return edgelabels_[label].sortcost();
-  };
-  adjacencylist_.reset(new DoubleBucketQueue(0.0f, initial_cost_threshold_,
-                                         bucketsize, edgecost));
-  edgestatus_.reset(new EdgeStatus());
+  if (adjacencylist_) {
+    adjacencylist_->reuse(0.0f, initial_cost_threshold_, bucketsize);
+  } else {
+    adjacencylist_.reset(new DoubleBucketQueue(0.0f, initial_cost_threshold_, bucketsize));
+  }
+  if (edgestatus_) {
+    edgestatus_->Init();
+  } else {
+    edgestatus_.reset(new EdgeStatus());
+  }
 
   // Initialize the origin and destination locations
   settled_count_ = 0;
@@ -348,7 +374,7 @@ std::vector<TimeDistance> TimeDistanceMatrix::ManyToOne(
           float newsortcost = oldsortcost - dc;
           edgelabels_[idx].Update(predindex, newcost, newsortcost,
                                   distance, 0, 0);
-          adjacencylist_->decrease(idx, newsortcost, oldsortcost);
+          adjacencylist_->decrease(idx, newsortcost);
         }
         continue;
       }
@@ -378,22 +404,32 @@ std::vector<TimeDistance> TimeDistanceMatrix::SourceToTarget(
         baldr::GraphReader& graphreader,
         const std::shared_ptr<sif::DynamicCost>* mode_costing,
         const sif::TravelMode mode) {
-  // Run a series of one to many calls and concatenate the results.
-  std::vector<TimeDistance> many_to_many;
-  if (source_location_list.size() <= target_location_list.size()) {
-    for (const auto& origin: source_location_list) {
-      std::vector<TimeDistance> td = OneToMany(origin, target_location_list,
-                                               graphreader, mode_costing, mode);
-      many_to_many.insert(many_to_many.end(), td.begin(), td.end());
-      Clear();
-    }
-  } else {
-    for (const auto& destination: target_location_list) {
-      std::vector<TimeDistance> td = ManyToOne(destination, source_location_list,
-                                               graphreader, mode_costing, mode);
-      many_to_many.insert(many_to_many.end(), td.begin(), td.end());
-      Clear();
+  // Run a series of one to many (or many to one) calls from the smaller set
+  // of locations and concatenate the results. With worker threads each
+  // worker takes the next location not searched yet until none are left,
+  // searches vary a lot in size so the work is not split up front. Each
+  // search stops on its own once all of its targets are settled.
+  const bool one_to_many = source_location_list.size() <= target_location_list.size();
+  const auto& origins = one_to_many ? source_location_list : target_location_list;
+  const auto& locations = one_to_many ? target_location_list : source_location_list;
+
+  std::vector<std::vector<TimeDistance>> rows(origins.size());
+  std::atomic<uint32_t> next_origin(0);
+  workers_->Run([&](const uint32_t worker) {
+    TimeDistanceMatrix& matrix = (worker == 0) ? *this : *worker_matrices_[worker - 1];
+    GraphReader& reader = (worker == 0) ? graphreader : *worker_readers_[worker - 1];
+    for (uint32_t i = next_origin++; i < origins.size(); i = next_origin++) {
+      rows[i] = one_to_many ?
+          matrix.OneToMany(origins[i], locations, reader, mode_costing, mode) :
+          matrix.ManyToOne(origins[i], locations, reader, mode_costing, mode);
+      matrix.Clear();
     }
+  });
+
+  std::vector<TimeDistance> many_to_many;
+  many_to_many.reserve(origins.size() * locations.size());
+  for (const auto& td : rows) {
+    many_to_many.insert(many_to_many.end(), td.begin(), td.end());
   }
   return many_to_many;
 }
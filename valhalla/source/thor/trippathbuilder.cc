@@ -118,6 +118,26 @@ uint32_t GetAdminIndex(
   return admin_index;
 }
 
+// Get the admin index of an admin of a tile. Nodes mostly share the admins
+// of their tiles so the admin info, and its strings, is only read the first
+// time an admin of a tile is seen.
+uint32_t GetAdminIndex(
+    const GraphTile* tile, const uint32_t admin_index,
+    std::unordered_map<GraphId, uint32_t>& tile_admin_map,
+    std::unordered_map<AdminInfo, uint32_t, AdminInfo::AdminInfoHasher>& admin_info_map,
+    std::vector<AdminInfo>& admin_info_list) {
+  const GraphId tile_id = tile->id();
+  const GraphId key(tile_id.tileid(), tile_id.level(), admin_index);
+  auto existing_admin = tile_admin_map.find(key);
+  if (existing_admin != tile_admin_map.end()) {
+    return existing_admin->second;
+  }
+  uint32_t index = GetAdminIndex(tile->admininfo(admin_index), admin_info_map,
+                                 admin_info_list);
+  tile_admin_map.emplace(key, index);
+  return index;
+}
+
 void AssignAdmins(const TripPathController& controller,
                   TripPath& trip_path,
                   const std::vector<AdminInfo>& admin_info_list) {
@@ -527,6 +547,7 @@ TripPath TripPathBuilder::Build(
   // Structures to process admins
   std::unordered_map<AdminInfo, uint32_t, AdminInfo::AdminInfoHasher> admin_info_map;
   std::vector<AdminInfo> admin_info_list;
+  std::unordered_map<GraphId, uint32_t> tile_admin_map;
   uint32_t last_node_admin_index;
 
   // If the path was only one edge we have a special case
@@ -536,7 +557,9 @@ TripPath TripPathBuilder::Build(
 
     // Get the shape. Reverse if the directed edge direction does
     // not match the traversal direction (based on start and end percent).
-    auto shape = tile->edgeinfo(edge->edgeinfo_offset()).shape();
+    std::vector<PointLL> edge_shape;
+    tile->edgeinfo(edge->edgeinfo_offset()).DecodeShape(edge_shape);
+    auto shape = edge_shape;
     if (edge->forward() != (start_pct < end_pct)) {
       std::reverse(shape.begin(), shape.end());
     }
@@ -568,7 +591,8 @@ TripPath TripPathBuilder::Build(
     auto trip_edge = AddTripEdge(
         controller, path.front().edgeid, path.front().trip_id, 0,
         path.front().mode, travel_types[static_cast<int>(path.front().mode)],
-        edge, trip_path.add_node(), tile, current_time, std::abs(end_pct - start_pct));
+        edge, trip_path.add_node(), tile, edge_shape, current_time,
+        std::abs(end_pct - start_pct));
 
     // Set begin shape index if requested
     if (controller.attributes.at(kEdgeBeginShapeIndex))
@@ -589,9 +613,8 @@ TripPath TripPathBuilder::Build(
     else {
       if (controller.attributes.at(kNodeaAdminIndex)) {
         node->set_admin_index(
-            GetAdminIndex(
-                end_tile->admininfo(end_tile->node(edge->endnode())->admin_index()),
-                admin_info_map, admin_info_list));
+            GetAdminIndex(end_tile, end_tile->node(edge->endnode())->admin_index(),
+                          tile_admin_map, admin_info_map, admin_info_list));
       }
     }
 
@@ -655,11 +678,40 @@ TripPath TripPathBuilder::Build(
     return trip_path;
   }
 
+  // Days from the pivot date of the origin date, the same for all nodes
+  uint32_t origin_days_from_pivot = 0;
+  if (origin.date_time_)
+    origin_days_from_pivot = DateTime::days_from_pivot_date(DateTime::get_formatted_date(*origin.date_time_));
+
+  // Look up the tiles and directed edges of the whole path up front, edges
+  // mostly follow one another within a tile so the tile of the edge before
+  // is checked first. It also tells how many nodes the trip path has.
+  std::vector<std::pair<const GraphTile*, const DirectedEdge*>> path_edges;
+  path_edges.reserve(path.size());
+  int node_count = 1;
+  const GraphTile* path_tile = nullptr;
+  for (const auto& path_info : path) {
+    if (path_tile == nullptr || path_tile->id() != path_info.edgeid.Tile_Base()) {
+      path_tile = graphreader.GetGraphTile(path_info.edgeid);
+    }
+    const DirectedEdge* path_edge = path_tile->directededge(path_info.edgeid);
+    path_edges.emplace_back(path_tile, path_edge);
+    if (!path_edge->trans_up() && !path_edge->trans_down()) {
+      node_count++;
+    }
+  }
+  trip_path.mutable_node()->Reserve(node_count);
+
+  // Intersecting edges are only needed if any of their attributes are
+  const bool intersecting_edges =
+      controller.category_attribute_enabled(kNodeIntersectingEdgeCategory);
+
   // Iterate through path
   uint32_t elapsedtime = 0;
   uint32_t block_id = 0;
   uint32_t prior_opp_local_index = -1;
   std::vector<PointLL> trip_shape;
+  std::vector<PointLL> edge_shape;
   std::string arrival_time;
   bool assumed_schedule = false;
   sif::TravelMode prev_mode = sif::TravelMode::kPedestrian;
@@ -670,8 +722,8 @@ TripPath TripPathBuilder::Build(
   for (auto edge_itr = path.begin(); edge_itr != path.end(); ++edge_itr) {
     const GraphId& edge = edge_itr->edgeid;
     const uint32_t trip_id = edge_itr->trip_id;
-    const GraphTile* graphtile = graphreader.GetGraphTile(edge);
-    const DirectedEdge* directededge = graphtile->directededge(edge);
+    const GraphTile* graphtile = path_edges[edge_itr - path.begin()].first;
+    const DirectedEdge* directededge = path_edges[edge_itr - path.begin()].second;
     const sif::TravelMode mode = edge_itr->mode;
     const uint8_t travel_type = travel_types[static_cast<uint32_t>(mode)];
 
@@ -685,7 +737,8 @@ TripPath TripPathBuilder::Build(
     TripPath_Node* trip_node = trip_path.add_node();
 
     // Set node attributes - only set if they are true since they are optional
-    const GraphTile* start_tile = graphreader.GetGraphTile(startnode);
+    const GraphTile* start_tile = graphtile->id() == startnode.Tile_Base() ?
+        graphtile : graphreader.GetGraphTile(startnode);
     const NodeInfo* node = start_tile->node(startnode);
 
     if (osmchangeset == 0 && controller.attributes.at(kOsmChangeset))
@@ -701,8 +754,7 @@ TripPath TripPathBuilder::Build(
 
     uint32_t current_time;
     if (origin.date_time_) {
-      current_time = DateTime::seconds_from_midnight(*origin.date_time_);
-      current_time += elapsedtime;
+      current_time = origin_sec_from_mid + elapsedtime;
     }
 
     // Assign the elapsed time from the start of the leg
@@ -711,16 +763,14 @@ TripPath TripPathBuilder::Build(
 
     // Assign the admin index
     if (controller.attributes.at(kNodeaAdminIndex)) {
-      trip_node->set_admin_index(GetAdminIndex(
-          start_tile->admininfo(node->admin_index()),
-          admin_info_map, admin_info_list));
+      trip_node->set_admin_index(GetAdminIndex(start_tile, node->admin_index(),
+          tile_admin_map, admin_info_map, admin_info_list));
     }
 
     if (controller.attributes.at(kNodeTimeZone)) {
-      const auto& tz_db = DateTime::get_tz_db();
-      auto tz = DateTime::get_tz_db().from_index(node->timezone());
-      if(tz)
-        trip_node->set_time_zone(tz->to_posix_string());
+      const auto& tz_posix = DateTime::get_tz_db().posix_string(node->timezone());
+      if(!tz_posix.empty())
+        trip_node->set_time_zone(tz_posix);
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -786,7 +836,7 @@ TripPath TripPathBuilder::Build(
         assumed_schedule = false;
         uint32_t date, day = 0;
         if (origin.date_time_) {
-          date = DateTime::days_from_pivot_date(DateTime::get_formatted_date(*origin.date_time_));
+          date = origin_days_from_pivot;
 
           if (graphtile->header()->date_created() > date) {
             // Set assumed schedule if requested
@@ -808,7 +858,7 @@ TripPath TripPathBuilder::Build(
 
           std::string dt = DateTime::get_duration(*origin.date_time_,
                            (transit_departure->departure_time() - origin_sec_from_mid),
-                           DateTime::get_tz_db().from_index(node->timezone()));
+                           node->timezone());
 
           std::size_t found = dt.find_last_of(" "); // remove tz abbrev.
           if (found != std::string::npos)
@@ -825,7 +875,7 @@ TripPath TripPathBuilder::Build(
                                      (transit_departure->departure_time() +
                                      transit_departure->elapsed_time()) -
                                      origin_sec_from_mid,
-                                     DateTime::get_tz_db().from_index(node->timezone()));
+                                     node->timezone());
 
           found = arrival_time.find_last_of(" "); //remove tz abbrev.
           if (found != std::string::npos)
@@ -858,14 +908,14 @@ TripPath TripPathBuilder::Build(
     auto is_last_edge = edge_itr == path.end() - 1;
     float length_pct = (
         is_first_edge ? 1.f - start_pct : (is_last_edge ? end_pct : 1.f));
+    graphtile->edgeinfo(directededge->edgeinfo_offset()).DecodeShape(edge_shape);
     TripPath_Edge* trip_edge = AddTripEdge(controller, edge, trip_id, block_id,
                                            mode, travel_type, directededge,
-                                           trip_node, graphtile, current_time,
-                                           length_pct);
+                                           trip_node, graphtile, edge_shape,
+                                           current_time, length_pct);
 
-    // Get the shape and set shape indexes (directed edge forward flag
-    // determines whether shape is traversed forward or reverse).
-    auto edgeinfo = graphtile->edgeinfo(directededge->edgeinfo_offset());
+    // Set shape indexes (directed edge forward flag determines whether
+    // shape is traversed forward or reverse).
     if (is_first_edge) {
       // Set begin shape index if requested
       if (controller.attributes.at(kEdgeBeginShapeIndex))
@@ -881,21 +931,21 @@ TripPath TripPathBuilder::Build(
       float length = static_cast<float>(directededge->length()) * length_pct;
       if (directededge->forward() == is_last_edge) {
         AddPartialShape<std::vector<PointLL>::const_iterator>(
-            trip_shape, edgeinfo.shape().begin(), edgeinfo.shape().end(),
+            trip_shape, edge_shape.cbegin(), edge_shape.cend(),
             length, is_last_edge, is_last_edge ? end_vrt : start_vrt);
       } else {
         AddPartialShape<std::vector<PointLL>::const_reverse_iterator>(
-            trip_shape, edgeinfo.shape().rbegin(), edgeinfo.shape().rend(),
+            trip_shape, edge_shape.crbegin(), edge_shape.crend(),
             length, is_last_edge, is_last_edge ? end_vrt : start_vrt);
       }
     }    // Just get the shape in there in the right direction
     else {
       if (directededge->forward())
-        trip_shape.insert(trip_shape.end(), edgeinfo.shape().begin() + 1,
-                          edgeinfo.shape().end());
+        trip_shape.insert(trip_shape.end(), edge_shape.begin() + 1,
+                          edge_shape.end());
       else
-        trip_shape.insert(trip_shape.end(), edgeinfo.shape().rbegin() + 1,
-                          edgeinfo.shape().rend());
+        trip_shape.insert(trip_shape.end(), edge_shape.rbegin() + 1,
+                          edge_shape.rend());
     }
     // Set end shape index if requested
     if (controller.attributes.at(kEdgeEndShapeIndex))
@@ -920,10 +970,10 @@ TripPath TripPathBuilder::Build(
     //          A || \\ G
     //            ||  \\
     //            (1)  (X)
-    if (startnode.Is_Valid()) {
+    if (intersecting_edges && startnode.Is_Valid()) {
       // Get the graph tile and the first edge from the node
-      const GraphTile* tile = graphreader.GetGraphTile(startnode);
-      const NodeInfo* nodeinfo = tile->node(startnode);
+      const GraphTile* tile = start_tile;
+      const NodeInfo* nodeinfo = node;
       if (mode == TravelMode::kPedestrian || mode == TravelMode::kBicycle) {
         // Iterate through edges on this level to find any intersecting edges
         // Follow any upwards or downward transitions
@@ -1032,9 +1082,9 @@ TripPath TripPathBuilder::Build(
   // Add the last node
   auto* node = trip_path.add_node();
   if (controller.attributes.at(kNodeaAdminIndex)) {
-    node->set_admin_index(GetAdminIndex(
-        last_tile->admininfo(last_tile->node(startnode)->admin_index()),
-        admin_info_map, admin_info_list));
+    node->set_admin_index(GetAdminIndex(last_tile,
+        last_tile->node(startnode)->admin_index(),
+        tile_admin_map, admin_info_map, admin_info_list));
   }
   if (controller.attributes.at(kNodeElapsedTime))
     node->set_elapsed_time(elapsedtime);
@@ -1074,6 +1124,7 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
                                             const DirectedEdge* directededge,
                                             TripPath_Node* trip_node,
                                             const GraphTile* graphtile,
+                                            const std::vector<PointLL>& shape,
                                             const uint32_t current_time,
                                             const float length_percentage) {
 
@@ -1085,11 +1136,12 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
   // Get the edgeinfo
   auto edgeinfo = graphtile->edgeinfo(directededge->edgeinfo_offset());
 
-  // Add names to edge if requested
+  // Add names to edge if requested, copying them straight from the tile
   if (controller.attributes.at(kEdgeNames)) {
-    std::vector<std::string> names = edgeinfo.GetNames();
-    for (const auto& name : names) {
-      trip_edge->add_name(name);
+    const uint32_t name_count = edgeinfo.name_count();
+    trip_edge->mutable_name()->Reserve(name_count);
+    for (uint32_t i = 0; i < name_count; ++i) {
+      trip_edge->add_name(edgeinfo.name(i));
     }
   }
 
@@ -1098,34 +1150,40 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
 #endif
 
   // Set the exits (if the directed edge has exit sign information) and if requested
-  if (directededge->exitsign()) {
-    std::vector<SignInfo> signs = graphtile->GetSigns(idx);
-    if (!signs.empty()) {
+  if (directededge->exitsign() &&
+      (controller.attributes.at(kEdgeSignExitNumber) ||
+       controller.attributes.at(kEdgeSignExitBranch) ||
+       controller.attributes.at(kEdgeSignExitToward) ||
+       controller.attributes.at(kEdgeSignExitName))) {
+    auto signs = graphtile->signs(idx);
+    if (signs.size() > 0) {
       TripPath_Sign* trip_exit = trip_edge->mutable_sign();
       for (const auto& sign : signs) {
         switch (sign.type()) {
           case Sign::Type::kExitNumber: {
             if (controller.attributes.at(kEdgeSignExitNumber))
-              trip_exit->add_exit_number(sign.text());
+              trip_exit->add_exit_number(graphtile->text(sign.text_offset()));
             break;
           }
           case Sign::Type::kExitBranch: {
             if (controller.attributes.at(kEdgeSignExitBranch))
-              trip_exit->add_exit_branch(sign.text());
+              trip_exit->add_exit_branch(graphtile->text(sign.text_offset()));
             break;
           }
           case Sign::Type::kExitToward: {
             if (controller.attributes.at(kEdgeSignExitToward))
-              trip_exit->add_exit_toward(sign.text());
+              trip_exit->add_exit_toward(graphtile->text(sign.text_offset()));
             break;
           }
           case Sign::Type::kExitName: {
             if (controller.attributes.at(kEdgeSignExitName))
-              trip_exit->add_exit_name(sign.text());
+              trip_exit->add_exit_name(graphtile->text(sign.text_offset()));
             break;
           }
         }
       }
+    } else {
+      LOG_ERROR("No signs found for idx = " + std::to_string(idx));
     }
   }
 
@@ -1177,7 +1235,7 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
       trip_edge->set_begin_heading(
           std::round(
               PointLL::HeadingAlongPolyline(
-                  edgeinfo.shape(),
+                  shape,
                   GetOffsetForHeading(directededge->classification(),
                                       directededge->use()))));
     }
@@ -1187,7 +1245,7 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
       trip_edge->set_end_heading(
           std::round(
               PointLL::HeadingAtEndOfPolyline(
-                  edgeinfo.shape(),
+                  shape,
                   GetOffsetForHeading(directededge->classification(),
                                       directededge->use()))));
     }
@@ -1217,7 +1275,7 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
           std::round(
               fmod(
                   (PointLL::HeadingAtEndOfPolyline(
-                      edgeinfo.shape(),
+                      shape,
                       GetOffsetForHeading(directededge->classification(),
                                           directededge->use())) + 180.0f),
                   360)));
@@ -1229,7 +1287,7 @@ TripPath_Edge* TripPathBuilder::AddTripEdge(const TripPathController& controller
           std::round(
               fmod(
                   (PointLL::HeadingAlongPolyline(
-                      edgeinfo.shape(),
+                      shape,
                       GetOffsetForHeading(directededge->classification(),
                                           directededge->use())) + 180.0f),
                   360)));
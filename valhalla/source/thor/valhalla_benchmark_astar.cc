@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "baldr/location.h"
+#include "baldr/pathlocation.h"
+#include "loki/search.h"
+#include "sif/autocost.h"
+#include "sif/directcost.h"
+#include "thor/astar.h"
+#include "thor/bidirectional_astar.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::sif;
+using namespace valhalla::thor;
+
+namespace {
+
+// Auto costing the path algorithms do not recognize as AutoCost, so they
+// run it through the virtual DynamicCost interface
+class VirtualAutoCost : public AutoCost {
+ public:
+  VirtualAutoCost(const boost::property_tree::ptree& config)
+      : AutoCost(config) {
+  }
+};
+
+struct result_t {
+  double ms;
+  float time;
+};
+
+// Route with the given path algorithm
+template <class algorithm_t>
+result_t Route(algorithm_t& algorithm, GraphReader& reader,
+               const cost_ptr_t* mode_costing, PathLocation origin,
+               PathLocation dest) {
+  auto start = std::chrono::steady_clock::now();
+  auto path = algorithm.GetBestPath(origin, dest, reader, mode_costing,
+                                    TravelMode::kDrive);
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+  result_t result{ms, path.empty() ? -1.0f : path.back().elapsed_time};
+  algorithm.Clear();
+  return result;
+}
+
+}
+
+// Routes a fixed set of auto routes with A* and bidirectional A*, once with
+// the expansion instantiated on AutoCost (DirectCost<AutoCost>) and once
+// through the virtual DynamicCost interface, and compares the time taken.
+// The routes are drawn from the nodes of the tile set with a fixed seed, so
+// the same tiles always give the same routes.
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: valhalla_benchmark_astar CONFIG [ROUTES] [MAX_KM]"
+              << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const size_t route_count = argc > 2 ? std::stoul(argv[2]) : 100;
+  const float max_distance = (argc > 3 ? std::stof(argv[3]) : 100.0f) * 1000.0f;
+
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  GraphReader reader(storage, config.get_child("mjolnir"));
+  const auto costing_options = config.get_child("costing_options.auto",
+                                                boost::property_tree::ptree());
+  cost_ptr_t direct[static_cast<int>(TravelMode::kMaxTravelMode)];
+  cost_ptr_t dynamic[static_cast<int>(TravelMode::kMaxTravelMode)];
+  direct[static_cast<uint32_t>(TravelMode::kDrive)] = CreateAutoCost(costing_options);
+  dynamic[static_cast<uint32_t>(TravelMode::kDrive)] =
+      std::make_shared<VirtualAutoCost>(costing_options);
+  const auto& costing = direct[static_cast<uint32_t>(TravelMode::kDrive)];
+  if (GetDirectCostType(*costing) != DirectCostType::kAuto ||
+      GetDirectCostType(*dynamic[static_cast<uint32_t>(TravelMode::kDrive)]) !=
+          DirectCostType::kDynamic) {
+    std::cout << "Unexpected costing types" << std::endl;
+    return 1;
+  }
+
+  // Nodes of the local level to draw the routes from, in tile order
+  std::vector<PointLL> nodes;
+  std::vector<GraphId> tiles;
+  const uint8_t local_level = reader.GetTileHierarchy().levels().rbegin()->first;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    if (tile_id.level() == local_level) {
+      tiles.push_back(tile_id);
+    }
+  }
+  std::sort(tiles.begin(), tiles.end());
+  for (const auto& tile_id : tiles) {
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    for (uint32_t i = 0; tile != nullptr && i < tile->header()->nodecount(); ++i) {
+      nodes.push_back(tile->node(i)->latlng());
+    }
+  }
+  if (nodes.empty()) {
+    std::cout << "No local nodes in the tile set" << std::endl;
+    return 1;
+  }
+
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+  AStarPathAlgorithm astar;
+  BidirectionalAStar bidir_astar;
+  double astar_direct = 0.0, astar_dynamic = 0.0;
+  double bidir_direct = 0.0, bidir_dynamic = 0.0;
+  size_t routes = 0, mismatches = 0;
+  for (size_t attempt = 0; routes < route_count && attempt < route_count * 1000;
+       ++attempt) {
+    const PointLL& a = nodes[pick(generator)];
+    const PointLL& b = nodes[pick(generator)];
+    if (a.Distance(b) > max_distance) {
+      continue;
+    }
+    const auto locations = valhalla::loki::Search({Location(a), Location(b)},
+        reader, costing->GetEdgeFilter(), costing->GetNodeFilter());
+    if (locations.size() != 2) {
+      continue;
+    }
+    const PathLocation& origin = locations.at(Location(a));
+    const PathLocation& dest = locations.at(Location(b));
+
+    const result_t ad = Route(astar, reader, direct, origin, dest);
+    if (ad.time < 0.0f) {
+      continue;
+    }
+    const result_t av = Route(astar, reader, dynamic, origin, dest);
+    const result_t bd = Route(bidir_astar, reader, direct, origin, dest);
+    const result_t bv = Route(bidir_astar, reader, dynamic, origin, dest);
+    if (ad.time != av.time || bd.time != bv.time) {
+      mismatches++;
+    }
+    astar_direct += ad.ms;
+    astar_dynamic += av.ms;
+    bidir_direct += bd.ms;
+    bidir_dynamic += bv.ms;
+    routes++;
+    reader.Trim();
+  }
+
+  if (routes == 0) {
+    std::cout << "No routes found" << std::endl;
+    return 1;
+  }
+  std::cout << std::fixed << std::setprecision(3) << routes << " routes" << std::endl
+            << "A*: DynamicCost " << astar_dynamic / routes << " ms, DirectCost<AutoCost> "
+            << astar_direct / routes << " ms" << std::endl
+            << "Bidirectional A*: DynamicCost " << bidir_dynamic / routes
+            << " ms, DirectCost<AutoCost> " << bidir_direct / routes << " ms"
+            << std::endl;
+  if (mismatches > 0) {
+    std::cout << mismatches << " routes differ between the costing paths" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "baldr/location.h"
+#include "baldr/pathlocation.h"
+#include "loki/search.h"
+#include "sif/autocost.h"
+#include "thor/isochrone.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::sif;
+using namespace valhalla::thor;
+
+namespace {
+
+constexpr size_t kDefaultSharedCacheSize = 1073741824; //1 gig
+
+struct result_t {
+  double ms;
+  std::vector<float> grid;
+};
+
+// Compute the isochrone a number of times, keeping the grid of the last
+result_t Compute(Isochrone& isochrone, GraphReader& reader,
+                 const cost_ptr_t* mode_costing, const PathLocation& origin,
+                 const unsigned int minutes, const size_t rounds) {
+  result_t result{0.0, {}};
+  for (size_t round = 0; round < rounds; ++round) {
+    std::vector<PathLocation> locations{origin};
+    auto start = std::chrono::steady_clock::now();
+    auto grid = isochrone.Compute(locations, minutes, reader, mode_costing,
+                                  TravelMode::kDrive);
+    result.ms += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    result.grid = grid->data();
+    isochrone.Clear();
+    reader.Trim();
+  }
+  result.ms /= rounds;
+  return result;
+}
+
+}
+
+// Computes an auto isochrone around a fixed location of a city extract on
+// one thread and with worker threads rasterizing the edge shapes, and
+// compares the time taken. Both must give the same grid.
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    std::cout << "usage: valhalla_benchmark_isochrone CONFIG LAT LON [MINUTES] [THREADS] [ROUNDS]"
+              << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const PointLL center(std::stof(argv[3]), std::stof(argv[2]));
+  const unsigned int minutes = argc > 4 ? std::stoul(argv[4]) : 30;
+  const uint32_t threads = argc > 5 ? std::stoul(argv[5]) : 4;
+  const size_t rounds = argc > 6 ? std::stoul(argv[6]) : 5;
+
+  const auto& mjolnir = config.get_child("mjolnir");
+  auto storage = std::make_shared<GraphTileFsStorage>(mjolnir);
+  GraphReader reader(storage, mjolnir);
+  auto shared_cache = std::make_shared<SynchronizedTileCache>(
+      mjolnir.get<size_t>("max_cache_size", kDefaultSharedCacheSize));
+  std::vector<std::shared_ptr<GraphReader>> worker_readers;
+  for (uint32_t i = 1; i < threads; ++i) {
+    worker_readers.emplace_back(std::make_shared<GraphReader>(storage, mjolnir, shared_cache));
+  }
+
+  cost_ptr_t mode_costing[static_cast<int>(TravelMode::kMaxTravelMode)];
+  mode_costing[static_cast<uint32_t>(TravelMode::kDrive)] =
+      CreateAutoCost(config.get_child("costing_options.auto",
+                                      boost::property_tree::ptree()));
+  const auto& costing = mode_costing[static_cast<uint32_t>(TravelMode::kDrive)];
+  const auto locations = valhalla::loki::Search({Location(center)}, reader,
+      costing->GetEdgeFilter(), costing->GetNodeFilter());
+  if (locations.size() != 1) {
+    std::cout << "No roads near the location" << std::endl;
+    return 1;
+  }
+  const PathLocation& origin = locations.at(Location(center));
+
+  // Warm the tile caches so both runs read the tiles from memory
+  Isochrone single, parallel(worker_readers);
+  Compute(single, reader, mode_costing, origin, minutes, 1);
+  Compute(parallel, reader, mode_costing, origin, minutes, 1);
+
+  const result_t s = Compute(single, reader, mode_costing, origin, minutes, rounds);
+  const result_t p = Compute(parallel, reader, mode_costing, origin, minutes, rounds);
+  std::cout << std::fixed << std::setprecision(3) << minutes << " minutes, "
+            << s.grid.size() << " cells: 1 thread " << s.ms << " ms, "
+            << threads << " threads " << p.ms << " ms" << std::endl;
+  if (s.grid != p.grid) {
+    std::cout << "Grids differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "baldr/location.h"
+#include "baldr/pathlocation.h"
+#include "loki/search.h"
+#include "sif/autocost.h"
+#include "thor/bidirectional_astar.h"
+#include "thor/landmarks.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::sif;
+using namespace valhalla::thor;
+
+namespace {
+
+// Relative difference in travel time allowed between the plain and the ALT
+// search, they add up the same costs in a different order
+constexpr float kTimeTolerance = 1e-4f;
+
+// Bidirectional A* telling how many edges it labeled
+class CountingAStar : public BidirectionalAStar {
+ public:
+  size_t label_count() const {
+    return edgelabels_forward_.size() + edgelabels_reverse_.size();
+  }
+};
+
+struct result_t {
+  size_t labels;
+  double ms;
+  float time;
+};
+
+// Route with or without landmarks
+result_t Route(CountingAStar& astar, GraphReader& reader,
+               const cost_ptr_t* mode_costing, PathLocation origin,
+               PathLocation dest) {
+  auto start = std::chrono::steady_clock::now();
+  auto path = astar.GetBestPath(origin, dest, reader, mode_costing,
+                                TravelMode::kDrive);
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+  result_t result{astar.label_count(), ms,
+                  path.empty() ? -1.0f : path.back().elapsed_time};
+  astar.Clear();
+  return result;
+}
+
+}
+
+// Routes a fixed set of long auto routes with and without landmarks and
+// compares the number of edges labeled and the time taken. The routes are
+// drawn from the nodes of the highway level with a fixed seed, so the same
+// tiles always give the same routes.
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cout << "usage: valhalla_benchmark_landmarks CONFIG LANDMARKS [ROUTES] [MIN_KM]"
+              << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  auto landmarks = Landmarks::Load(argv[2]);
+  const size_t route_count = argc > 3 ? std::stoul(argv[3]) : 20;
+  const float min_distance = (argc > 4 ? std::stof(argv[4]) : 500.0f) * 1000.0f;
+
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  GraphReader reader(storage, config.get_child("mjolnir"));
+  cost_ptr_t mode_costing[static_cast<int>(TravelMode::kMaxTravelMode)];
+  mode_costing[static_cast<uint32_t>(TravelMode::kDrive)] =
+      CreateAutoCost(config.get_child("costing_options.auto",
+                                      boost::property_tree::ptree()));
+  const auto& costing = mode_costing[static_cast<uint32_t>(TravelMode::kDrive)];
+
+  // Highway nodes to draw the routes from
+  std::vector<PointLL> nodes;
+  std::vector<GraphId> tiles;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    if (tile_id.level() == 0) {
+      tiles.push_back(tile_id);
+    }
+  }
+  std::sort(tiles.begin(), tiles.end());
+  for (const auto& tile_id : tiles) {
+    const GraphTile* tile = reader.GetGraphTile(tile_id);
+    for (uint32_t i = 0; tile != nullptr && i < tile->header()->nodecount(); ++i) {
+      nodes.push_back(tile->node(i)->latlng());
+    }
+  }
+  if (nodes.empty()) {
+    std::cout << "No highway nodes in the tile set" << std::endl;
+    return 1;
+  }
+
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+  CountingAStar plain, alt;
+  alt.set_landmarks(landmarks);
+  result_t plain_total{0, 0.0, 0.0f}, alt_total{0, 0.0, 0.0f};
+  size_t routes = 0, mismatches = 0;
+  for (size_t attempt = 0; routes < route_count && attempt < route_count * 1000;
+       ++attempt) {
+    const PointLL& a = nodes[pick(generator)];
+    const PointLL& b = nodes[pick(generator)];
+    const float distance = a.Distance(b);
+    if (distance < min_distance) {
+      continue;
+    }
+    const auto locations = valhalla::loki::Search({Location(a), Location(b)},
+        reader, costing->GetEdgeFilter(), costing->GetNodeFilter());
+    if (locations.size() != 2) {
+      continue;
+    }
+    const PathLocation& origin = locations.at(Location(a));
+    const PathLocation& dest = locations.at(Location(b));
+
+    const result_t p = Route(plain, reader, mode_costing, origin, dest);
+    const result_t l = Route(alt, reader, mode_costing, origin, dest);
+    if (p.time < 0.0f) {
+      continue;
+    }
+    std::cout << std::fixed << std::setprecision(1)
+              << distance / 1000.0f << " km: " << p.labels << " -> "
+              << l.labels << " edges, " << p.ms << " -> " << l.ms << " ms, "
+              << p.time << " -> " << l.time << " s" << std::endl;
+
+    // The landmarks heuristic must never overestimate, so the ALT search
+    // has to find a route exactly as fast as the plain one
+    if (l.time < 0.0f || std::abs(l.time - p.time) > kTimeTolerance * std::max(p.time, 1.0f)) {
+      std::cout << "Travel times differ" << std::endl;
+      mismatches++;
+      continue;
+    }
+    plain_total = {plain_total.labels + p.labels, plain_total.ms + p.ms,
+                   plain_total.time + p.time};
+    alt_total = {alt_total.labels + l.labels, alt_total.ms + l.ms,
+                 alt_total.time + l.time};
+    routes++;
+  }
+
+  if (routes == 0) {
+    std::cout << "No routes found";
+    if (mismatches > 0) {
+      std::cout << ", " << mismatches << " routes differ between the searches";
+    }
+    std::cout << std::endl;
+    return 1;
+  }
+  std::cout << routes << " routes, edges labeled " << plain_total.labels / routes
+            << " -> " << alt_total.labels / routes << ", latency "
+            << plain_total.ms / routes << " -> " << alt_total.ms / routes
+            << " ms, travel time " << plain_total.time / routes << " -> "
+            << alt_total.time / routes << " s" << std::endl;
+  if (mismatches > 0) {
+    std::cout << mismatches << " routes differ between the searches" << std::endl;
+    return 1;
+  }
+  return 0;
+}
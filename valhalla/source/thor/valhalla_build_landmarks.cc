@@ -0,0 +1,55 @@
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "baldr/graphconstants.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtilefsstorage.h"
+#include "thor/landmarks.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::thor;
+
+// Computes the landmark distances of a tile set and writes them to a file
+// for the thor.landmarks setting. The access modes name the edges followed,
+// the landmarks only serve costings that use a subset of them.
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cout << "usage: valhalla_build_landmarks CONFIG OUTPUT [COUNT] [MODES]"
+              << std::endl << "  MODES is a comma separated list of auto, "
+              << "truck, bus, hov, bicycle and pedestrian, defaults to auto"
+              << std::endl;
+    return 1;
+  }
+
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(argv[1], config);
+  const uint32_t count = argc > 3 ? std::stoul(argv[3]) : kDefaultLandmarkCount;
+
+  const std::unordered_map<std::string, uint32_t> modes {
+    {"auto", kAutoAccess}, {"truck", kTruckAccess}, {"bus", kBusAccess},
+    {"hov", kHOVAccess}, {"bicycle", kBicycleAccess},
+    {"pedestrian", kPedestrianAccess}
+  };
+  uint32_t access_mode = 0;
+  std::stringstream names(argc > 4 ? argv[4] : "auto");
+  for (std::string name; std::getline(names, name, ',');) {
+    auto mode = modes.find(name);
+    if (mode == modes.end()) {
+      std::cout << "Unknown access mode: " << name << std::endl;
+      return 1;
+    }
+    access_mode |= mode->second;
+  }
+
+  auto storage = std::make_shared<GraphTileFsStorage>(config.get_child("mjolnir"));
+  GraphReader reader(storage, config.get_child("mjolnir"));
+  auto landmarks = Landmarks::Build(reader, count, access_mode);
+  landmarks->Save(argv[2]);
+  return 0;
+}